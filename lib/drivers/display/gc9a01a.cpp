@@ -30,6 +30,7 @@
 
 /* === Includes === */
 #include "gc9a01a.h"
+#include <profile.h>
 
 /* Provide valid instantiations */
 template class gc9a01a::Controller<spi::Controller, gpio::Pin>;
@@ -53,6 +54,8 @@ namespace gc9a01a
         const uint16_t *buffer_begin,
         const uint16_t *buffer_end) -> bool
     {
+        OTOS_PROFILE("gc9a01a.draw");
+
         /* Start memory write */
         if (!this->send_command_byte(Command::Write_Memory))
             return false;
@@ -80,6 +83,8 @@ namespace gc9a01a
         const uint32_t color,
         const uint32_t background) -> bool
     {
+        OTOS_PROFILE("gc9a01a.draw");
+
         /* Start memory write */
         if (!this->send_command_byte(Command::Write_Memory))
             return false;
@@ -126,6 +131,8 @@ namespace gc9a01a
         const uint32_t background,
         void (*hook)()) -> bool
     {
+        OTOS_PROFILE("gc9a01a.draw");
+
         /* Start memory write */
         if (!this->send_command_byte(Command::Write_Memory))
             return false;
@@ -29,6 +29,7 @@
 
 /* === Includes === */
 #include "ili9341.h"
+#include <profile.h>
 
 /* Provide valid instantiations => use this as "concepts" for the display controller */
 //* @todo This seems a bit much work, the template approach of the bus controllers is nice though... */
@@ -81,6 +82,8 @@ namespace ili9341
         const uint16_t *buffer_begin,
         const uint16_t *buffer_end) -> bool
     {
+        OTOS_PROFILE("ili9341.draw");
+
         /* Start memory write */
         if (!this->send_command_byte(Command::Write_Memory))
             return false;
@@ -108,6 +111,8 @@ namespace ili9341
         const uint32_t color,
         const uint32_t background) -> bool
     {
+        OTOS_PROFILE("ili9341.draw");
+
         /* Start memory write */
         if (!this->send_command_byte(Command::Write_Memory))
             return false;
@@ -154,6 +159,8 @@ namespace ili9341
         const uint32_t background,
         void (*hook)()) -> bool
     {
+        OTOS_PROFILE("ili9341.draw");
+
         /* Start memory write */
         if (!this->send_command_byte(Command::Write_Memory))
             return false;
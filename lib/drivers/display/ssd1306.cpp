@@ -29,6 +29,7 @@
 
 /* === Includes === */
 #include "ssd1306.h"
+#include <profile.h>
 
 /* Provide template instantiations with allowed bus controllers */
 template class ssd1306::Controller<i2c::Controller>;
@@ -43,6 +44,8 @@ namespace ssd1306
     template <class bus_controller>
     auto Controller<bus_controller>::draw(uint8_t *const buffer) -> bool
     {
+        OTOS_PROFILE("ssd1306.draw");
+
         /* Send all 4 pages of the buffer */
         for (uint8_t iPage = 0; iPage < 4; iPage++)
             if (!bus::send_array_leader(this->mybus, 0x40, (buffer + 128 * iPage), 128))
@@ -29,6 +29,7 @@
 
 /* === Includes === */
 #include "uc1611.h"
+#include <profile.h>
 
 /* Provide valid instantiations => use this as "concepts" for the display controller */
 //* @todo This seems a bit much work, the template approach of the bus controllers is nice though... */
@@ -98,6 +99,8 @@ namespace uc1611
         const uint8_t *buffer_begin,
         const uint8_t *buffer_end) -> bool
     {
+        OTOS_PROFILE("uc1611.draw");
+
         /* signal data */
         this->dx_pin->set_high();
 
@@ -122,6 +125,8 @@ namespace uc1611
         const uint8_t *buffer_end,
         void (*hook)()) -> bool
     {
+        OTOS_PROFILE("uc1611.draw");
+
         /* signal data */
         this->dx_pin->set_high();
 
@@ -40,6 +40,7 @@
 #include "stm32/sdio_stm32.h"
 #include "stm32/timer_stm32.h"
 #include "stm32/usart_stm32.h"
+#include "stm32/watchdog_stm32.h"
 
 /* === Chip driver === */
 /* BMS chips */
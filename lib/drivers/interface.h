@@ -307,11 +307,33 @@ namespace bus
     {
         return bus.read_array(dest.data(), n_bytes);
     };
+
+    /**
+     * @brief Send a byte to a bus target and receive a byte at the same time.
+     * Only full duplex buses, like SPI, can implement this.
+     * @param byte Byte to be sent
+     * @return Returns True and the received byte when the transfer was successful, False otherwise.
+     * @details blocking function
+     */
+    template <class bus_controller>
+    std::optional<uint8_t> transfer_byte(bus_controller &bus, const uint8_t byte)
+    {
+        return bus.transfer_byte(byte);
+    };
 };
 
 // => SD Card Interface
 namespace sdio
 {
+    /* === Enums === */
+    /* SDIO Bus modes */
+    enum class Width : uint8_t
+    {
+        Default = 0b00,
+        _4Bit = 0b01,
+        _8Bit = 0b10
+    };
+
     /*
      * The following functions are just wrapper for the SDIO controller class
      * You can provide your own specialized overloads when you want to use an SPI bus
@@ -357,6 +379,60 @@ namespace sdio
     {
         return card.write_single_block(buffer_begin, buffer_end);
     };
+    template <class sdio>
+    bool read_multiple_blocks(sdio &card, const uint32_t *buffer_begin, const uint32_t *buffer_end)
+    {
+        return card.read_multiple_blocks(buffer_begin, buffer_end);
+    };
+    template <class sdio>
+    bool write_multiple_blocks(sdio &card, const uint32_t *buffer_begin, const uint32_t *buffer_end)
+    {
+        return card.write_multiple_blocks(buffer_begin, buffer_end);
+    };
+
+    /* Transfer the data blocks in the background with DMA */
+    template <class sdio>
+    bool has_dma(const sdio &card)
+    {
+        return card.has_dma_stream();
+    };
+    template <class sdio>
+    bool start_dma_read(sdio &card, const uint32_t *buffer_begin, const uint32_t *buffer_end)
+    {
+        return card.start_dma_read(buffer_begin, buffer_end);
+    };
+    template <class sdio>
+    bool start_dma_write(sdio &card, const uint32_t *buffer_begin, const uint32_t *buffer_end)
+    {
+        return card.start_dma_write(buffer_begin, buffer_end);
+    };
+    template <class sdio>
+    bool dma_transfer_finished(const sdio &card)
+    {
+        return card.dma_transfer_finished();
+    };
+    template <class sdio>
+    bool complete_dma_transfer(sdio &card)
+    {
+        return card.complete_dma_transfer();
+    };
+
+    /* Configure the bus after the card identification */
+    template <class sdio>
+    void set_bus_width(sdio &card, const Width width)
+    {
+        card.set_bus_width(width);
+    };
+    template <class sdio>
+    void set_clock(sdio &card, const uint32_t clock_rate)
+    {
+        card.set_clock(clock_rate);
+    };
+    template <class sdio>
+    void set_data_timeout(sdio &card, const uint32_t bus_ticks)
+    {
+        card.set_hardware_timeout(bus_ticks);
+    };
 };
 
 // => Timer Interface
@@ -141,6 +141,20 @@ namespace dma
     };
 
     /* === Methods === */
+    auto Stream::set_burst(const Burst memory, const Burst peripheral) -> Stream &
+    {
+#if defined(STM32F4)
+        /* clear old burst configuration */
+        this->Instance->CR &= ~(DMA_SxCR_MBURST_Msk | DMA_SxCR_PBURST_Msk);
+
+        /* set new burst configuration */
+        this->Instance->CR |= (static_cast<uint8_t>(memory) << DMA_SxCR_MBURST_Pos) & DMA_SxCR_MBURST_Msk;
+        this->Instance->CR |= (static_cast<uint8_t>(peripheral) << DMA_SxCR_PBURST_Pos) & DMA_SxCR_PBURST_Msk;
+#endif // STM32F4
+        /* Return the reference to the current object */
+        return *this;
+    };
+
     auto Stream::set_direction(const Direction &direction) -> Stream &
     {
 #if defined(STM32F4)
@@ -163,6 +177,19 @@ namespace dma
         return *this;
     };
 
+    auto Stream::set_fifo(const bool enable) -> Stream &
+    {
+#if defined(STM32F4)
+        /* Use the full FIFO as threshold, which fits all burst sizes of 32-bit data */
+        if (enable)
+            this->Instance->FCR = DMA_SxFCR_DMDIS | DMA_SxFCR_FTH_1 | DMA_SxFCR_FTH_0;
+        else
+            this->Instance->FCR &= ~DMA_SxFCR_DMDIS;
+#endif // STM32F4
+        /* Return the reference to the current object */
+        return *this;
+    };
+
     auto Stream::set_number_of_transfers(const size_t &number_of_transfers) -> Stream &
     {
         /* Set number of memory transfers */
@@ -194,6 +221,16 @@ namespace dma
         return *this;
     };
 
+    auto Stream::set_peripheral_flow_control(const bool enable) -> Stream &
+    {
+#if defined(STM32F4)
+        this->Instance->CR &= ~DMA_SxCR_PFCTRL;
+        this->Instance->CR |= (enable ? DMA_SxCR_PFCTRL : 0);
+#endif // STM32F4
+        /* Return the reference to the current object */
+        return *this;
+    };
+
     auto Stream::is_enabled() const -> bool
     {
 #if defined(STM32F4)
@@ -216,6 +253,15 @@ namespace dma
 #endif // STM32F4
     };
 
+    auto Stream::is_transfer_error() const -> bool
+    {
+#if defined(STM32F4)
+        return *this->Flags & (1 << (this->flag_offset + DMA_LISR_TEIF0_Pos));
+#elif defined(STM32L0)
+        return *this->Flags & (1 << (this->flag_offset + DMA_ISR_TEIF1_Pos));
+#endif // STM32F4
+    };
+
     void Stream::clear_interrupt_flag(const Flag &flag)
     {
 #if defined(STM32F4)
@@ -225,6 +271,15 @@ namespace dma
 #endif // STM32F4
     };
 
+    void Stream::disable()
+    {
+#if defined(STM32F4)
+        this->Instance->CR &= ~DMA_SxCR_EN;
+#elif defined(STM32L0)
+        this->Instance->CCR &= ~DMA_CCR_EN;
+#endif // STM32F4
+    };
+
     auto Stream::enable() -> bool
     {
         /* Only when Stream is not already enabled */
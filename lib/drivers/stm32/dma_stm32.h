@@ -37,6 +37,15 @@ namespace dma
         TransferError
     };
 
+    /* Burst transfers of the F4 devices */
+    enum class Burst : uint8_t
+    {
+        Single = 0b00,
+        Increment_4 = 0b01,
+        Increment_8 = 0b10,
+        Increment_16 = 0b11
+    };
+
     /* === Declarations === */
     /**
      * @brief This class/struct is used to define the used
@@ -182,6 +191,17 @@ namespace dma
         };
 
         /* === Setters === */
+        /**
+         * @brief Set the burst transfers of the memory and the peripheral.
+         * Burst transfers are only possible when the FIFO is enabled.
+         * @note Only available on F4 devices, has no effect on L0 devices.
+         *
+         * @param memory The burst of the memory side.
+         * @param peripheral The burst of the peripheral side.
+         * @return Stream& Reference to the stream object.
+         */
+        auto set_burst(const Burst memory, const Burst peripheral) -> Stream &;
+
         /**
          * @brief Set the data direction of the DMA stream.
          *
@@ -190,6 +210,17 @@ namespace dma
          */
         auto set_direction(const Direction &direction) -> Stream &;
 
+        /**
+         * @brief Enable or disable the FIFO of the DMA stream.
+         * When enabled, the direct mode is disabled and the
+         * FIFO threshold is set to the full FIFO.
+         * @note Only available on F4 devices, has no effect on L0 devices.
+         *
+         * @param enable Whether to enable the FIFO.
+         * @return Stream& Reference to the stream object.
+         */
+        auto set_fifo(const bool enable) -> Stream &;
+
         /**
          * @brief Set the number of items to be transferred by the DMA stream.
          *
@@ -206,6 +237,17 @@ namespace dma
          */
         auto set_peripheral_size(const Width &width) -> Stream &;
 
+        /**
+         * @brief Let the peripheral control the number of transfers.
+         * The number of transfers of the stream is ignored then and
+         * the peripheral signals the end of the transfer.
+         * @note Only available on F4 devices, has no effect on L0 devices.
+         *
+         * @param enable Whether the peripheral is the flow controller.
+         * @return Stream& Reference to the stream object.
+         */
+        auto set_peripheral_flow_control(const bool enable) -> Stream &;
+
         /* === Getters === */
         /**
          * @brief Check if the DMA stream is enabled.
@@ -220,6 +262,12 @@ namespace dma
          */
         auto is_transfer_complete() const -> bool;
 
+        /**
+         * @brief Check whether a transfer error occurred on the stream.
+         * @return Returns True when the transfer error flag is set.
+         */
+        auto is_transfer_error() const -> bool;
+
         /* === Methods === */
         /**
          * @brief Clear the interrupt flags of the DMA stream.
@@ -229,6 +277,12 @@ namespace dma
          */
         void clear_interrupt_flag(const Flag &flag);
 
+        /**
+         * @brief Disable the DMA stream.
+         * An ongoing transfer is aborted.
+         */
+        void disable();
+
         /**
          * @brief Enable the DMA stream.
          * This function automatically resets the interrupt flags and
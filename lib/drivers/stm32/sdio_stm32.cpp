@@ -50,6 +50,11 @@ namespace sdio
         /* Set the initial clock rate */
         this->set_clock(clock_rate, true);
 
+        /* The hardware flow control stops the bus clock while the
+         * FIFO is full or empty, so the FIFO does not overrun or
+         * underrun when the data is polled at high clock rates. */
+        this->peripheral->CLKCR |= SDIO_CLKCR_HWFC_EN;
+
         /* Set the timeout limit -> This value is high, because
          * during the card identification the clock speed
          * has to be 400 kHz. */
@@ -61,6 +66,14 @@ namespace sdio
     };
 
     /* === Methods === */
+    auto Controller::assign_dma_stream(dma::Stream &stream) -> Controller &
+    {
+        this->dma_stream = &stream;
+
+        /* Return the reference to the controller */
+        return *this;
+    };
+
     auto Controller::set_bus_width(const Width width) -> Controller &
     {
         /* Save the old register value without the prescaler bits */
@@ -77,15 +90,18 @@ namespace sdio
         const uint32_t clock_rate,
         const bool enable_save_power) -> Controller &
     {
-        /* Get the prescaler value with its 8 significant bits */
-        /* -> SDIO clock is ALWAYS 48 MHz */
-        const uint8_t prescaler = ((48'000'000 / clock_rate) - 2);
+        /* Get the prescaler value with its 8 significant bits, the divider is rounded up */
+        /* -> SDIO clock is ALWAYS 48 MHz and is divided by (prescaler + 2) */
+        const uint32_t divider = std::clamp<uint32_t>((48'000'000 + clock_rate - 1) / clock_rate, 2, 257);
+        const uint8_t prescaler = static_cast<uint8_t>(divider - 2);
 
-        /* Save the old register value without the prescaler bits */
+        /* Save the old register value without the prescaler and bypass bits */
         const uint32_t register_old = (this->peripheral->CLKCR & 0b1111101100000000);
 
-        /* Set the new clock configuration */
+        /* Set the new clock configuration, the full 48 MHz bypass the divider */
         this->peripheral->CLKCR = register_old | prescaler;
+        if (clock_rate >= 48'000'000)
+            this->peripheral->CLKCR |= SDIO_CLKCR_BYPASS;
         if (enable_save_power)
             this->peripheral->CLKCR |= SDIO_CLKCR_PWRSAV;
 
@@ -129,6 +145,32 @@ namespace sdio
         return this->peripheral->STA & SDIO_STA_DBCKEND;
     };
 
+    auto Controller::data_transfer_finished() const -> bool
+    {
+        return this->peripheral->STA & SDIO_STA_DATAEND;
+    };
+
+    auto Controller::dma_transfer_finished() const -> bool
+    {
+        /* Without a stream no transfer is running */
+        if (this->dma_stream == nullptr)
+            return false;
+
+        /* Errors abort the transfer */
+        if (this->peripheral->STA & (SDIO_STA_DTIMEOUT | SDIO_STA_DCRCFAIL | SDIO_STA_RXOVERR | SDIO_STA_TXUNDERR))
+            return true;
+        if (this->dma_stream->is_transfer_error())
+            return true;
+
+        /* The DMA has to empty the FIFO after the last data was received */
+        return this->data_transfer_finished() && this->dma_stream->is_transfer_complete();
+    };
+
+    auto Controller::has_dma_stream() const -> bool
+    {
+        return this->dma_stream != nullptr;
+    };
+
     auto Controller::data_RX_available() const -> bool
     {
         return this->peripheral->STA & SDIO_STA_RXDAVL;
@@ -173,6 +215,39 @@ namespace sdio
         this->peripheral->ICR = SDIO_ICR_RXOVERRC | SDIO_ICR_TXUNDERRC | SDIO_ICR_DTIMEOUTC | SDIO_ICR_CTIMEOUTC | SDIO_ICR_DCRCFAILC | SDIO_ICR_CCRCFAILC;
     };
 
+    auto Controller::complete_dma_transfer() -> bool
+    {
+        /* Without a stream no transfer was started */
+        if (this->dma_stream == nullptr)
+        {
+            this->set_error(error::Code::SDIO_No_DMA_Stream);
+            return false;
+        }
+
+        /* Check the transfer for errors */
+        bool success = true;
+        if (this->peripheral->STA & SDIO_STA_DTIMEOUT)
+        {
+            this->set_error(error::Code::SDIO_Timeout);
+            success = false;
+        }
+        else if ((this->peripheral->STA & (SDIO_STA_DCRCFAIL | SDIO_STA_RXOVERR | SDIO_STA_TXUNDERR)) ||
+                 this->dma_stream->is_transfer_error())
+        {
+            this->set_error(error::Code::SDIO_Data_Error);
+            success = false;
+        }
+
+        /* Release the data path and the DMA stream */
+        if (not success)
+            this->dma_stream->disable();
+        this->peripheral->DCTRL = 0;
+        this->dma_stream->clear_interrupt_flag(dma::Flag::All);
+        this->clear_error_flags();
+        this->clear_data_flags();
+        return success;
+    };
+
     auto Controller::read_single_block(
         const uint32_t *buffer_begin,
         const uint32_t *buffer_end) -> bool
@@ -276,6 +351,130 @@ namespace sdio
         return true;
     };
 
+    auto Controller::read_multiple_blocks(
+        const uint32_t *buffer_begin,
+        const uint32_t *buffer_end) -> bool
+    {
+        /* Only when bus is not busy */
+        if (this->is_busy())
+        {
+            this->set_error(error::Code::SDIO_BUS_Busy_Error);
+            return false;
+        }
+
+        /* The buffer has 4 bytes per entry and has to contain whole blocks */
+        const uint32_t n_bytes = std::distance(buffer_begin, buffer_end) * 4;
+        if ((n_bytes == 0) || ((n_bytes % BLOCK_LENGTH) != 0))
+            return false;
+
+        /* Set the data length in bytes. */
+        this->set_data_length(n_bytes);
+
+        /* Start transfer */
+        this->peripheral->DCTRL = (BLOCK_EXPONENT << 4) | SDIO_DCTRL_DTDIR | SDIO_DCTRL_DTEN;
+
+        /* Wait until the data counter reached zero or the data is corrupted */
+        constexpr uint32_t data_errors = SDIO_STA_DCRCFAIL | SDIO_STA_RXOVERR;
+        uint32_t *iter = const_cast<uint32_t *>(buffer_begin);
+        this->reset_timeout();
+        while (not this->data_transfer_finished() && not(this->peripheral->STA & data_errors))
+        {
+            /* Check for timeouts, the software timeout restarts with every word */
+            if (this->hardware_timeout() || this->timed_out())
+            {
+                this->set_error(error::Code::SDIO_Timeout);
+                return false;
+            }
+
+            /* Save the FIFO data */
+            if (this->data_RX_available() && (iter != buffer_end))
+            {
+                *iter = this->peripheral->FIFO;
+                iter++;
+                this->reset_timeout();
+            }
+        }
+
+        /* The FIFO still holds the last words when the data counter reached zero */
+        while (this->data_RX_available() && (iter != buffer_end))
+        {
+            *iter = this->peripheral->FIFO;
+            iter++;
+        }
+
+        /* Check the data for errors */
+        if (this->peripheral->STA & data_errors)
+        {
+            this->set_error(error::Code::SDIO_Data_Error);
+            this->clear_data_flags();
+            this->clear_error_flags();
+            return false;
+        }
+
+        /* Transfer finished without errors, clear flags and exit. */
+        this->clear_data_flags();
+        return true;
+    };
+
+    auto Controller::start_dma(
+        const uint32_t *buffer_begin,
+        const uint32_t *buffer_end,
+        const dma::Direction direction) -> bool
+    {
+        /* The stream has to be assigned beforehand */
+        if (this->dma_stream == nullptr)
+        {
+            this->set_error(error::Code::SDIO_No_DMA_Stream);
+            return false;
+        }
+
+        /* Only when bus and stream are not busy */
+        if (this->is_busy() || this->dma_stream->is_enabled())
+        {
+            this->set_error(error::Code::SDIO_BUS_Busy_Error);
+            return false;
+        }
+
+        /* The buffer has 4 bytes per entry and has to contain whole blocks */
+        const uint32_t n_bytes = std::distance(buffer_begin, buffer_end) * 4;
+        if ((n_bytes == 0) || ((n_bytes % BLOCK_LENGTH) != 0))
+            return false;
+
+        /*
+         * The SDIO is the flow controller and the FIFO is
+         * used with bursts of 4 words, as required by the
+         * SDIO peripheral.
+         */
+        this->dma_stream->set_direction(direction)
+            .set_peripheral_size(dma::Width::_32bit)
+            .set_peripheral_flow_control(true)
+            .set_burst(dma::Burst::Increment_4, dma::Burst::Increment_4)
+            .set_fifo(true)
+            .assign_peripheral(this->peripheral->FIFO)
+            .assign_memory(*const_cast<uint32_t *>(buffer_begin), true);
+        this->dma_stream->enable();
+
+        /* Start the data path */
+        const uint32_t read = (direction == dma::Direction::peripheral_to_memory) ? SDIO_DCTRL_DTDIR : 0;
+        this->set_data_length(n_bytes);
+        this->peripheral->DCTRL = (BLOCK_EXPONENT << 4) | read | SDIO_DCTRL_DMAEN | SDIO_DCTRL_DTEN;
+        return true;
+    };
+
+    auto Controller::start_dma_read(
+        const uint32_t *buffer_begin,
+        const uint32_t *buffer_end) -> bool
+    {
+        return this->start_dma(buffer_begin, buffer_end, dma::Direction::peripheral_to_memory);
+    };
+
+    auto Controller::start_dma_write(
+        const uint32_t *buffer_begin,
+        const uint32_t *buffer_end) -> bool
+    {
+        return this->start_dma(buffer_begin, buffer_end, dma::Direction::memory_to_peripheral);
+    };
+
     auto Controller::send_command_no_response(
         const uint8_t command,
         const uint32_t argument) -> bool
@@ -512,6 +711,63 @@ namespace sdio
             }
         }
 
+        /* Transfer finished without errors, clear flags and exit. */
+        this->clear_data_flags();
+        return true;
+    };
+    auto Controller::write_multiple_blocks(
+        const uint32_t *buffer_begin,
+        const uint32_t *buffer_end) -> bool
+    {
+        /* Only when bus is not busy */
+        if (this->is_busy())
+        {
+            this->set_error(error::Code::SDIO_BUS_Busy_Error);
+            return false;
+        }
+
+        /* The buffer has 4 bytes per entry and has to contain whole blocks */
+        const uint32_t n_bytes = std::distance(buffer_begin, buffer_end) * 4;
+        if ((n_bytes == 0) || ((n_bytes % BLOCK_LENGTH) != 0))
+            return false;
+
+        /* Set the data length in bytes. */
+        this->set_data_length(n_bytes);
+
+        /* Start transfer */
+        this->peripheral->DCTRL = (BLOCK_EXPONENT << 4) | SDIO_DCTRL_DTEN;
+
+        /* Wait until the data counter reached zero and the bus is idle */
+        constexpr uint32_t data_errors = SDIO_STA_DCRCFAIL | SDIO_STA_TXUNDERR;
+        const uint32_t *iter = buffer_begin;
+        this->reset_timeout();
+        while ((not this->data_transfer_finished()) || this->is_busy())
+        {
+            /* Check for timeouts, the software timeout restarts with every word */
+            if (this->hardware_timeout() || this->timed_out())
+            {
+                this->set_error(error::Code::SDIO_Timeout);
+                return false;
+            }
+
+            /* The card did not accept the data */
+            if (this->peripheral->STA & data_errors)
+            {
+                this->set_error(error::Code::SDIO_Data_Error);
+                this->clear_data_flags();
+                this->clear_error_flags();
+                return false;
+            }
+
+            /* Fill the FIFO */
+            if (this->data_TX_empty() && (iter != buffer_end))
+            {
+                this->peripheral->FIFO = *iter;
+                iter++;
+                this->reset_timeout();
+            }
+        }
+
         /* Transfer finished without errors, clear flags and exit. */
         this->clear_data_flags();
         return true;
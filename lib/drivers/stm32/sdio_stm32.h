@@ -22,26 +22,24 @@
 #define SDIO_STM32_H_
 
 /* === Includes === */
+#include <algorithm>
 #include <optional>
 #include "vendors.h"
 
 /* === Needed Interfaces === */
 #include "interface.h"
 #include "peripherals_stm32.h"
+#include "dma_stm32.h"
 
 #ifdef STM32F4 /* Only STM32F4 devices have the SDIO peripheral */
 
 /* === Declarations === */
 namespace sdio
 {
-    /* === Enums === */
-    /* SDIO Bus modes */
-    enum class Width: uint8_t
-    {
-        Default     = 0b00,
-        _4Bit       = 0b01,
-        _8Bit       = 0b10
-    };
+    /* === Constants === */
+    /* The block length of multiple block transfers in bytes -> 2^9 = 512 */
+    constexpr uint32_t BLOCK_LENGTH = 512;
+    constexpr uint8_t BLOCK_EXPONENT = 9;
 
     /* === Classes === */
     class Controller : public driver::Base<stm32::Peripheral>
@@ -58,6 +56,15 @@ namespace sdio
         Controller &operator=(Controller &&) = default;
 
         /* === Setters === */
+        /**
+         * @brief Assign the DMA stream for the data transfers.
+         * On the STM32F4 the SDIO is connected to DMA2 Stream 3
+         * or Stream 6 with Channel 4.
+         *
+         * @param stream The DMA stream to use.
+         */
+        auto assign_dma_stream(dma::Stream &stream) -> Controller &;
+
         /**
          * @brief Set the bus width for the communication.
          *
@@ -68,7 +75,12 @@ namespace sdio
         /**
          * @brief Set the clock rate for the bus communication.
          *
-         * @param clock_rate The clock rate in [Hz]. Should be [400 kHz ... 25 MHz] for SDHC-Cards.
+         * The clock is divided from 48 MHz and does not exceed the
+         * requested rate. Rates of 48 MHz and above bypass the divider,
+         * which requires the card to be in high-speed mode. The hardware
+         * flow control, which is enabled by the constructor, is kept.
+         *
+         * @param clock_rate The clock rate in [Hz]. Should be [400 kHz ... 25 MHz] for SDHC-Cards, 50 MHz in high-speed mode.
          * @param enable_power_save If True the clock is only enabled when bus is active.
          */
         auto set_clock(uint32_t clock_rate, bool enable_save_power = false) -> Controller &;
@@ -113,6 +125,27 @@ namespace sdio
          */
         auto data_block_transfer_finished() const -> bool;
 
+        /**
+         * @brief Check whether the complete data transfer
+         * is finished, i.e. the data counter reached zero.
+         */
+        auto data_transfer_finished() const -> bool;
+
+        /**
+         * @brief Check whether the running DMA transfer is finished.
+         * Returns also True when the transfer was aborted due to
+         * an error, so waiting threads can always continue.
+         * Returns False when no DMA stream is assigned.
+         * Use complete_dma_transfer() afterwards.
+         */
+        auto dma_transfer_finished() const -> bool;
+
+        /**
+         * @brief Check whether a DMA stream is assigned, so
+         * the data blocks can be transferred with DMA.
+         */
+        auto has_dma_stream() const -> bool;
+
         /**
          * @brief Check whether RX FIFO contains valid data.
          */
@@ -176,6 +209,19 @@ namespace sdio
          */
         void clear_error_flags();
 
+        /**
+         * @brief Complete a finished DMA transfer.
+         * Checks the transfer for errors and releases the data path.
+         *
+         * Sets the following errors:
+         * - SDIO_Timeout
+         * - SDIO_Data_Error
+         * - SDIO_No_DMA_Stream
+         *
+         * @return Returns True when the data was transferred without errors.
+         */
+        auto complete_dma_transfer() -> bool;
+
         /**
          * @brief Read a data block.
          * The length of the block is defined by the length of the
@@ -189,6 +235,23 @@ namespace sdio
          */
         auto read_single_block(const uint32_t* buffer_begin, const uint32_t* buffer_end) -> bool;
 
+        /**
+         * @brief Read multiple data blocks with one transfer.
+         * The blocks have a length of 512 bytes and the number
+         * of blocks is defined by the length of the given buffer.
+         *
+         * The card has to be told to send the blocks beforehand.
+         * Sets the following errors:
+         * - SDIO_BUS_Busy_Error
+         * - SDIO_Timeout
+         * - SDIO_Data_Error
+         *
+         * @param buffer_begin The begin iterator of the receive buffer.
+         * @param buffer_end The end of the receive buffer.
+         * @return Return True when all blocks were read successfully.
+         */
+        auto read_multiple_blocks(const uint32_t* buffer_begin, const uint32_t* buffer_end) -> bool;
+
         /**
          * @brief Send a command without an expected response.
          *
@@ -273,6 +336,46 @@ namespace sdio
          */
         auto send_command_R7_response(const uint8_t command, const uint32_t argument) -> std::optional<uint32_t>;
 
+        /**
+         * @brief Start reading data blocks using the DMA stream.
+         * The function returns immediately after starting the transfer.
+         * Poll dma_transfer_finished() and call complete_dma_transfer()
+         * afterwards. The buffer must not be used during the transfer.
+         *
+         * The blocks have a length of 512 bytes and the card has to be
+         * told to send the blocks beforehand.
+         *
+         * Sets the following errors:
+         * - SDIO_BUS_Busy_Error
+         * - SDIO_No_DMA_Stream
+         *
+         * @param buffer_begin The begin iterator of the receive buffer.
+         * @param buffer_end The end of the receive buffer.
+         * @return Returns True when the transfer was started.
+         * @details non-blocking function
+         */
+        auto start_dma_read(const uint32_t* buffer_begin, const uint32_t* buffer_end) -> bool;
+
+        /**
+         * @brief Start writing data blocks using the DMA stream.
+         * The function returns immediately after starting the transfer.
+         * Poll dma_transfer_finished() and call complete_dma_transfer()
+         * afterwards. The buffer must not be changed during the transfer.
+         *
+         * The blocks have a length of 512 bytes and the card has to be
+         * told to receive the blocks beforehand.
+         *
+         * Sets the following errors:
+         * - SDIO_BUS_Busy_Error
+         * - SDIO_No_DMA_Stream
+         *
+         * @param buffer_begin The begin iterator of the transmit data.
+         * @param buffer_end The end of the transmit buffer.
+         * @return Returns True when the transfer was started.
+         * @details non-blocking function
+         */
+        auto start_dma_write(const uint32_t* buffer_begin, const uint32_t* buffer_end) -> bool;
+
         /**
          * @brief Write a data block.
          * The length of the block is defined by the length of the
@@ -286,6 +389,23 @@ namespace sdio
          */
         auto write_single_block(const uint32_t* buffer_begin, const uint32_t* buffer_end) -> bool;
 
+        /**
+         * @brief Write multiple data blocks with one transfer.
+         * The blocks have a length of 512 bytes and the number
+         * of blocks is defined by the length of the given buffer.
+         *
+         * The card has to be told to receive the blocks beforehand.
+         * Sets the following errors:
+         * - SDIO_BUS_Busy_Error
+         * - SDIO_Timeout
+         * - SDIO_Data_Error
+         *
+         * @param buffer_begin The begin iterator of the transmit data.
+         * @param buffer_end The end of the transmit buffer.
+         * @return Return True when all blocks were sent successfully.
+         */
+        auto write_multiple_blocks(const uint32_t* buffer_begin, const uint32_t* buffer_end) -> bool;
+
     private:
         /* === Constructors === */
         /**
@@ -296,8 +416,20 @@ namespace sdio
          */
         Controller(uint32_t clock_rate);
 
+        /* === Methods === */
+        /**
+         * @brief Configure the DMA stream and the data path for a DMA transfer.
+         *
+         * @param buffer_begin The begin iterator of the data buffer.
+         * @param buffer_end The end of the data buffer.
+         * @param direction The direction of the transfer.
+         * @return Returns True when the transfer was started.
+         */
+        auto start_dma(const uint32_t* buffer_begin, const uint32_t* buffer_end, dma::Direction direction) -> bool;
+
         /* === Properties === */
-        SDIO_TypeDef *peripheral; /**< Pointer to the SDIO peripheral. */
+        SDIO_TypeDef *peripheral;           /**< Pointer to the SDIO peripheral. */
+        dma::Stream *dma_stream{nullptr};   /**< The DMA stream for data transfers. */
     };
 }; // namespace sdio
 #endif // STM32F4
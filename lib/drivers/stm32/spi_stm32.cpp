@@ -298,43 +298,8 @@ namespace spi
 
     auto Controller::read_data_byte() -> std::optional<uint8_t>
     {
-        /* Empty the RX buffer if its not empty */
-        uint8_t rx = 0;
-        if (this->RX_data_valid())
-            rx = this->peripheral->DR;
-
-        /* Wait until TX buffer is empty */
-        this->reset_timeout();
-        while (not this->last_transmit_finished())
-        {
-            /* Check for timeouts */
-            if (this->timed_out())
-            {
-                /* Peripheral timed out -> set error */
-                this->set_error(error::Code::SPI_Timeout);
-                return {};
-            }
-        }
-
-        /* Initiate receive by sending dummy data => SPI is in Full Duplex mode */
-        this->peripheral->DR = 0x00;
-
-        /* Wait until RX buffer contains data */
-        this->reset_timeout();
-        while (not this->RX_data_valid())
-        {
-            /* Check for timeouts */
-            if (this->timed_out())
-            {
-                /* Peripheral timed out -> set error */
-                this->set_error(error::Code::SPI_Timeout);
-                return {};
-            }
-        }
-
-        /* read the byte */
-        rx = this->peripheral->DR;
-        return rx;
+        /* Initiate receive by sending dummy data */
+        return this->transfer_byte(0x00);
     };
 
     auto Controller::send_data(const bus::Data_t payload,
@@ -480,4 +445,45 @@ namespace spi
         /* Read was successful */
         return true;
     };
+
+    auto Controller::transfer_byte(const uint8_t data) -> std::optional<uint8_t>
+    {
+        /* Empty the RX buffer if its not empty */
+        uint8_t rx = 0;
+        if (this->RX_data_valid())
+            rx = this->peripheral->DR;
+
+        /* Wait until TX buffer is empty */
+        this->reset_timeout();
+        while (not this->last_transmit_finished())
+        {
+            /* Check for timeouts */
+            if (this->timed_out())
+            {
+                /* Peripheral timed out -> set error */
+                this->set_error(error::Code::SPI_Timeout);
+                return {};
+            }
+        }
+
+        /* Send the data, the received byte is shifted in at the same time => SPI is in Full Duplex mode */
+        this->peripheral->DR = data;
+
+        /* Wait until RX buffer contains data */
+        this->reset_timeout();
+        while (not this->RX_data_valid())
+        {
+            /* Check for timeouts */
+            if (this->timed_out())
+            {
+                /* Peripheral timed out -> set error */
+                this->set_error(error::Code::SPI_Timeout);
+                return {};
+            }
+        }
+
+        /* read the byte */
+        rx = this->peripheral->DR;
+        return rx;
+    };
 }; // namespace spi
@@ -199,6 +199,21 @@ namespace spi
          */
         auto read_array(uint8_t *dest, uint8_t n_bytes) -> bool;
 
+        /**
+         * @brief Send a byte and return the byte which was received
+         * at the same time. Other than when reading data, the byte
+         * which clocks the target is given by the caller, e.g. SD
+         * cards expect 0xFF while they are sending.
+         *
+         * Sets the following errors:
+         * - SPI_Timeout
+         *
+         * @param data The byte to send.
+         * @return Returns the received byte when the transfer was successful.
+         * @details blocking function
+         */
+        auto transfer_byte(uint8_t data) -> std::optional<uint8_t>;
+
         /**
          * @brief Create a dma stream object for the SPI controller.
          * This function should be called with a rvalue reference to a DMA Stream object.
@@ -138,13 +138,13 @@ namespace detail
 namespace timer
 {
     /* === Functions === */
-    void SysTick_Configure()
+    void SysTick_Configure(const uint32_t tick_rate_hz)
     {
-        /* Compute the ticks per ms */
-        constexpr uint32_t ticks_ms = (F_CPU / 1000);
+        /* Compute the core clock cycles per interrupt */
+        const uint32_t ticks = (F_CPU / tick_rate_hz);
 
         /* Configure the SysTick timer */
-        SysTick_Config(ticks_ms);
+        SysTick_Config(ticks);
 
         /* Reconfigure Priorities so that SysTick has the highest priority */
 #if defined(STM32L0)
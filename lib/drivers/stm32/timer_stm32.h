@@ -441,9 +441,12 @@ namespace timer
 
     /* === Functions === */
     /**
-     * @brief Configure the SysTick timer for interrupts every 1 ms.
+     * @brief Configure the SysTick timer for periodic interrupts.
+     * Use the kernel tick rate OTOS::tick_rate_hz when the interrupt
+     * drives the kernel.
+     * @param tick_rate_hz The interrupt rate in [Hz], defaults to 1 kHz.
      */
-    void SysTick_Configure();
+    void SysTick_Configure(uint32_t tick_rate_hz = 1'000U);
 
     /* === Atomic access functions === */
     namespace atomic
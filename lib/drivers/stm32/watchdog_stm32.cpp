@@ -0,0 +1,86 @@
+/**
+ * OTOS - Open Tec Operating System
+ * Copyright (c) 2021 - 2024 Sebastian Oberschwendtner, sebastian.oberschwendtner@gmail.com
+ *
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+/**
+ ==============================================================================
+ * @file    watchdog_stm32.cpp
+ * @author  SO
+ * @version v5.2.0
+ * @date    18-October-2026
+ * @brief   Independent watchdog driver for STM32 microcontrollers.
+ ==============================================================================
+ */
+
+/* === Includes === */
+#include "watchdog_stm32.h"
+#include <algorithm>
+
+namespace watchdog
+{
+    /* === Builder === */
+    auto Independent::create(const std::chrono::milliseconds timeout) -> Independent
+    {
+        /* Find the smallest prescaler for which the reload value fits into the register */
+        uint32_t prescaler = 0;
+        uint32_t reload = 0;
+        for (; prescaler < 7; prescaler++)
+        {
+            const uint32_t f_counter = f_lsi / (4U << prescaler);
+            reload = static_cast<uint32_t>((timeout.count() * f_counter) / 1'000);
+            if (reload <= (IWDG_RLR_RL + 1))
+                break;
+        }
+
+        /* Limit the reload value to the register range */
+        prescaler = std::min<uint32_t>(prescaler, 6);
+        reload = std::clamp<uint32_t>(reload, 1, IWDG_RLR_RL + 1);
+
+        /* Start the watchdog and configure the timeout */
+        IWDG->KR = key::Start;
+        IWDG->KR = key::Unlock;
+        IWDG->PR = prescaler;
+        IWDG->RLR = reload - 1;
+
+        /* Wait until the registers are updated and reload the counter */
+        while (IWDG->SR & (IWDG_SR_PVU | IWDG_SR_RVU))
+        {
+        };
+        IWDG->KR = key::Reload;
+
+        /* Return the watchdog with the actual timeout */
+        const uint32_t f_counter = f_lsi / (4U << prescaler);
+        return Independent(std::chrono::milliseconds((reload * 1'000U) / f_counter));
+    };
+
+    /* === Constructors === */
+    Independent::Independent(const std::chrono::milliseconds timeout)
+        : timeout{timeout} {};
+
+    /* === Getters === */
+    auto Independent::get_timeout() const -> std::chrono::milliseconds
+    {
+        return this->timeout;
+    };
+
+    /* === Methods === */
+    void Independent::kick()
+    {
+        watchdog::kick();
+    };
+}; // namespace watchdog
@@ -0,0 +1,105 @@
+/**
+ * OTOS - Open Tec Operating System
+ * Copyright (c) 2021 - 2024 Sebastian Oberschwendtner, sebastian.oberschwendtner@gmail.com
+ *
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef WATCHDOG_STM32_H_
+#define WATCHDOG_STM32_H_
+
+// === Includes ===
+#include "interface.h"
+#include "vendors.h"
+#include <chrono>
+#include <cstdint>
+
+// === Declarations ===
+namespace watchdog
+{
+    /* === Constants === */
+#if defined(STM32L0)
+    constexpr uint32_t f_lsi = 37'000; /**< [Hz] Frequency of the low speed internal clock. */
+#else
+    constexpr uint32_t f_lsi = 32'000; /**< [Hz] Frequency of the low speed internal clock. */
+#endif
+
+    namespace key
+    {
+        static constexpr uint16_t Reload = 0xAAAA; /**< Reload the watchdog counter. */
+        static constexpr uint16_t Unlock = 0x5555; /**< Enable access to the PR and RLR registers. */
+        static constexpr uint16_t Start = 0xCCCC;  /**< Start the watchdog. */
+    }; // namespace key
+
+    /**
+     * @class Independent
+     * @brief Driver for the independent watchdog (IWDG).
+     * Once started the watchdog cannot be stopped anymore.
+     * It resets the device, when it is not kicked within
+     * the configured timeout.
+     */
+    class Independent
+    {
+      public:
+        /* === Builder === */
+        /**
+         * @brief Start the independent watchdog with a timeout.
+         * The timeout is rounded down to the resolution of the
+         * watchdog prescaler and limited to the maximum timeout.
+         *
+         * @param timeout The time after which the watchdog resets the device.
+         * @return The watchdog instance.
+         */
+        [[nodiscard]] static auto create(std::chrono::milliseconds timeout) -> Independent;
+
+        /* === Getters === */
+        /**
+         * @brief Get the configured timeout of the watchdog.
+         * @return The timeout in [ms].
+         */
+        [[nodiscard]] auto get_timeout() const -> std::chrono::milliseconds;
+
+        /* === Methods === */
+        /**
+         * @brief Reload the watchdog counter.
+         */
+        void kick();
+
+      private:
+        /* === Constructors === */
+        /**
+         * @brief Construct a new watchdog object.
+         * @param timeout The configured timeout of the watchdog.
+         */
+        explicit Independent(std::chrono::milliseconds timeout);
+
+        /* === Properties === */
+        std::chrono::milliseconds timeout; /**< The configured timeout of the watchdog. */
+    };
+
+    /* === Functions === */
+    /**
+     * @brief Reload the watchdog counter. Atomic access, can be used
+     * within an interrupt handler or as a function pointer for the
+     * kernel supervision.
+     */
+    OTOS_ATOMIC void kick()
+    {
+        IWDG->KR = key::Reload;
+    }
+}; // namespace watchdog
+
+#endif // WATCHDOG_STM32_H_
@@ -32,6 +32,7 @@
 
 /* Provide valid template instantiations */
 template class fat32::File<fat32::Volume<sdhc::Card>>;
+template class fat32::File<fat32::Volume<drive::Cache<sdhc::Card, 8>>>;
 
 namespace fat32
 {
@@ -39,8 +40,18 @@ namespace fat32
     template <class Volume_t>
     auto File<Volume_t>::close() -> bool
     {
-        /* Flush the block buffer to the card */
-        this->flush();
+        /* Write the block buffer to the card, the file is not accessed afterwards */
+        this->write_buffers();
+
+        /* Free the reserved clusters which were not used */
+        if (this->preallocated)
+        {
+            this->volume->trim_file(this->handle);
+            this->preallocated = false;
+        }
+
+        /* Write the data which is buffered by the memory */
+        this->volume->sync();
 
         /* Set file state to closed */
         this->state = files::State::Closed;
@@ -48,11 +59,109 @@ namespace fat32
         return true;
     };
 
+    template <class Volume_t>
+    auto File<Volume_t>::complete_read_ahead() -> bool
+    {
+        if (this->read_ahead.pending)
+        {
+            this->read_ahead.valid = this->volume->complete_read();
+            this->read_ahead.pending = false;
+        }
+        return this->read_ahead.valid;
+    };
+
+    template <class Volume_t>
+    void File<Volume_t>::complete_write_behind()
+    {
+        this->start_write_behind();
+        if (this->write_behind.pending)
+        {
+            this->volume->complete_write();
+            this->write_behind.pending = false;
+        }
+    };
+
+    template <class Volume_t>
+    void File<Volume_t>::collect_sector()
+    {
+        /* Only consecutive sectors of one cluster are written together */
+        const uint32_t cluster = this->handle.current.cluster;
+        const uint32_t sector = this->handle.current.sector - 1;
+        Write_Behind &behind = this->write_behind;
+        if ((behind.count > 0) && ((cluster != behind.cluster) || (sector != behind.first + behind.count)))
+            this->start_write_behind();
+        if (behind.count == 0)
+        {
+            behind.cluster = cluster;
+            behind.first = sector;
+        }
+
+        /* Copy the block buffer to the collecting half */
+        const auto *data = reinterpret_cast<const uint32_t *>(this->handle.block_buffer.begin());
+        std::copy(data, data + 128, behind.buffer + (behind.half * behind.sectors + behind.count) * 128);
+        behind.count++;
+        if (behind.count == behind.sectors)
+            this->start_write_behind();
+
+        /* Continue with the next sector of the file */
+        this->volume->move_to_next_sector(this->handle);
+    };
+
+    template <class Volume_t>
+    void File<Volume_t>::continue_with_next_sector()
+    {
+        /* A changed sector is written, which also moves to the next sector */
+        if (this->state == files::State::Changed)
+            return this->write_sector();
+
+        /* The sector was only read, so move to the next sector and read it when it is within the file */
+        this->volume->move_to_next_sector(this->handle);
+        if (this->access_position < this->handle.size)
+            this->read_current_sector();
+    };
+
+    template <class Volume_t>
+    void File<Volume_t>::discard_read_ahead()
+    {
+        this->complete_read_ahead();
+        this->read_ahead.valid = false;
+    };
+
     template <class Volume_t>
     void File<Volume_t>::flush()
     {
-        this->volume->write_file_to_memory(this->handle);
-        this->volume->write_filesize_to_directory(this->handle);
+        /* Files which are not changed are already written */
+        if (this->state != files::State::Changed)
+            return;
+        this->write_buffers();
+
+        /* The directory entry is updated with the block buffer, so read the sector of the position again */
+        if ((this->handle.current.byte != 0) || (this->access_position < this->size()))
+            this->read_current_sector();
+    };
+
+    template <class Volume_t>
+    auto File<Volume_t>::is_sync_interval_elapsed() const -> bool
+    {
+        if ((this->sync_policy.interval_ms == 0) || (this->sync_policy.get_time_ms == nullptr))
+            return false;
+        return (this->sync_policy.get_time_ms() - this->time_synced) >= this->sync_policy.interval_ms;
+    };
+
+    template <class Volume_t>
+    auto File<Volume_t>::preallocate(const uint32_t bytes) -> bool
+    {
+        /* Only when file is not read-only */
+        if (
+            (this->state == files::State::Read_only) or
+            (this->state == files::State::Closed))
+            return false;
+
+        /* Reserve the clusters */
+        if (not this->volume->preallocate(this->handle, bytes))
+            return false;
+        this->preallocated = true;
+        return true;
     };
 
     template <class Volume_t>
@@ -64,28 +173,62 @@ namespace fat32
             (this->state == files::State::Closed))
             return false;
 
+        /* After reading up to the end of a sector, the byte belongs to the next sector */
+        if (this->handle.current.byte == 512)
+            this->continue_with_next_sector();
+
         /* Set file state to changed */
         this->state = files::State::Changed;
 
         /* Write the byte to the current buffer position */
         this->handle.block_buffer[this->handle.current.byte] = byte;
 
-        /* Update position counter */
+        /* Update position counter, the file only grows when writing at its end */
         this->handle.current.byte++;
-        this->handle.size++;
         this->access_position++;
+        this->handle.size = std::max(this->handle.size, this->access_position);
 
-        /* When block buffer is full flush it to the card */
+        /* When block buffer is full write it to the card */
         if (this->handle.current.byte == 512)
-        {
-            this->volume->write_file_to_memory(this->handle);
-            this->volume->write_filesize_to_directory(this->handle);
-            this->handle.current.byte = 0;
-        }
+            this->write_sector();
+
+        /* Flush the file when the sync interval elapsed */
+        if (this->is_sync_interval_elapsed())
+            this->flush();
 
         return true;
     };
 
+    template <class Volume_t>
+    auto File<Volume_t>::pread(
+        const uint32_t position,
+        char *buffer,
+        const std::size_t len) -> std::size_t
+    {
+        /* Move to the position */
+        if (not this->seekg(position))
+            return 0;
+
+        /* Read the data until the end of the file */
+        return this->read(buffer, len);
+    };
+
+    template <class Volume_t>
+    auto File<Volume_t>::pwrite(
+        const uint32_t position,
+        const char *begin,
+        const std::size_t len) -> bool
+    {
+        /* Only when file is not read-only */
+        if (
+            (this->state == files::State::Read_only) or
+            (this->state == files::State::Closed))
+            return false;
+
+        /* Move to the position and write the data */
+        return this->seekp(position) && this->write(begin, len);
+    };
+
     template <class Volume_t>
     auto File<Volume_t>::read() -> uint8_t
     {
@@ -93,10 +236,11 @@ namespace fat32
         if (this->tell() == this->size())
             return 0;
 
-        /* Check whether end of sector was reached */
+        /* Check whether end of sector was reached, the changed data is written beforehand */
         if (this->handle.current.byte == 512)
         {
-            volume->read_next_sector_of_cluster(this->handle);
+            this->write_buffers();
+            this->read_next_sector();
             this->handle.current.byte = 0;
         }
 
@@ -105,12 +249,277 @@ namespace fat32
         return this->handle.block_buffer[this->handle.current.byte++];
     };
 
+    template <class Volume_t>
+    auto File<Volume_t>::read(
+        char *buffer,
+        const std::size_t len) -> std::size_t
+    {
+        /* Read the data until the end of the file */
+        std::size_t remaining = std::min<std::size_t>(len, this->size() - this->tell());
+        char *ptr = buffer;
+        while (remaining > 0)
+        {
+            /* Check whether end of sector was reached */
+            if (this->handle.current.byte == 512)
+            {
+                /* The changed data is written before the block buffer is used for the next sector */
+                this->write_buffers();
+
+                /* Whole sectors which are not read ahead are read directly to the buffer */
+                const uint32_t sector_in_file = this->access_position / 512;
+                const bool aligned = (reinterpret_cast<std::uintptr_t>(ptr) % alignof(uint32_t)) == 0;
+                const bool buffered = (this->read_ahead.pending || this->read_ahead.valid) &&
+                                      (sector_in_file - this->read_ahead.first < this->read_ahead.count);
+                if (aligned && (remaining >= 512) && not buffered)
+                {
+                    /* Get the cluster of the next sector from the chain of the file */
+                    const uint32_t sectors_per_cluster = this->volume->partition.Sectors_per_Cluster;
+                    const auto cluster = this->volume->get_cluster_of_file(this->handle, sector_in_file / sectors_per_cluster);
+                    if (not cluster)
+                        break;
+
+                    /* Read the sectors up to the end of the cluster with one transfer */
+                    const uint32_t sector = sector_in_file % sectors_per_cluster;
+                    const uint32_t count = std::min<uint32_t>(remaining / 512, sectors_per_cluster - sector);
+                    if (not this->volume->read_sectors_of_cluster(reinterpret_cast<uint32_t *>(ptr), cluster.value(), sector, count))
+                        break;
+
+                    /* The last read sector is the current sector, the block buffer is not valid.
+                     * The file is not changed, so the block buffer is not written back. */
+                    this->handle.current.cluster = cluster.value();
+                    this->handle.current.sector = static_cast<uint8_t>(sector + count);
+                    this->read_ahead.next = sector_in_file + count;
+                    ptr += count * 512;
+                    remaining -= count * 512;
+                    this->access_position += count * 512;
+                    continue;
+                }
+
+                /* Otherwise read the next sector to the block buffer */
+                if (not this->read_next_sector())
+                    break;
+                this->handle.current.byte = 0;
+            }
+
+            /* Copy the data of the current sector */
+            const std::size_t count = std::min<std::size_t>(remaining, 512 - this->handle.current.byte);
+            std::copy_n(this->handle.block_buffer.begin() + this->handle.current.byte, count, ptr);
+            this->handle.current.byte += static_cast<uint16_t>(count);
+            ptr += count;
+            remaining -= count;
+            this->access_position += count;
+        }
+        return static_cast<std::size_t>(ptr - buffer);
+    };
+
+    template <class Volume_t>
+    auto File<Volume_t>::read_next_sector() -> bool
+    {
+        /* Without read ahead the sector is read from the memory */
+        if (this->read_ahead.sectors == 0)
+            return this->volume->read_next_sector_of_cluster(this->handle);
+
+        /* The access position is at the beginning of the next sector */
+        const uint32_t sector_in_file = this->access_position / 512;
+        const bool sequential = sector_in_file == this->read_ahead.next;
+        this->read_ahead.next = sector_in_file + 1;
+
+        /* Load the sector when it is not buffered, the following sectors only for sequential reads */
+        const bool buffered = this->complete_read_ahead() && (sector_in_file - this->read_ahead.first < this->read_ahead.count);
+        if (not buffered)
+        {
+            const uint32_t count = sequential ? this->read_ahead.sectors : 1;
+            if (not this->start_read_ahead(sector_in_file, count) || not this->complete_read_ahead())
+                return false;
+        }
+
+        /* Copy the sector to the block buffer */
+        const uint32_t index = sector_in_file - this->read_ahead.first;
+        const uint32_t *sector = this->read_ahead.buffer + index * 128;
+        std::copy(sector, sector + 128, reinterpret_cast<uint32_t *>(this->handle.block_buffer.begin()));
+        this->handle.current.cluster = this->read_ahead.cluster;
+        this->handle.current.sector = static_cast<uint8_t>(sector_in_file % this->volume->partition.Sectors_per_Cluster + 1);
+
+        /* Load the next sectors while the last buffered sector is consumed */
+        if (sequential && (index + 1 == this->read_ahead.count) && ((sector_in_file + 1) * 512 < this->size()))
+            this->start_read_ahead(sector_in_file + 1, this->read_ahead.sectors);
+        return true;
+    };
+
+    template <class Volume_t>
+    auto File<Volume_t>::read_current_sector() -> bool
+    {
+        /* Convert the byte buffer to a 32-bit buffer for transfer with memory */
+        const uint32_t *buffer = reinterpret_cast<uint32_t *>(this->handle.block_buffer.begin());
+
+        /* The current sector count starts at 1 */
+        return this->volume->read_sectors_of_cluster(
+            buffer, this->handle.current.cluster, this->handle.current.sector - 1, 1);
+    };
+
+    template <class Volume_t>
+    auto File<Volume_t>::seek(
+        const int32_t offset,
+        const files::seekdir whence) -> bool
+    {
+        /* Get the origin of the offset */
+        int64_t origin = 0;
+        if (whence == files::Seek::cur)
+            origin = this->tell();
+        else if (whence == files::Seek::end)
+            origin = this->size();
+
+        /* The position has to be within the file */
+        const int64_t position = origin + offset;
+        if ((position < 0) || (position > this->size()))
+            return false;
+        return this->seekg(static_cast<uint32_t>(position));
+    };
+
+    template <class Volume_t>
+    auto File<Volume_t>::seekg(const uint32_t position) -> bool
+    {
+        /* The position has to be within the file */
+        if (position > this->size())
+            return false;
+
+        /* Write the changed data before the buffer is used for the new position */
+        this->write_buffers();
+
+        /* Get the cluster of the position from the chain of the file */
+        const uint32_t sector_in_file = position / 512;
+        const uint32_t sectors_per_cluster = this->volume->partition.Sectors_per_Cluster;
+        const auto cluster = this->volume->get_cluster_of_file(this->handle, sector_in_file / sectors_per_cluster);
+        if (not cluster)
+            return this->seek_next_cluster(position);
+
+        /* Read the sector which contains the position */
+        this->handle.current.cluster = cluster.value();
+        this->handle.current.sector = static_cast<uint8_t>(sector_in_file % sectors_per_cluster + 1);
+        this->handle.current.byte = static_cast<uint16_t>(position % 512);
+        if (not this->read_current_sector())
+            return false;
+
+        /* Update the access position */
+        this->access_position = position;
+        return true;
+    };
+
+    template <class Volume_t>
+    auto File<Volume_t>::seek_next_cluster(const uint32_t position) -> bool
+    {
+        /* Only the end of a writable file which fills its last cluster has no cluster yet */
+        const uint32_t sectors_per_cluster = this->volume->partition.Sectors_per_Cluster;
+        const uint32_t cluster_size = 512 * sectors_per_cluster;
+        if ((position == 0) || (position != this->size()) || (position % cluster_size != 0))
+            return false;
+        if (this->state == files::State::Read_only)
+            return false;
+
+        /* Continue after the last sector of the file, which allocates the next cluster */
+        const auto last_cluster = this->volume->get_cluster_of_file(this->handle, position / cluster_size - 1);
+        if (not last_cluster)
+            return false;
+        this->handle.current.cluster = last_cluster.value();
+        this->handle.current.sector = static_cast<uint8_t>(sectors_per_cluster);
+        if (not this->volume->move_to_next_sector(this->handle))
+            return false;
+
+        /* Update the access position */
+        this->access_position = position;
+        return true;
+    };
+
+    template <class Volume_t>
+    auto File<Volume_t>::seekp(const uint32_t position) -> bool
+    {
+        return this->seekg(position);
+    };
+
+    template <class Volume_t>
+    void File<Volume_t>::set_read_ahead(uint32_t *buffer, const uint32_t sectors)
+    {
+        this->discard_read_ahead();
+        this->read_ahead.buffer = buffer;
+        this->read_ahead.sectors = (buffer != nullptr) ? sectors : 0;
+    };
+
+    template <class Volume_t>
+    void File<Volume_t>::set_write_behind(uint32_t *buffer, const uint32_t sectors)
+    {
+        this->complete_write_behind();
+        this->write_behind.buffer = buffer;
+        this->write_behind.sectors = (buffer != nullptr) ? sectors / 2 : 0;
+        this->write_behind.half = 0;
+    };
+
+    template <class Volume_t>
+    void File<Volume_t>::set_sync_policy(const files::Sync_Policy &policy)
+    {
+        this->sync_policy = policy;
+        if (policy.get_time_ms != nullptr)
+            this->time_synced = policy.get_time_ms();
+    };
+
     template <class Volume_t>
     auto File<Volume_t>::size() const -> uint32_t
     {
         return this->handle.size;
     };
 
+    template <class Volume_t>
+    auto File<Volume_t>::sync() -> bool
+    {
+        /* Flush the block buffer to the card */
+        this->flush();
+
+        /* Write the data which is buffered by the memory */
+        return this->volume->sync();
+    };
+
+    template <class Volume_t>
+    auto File<Volume_t>::start_read_ahead(
+        const uint32_t sector_in_file,
+        const uint32_t count) -> bool
+    {
+        /* Get the cluster of the sector from the chain of the file */
+        const uint32_t sectors_per_cluster = this->volume->partition.Sectors_per_Cluster;
+        const auto cluster = this->volume->get_cluster_of_file(this->handle, sector_in_file / sectors_per_cluster);
+        if (not cluster)
+            return false;
+
+        /* Read up to the end of the cluster and the end of the file */
+        const uint32_t sector = sector_in_file % sectors_per_cluster;
+        const uint32_t sectors_of_file = (this->size() + 511) / 512;
+        if (sector_in_file >= sectors_of_file)
+            return false;
+        this->read_ahead.first = sector_in_file;
+        this->read_ahead.count = std::min({count, sectors_per_cluster - sector, sectors_of_file - sector_in_file});
+        this->read_ahead.cluster = cluster.value();
+        this->read_ahead.valid = false;
+        this->read_ahead.pending = this->volume->start_read_sectors_of_cluster(
+            this->read_ahead.buffer, cluster.value(), sector, this->read_ahead.count);
+        return this->read_ahead.pending;
+    };
+
+    template <class Volume_t>
+    void File<Volume_t>::start_write_behind()
+    {
+        Write_Behind &behind = this->write_behind;
+        if (behind.count == 0)
+            return;
+
+        /* Both halves are in use, so wait for the other half */
+        if (behind.pending)
+            this->volume->complete_write();
+
+        /* Write the collected half and collect with the other half */
+        behind.pending = this->volume->start_write_sectors_of_cluster(
+            behind.buffer + behind.half * behind.sectors * 128, behind.cluster, behind.first, behind.count);
+        behind.half ^= 1;
+        behind.count = 0;
+    };
+
     template <class Volume_t>
     auto File<Volume_t>::tell() const -> uint32_t
     {
@@ -128,6 +537,10 @@ namespace fat32
             (this->state == files::State::Closed))
             return false;
 
+        /* After reading up to the end of a sector, the data belongs to the next sector */
+        if (this->handle.current.byte == 512)
+            this->continue_with_next_sector();
+
         /* Set file state to changed */
         this->state = files::State::Changed;
 
@@ -138,19 +551,69 @@ namespace fat32
             /* Write the byte to the current buffer position */
             this->handle.block_buffer[this->handle.current.byte] = *ptr++;
 
-            /* Update position counter */
+            /* Update position counter, the file only grows when writing at its end */
             this->handle.current.byte++;
-            this->handle.size++;
             this->access_position++;
+            this->handle.size = std::max(this->handle.size, this->access_position);
 
-            /* When block buffer is full flush it to the card */
+            /* When block buffer is full write it to the card */
             if (this->handle.current.byte == 512)
-            {
-                this->flush();
-                this->handle.current.byte = 0;
-            }
+                this->write_sector();
         }
 
+        /* Flush the file when the sync interval elapsed */
+        if (this->is_sync_interval_elapsed())
+            this->flush();
+
         return true;
     };
+
+    template <class Volume_t>
+    void File<Volume_t>::write_sector()
+    {
+        /* The buffered sectors can be outdated afterwards */
+        this->discard_read_ahead();
+
+        /* Write the block buffer to the card or collect it for the write behind */
+        if (this->write_behind.sectors == 0)
+            this->volume->write_file_to_memory(this->handle);
+        else
+            this->collect_sector();
+        this->handle.current.byte = 0;
+
+        /* Update the directory entry according to the sync policy, the entry only covers written sectors */
+        this->unsynced_sectors++;
+        if ((this->sync_policy.sectors != 0) && (this->unsynced_sectors >= this->sync_policy.sectors))
+        {
+            this->complete_write_behind();
+            this->volume->write_filesize_to_directory(this->handle);
+            this->unsynced_sectors = 0;
+            if (this->sync_policy.get_time_ms != nullptr)
+                this->time_synced = this->sync_policy.get_time_ms();
+        }
+
+        /* Within the file the next sector has to be read before it is changed */
+        if (this->access_position < this->handle.size)
+            this->read_current_sector();
+    };
+
+    template <class Volume_t>
+    void File<Volume_t>::write_buffers()
+    {
+        /* Only changed data is written, the block buffer of a read file can be outdated */
+        if (this->state != files::State::Changed)
+            return;
+
+        /* The buffered sectors can be outdated afterwards */
+        this->discard_read_ahead();
+        this->complete_write_behind();
+        this->volume->write_current_sector(this->handle);
+        this->volume->write_filesize_to_directory(this->handle);
+        this->state = files::State::Open;
+
+        /* Restart the sync policy */
+        this->unsynced_sectors = 0;
+        if (this->sync_policy.get_time_ms != nullptr)
+            this->time_synced = this->sync_policy.get_time_ms();
+    };
 }; // namespace fat32
@@ -55,6 +55,32 @@ namespace files
         /* static constexpr openmode trunc = 0b00010000; */
         /* static constexpr openmode ate = 0b00100000; */
     }
+
+    /**
+     * @brief Policy when the size of a changed file is written to
+     * its directory entry. The entry is always updated when the
+     * file is closed, flushed or synchronized.
+     *
+     * Updating the entry costs a read and a write of the directory
+     * sector, so updating it less often increases the write rate.
+     * After a power loss only the data up to the last update is
+     * part of the file.
+     */
+    struct Sync_Policy
+    {
+        uint32_t sectors{1};                /**< Update the entry after this number of written sectors, 0 to disable. */
+        uint32_t interval_ms{0};            /**< Flush the file when writing after this time since the last update, 0 to disable. */
+        uint32_t (*get_time_ms)(){nullptr}; /**< Function to get the current time in ms, needed for the interval. */
+    };
+
+    /* Seek directions as defined in the C++ standard */
+    typedef uint8_t seekdir;
+    namespace Seek
+    {
+        static constexpr seekdir beg = 0;
+        static constexpr seekdir cur = 1;
+        static constexpr seekdir end = 2;
+    }
 }; // namespace files
 
 namespace fat32
@@ -74,6 +100,13 @@ namespace fat32
             : OTOS::iostream<File<Volume_t>>(*this), handle{file}, volume{&volume_used} {};
         File(Filehandler &file, Volume_t &volume_used, files::State file_state)
             : File{file, volume_used} { this->state = file_state; };
+        File(Filehandler &file, Volume_t &volume_used, files::State file_state, files::openmode mode)
+            : File{file, volume_used, file_state}
+        {
+            /* Appending starts at the end of the file */
+            if ((mode & files::Mode::app) && (file_state == files::State::Open) && (this->size() > 0))
+                this->seekp(this->size());
+        };
         File(File &&) = delete;
         File &operator=(File &) = delete;
         File &operator=(File &&other)
@@ -85,23 +118,45 @@ namespace fat32
             this->volume = other.volume;
             this->access_position = other.access_position;
             this->state = other.state;
+            this->sync_policy = other.sync_policy;
+            this->unsynced_sectors = other.unsynced_sectors;
+            this->time_synced = other.time_synced;
+            this->preallocated = other.preallocated;
+            this->read_ahead = other.read_ahead;
+            this->write_behind = other.write_behind;
             return *this;
         };
         ~File(){};
 
         /* === Methods === */
         /**
-         * @brief Close the file and write data.
+         * @brief Close the file and write data. Only changed
+         * files are written, files which were only read do not
+         * change the memory.
          *
          * @return Return True when the file was successfully written.
          */
         auto close() -> bool;
 
         /**
-         * @brief Flush the file and write data.
+         * @brief Flush the file and write data. The
+         * size of the file is updated in the directory
+         * and writing can continue at the same position.
+         * Files which are not changed are not written.
          */
         void flush();
 
+        /**
+         * @brief Reserve consecutive clusters for the next bytes
+         * written to the file. Writing within the reserved clusters
+         * does not change the FAT, the clusters which are not used
+         * are freed when the file is closed.
+         *
+         * @param bytes The number of bytes to reserve behind the end of the file.
+         * @return Returns True when the clusters were reserved.
+         */
+        auto preallocate(uint32_t bytes) -> bool;
+
         /**
          * @brief Put a byte to the file. After
          * each access the byte counter is increased.
@@ -111,6 +166,28 @@ namespace fat32
          */
         auto put(char byte) -> bool;
 
+        /**
+         * @brief Read data at a position of the file. The
+         * access position is moved behind the read data.
+         *
+         * @param position The position in the file in bytes.
+         * @param buffer The buffer for the data.
+         * @param len The number of bytes to read.
+         * @return The number of bytes which were read, less than len when the end of file is reached.
+         */
+        auto pread(uint32_t position, char *buffer, std::size_t len) -> std::size_t;
+
+        /**
+         * @brief Write data at a position of the file. The
+         * access position is moved behind the written data.
+         *
+         * @param position The position in the file in bytes.
+         * @param begin The begin iterator of the data to write.
+         * @param len The number of bytes to write.
+         * @return Return True when the data was successfully written.
+         */
+        auto pwrite(uint32_t position, const char *begin, std::size_t len) -> bool;
+
         /**
          * @brief Read data from the file. After
          * each access the byte counter is increased.
@@ -121,9 +198,92 @@ namespace fat32
          * @return The data byte at the current access position.
          */
         auto read() -> uint8_t;
+
+        /**
+         * @brief Read data from the file to a buffer. The data
+         * before and after whole sectors is copied from the block
+         * buffer. Whole sectors are read directly to the buffer,
+         * consecutive sectors of a cluster with one memory transfer.
+         *
+         * The buffer should be aligned to 4 bytes, otherwise all
+         * sectors are read using the block buffer. Changed data is
+         * written before the next sector is read.
+         *
+         * @param buffer The buffer for the data.
+         * @param len The number of bytes to read.
+         * @return The number of bytes which were read, less than len when the end of file is reached.
+         */
+        auto read(char *buffer, std::size_t len) -> std::size_t;
         /* read_line(); */
         /* save(); */
-        /* seek(); */
+
+        /**
+         * @brief Move the access position relative to the beginning,
+         * the current position or the end of the file.
+         *
+         * @param offset The offset in bytes, can be negative.
+         * @param whence The origin of the offset, one of files::Seek.
+         * @return Returns True when the position is within the file and the data was read.
+         */
+        auto seek(int32_t offset, files::seekdir whence) -> bool;
+
+        /**
+         * @brief Set the access position for reading. The cluster
+         * of the position is found with the known cluster chain
+         * of the file, changed data is written beforehand.
+         *
+         * The file has one access position for reading and writing.
+         *
+         * When a writable file ends at the end of its last cluster,
+         * seeking to the end of the file allocates the next cluster.
+         *
+         * @param position The new position in bytes, has to be within the file or at its end.
+         * @return Returns True when the sector of the position was read.
+         */
+        auto seekg(uint32_t position) -> bool;
+
+        /**
+         * @brief Set the access position for writing.
+         * The file has one access position for reading and writing.
+         *
+         * @param position The new position in bytes, has to be within the file or at its end.
+         * @return Returns True when the sector of the position was read.
+         */
+        auto seekp(uint32_t position) -> bool;
+
+        /**
+         * @brief Read the following sectors of the file ahead to a second
+         * buffer when the file is read sequentially. The block buffer holds
+         * the sector which is consumed while the next sectors are loaded with
+         * one transfer. Memories with a DMA path load them in the background,
+         * so reading does not wait for the memory at the sector boundaries.
+         *
+         * @param buffer The buffer for the sectors, nullptr disables the read ahead.
+         * @param sectors The number of sectors the buffer holds.
+         */
+        void set_read_ahead(uint32_t *buffer, uint32_t sectors);
+
+        /**
+         * @brief Set when the size of the file is written to its
+         * directory entry while writing.
+         *
+         * @param policy The new sync policy of the file.
+         */
+        void set_sync_policy(const files::Sync_Policy &policy);
+
+        /**
+         * @brief Write full sectors behind the producer. The buffer is split
+         * in two halves: one half collects the full sectors of the block
+         * buffer while the other half is written with one transfer. Memories
+         * with a DMA path write in the background, so writing only waits
+         * when both halves are in use. Flushing the file writes all sectors.
+         * Updating the directory entry also writes all sectors, so the sync
+         * policy should span at least half of the buffer.
+         *
+         * @param buffer The buffer for the sectors, nullptr disables the write behind.
+         * @param sectors The number of sectors the buffer holds, at least 2.
+         */
+        void set_write_behind(uint32_t *buffer, uint32_t sectors);
 
         /**
          * @brief Return the current size of the file
@@ -133,6 +293,15 @@ namespace fat32
          */
         auto size() const -> uint32_t;
 
+        /**
+         * @brief Flush the file and write the data which is
+         * buffered by the volume to the memory. The file
+         * stays open.
+         *
+         * @return Returns True when the buffered data was written.
+         */
+        auto sync() -> bool;
+
         /**
          * @brief Get the internal access position pointer
          * for read and write access of the file.
@@ -157,10 +326,140 @@ namespace fat32
         State state{State::Closed}; /**< State of the file. */
 
       private:
+        /* === Types === */
+        struct Read_Ahead
+        {
+            uint32_t *buffer{nullptr}; /**< The buffer for the sectors which are read ahead. */
+            uint32_t sectors{0};       /**< The number of sectors of the buffer, 0 when the read ahead is disabled. */
+            uint32_t first{0};         /**< The index of the first buffered sector within the file. */
+            uint32_t count{0};         /**< The number of buffered sectors. */
+            uint32_t cluster{0};       /**< The cluster of the buffered sectors. */
+            uint32_t next{1};          /**< The index of the sector which follows the last consumed sector. */
+            bool pending{false};       /**< The transfer to the buffer is not completed yet. */
+            bool valid{false};         /**< The buffer contains the sectors. */
+        };
+
+        struct Write_Behind
+        {
+            uint32_t *buffer{nullptr}; /**< The buffer for the sectors which are written behind. */
+            uint32_t sectors{0};       /**< The number of sectors of one half, 0 when the write behind is disabled. */
+            uint32_t half{0};          /**< The half which collects the sectors. */
+            uint32_t cluster{0};       /**< The cluster of the collected sectors. */
+            uint32_t first{0};         /**< The first collected sector within the cluster, starting at 0. */
+            uint32_t count{0};         /**< The number of collected sectors. */
+            bool pending{false};       /**< The transfer of the other half is not completed yet. */
+        };
+
+        /* === Methods === */
+        /**
+         * @brief Wait for the sectors which are read ahead.
+         *
+         * @return Returns True when the buffer contains valid sectors.
+         */
+        auto complete_read_ahead() -> bool;
+
+        /**
+         * @brief Write the collected sectors and wait until
+         * all sectors which are written behind are written.
+         */
+        void complete_write_behind();
+
+        /**
+         * @brief Collect the full block buffer for the write
+         * behind and move the file to its next sector.
+         */
+        void collect_sector();
+
+        /**
+         * @brief Continue with the next sector when the current
+         * sector was read up to its end. A changed sector is
+         * written, otherwise the next sector is read when it
+         * is within the file.
+         */
+        void continue_with_next_sector();
+
+        /**
+         * @brief Wait for the sectors which are read ahead and
+         * discard them, e.g. because the file is changed.
+         */
+        void discard_read_ahead();
+
+        /**
+         * @brief Read the next sector of the file to the block buffer.
+         * With read ahead the sector is copied from the second buffer
+         * and the following sectors are loaded when the buffer is consumed.
+         *
+         * @return Returns True when the sector was read.
+         */
+        auto read_next_sector() -> bool;
+
+        /**
+         * @brief Start reading sectors ahead, up to the end of
+         * their cluster and the end of the file.
+         *
+         * @param sector_in_file The index of the first sector within the file.
+         * @param count The number of sectors to read.
+         * @return Returns True when the read was started.
+         */
+        auto start_read_ahead(uint32_t sector_in_file, uint32_t count) -> bool;
+
+        /**
+         * @brief Start writing the collected sectors. Waits for
+         * the transfer of the other half beforehand.
+         */
+        void start_write_behind();
+
+        /**
+         * @brief Read the sector at the current position of the
+         * filehandler to the block buffer.
+         *
+         * @return Returns True when the sector was read.
+         */
+        auto read_current_sector() -> bool;
+
+        /**
+         * @brief Move to the end of a file which fills its last
+         * cluster. The next cluster is allocated for the data
+         * which is written at the end.
+         *
+         * @param position The end of the file in bytes.
+         * @return Returns True when the file points to the next cluster.
+         */
+        auto seek_next_cluster(uint32_t position) -> bool;
+
+        /**
+         * @brief Check whether the sync interval elapsed since
+         * the directory entry was updated the last time.
+         *
+         * @return Returns True when the file should be flushed.
+         */
+        auto is_sync_interval_elapsed() const -> bool;
+
+        /**
+         * @brief Write the full block buffer to the memory and
+         * update the directory entry according to the sync policy.
+         */
+        void write_sector();
+
+        /**
+         * @brief Write the block buffer and the sectors which are
+         * written behind to the memory and update the directory entry,
+         * only when the file is changed. The file is open afterwards.
+         * The directory entry is updated with the block buffer, so it
+         * does not contain the sector of the position afterwards.
+         */
+        void write_buffers();
+
         /* === Properties === */
-        fat32::Filehandler handle;   /**< Handle to current file. */
-        Volume_t *volume;            /**< Pointer to the volume used. */
-        uint32_t access_position{0}; /**< Current access position in the file. */
+        fat32::Filehandler handle;        /**< Handle to current file. */
+        Volume_t *volume;                 /**< Pointer to the volume used. */
+        uint32_t access_position{0};      /**< Current access position in the file. */
+        files::Sync_Policy sync_policy{}; /**< When the directory entry is updated. */
+        uint32_t unsynced_sectors{0};     /**< Written sectors since the last update of the directory entry. */
+        uint32_t time_synced{0};          /**< [ms] The time of the last update of the directory entry. */
+        bool preallocated{false};         /**< The file has reserved clusters which are freed when it is closed. */
+        Read_Ahead read_ahead{};          /**< The sectors which are read ahead. */
+        Write_Behind write_behind{};      /**< The sectors which are written behind. */
     };
 
     /* === Functions to interact with files === */
@@ -177,7 +476,8 @@ namespace fat32
      * @tparam Volume_t The volume type to use.
      * @param volume_used The mounted instance of the volume.
      * @param path_to_file The path to the file.
-     * @param mode The mode to open the file in. The modes have the behavior as defined in the C++ standard.
+     * @param mode The mode to open the file in. The modes have the behavior as defined in the C++ standard,
+     * files opened with files::Mode::app are written at their end.
      * @return File<Volume_t> Returns a file object indicating whether the file was found or not.
      */
     template <class Volume_t>
@@ -256,7 +556,7 @@ namespace fat32
             }
         }
         /* Create the file and return it */
-        return File<Volume_t>{ref, volume_used, file_state};
+        return File<Volume_t>{ref, volume_used, file_state, mode};
     };
 }; // namespace fat32
 
@@ -45,6 +45,17 @@ namespace fat32
         return this->FAT_Begin + (FAT_offset / 512) + (this->FAT_Size * (FAT - 1));
     };
 
+    auto Partition::get_max_cluster() const -> uint32_t
+    {
+        /* The number of entries of the FAT limits the clusters */
+        const uint32_t entries = this->is_fat16 ? this->FAT_Size * (512 / 2) : this->FAT_Size * (512 / 4);
+
+        /* Cluster numbering begins at 2 */
+        if (this->Cluster_Count != 0)
+            return std::min(this->Cluster_Count + 1, entries - 1);
+        return entries - 1;
+    };
+
     auto Partition::get_LBA_of_cluster(const uint32_t cluster) const -> uint32_t
     {
         if (cluster >= 2)
@@ -121,6 +132,138 @@ namespace fat32
         this->size = read_long(this->block_buffer.begin(), pos_offset + DIR_Entry::Filesize);
     };
 
+    auto Directory_Entry::is_directory() const -> bool
+    {
+        return this->attributes & Attribute::is_Directory;
+    };
+
+    void Directory_Entry::read_from_buffer(const uint8_t *block, const uint32_t entry_id)
+    {
+        /* The id is consecutive over all sectors of the directory, one sector contains 16 entries */
+        const uint16_t pos_offset = static_cast<uint16_t>(entry_id % (512 / 32)) * 32;
+        this->id = entry_id;
+
+        /* Read the name */
+        std::copy(block + pos_offset, block + pos_offset + 11, this->name.begin());
+        this->name[11] = 0;
+
+        /* Read the properties */
+        this->attributes = read_byte(block, pos_offset + DIR_Entry::Attributes);
+        this->start_cluster = static_cast<uint32_t>(read_short(block, pos_offset + DIR_Entry::First_Cluster_L));
+        this->start_cluster |= (static_cast<uint32_t>(read_short(block, pos_offset + DIR_Entry::First_Cluster_H)) << 16);
+        this->size = read_long(block, pos_offset + DIR_Entry::Filesize);
+    };
+
+    void Chain::reset(const uint32_t start_cluster)
+    {
+        this->extents[0] = {start_cluster, 1};
+        this->count = 1;
+        this->complete = false;
+    };
+
+    void Chain::clear()
+    {
+        this->count = 0;
+        this->complete = false;
+    };
+
+    auto Chain::append(const uint32_t cluster) -> bool
+    {
+        /* Extend the last extent when the cluster follows it */
+        Extent &last = this->extents[this->count - 1];
+        if (cluster == last.cluster + last.length)
+        {
+            last.length++;
+            return true;
+        }
+
+        /* Otherwise a new extent is needed */
+        if (this->count == this->extents.size())
+            return false;
+        this->extents[this->count++] = {cluster, 1};
+        return true;
+    };
+
+    auto Chain::contains(const uint32_t cluster) const -> bool
+    {
+        return std::any_of(
+            this->extents.begin(),
+            this->extents.begin() + this->count,
+            [cluster](const Extent &extent)
+            { return (cluster >= extent.cluster) && (cluster - extent.cluster < extent.length); });
+    };
+
+    auto Chain::get_cluster(uint32_t index) const -> std::optional<uint32_t>
+    {
+        /* Skip the extents before the index */
+        for (uint8_t extent = 0; extent < this->count; extent++)
+        {
+            if (index < this->extents[extent].length)
+                return this->extents[extent].cluster + index;
+            index -= this->extents[extent].length;
+        }
+        return {};
+    };
+
+    auto Chain::get_last_cluster() const -> uint32_t
+    {
+        const Extent &last = this->extents[this->count - 1];
+        return last.cluster + last.length - 1;
+    };
+
+    auto Chain::get_length() const -> uint32_t
+    {
+        uint32_t length = 0;
+        for (uint8_t extent = 0; extent < this->count; extent++)
+            length += this->extents[extent].length;
+        return length;
+    };
+
+    auto Chain::get_next_cluster(const uint32_t cluster) const -> std::optional<uint32_t>
+    {
+        for (uint8_t extent = 0; extent < this->count; extent++)
+        {
+            const Extent &run = this->extents[extent];
+            if ((cluster < run.cluster) || (cluster - run.cluster >= run.length))
+                continue;
+
+            /* Within the run the next cluster follows directly */
+            if (cluster - run.cluster + 1 < run.length)
+                return cluster + 1;
+
+            /* At the end of the run the next extent continues the chain */
+            if (extent + 1 < this->count)
+                return this->extents[extent + 1].cluster;
+            return {};
+        }
+        return {};
+    };
+
+    auto Chain::is_used() const -> bool
+    {
+        return this->count > 0;
+    };
+
+    auto Lookup::get_key(const std::array<char, 12> &name, const uint32_t directory) -> uint32_t
+    {
+        /* FNV-1a hash of the 8.3 name and the cluster */
+        uint32_t hash = 2166136261U;
+        for (auto character = name.begin(); character != name.begin() + 11; character++)
+            hash = (hash ^ static_cast<uint8_t>(*character)) * 16777619U;
+        for (uint8_t shift = 0; shift < 32; shift += 8)
+            hash = (hash ^ ((directory >> shift) & 0xFF)) * 16777619U;
+        return hash;
+    };
+
+    auto Lookup::matches(
+        const uint32_t key,
+        const std::array<char, 12> &name,
+        const uint32_t directory) const -> bool
+    {
+        return (this->last_used != 0) && (this->key == key) && (this->directory == directory) &&
+               std::equal(name.begin(), name.begin() + 11, this->entry.name.begin());
+    };
+
     /* === Functions === */
     auto boot_is_EFI(const uint8_t *block) -> bool
     {
@@ -206,6 +349,32 @@ namespace fat32
         return read_long(block, TABLE_LBA_BEGIN);
     };
 
+    auto FSInfo::is_valid(const uint8_t *block) -> bool
+    {
+        return (read_long(block, LEAD_SIGNATURE) == 0x41615252) &&
+               (read_long(block, STRUCT_SIGNATURE) == 0x61417272) &&
+               (read_long(block, TRAIL_SIGNATURE) == 0xAA550000);
+    };
+
+    auto FSInfo::get_free_count(const uint8_t *block) -> uint32_t
+    {
+        return read_long(block, FREE_COUNT);
+    };
+
+    auto FSInfo::get_next_free(const uint8_t *block) -> uint32_t
+    {
+        return read_long(block, NEXT_FREE);
+    };
+
+    void FSInfo::set_free_clusters(
+        uint8_t *const block,
+        const uint32_t free_count,
+        const uint32_t next_free)
+    {
+        write_long(block, FREE_COUNT, free_count);
+        write_long(block, NEXT_FREE, next_free);
+    };
+
     auto BPB::initialize_partition(
         const uint8_t *block,
         const uint32_t partition_begin) -> Partition
@@ -236,9 +405,14 @@ namespace fat32
             block + label_position + 11,
             label.begin());
 
+        /* Only FAT32 volumes have a FSInfo sector, 0 and 0xFFFF indicate that it is missing */
+        const uint16_t fs_info = is_fat16 ? 0 : get_FS_info_sector(block);
+        const uint32_t fs_info_sector = ((fs_info == 0) || (fs_info == 0xFFFF)) ? 0 : partition_begin + fs_info;
+
         /* Construct the volume with the derived values */
         return Partition{
-            lba_begin, FAT_size, first_data_sector, root_dir_cluster, sector_per_cluster, is_fat16, label};
+            lba_begin, FAT_size, first_data_sector, root_dir_cluster, sector_per_cluster, is_fat16, label,
+            fs_info_sector, cluster_count};
     };
 
     auto BPB::get_bytes_per_sector(const uint8_t *block) -> uint16_t
@@ -267,6 +441,11 @@ namespace fat32
         return read_byte(block, RESERVED_SEC);
     };
 
+    auto BPB::get_FS_info_sector(const uint8_t *block) -> uint16_t
+    {
+        return read_short(block, FS_INFO_SECTOR);
+    };
+
     auto BPB::get_root_directory_cluster(const uint8_t *block) -> uint32_t
     {
         return read_long(block, ROOT_DIR_CLUSTER);
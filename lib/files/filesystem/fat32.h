@@ -28,8 +28,21 @@
 /* === Includes === */
 #include <algorithm>
 #include <array>
+#include <optional>
 #include <misc/types.h>
 
+/* === Defines === */
+/** The number of contiguous runs of clusters which are
+ * remembered for the cluster chain of one file.
+ */
+#ifndef OTOS_FAT_EXTENTS
+#ifdef OTOS_REDUCE_MEMORY_USAGE
+#define OTOS_FAT_EXTENTS 4
+#else
+#define OTOS_FAT_EXTENTS 8
+#endif // OTOS_REDUCE_MEMORY_USAGE
+#endif // OTOS_FAT_EXTENTS
+
 namespace fat32
 {
     /* === Enums for byte positions */
@@ -60,10 +73,21 @@ namespace fat32
         TOT_SECTORS_32 = 0x20,     // long
         FAT_SIZE_32 = 0x24,        // long
         ROOT_DIR_CLUSTER = 0x2C,   // long
+        FS_INFO_SECTOR = 0x30,     // short
         FAT16_VOLUME_LABEL = 0x2B, /* 11 bytes */
         FAT32_VOLUME_LABEL = 0x47  /* 11 bytes */
     };
 
+    /* FSInfo positions */
+    enum FSInfo_Pos : uint16_t
+    {
+        LEAD_SIGNATURE = 0x000,   // long
+        STRUCT_SIGNATURE = 0x1E4, // long
+        FREE_COUNT = 0x1E8,       // long
+        NEXT_FREE = 0x1EC,        // long
+        TRAIL_SIGNATURE = 0x1FC   // long
+    };
+
     /* Directory/File Property positions */
     enum DIR_Entry : uint16_t
     {
@@ -87,6 +111,7 @@ namespace fat32
         Volume_ID = 0x08,
         is_Directory = 0x10,
         Archive = 0x20,
+        Long_Name = 0x0F,
     };
 
     // Date and time Bit positions
@@ -132,6 +157,15 @@ namespace fat32
          */
         auto get_FAT_sector(const uint32_t cluster, const uint8_t FAT = 1) const -> uint32_t;
 
+        /**
+         * @brief Get the number of the last cluster which can be allocated.
+         * The cluster count of the partition is limited by the number
+         * of entries which fit into the FAT.
+         *
+         * @return The number of the last valid cluster.
+         */
+        auto get_max_cluster() const -> uint32_t;
+
         /**
          * @brief Compute the LBA begin address of a specific cluster
          * Cluster numbering begins at 2!
@@ -173,6 +207,8 @@ namespace fat32
         uint32_t Sectors_per_Cluster{0};    /**< The number of sectors per cluster. */
         bool is_fat16{false};               /**< True when the FAT is a FAT16. */
         std::array<char, 12> name{0};       /**< The name of the volume. */
+        uint32_t FS_Info_Sector{0};         /**< The block of the FSInfo sector, 0 when the volume has none. */
+        uint32_t Cluster_Count{0};          /**< The number of clusters in the data area. */
     };
 
     struct Filehandler
@@ -194,6 +230,7 @@ namespace fat32
         std::array<char, 12> name{0};             /**< The name of the file. */
         std::array<uint8_t, 512> block_buffer{0}; /**< The buffer for the file data. */
         Counter current{};                        /**< For keeping track of the current write/read position. */
+        uint32_t entry{0};                        /**< The next entry when iterating over a directory. */
 
         /* === Methods === */
         /**
@@ -220,6 +257,163 @@ namespace fat32
         void update_properties_from_buffer();
     };
 
+    /**
+     * @brief The properties of one entry of a directory,
+     * without the buffer which is needed to access a file.
+     */
+    struct Directory_Entry
+    {
+        /* === Properties === */
+        uint32_t id{0};               /**< The id of the entry in the directory. */
+        std::array<char, 12> name{0}; /**< The name of the entry. */
+        uint8_t attributes{0};        /**< The attributes of the entry. */
+        uint32_t size{0};             /**< [bytes] The size of the file. */
+        uint32_t start_cluster{0};    /**< The cluster of the first data block. */
+
+        /* === Methods === */
+        /**
+         * @brief Check whether the entry is a directory.
+         *
+         * @return Returns True when the entry represents a directory.
+         */
+        auto is_directory() const -> bool;
+
+        /**
+         * @brief Read the properties of an entry from
+         * the sector of the directory which contains it.
+         *
+         * @param block The sector of the directory.
+         * @param entry_id The id of the entry in the directory.
+         */
+        void read_from_buffer(const uint8_t *block, uint32_t entry_id);
+    };
+
+    /**
+     * @brief The known part of the cluster chain of a file.
+     * The chain is compressed into extents, which are runs of
+     * consecutive clusters. The extents describe the chain from
+     * its start cluster up to the last cluster which was discovered
+     * in the FAT, so most files are described by one extent.
+     */
+    struct Chain
+    {
+        /* === Struct for one run of clusters === */
+        struct Extent
+        {
+            uint32_t cluster{0}; /**< The first cluster of the run. */
+            uint32_t length{0};  /**< The number of consecutive clusters. */
+        };
+
+        /* === Methods === */
+        /**
+         * @brief Start a new chain which only knows its start cluster.
+         *
+         * @param start_cluster The first cluster of the file.
+         */
+        void reset(uint32_t start_cluster);
+
+        /**
+         * @brief Forget the chain, so that the slot can be reused.
+         */
+        void clear();
+
+        /**
+         * @brief Append the successor of the last known cluster.
+         * When the cluster does not continue the last extent and
+         * all extents are used, the chain is not extended.
+         *
+         * @param cluster The next cluster of the chain.
+         * @return Returns True when the cluster was appended.
+         */
+        auto append(uint32_t cluster) -> bool;
+
+        /**
+         * @brief Check whether a cluster is part of the known chain.
+         *
+         * @param cluster The cluster number to check.
+         * @return Returns True when the cluster is in one of the extents.
+         */
+        auto contains(uint32_t cluster) const -> bool;
+
+        /**
+         * @brief Get the cluster at a position within the chain.
+         *
+         * @param index The position of the cluster in the file, starting at 0.
+         * @return The cluster number, nothing when the position is not known.
+         */
+        auto get_cluster(uint32_t index) const -> std::optional<uint32_t>;
+
+        /**
+         * @brief Get the last cluster which is known.
+         *
+         * @return The number of the last known cluster.
+         */
+        auto get_last_cluster() const -> uint32_t;
+
+        /**
+         * @brief Get the number of clusters which are known.
+         *
+         * @return The number of clusters described by the extents.
+         */
+        auto get_length() const -> uint32_t;
+
+        /**
+         * @brief Get the successor of a cluster within the known chain.
+         *
+         * @param cluster The current cluster.
+         * @return The next cluster, nothing when the successor is not known.
+         */
+        auto get_next_cluster(uint32_t cluster) const -> std::optional<uint32_t>;
+
+        /**
+         * @brief Check whether the chain describes a file.
+         *
+         * @return Returns True when the chain is used.
+         */
+        auto is_used() const -> bool;
+
+        /* === Properties === */
+        std::array<Extent, OTOS_FAT_EXTENTS> extents{}; /**< The runs of the chain in file order. */
+        uint8_t count{0};                               /**< The number of used extents. */
+        bool complete{false};                           /**< The last known cluster is the end of the file. */
+        uint32_t last_used{0};                          /**< The time of the last access, used to replace chains. */
+    };
+
+    /**
+     * @brief A remembered directory entry of a file name, so
+     * opening the file again does not have to search the directory.
+     * The entry is found with a hash of the name and the directory.
+     */
+    struct Lookup
+    {
+        /* === Methods === */
+        /**
+         * @brief Get the hash of a file name within a directory.
+         *
+         * @param name The name of the file.
+         * @param directory The start cluster of the directory.
+         * @return The hash of the name and the directory.
+         */
+        static auto get_key(const std::array<char, 12> &name, uint32_t directory) -> uint32_t;
+
+        /**
+         * @brief Check whether the lookup is for a file name within a directory.
+         *
+         * @param key The hash of the name and the directory.
+         * @param name The name of the file.
+         * @param directory The start cluster of the directory.
+         * @return Returns True when the lookup contains the entry of the file.
+         */
+        auto matches(uint32_t key, const std::array<char, 12> &name, uint32_t directory) const -> bool;
+
+        /* === Properties === */
+        uint32_t key{0};         /**< The hash of the name and the directory. */
+        uint32_t directory{0};   /**< The start cluster of the directory. */
+        uint32_t cluster{0};     /**< The cluster of the directory which contains the entry. */
+        Directory_Entry entry{}; /**< The remembered directory entry. */
+        uint32_t last_used{0};   /**< The time of the last access, 0 when the lookup is not used. */
+    };
+
     /* === Functions === */
     /**
      * @brief Check whether the boot sector contains
@@ -334,6 +528,46 @@ namespace fat32
          */
         auto get_table_begin(const uint8_t *block) -> uint32_t;
     }; // namespace EFI
+    namespace FSInfo
+    {
+        /* The value of the free count when the count is not known */
+        constexpr uint32_t UNKNOWN = 0xFFFFFFFF;
+
+        /**
+         * @brief Check whether the block contains a valid
+         * FSInfo sector with all three signatures.
+         *
+         * @param block The pointer to the block data buffer.
+         * @return Returns True when the FSInfo sector is valid.
+         */
+        auto is_valid(const uint8_t *block) -> bool;
+
+        /**
+         * @brief Read the last known number of free clusters.
+         *
+         * @param block The pointer to the block data buffer.
+         * @return The number of free clusters, UNKNOWN when it has to be computed.
+         */
+        auto get_free_count(const uint8_t *block) -> uint32_t;
+
+        /**
+         * @brief Read the cluster where the search for free clusters should start.
+         *
+         * @param block The pointer to the block data buffer.
+         * @return The hint for the next free cluster, UNKNOWN when there is no hint.
+         */
+        auto get_next_free(const uint8_t *block) -> uint32_t;
+
+        /**
+         * @brief Write the free count and the next free hint
+         * to the FSInfo sector in the block data buffer.
+         *
+         * @param block The pointer to the block data buffer.
+         * @param free_count The number of free clusters.
+         * @param next_free The hint for the next free cluster.
+         */
+        void set_free_clusters(uint8_t *const block, const uint32_t free_count, const uint32_t next_free);
+    }; // namespace FSInfo
     namespace BPB
     {
         /**
@@ -383,6 +617,15 @@ namespace fat32
          */
         auto get_reserved_sectors(const uint8_t *block) -> uint8_t;
 
+        /**
+         * @brief Get the sector of the FSInfo structure
+         * relative to the begin of the partition.
+         *
+         * @param block The pointer to the block data buffer.
+         * @return The sector of the FSInfo, 0 when the volume has none.
+         */
+        auto get_FS_info_sector(const uint8_t *block) -> uint16_t;
+
         /**
          * @brief Get the root directory cluster from the BPB.
          * 
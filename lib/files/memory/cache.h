@@ -0,0 +1,344 @@
+/**
+ * OTOS - Open Tec Operating System
+ * Copyright (c) 2022 - 2024 Sebastian Oberschwendtner, sebastian.oberschwendtner@gmail.com
+ *
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef CACHE_H_
+#define CACHE_H_
+
+/* === Includes === */
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include "drive.h"
+
+namespace drive
+{
+    /**
+     * @brief Write-back cache for the blocks of a memory.
+     * The cache is a layer around the memory used by a volume
+     * and provides the same interface as the memory:
+     *
+     * drive::Cache<sdhc::Card, 8> cache{card};
+     * fat32::Volume<drive::Cache<sdhc::Card, 8>> volume{cache};
+     *
+     * The cache cannot be copied, a copy would hold its own dirty
+     * blocks. The volume uses the cache by reference, so the cache
+     * can be accessed directly or with volume.memory.
+     *
+     * Written blocks are kept in the cache until they are replaced
+     * or the cache is synchronized. The least recently used block
+     * is replaced when the cache is full.
+     *
+     * Transfers of multiple blocks bypass the cache, but the
+     * cached copies of the blocks are kept coherent.
+     *
+     * @tparam Memory The memory which is cached.
+     * @tparam N The number of blocks in the cache.
+     */
+    template <class Memory, std::size_t N>
+    class Cache
+    {
+      public:
+        /* === Parameters === */
+        static constexpr std::size_t block_words = 128; /**< One block has 512 bytes. */
+        static_assert(N > 0, "OTOS: The cache needs at least one block!");
+
+        /* === Constructors === */
+        Cache() = delete;
+        Cache(const Cache &) = delete;
+        Cache(Cache &&) = delete;
+        auto operator=(const Cache &) -> Cache & = delete;
+        auto operator=(Cache &&) -> Cache & = delete;
+
+        /**
+         * @brief Construct a new Cache object.
+         *
+         * @param memory_used The memory which is cached.
+         */
+        explicit Cache(Memory &memory_used)
+            : memory{&memory_used} {};
+
+        /* === Getters === */
+        /**
+         * @brief Get the number of block accesses which were served by the cache.
+         * @return The number of cache hits.
+         */
+        auto get_hits() const -> uint32_t { return this->hits; };
+
+        /**
+         * @brief Get the number of block accesses which were not in the cache.
+         * @return The number of cache misses.
+         */
+        auto get_misses() const -> uint32_t { return this->misses; };
+
+        /**
+         * @brief Get the number of dirty blocks which were written to the memory.
+         * @return The number of write backs.
+         */
+        auto get_write_backs() const -> uint32_t { return this->write_backs; };
+
+        /**
+         * @brief Get the number of cached blocks which are not yet written to the memory.
+         * @return The number of dirty blocks.
+         */
+        auto get_dirty() const -> std::size_t
+        {
+            return std::count_if(
+                this->entries.begin(), this->entries.end(),
+                [](const Entry &entry) { return entry.valid && entry.dirty; });
+        };
+
+        /**
+         * @brief Get the memory which is cached.
+         * @return Reference to the memory.
+         */
+        auto get_memory() -> Memory & { return *this->memory; };
+
+        /* === Methods === */
+        /**
+         * @brief Read a block through the cache.
+         *
+         * @param buffer The buffer for the block, it has to hold 512 bytes.
+         * @param block The address of the block.
+         * @return Returns True when the block was read.
+         */
+        auto read_single_block(const uint32_t *buffer, const uint32_t block) -> bool
+        {
+            /* Get the entry of the block */
+            auto index = this->find(block);
+            if (index)
+                this->hits++;
+            else
+            {
+                /* Load the block from memory */
+                this->misses++;
+                index = this->replace();
+                if (not index)
+                    return false;
+                if (not drive::read_single_block(*this->memory, this->data[index.value()].data(), block))
+                    return false;
+                this->entries[index.value()] = Entry{block, 0, true, false};
+            }
+
+            /* Copy the block to the buffer */
+            this->touch(index.value());
+            std::copy(this->data[index.value()].begin(), this->data[index.value()].end(), const_cast<uint32_t *>(buffer));
+            return true;
+        };
+
+        /**
+         * @brief Write a block to the cache.
+         * The block is written to the memory when it is replaced
+         * or the cache is synchronized.
+         *
+         * @param buffer The data of the block, it has to hold 512 bytes.
+         * @param block The address of the block.
+         * @return Returns True when the block was written to the cache.
+         */
+        auto write_single_block(const uint32_t *buffer, const uint32_t block) -> bool
+        {
+            /* Get the entry of the block, the block is overwritten completely */
+            auto index = this->find(block);
+            if (index)
+                this->hits++;
+            else
+            {
+                this->misses++;
+                index = this->replace();
+                if (not index)
+                    return false;
+            }
+
+            /* Copy the data to the cache */
+            std::copy(buffer, buffer + block_words, this->data[index.value()].begin());
+            this->entries[index.value()] = Entry{block, 0, true, true};
+            this->touch(index.value());
+            return true;
+        };
+
+        /**
+         * @brief Read multiple consecutive blocks from the memory.
+         * Cached blocks replace the data read from the memory.
+         *
+         * @param buffer The buffer for the blocks, it has to hold count * 512 bytes.
+         * @param block The address of the first block.
+         * @param count The number of blocks.
+         * @return Returns True when the blocks were read.
+         */
+        auto read_multiple_blocks(const uint32_t *buffer, const uint32_t block, const uint32_t count) -> bool
+        {
+            if (not drive::read_multiple_blocks(*this->memory, buffer, block, count))
+                return false;
+
+            /* The cache contains the newest data of the blocks */
+            for (std::size_t index = 0; index < N; index++)
+            {
+                const Entry &entry = this->entries[index];
+                if (entry.valid && (entry.block - block < count))
+                    std::copy(
+                        this->data[index].begin(), this->data[index].end(),
+                        const_cast<uint32_t *>(buffer) + (entry.block - block) * block_words);
+            }
+            return true;
+        };
+
+        /**
+         * @brief Write multiple consecutive blocks to the memory.
+         * Cached copies of the blocks are updated and are clean afterwards.
+         *
+         * @param buffer The data of the blocks, it has to hold count * 512 bytes.
+         * @param block The address of the first block.
+         * @param count The number of blocks.
+         * @return Returns True when the blocks were written.
+         */
+        auto write_multiple_blocks(const uint32_t *buffer, const uint32_t block, const uint32_t count) -> bool
+        {
+            if (not drive::write_multiple_blocks(*this->memory, buffer, block, count))
+                return false;
+
+            /* Keep the cached copies coherent */
+            for (std::size_t index = 0; index < N; index++)
+            {
+                Entry &entry = this->entries[index];
+                if (entry.valid && (entry.block - block < count))
+                {
+                    const uint32_t *begin = buffer + (entry.block - block) * block_words;
+                    std::copy(begin, begin + block_words, this->data[index].begin());
+                    entry.dirty = false;
+                }
+            }
+            return true;
+        };
+
+        /**
+         * @brief Write all dirty blocks to the memory.
+         * Call this before the memory is removed or powered down.
+         *
+         * @return Returns True when all blocks were written.
+         */
+        auto sync() -> bool
+        {
+            bool success = true;
+            for (std::size_t index = 0; index < N; index++)
+                success &= this->write_back(index);
+            return success;
+        };
+
+        /**
+         * @brief Reset the hit and miss statistics.
+         */
+        void reset_statistics()
+        {
+            this->hits = 0;
+            this->misses = 0;
+            this->write_backs = 0;
+        };
+
+      private:
+        /* === Types === */
+        struct Entry
+        {
+            uint32_t block{0};     /**< The address of the cached block. */
+            uint32_t last_used{0}; /**< The access count when the block was last used. */
+            bool valid{false};     /**< The entry contains a block. */
+            bool dirty{false};     /**< The block has to be written to the memory. */
+        };
+
+        /* === Methods === */
+        /**
+         * @brief Find the entry of a block.
+         * @param block The address of the block.
+         * @return The index of the entry when the block is cached.
+         */
+        auto find(const uint32_t block) const -> std::optional<std::size_t>
+        {
+            for (std::size_t index = 0; index < N; index++)
+                if (this->entries[index].valid && (this->entries[index].block == block))
+                    return index;
+            return {};
+        };
+
+        /**
+         * @brief Get an entry for a new block. Empty entries are used
+         * first, otherwise the least recently used block is replaced.
+         * @return The index of the entry, nothing when the replaced block could not be written.
+         */
+        auto replace() -> std::optional<std::size_t>
+        {
+            const auto victim = std::min_element(
+                this->entries.begin(), this->entries.end(),
+                [](const Entry &lhs, const Entry &rhs)
+                { return (lhs.valid ? lhs.last_used + 1 : 0) < (rhs.valid ? rhs.last_used + 1 : 0); });
+            const std::size_t index = std::distance(this->entries.begin(), victim);
+            if (not this->write_back(index))
+                return {};
+            this->entries[index].valid = false;
+            return index;
+        };
+
+        /**
+         * @brief Mark an entry as recently used.
+         * @param index The index of the entry.
+         */
+        void touch(const std::size_t index)
+        {
+            this->entries[index].last_used = ++this->access_count;
+        };
+
+        /**
+         * @brief Write an entry to the memory when it is dirty.
+         * @param index The index of the entry.
+         * @return Returns True when the entry is clean afterwards.
+         */
+        auto write_back(const std::size_t index) -> bool
+        {
+            Entry &entry = this->entries[index];
+            if (not(entry.valid && entry.dirty))
+                return true;
+            if (not drive::write_single_block(*this->memory, this->data[index].data(), entry.block))
+                return false;
+            entry.dirty = false;
+            this->write_backs++;
+            return true;
+        };
+
+        /* === Properties === */
+        Memory *memory;                                      /**< The memory which is cached. */
+        std::array<std::array<uint32_t, block_words>, N> data{}; /**< The data of the cached blocks. */
+        std::array<Entry, N> entries{};                      /**< The state of the cached blocks. */
+        uint32_t access_count{0};                            /**< Counter for the least recently used replacement. */
+        uint32_t hits{0};                                    /**< The number of cache hits. */
+        uint32_t misses{0};                                  /**< The number of cache misses. */
+        uint32_t write_backs{0};                             /**< The number of written dirty blocks. */
+    };
+
+    /* === Functions to interface with the cache === */
+    /**
+     * @brief Write all dirty blocks of the cache to the memory.
+     */
+    template <class Memory, std::size_t N>
+    bool sync(Cache<Memory, N> &cache)
+    {
+        return cache.sync();
+    };
+}; // namespace drive
+
+#endif // CACHE_H_
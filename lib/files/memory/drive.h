@@ -0,0 +1,93 @@
+/**
+ * OTOS - Open Tec Operating System
+ * Copyright (c) 2022 - 2024 Sebastian Oberschwendtner, sebastian.oberschwendtner@gmail.com
+ *
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef DRIVE_H_
+#define DRIVE_H_
+
+/* === Includes === */
+#include <cstdint>
+
+namespace drive
+{
+    /* === Functions to interface with memory === */
+    template <class Memory>
+    bool read_single_block(Memory &memory, const uint32_t *buffer, const uint32_t block)
+    {
+        return memory.read_single_block(buffer, block);
+    };
+    template <class Memory>
+    bool write_single_block(Memory &memory, const uint32_t *buffer, const uint32_t block)
+    {
+        return memory.write_single_block(buffer, block);
+    };
+    template <class Memory>
+    bool read_multiple_blocks(Memory &memory, const uint32_t *buffer, const uint32_t block, const uint32_t count)
+    {
+        return memory.read_multiple_blocks(buffer, block, count);
+    };
+    template <class Memory>
+    bool write_multiple_blocks(Memory &memory, const uint32_t *buffer, const uint32_t block, const uint32_t count)
+    {
+        return memory.write_multiple_blocks(buffer, block, count);
+    };
+
+    /* Memory without a DMA path transfers the blocks immediately.
+     * Memories which transfer in the background finish a started
+     * transfer before they accept the next access. */
+    template <class Memory>
+    bool start_read_multiple_blocks(Memory &memory, const uint32_t *buffer, const uint32_t block, const uint32_t count)
+    {
+        return drive::read_multiple_blocks(memory, buffer, block, count);
+    };
+    template <class Memory>
+    bool is_read_finished([[maybe_unused]] Memory &memory)
+    {
+        return true;
+    };
+    template <class Memory>
+    bool complete_read([[maybe_unused]] Memory &memory)
+    {
+        return true;
+    };
+    template <class Memory>
+    bool start_write_multiple_blocks(Memory &memory, const uint32_t *buffer, const uint32_t block, const uint32_t count)
+    {
+        return drive::write_multiple_blocks(memory, buffer, block, count);
+    };
+    template <class Memory>
+    bool is_write_finished([[maybe_unused]] Memory &memory)
+    {
+        return true;
+    };
+    template <class Memory>
+    bool complete_write([[maybe_unused]] Memory &memory)
+    {
+        return true;
+    };
+
+    /* Memory without a cache writes all blocks immediately */
+    template <class Memory>
+    bool sync([[maybe_unused]] Memory &memory)
+    {
+        return true;
+    };
+}; // namespace drive
+
+#endif // DRIVE_H_
@@ -0,0 +1,477 @@
+/**
+ * OTOS - Open Tec Operating System
+ * Copyright (c) 2022 - 2024 Sebastian Oberschwendtner, sebastian.oberschwendtner@gmail.com
+ *
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef LOG_H_
+#define LOG_H_
+
+/* === Includes === */
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include "drive.h"
+
+namespace drive
+{
+    /* === Functions === */
+    /**
+     * @brief Compute the CRC-32 (IEEE 802.3) of data. The
+     * CRC can be continued by passing the previous result.
+     *
+     * @param data The data.
+     * @param length The number of bytes.
+     * @param crc The CRC of the preceding data.
+     * @return The CRC including the data.
+     */
+    inline auto crc32(const uint8_t *data, const std::size_t length, uint32_t crc = 0) -> uint32_t
+    {
+        /* Nibble table, which is a compromise between speed and flash size */
+        constexpr std::array<uint32_t, 16> table{
+            0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC,
+            0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+            0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+            0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C};
+
+        crc = ~crc;
+        for (std::size_t i = 0; i < length; i++)
+        {
+            crc ^= data[i];
+            crc = (crc >> 4) ^ table[crc & 0x0F];
+            crc = (crc >> 4) ^ table[crc & 0x0F];
+        }
+        return ~crc;
+    };
+
+    /**
+     * @brief Append-only store for records on a range of blocks,
+     * which bypasses the filesystem for high-rate data capture:
+     *
+     * drive::Log<sdhc::Card, 8> log{card, first_block, block_count};
+     * if (not log.mount()) log.format();
+     * log.append(&sample, sizeof(sample));
+     *
+     * The records are packed into blocks which are written with one
+     * transfer per N blocks. Two buffers of N blocks alternate, so
+     * memories with a DMA path write one buffer in the background
+     * while the records are collected in the other one. Appending
+     * only copies the record and never waits for more than one
+     * transfer.
+     *
+     * Every block has a header with the epoch of the log, a sequence
+     * number and a CRC. The blocks are used as a ring and the oldest
+     * blocks are overwritten when the range is full. Mounting finds
+     * the newest block with a binary search over the sequence numbers.
+     * A power loss only loses the records which were not written yet
+     * and the block which was written at that moment. sync() writes
+     * the collected records, the next records start a new block.
+     *
+     * @tparam Memory The memory which stores the log.
+     * @tparam N The number of blocks which are written with one transfer.
+     */
+    template <class Memory, std::size_t N = 4>
+    class Log
+    {
+      public:
+        /* === Parameters === */
+        static constexpr std::size_t block_words = 128;              /**< One block has 512 bytes. */
+        static constexpr std::size_t header_size = 20;               /**< [bytes] The size of the block header. */
+        static constexpr std::size_t payload_size = 512 - header_size; /**< [bytes] The space for records in one block. */
+        static constexpr std::size_t max_record = payload_size - 2;  /**< [bytes] The largest record, the length uses 2 bytes. */
+        static constexpr uint32_t magic = 0x474F4C4F;                /**< Marks the blocks of a log, "OLOG". */
+        static_assert(N > 0, "OTOS: A transfer needs at least one block!");
+
+        /* === Types === */
+        /**
+         * @brief Streams the records of a log from the oldest to
+         * the newest one. Records which are appended while reading
+         * are read once they are written.
+         */
+        class Reader
+        {
+          public:
+            /* === Constructors === */
+            Reader() = delete;
+
+            /**
+             * @brief Construct a new Reader object.
+             *
+             * @param log_used The mounted log which is read.
+             */
+            explicit Reader(Log &log_used)
+                : log{&log_used}
+            {
+                const uint32_t head = log_used.get_sequence();
+                this->sequence = (head > log_used.count) ? head - log_used.count + 1 : 1;
+            };
+
+            /* === Methods === */
+            /**
+             * @brief Read the next record. Records which do not
+             * fit into the buffer are truncated.
+             *
+             * @param data The buffer for the record.
+             * @param size The size of the buffer in bytes.
+             * @return The length of the record, no value when all records were read.
+             */
+            auto next(void *data, const std::size_t size) -> std::optional<uint16_t>
+            {
+                /* Load the next valid block, blocks which were overwritten or torn are skipped */
+                const auto *bytes = reinterpret_cast<const uint8_t *>(this->block.data());
+                while (this->offset >= this->used)
+                {
+                    if (this->sequence > this->log->get_sequence())
+                        return {};
+                    this->offset = 0;
+                    this->used = 0;
+                    if (this->log->read_block(this->block.data(), this->sequence))
+                        this->used = read_short(bytes, 12);
+                    this->sequence++;
+                }
+
+                /* Copy the record */
+                const uint16_t length = read_short(bytes, header_size + this->offset);
+                const uint8_t *record = bytes + header_size + this->offset + 2;
+                std::copy(record, record + std::min<std::size_t>(length, size), static_cast<uint8_t *>(data));
+                this->offset += 2 + length;
+                return length;
+            };
+
+          private:
+            /* === Properties === */
+            Log *log;                                    /**< The log which is read. */
+            std::array<uint32_t, block_words> block{};  /**< The block which is read. */
+            uint32_t sequence{1};                        /**< The sequence number of the next block. */
+            uint16_t offset{0};                          /**< [bytes] The position of the next record in the payload. */
+            uint16_t used{0};                            /**< [bytes] The used payload of the block. */
+        };
+
+        /* === Constructors === */
+        Log() = delete;
+        Log(const Log &) = delete;
+        auto operator=(const Log &) -> Log & = delete;
+
+        /**
+         * @brief Construct a new Log object.
+         *
+         * @param memory_used The memory which stores the log.
+         * @param first The address of the first block of the log.
+         * @param blocks The number of blocks of the log, at least 2.
+         */
+        Log(Memory &memory_used, const uint32_t first, const uint32_t blocks)
+            : memory{&memory_used}, begin{first}, count{blocks} {};
+
+        /* === Getters === */
+        /**
+         * @brief Get the sequence number of the newest block
+         * which is written to the memory.
+         * @return The sequence number, 0 when the log is not mounted.
+         */
+        auto get_sequence() const -> uint32_t { return this->head; };
+
+        /**
+         * @brief Get the epoch of the log, which changes
+         * every time the log is formatted.
+         * @return The epoch of the log.
+         */
+        auto get_epoch() const -> uint32_t { return this->epoch; };
+
+        /* === Methods === */
+        /**
+         * @brief Start a new empty log. The first block is written
+         * with a new epoch, so the blocks of the previous log are
+         * ignored and do not have to be erased.
+         *
+         * @return Returns True when the log was formatted.
+         */
+        auto format() -> bool
+        {
+            if ((this->count < 2) || not this->complete())
+                return false;
+
+            /* Continue the epoch of a previous log */
+            uint32_t *block = this->get_current_block();
+            const bool previous = drive::read_single_block(*this->memory, block, this->begin) && this->is_valid(block);
+            this->epoch = previous ? read_long(reinterpret_cast<uint8_t *>(block), 4) + 1 : 1;
+
+            /* The first block is empty */
+            this->head = 0;
+            this->sequence = 1;
+            this->collected = 0;
+            this->used = 0;
+            this->finish_block();
+            return this->sync();
+        };
+
+        /**
+         * @brief Mount an existing log and continue it after
+         * its newest block.
+         *
+         * @return Returns True when the log was found.
+         */
+        auto mount() -> bool
+        {
+            if ((this->count < 2) || not this->complete())
+                return false;
+            this->epoch = 0;
+            this->head = 0;
+
+            /* The first block determines the epoch and the current lap */
+            uint32_t *block = this->get_current_block();
+            const auto *bytes = reinterpret_cast<const uint8_t *>(block);
+            if (drive::read_single_block(*this->memory, block, this->begin) && this->is_valid(block))
+            {
+                /* The blocks up to the newest one continue the sequence of the first block */
+                this->epoch = read_long(bytes, 4);
+                const uint32_t first = read_long(bytes, 8);
+                uint32_t low = 0;
+                uint32_t high = this->count;
+                while (high - low > 1)
+                {
+                    const uint32_t middle = low + (high - low) / 2;
+                    if (this->read_block(block, first + middle))
+                        low = middle;
+                    else
+                        high = middle;
+                }
+                this->head = first + low;
+            }
+            /* The first block was torn while the log wrapped around, so the last block is the newest one */
+            else if (drive::read_single_block(*this->memory, block, this->begin + this->count - 1) && this->is_valid(block))
+            {
+                this->epoch = read_long(bytes, 4);
+                this->head = read_long(bytes, 8);
+            }
+            if (this->epoch == 0)
+                return false;
+
+            /* Continue with a new block */
+            this->sequence = this->head + 1;
+            this->collected = 0;
+            this->used = 0;
+            return true;
+        };
+
+        /**
+         * @brief Append a record to the log. The record is written
+         * when a buffer of N blocks is full or the log is synchronized.
+         *
+         * @param data The data of the record.
+         * @param length The number of bytes, at most max_record.
+         * @return Returns True when the record was appended.
+         */
+        auto append(const void *data, const std::size_t length) -> bool
+        {
+            if ((this->epoch == 0) || (length == 0) || (length > max_record))
+                return false;
+
+            /* Records are not split across blocks */
+            if ((this->used + 2 + length > payload_size) && not this->finish_block())
+                return false;
+
+            /* Copy the record to the current block */
+            auto *bytes = reinterpret_cast<uint8_t *>(this->get_current_block()) + header_size + this->used;
+            write_short(bytes, 0, static_cast<uint16_t>(length));
+            std::copy_n(static_cast<const uint8_t *>(data), length, bytes + 2);
+            this->used += 2 + length;
+            return true;
+        };
+
+        /**
+         * @brief Write the collected records to the memory
+         * and wait until they are written.
+         *
+         * @return Returns True when all records are written.
+         */
+        auto sync() -> bool
+        {
+            if (this->epoch == 0)
+                return false;
+            if ((this->used > 0) && not this->finish_block())
+                return false;
+            return this->write_collected() && this->complete();
+        };
+
+      private:
+        /* === Methods === */
+        /**
+         * @brief Get the block which collects the records.
+         * @return Pointer to the block in the collecting buffer.
+         */
+        auto get_current_block() -> uint32_t *
+        {
+            return this->buffer.data() + (this->half * N + this->collected) * block_words;
+        };
+
+        /**
+         * @brief Get the address of the block of a sequence number.
+         * @param sequence The sequence number of the block.
+         * @return The address of the block in the memory.
+         */
+        auto get_address(const uint32_t sequence) const -> uint32_t
+        {
+            return this->begin + (sequence - 1) % this->count;
+        };
+
+        /**
+         * @brief Check the magic number and the CRC of a block.
+         * @param block The data of the block.
+         * @return Returns True when the block belongs to a log.
+         */
+        static auto is_valid(const uint32_t *block) -> bool
+        {
+            const auto *bytes = reinterpret_cast<const uint8_t *>(block);
+            const uint16_t used = read_short(bytes, 12);
+            if ((read_long(bytes, 0) != magic) || (used > payload_size))
+                return false;
+            const uint32_t crc = crc32(bytes + header_size, used, crc32(bytes, 16));
+            return crc == read_long(bytes, 16);
+        };
+
+        /**
+         * @brief Read the block of a sequence number.
+         * @param block The buffer for the block.
+         * @param sequence The sequence number of the block.
+         * @return Returns True when the block is valid and belongs to the sequence number.
+         */
+        auto read_block(uint32_t *block, const uint32_t sequence) -> bool
+        {
+            const auto *bytes = reinterpret_cast<const uint8_t *>(block);
+            return drive::read_single_block(*this->memory, block, this->get_address(sequence)) &&
+                   this->is_valid(block) &&
+                   (read_long(bytes, 4) == this->epoch) &&
+                   (read_long(bytes, 8) == sequence);
+        };
+
+        /**
+         * @brief Finish the header of the current block and continue
+         * with the next block. A full buffer is written to the memory.
+         *
+         * @return Returns True when the block was finished.
+         */
+        auto finish_block() -> bool
+        {
+            auto *bytes = reinterpret_cast<uint8_t *>(this->get_current_block());
+            write_long(bytes, 0, magic);
+            write_long(bytes, 4, this->epoch);
+            write_long(bytes, 8, this->sequence++);
+            write_short(bytes, 12, this->used);
+            write_short(bytes, 14, 0);
+            write_long(bytes, 16, crc32(bytes + header_size, this->used, crc32(bytes, 16)));
+            this->used = 0;
+
+            /* Write the buffer when it is full */
+            if (++this->collected == N)
+                return this->write_collected();
+            return true;
+        };
+
+        /**
+         * @brief Wait for the pending transfer.
+         * @return Returns True when the blocks were written.
+         */
+        auto complete() -> bool
+        {
+            if (this->pending == 0)
+                return true;
+            const bool success = drive::complete_write(*this->memory);
+            if (success)
+                this->head = this->pending;
+            this->pending = 0;
+            return success;
+        };
+
+        /**
+         * @brief Start writing the collected blocks and collect
+         * the next blocks in the other buffer. The transfer is
+         * split when the blocks wrap around the end of the range.
+         *
+         * @return Returns True when the transfer was started.
+         */
+        auto write_collected() -> bool
+        {
+            if (this->collected == 0)
+                return true;
+
+            /* Only one transfer is pending at a time */
+            if (not this->complete())
+                return false;
+
+            /* Write the blocks */
+            const uint32_t *blocks = this->buffer.data() + this->half * N * block_words;
+            const uint32_t first = this->sequence - this->collected;
+            const uint32_t offset = (first - 1) % this->count;
+            const uint32_t until_end = std::min<uint32_t>(this->collected, this->count - offset);
+            bool success = drive::start_write_multiple_blocks(*this->memory, blocks, this->begin + offset, until_end);
+            if (success && (until_end < this->collected))
+            {
+                success = drive::complete_write(*this->memory) &&
+                          drive::start_write_multiple_blocks(*this->memory, blocks + until_end * block_words, this->begin, this->collected - until_end);
+            }
+
+            /* Collect the next blocks in the other buffer */
+            this->pending = success ? this->sequence - 1 : 0;
+            this->half ^= 1;
+            this->collected = 0;
+
+            /* Memories without a DMA path have already written the blocks */
+            if (success && drive::is_write_finished(*this->memory))
+                return this->complete();
+            return success;
+        };
+
+        /**
+         * @brief Little-endian access to the block header.
+         */
+        static auto read_short(const uint8_t *bytes, const std::size_t position) -> uint16_t
+        {
+            return static_cast<uint16_t>(bytes[position] | (bytes[position + 1] << 8));
+        };
+        static auto read_long(const uint8_t *bytes, const std::size_t position) -> uint32_t
+        {
+            return static_cast<uint32_t>(read_short(bytes, position)) | (static_cast<uint32_t>(read_short(bytes, position + 2)) << 16);
+        };
+        static void write_short(uint8_t *bytes, const std::size_t position, const uint16_t value)
+        {
+            bytes[position] = static_cast<uint8_t>(value & 0xFF);
+            bytes[position + 1] = static_cast<uint8_t>(value >> 8);
+        };
+        static void write_long(uint8_t *bytes, const std::size_t position, const uint32_t value)
+        {
+            write_short(bytes, position, static_cast<uint16_t>(value & 0xFFFF));
+            write_short(bytes, position + 2, static_cast<uint16_t>(value >> 16));
+        };
+
+        /* === Properties === */
+        Memory *memory;                                      /**< The memory which stores the log. */
+        uint32_t begin;                                      /**< The address of the first block of the log. */
+        uint32_t count;                                      /**< The number of blocks of the log. */
+        std::array<uint32_t, 2 * N * block_words> buffer{}; /**< The two buffers which collect the blocks. */
+        uint32_t epoch{0};                                   /**< The epoch of the log. */
+        uint32_t head{0};                                    /**< The sequence number of the newest written block. */
+        uint32_t sequence{1};                                /**< The sequence number of the current block. */
+        uint32_t pending{0};                                 /**< The newest sequence number of the pending transfer, 0 when none is pending. */
+        uint32_t collected{0};                               /**< The number of finished blocks in the collecting buffer. */
+        uint16_t used{0};                                    /**< [bytes] The used payload of the current block. */
+        uint8_t half{0};                                     /**< The buffer which collects the blocks. */
+    };
+}; // namespace drive
+
+#endif // LOG_H_
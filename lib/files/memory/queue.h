@@ -0,0 +1,456 @@
+/**
+ * OTOS - Open Tec Operating System
+ * Copyright (c) 2022 - 2024 Sebastian Oberschwendtner, sebastian.oberschwendtner@gmail.com
+ *
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef QUEUE_H_
+#define QUEUE_H_
+
+/* === Includes === */
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <task.h>
+#include "drive.h"
+
+namespace drive
+{
+    /* === Enums === */
+    enum class Operation : uint8_t
+    {
+        Read = 0,
+        Write,
+        Sync
+    };
+
+    enum class Status : uint8_t
+    {
+        Idle = 0,
+        Pending,
+        Done,
+        Failed
+    };
+
+    /* === Types === */
+    /**
+     * @brief A request to transfer blocks of a memory.
+     * The request is owned by the client which submits it
+     * and has to exist until the request is finished.
+     */
+    struct Request
+    {
+        Operation operation{Operation::Read}; /**< The requested operation. */
+        uint32_t block{0};                    /**< The address of the first block. */
+        uint32_t count{1};                    /**< The number of blocks. */
+        const uint32_t *buffer{nullptr};      /**< The data of the blocks, it has to hold count * 512 bytes. */
+        Status status{Status::Idle};          /**< The state of the request. */
+
+        /**
+         * @brief Check whether the request is finished.
+         * @return Returns True when the request is done or failed.
+         */
+        auto is_done() const -> bool
+        {
+            return (this->status == Status::Done) || (this->status == Status::Failed);
+        };
+
+        /**
+         * @brief Check whether the blocks of two requests overlap.
+         * @param other The other request.
+         * @return Returns True when both requests access the same block.
+         */
+        auto overlaps(const Request &other) const -> bool
+        {
+            return (this->block < other.block + other.count) && (other.block < this->block + this->count);
+        };
+    };
+
+    /**
+     * @brief Queue for the block requests of several threads to
+     * one memory. One storage thread owns the queue and the memory
+     * and calls process() periodically, the other threads submit
+     * requests and poll or wait for their completion:
+     *
+     * // storage thread
+     * drive::Queue<sdhc::Card, 8> queue{card};
+     * while (true) { queue.process(); OTOS::Task::yield(); }
+     *
+     * // client thread
+     * drive::Request request{drive::Operation::Write, block, 1, data.data()};
+     * queue.submit(request);
+     * queue.wait(request);
+     *
+     * The pending requests are served like an elevator: in ascending
+     * order of their blocks starting at the last accessed block, then
+     * the remaining requests from the lowest block. Adjacent requests
+     * of the same operation are merged into one transfer of up to M
+     * blocks. A sync request is a barrier, the requests submitted
+     * before are finished first and the requests submitted afterwards
+     * are not moved in front of it. Requests which overlap a pending
+     * request of the other operation are not reordered either.
+     *
+     * @tparam Memory The memory which is accessed.
+     * @tparam N The number of pending requests.
+     * @tparam M The number of blocks which are merged into one transfer.
+     */
+    template <class Memory, std::size_t N, std::size_t M = 4>
+    class Queue
+    {
+      public:
+        /* === Parameters === */
+        static constexpr std::size_t block_words = 128; /**< One block has 512 bytes. */
+        static_assert(N > 0, "OTOS: The queue needs at least one request!");
+        static_assert(M > 0, "OTOS: A transfer needs at least one block!");
+
+        /* === Constructors === */
+        Queue() = delete;
+        Queue(const Queue &) = delete;
+        auto operator=(const Queue &) -> Queue & = delete;
+
+        /**
+         * @brief Construct a new Queue object.
+         *
+         * @param memory_used The memory which is accessed.
+         */
+        explicit Queue(Memory &memory_used)
+            : memory{&memory_used} {};
+
+        /* === Getters === */
+        /**
+         * @brief Get the number of requests which are not finished.
+         * @return The number of pending requests.
+         */
+        auto get_pending() const -> std::size_t { return this->pending_count; };
+
+        /**
+         * @brief Get the number of transfers with the memory.
+         * @return The number of read and write transfers.
+         */
+        auto get_transfers() const -> uint32_t { return this->transfers; };
+
+        /**
+         * @brief Get the number of requests which were merged
+         * into the transfer of a preceding request.
+         * @return The number of merged requests.
+         */
+        auto get_merged() const -> uint32_t { return this->merged; };
+
+        /**
+         * @brief Get the memory which is accessed.
+         * @return Reference to the memory.
+         */
+        auto get_memory() -> Memory & { return *this->memory; };
+
+        /* === Methods === */
+        /**
+         * @brief Submit a request to the queue.
+         *
+         * @param request The request, it has to exist until it is finished.
+         * @return Returns True when the request is pending, False when the
+         * queue is full or the request is already pending or invalid.
+         */
+        auto submit(Request &request) -> bool
+        {
+            if ((this->pending_count == N) || (request.status == Status::Pending))
+                return false;
+            if ((request.operation != Operation::Sync) && ((request.count == 0) || (request.buffer == nullptr)))
+                return false;
+
+            request.status = Status::Pending;
+            this->pending[this->pending_count++] = &request;
+            return true;
+        };
+
+        /**
+         * @brief Wait for a submitted request. The calling
+         * thread yields until the storage thread finished it.
+         *
+         * @param request The submitted request.
+         * @return Returns True when the request is done.
+         */
+        auto wait(const Request &request) const -> bool
+        {
+            YIELD_WHILE(request.status == Status::Pending);
+            return request.status == Status::Done;
+        };
+
+        /**
+         * @brief Submit a request and process the queue until the
+         * request is finished. Only call this from the storage thread.
+         *
+         * @param request The request.
+         * @return Returns True when the request is done.
+         */
+        auto execute(Request &request) -> bool
+        {
+            /* Make room for the request */
+            while (not this->submit(request))
+            {
+                if ((request.status == Status::Pending) || (this->process() == 0))
+                    return false;
+            }
+
+            /* The requests in front are served as well */
+            while (request.status == Status::Pending)
+                this->process();
+            return request.status == Status::Done;
+        };
+
+        /**
+         * @brief Serve the pending requests up to the next sync request.
+         * Only call this from the storage thread.
+         *
+         * @return The number of finished requests.
+         */
+        auto process() -> std::size_t
+        {
+            if (this->pending_count == 0)
+                return 0;
+
+            /* A sync request at the front is served alone */
+            if (this->pending[0]->operation == Operation::Sync)
+            {
+                this->finish(this->pending[0], drive::sync(*this->memory));
+                this->remove(1);
+                return 1;
+            }
+
+            /* Take the requests until the next barrier */
+            std::array<Request *, N> batch{};
+            std::size_t size = 0;
+            for (; size < this->pending_count; size++)
+            {
+                const Request *request = this->pending[size];
+                const bool conflict = std::any_of(
+                    this->pending.begin(), this->pending.begin() + size,
+                    [request](const Request *other)
+                    { return (other->operation != request->operation) && other->overlaps(*request); });
+                if ((request->operation == Operation::Sync) || conflict)
+                    break;
+                batch[size] = this->pending[size];
+            }
+            this->remove(size);
+
+            /* Sort the requests in elevator order, starting at the last accessed block */
+            const uint32_t head = this->head;
+            std::stable_sort(
+                batch.begin(), batch.begin() + size,
+                [head](const Request *lhs, const Request *rhs)
+                {
+                    const bool lhs_wrapped = lhs->block < head;
+                    const bool rhs_wrapped = rhs->block < head;
+                    if (lhs_wrapped != rhs_wrapped)
+                        return rhs_wrapped;
+                    return lhs->block < rhs->block;
+                });
+
+            /* Merge adjacent requests of the same operation */
+            for (std::size_t first = 0; first < size;)
+            {
+                std::size_t last = first + 1;
+                uint32_t blocks = batch[first]->count;
+                while ((last < size) && (batch[last]->operation == batch[first]->operation) &&
+                       (batch[last]->block == batch[last - 1]->block + batch[last - 1]->count) &&
+                       (blocks + batch[last]->count <= M))
+                {
+                    blocks += batch[last]->count;
+                    last++;
+                }
+                this->transfer(batch.data() + first, last - first, blocks);
+                first = last;
+            }
+            return size;
+        };
+
+        /**
+         * @brief Reset the transfer statistics.
+         */
+        void reset_statistics()
+        {
+            this->transfers = 0;
+            this->merged = 0;
+        };
+
+      private:
+        /* === Methods === */
+        /**
+         * @brief Transfer a group of adjacent requests with one
+         * memory access. Merged requests are copied through the
+         * staging buffer.
+         *
+         * @param group The requests in ascending order of their blocks.
+         * @param count The number of requests.
+         * @param blocks The number of blocks of all requests.
+         */
+        void transfer(Request *const *group, const std::size_t count, const uint32_t blocks)
+        {
+            const Request &first = *group[0];
+            const bool is_write = first.operation == Operation::Write;
+            bool success = false;
+
+            if (count == 1)
+            {
+                /* A single request uses its own buffer */
+                if (is_write)
+                    success = (blocks == 1)
+                                  ? drive::write_single_block(*this->memory, first.buffer, first.block)
+                                  : drive::write_multiple_blocks(*this->memory, first.buffer, first.block, blocks);
+                else
+                    success = (blocks == 1)
+                                  ? drive::read_single_block(*this->memory, first.buffer, first.block)
+                                  : drive::read_multiple_blocks(*this->memory, first.buffer, first.block, blocks);
+            }
+            else if (is_write)
+            {
+                /* Collect the data of the requests */
+                uint32_t *position = this->staging.data();
+                for (std::size_t index = 0; index < count; index++)
+                    position = std::copy(group[index]->buffer, group[index]->buffer + group[index]->count * block_words, position);
+                success = drive::write_multiple_blocks(*this->memory, this->staging.data(), first.block, blocks);
+            }
+            else
+            {
+                /* Distribute the data to the requests */
+                success = drive::read_multiple_blocks(*this->memory, this->staging.data(), first.block, blocks);
+                const uint32_t *position = this->staging.data();
+                for (std::size_t index = 0; success && (index < count); index++)
+                {
+                    std::copy(position, position + group[index]->count * block_words, const_cast<uint32_t *>(group[index]->buffer));
+                    position += group[index]->count * block_words;
+                }
+            }
+
+            /* Finish the requests */
+            this->transfers++;
+            this->merged += count - 1;
+            this->head = first.block + blocks;
+            for (std::size_t index = 0; index < count; index++)
+                this->finish(group[index], success);
+        };
+
+        /**
+         * @brief Set the result of a request.
+         * @param request The finished request.
+         * @param success Whether the request was successful.
+         */
+        static void finish(Request *request, const bool success)
+        {
+            request->status = success ? Status::Done : Status::Failed;
+        };
+
+        /**
+         * @brief Remove requests from the front of the queue.
+         * @param count The number of removed requests.
+         */
+        void remove(const std::size_t count)
+        {
+            std::copy(this->pending.begin() + count, this->pending.begin() + this->pending_count, this->pending.begin());
+            this->pending_count -= count;
+        };
+
+        /* === Properties === */
+        Memory *memory;                                 /**< The memory which is accessed. */
+        std::array<Request *, N> pending{};             /**< The pending requests in the order of submission. */
+        std::array<uint32_t, M * block_words> staging{}; /**< The data of merged requests. */
+        std::size_t pending_count{0};                   /**< The number of pending requests. */
+        uint32_t head{0};                               /**< The block after the last transfer. */
+        uint32_t transfers{0};                          /**< The number of transfers with the memory. */
+        uint32_t merged{0};                             /**< The number of merged requests. */
+    };
+
+    /**
+     * @brief Memory interface of a queue for the storage thread,
+     * e.g. to mount a volume on the memory which is shared with
+     * the clients of the queue:
+     *
+     * drive::Queue_Memory<drive::Queue<sdhc::Card, 8>> port{queue};
+     * fat32::Volume<drive::Queue_Memory<drive::Queue<sdhc::Card, 8>>> volume{port};
+     *
+     * Each access is executed immediately together with the pending
+     * requests of the clients, so only use it in the storage thread.
+     * The volume and its files for this configuration are provided
+     * by queue_volume.cpp, other configurations have to include this
+     * header before the volume.
+     *
+     * @tparam Queue_t The type of the queue.
+     */
+    template <class Queue_t>
+    class Queue_Memory
+    {
+      public:
+        /* === Constructors === */
+        Queue_Memory() = delete;
+
+        /**
+         * @brief Construct a new Queue_Memory object.
+         *
+         * @param queue_used The queue which is used.
+         */
+        explicit Queue_Memory(Queue_t &queue_used)
+            : queue{&queue_used} {};
+
+        /* === Methods === */
+        auto read_single_block(const uint32_t *buffer, const uint32_t block) -> bool
+        {
+            Request request{Operation::Read, block, 1, buffer};
+            return this->queue->execute(request);
+        };
+        auto write_single_block(const uint32_t *buffer, const uint32_t block) -> bool
+        {
+            Request request{Operation::Write, block, 1, buffer};
+            return this->queue->execute(request);
+        };
+        auto read_multiple_blocks(const uint32_t *buffer, const uint32_t block, const uint32_t count) -> bool
+        {
+            Request request{Operation::Read, block, count, buffer};
+            return this->queue->execute(request);
+        };
+        auto write_multiple_blocks(const uint32_t *buffer, const uint32_t block, const uint32_t count) -> bool
+        {
+            Request request{Operation::Write, block, count, buffer};
+            return this->queue->execute(request);
+        };
+
+        /**
+         * @brief Finish all pending requests and synchronize the memory.
+         * @return Returns True when the memory was synchronized.
+         */
+        auto sync() -> bool
+        {
+            Request request{Operation::Sync, 0, 0, nullptr};
+            return this->queue->execute(request);
+        };
+
+      private:
+        /* === Properties === */
+        Queue_t *queue; /**< The queue which is used. */
+    };
+
+    /* === Functions to interface with the queue === */
+    /**
+     * @brief Finish all pending requests and synchronize the memory.
+     */
+    template <class Queue_t>
+    bool sync(Queue_Memory<Queue_t> &memory)
+    {
+        return memory.sync();
+    };
+}; // namespace drive
+
+#endif // QUEUE_H_
@@ -71,20 +71,53 @@ namespace sdhc
         return true;
     };
 
+    auto Card::get_SCR() -> bool
+    {
+        /* The SCR is sent as data with 8 bytes */
+        std::array<uint32_t, 2> buffer{0};
+        if (!this->send_app_command() || !this->mybus->send_command_R1_response(ACMD<51>(), 0))
+            return false;
+        if (!this->mybus->read_single_block(buffer.begin(), buffer.end()))
+            return false;
+
+        /* Evaluate the fields of the register */
+        const auto *scr = reinterpret_cast<const uint8_t *>(buffer.begin());
+        this->spec_version = scr[0] & 0x0F;
+        this->supports_4bits = scr[1] & SCR::BUS_WIDTH_4;
+        this->supports_CMD23 = scr[3] & SCR::CMD23_SUPPORT;
+        return true;
+    };
+
+    auto Card::get_SSR() -> bool
+    {
+        /* The SSR is sent as data with 64 bytes */
+        std::array<uint32_t, 16> buffer{0};
+        if (!this->send_app_command() || !this->mybus->send_command_R1_response(ACMD<13>(), 0))
+            return false;
+        if (!this->mybus->read_single_block(buffer.begin(), buffer.end()))
+            return false;
+
+        /* Evaluate the fields of the register, the sizes are coded as table indices */
+        constexpr std::array<uint8_t, 5> speed_classes{0, 2, 4, 6, 10};
+        constexpr std::array<uint32_t, 16> AU_sizes{
+            0, 16, 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192, 12288, 16384, 24576, 32768, 65536};
+        const auto *ssr = reinterpret_cast<const uint8_t *>(buffer.begin());
+        this->speed_class = (ssr[8] < speed_classes.size()) ? speed_classes[ssr[8]] : 0;
+        this->AU_size = AU_sizes[ssr[10] >> 4];
+        return true;
+    };
+
     auto Card::set_bus_width_4bits() -> bool
     {
         /* Goto subcommand mode */
-        auto response = this->mybus->send_command_R1_response(CMD<55>(), 0);
-
-        /* Check whether card respondend and accepted the subcommand */
-        if (!(response.value_or(0) & R1::APP_CMD))
+        if (!this->send_app_command())
         {
             this->state = State::Disconnected;
             return false;
         }
 
         /* Sent command to change bus width */
-        response = this->mybus->send_command_R1_response(CMD<6>(), 0b10);
+        auto response = this->mybus->send_command_R1_response(CMD<6>(), 0b10);
 
         /* Check whether accepts the change */
         if (response.value() & R1::ERROR)
@@ -93,6 +126,28 @@ namespace sdhc
             return true;
     };
 
+    auto Card::set_high_speed() -> bool
+    {
+        /* CMD6 is supported from version 1.10 of the specification */
+        this->supports_high_speed = false;
+        if (this->spec_version == 0)
+            return false;
+
+        /* Check whether the card supports the high-speed function */
+        std::array<uint32_t, 16> status{0};
+        const auto *bytes = reinterpret_cast<const uint8_t *>(status.begin());
+        if (!this->switch_function(CMD6::Check_High_Speed, status))
+            return false;
+        if (!(bytes[13] & 0b10) || ((bytes[16] & 0x0F) != 1))
+            return false;
+        this->supports_high_speed = true;
+
+        /* Switch to the high-speed function, the status contains the selected function */
+        if (!this->switch_function(CMD6::Switch_High_Speed, status))
+            return false;
+        return (bytes[16] & 0x0F) == 1;
+    };
+
     void Card::eject()
     {
         /* When card is present eject it */
@@ -131,6 +186,9 @@ namespace sdhc
 
     auto Card::read_single_block(const uint32_t *buffer_begin, const uint32_t block) -> bool
     {
+        /* The bus is used by the transfer in the background */
+        this->finish_transfer();
+
         /*
          * Get the address:
          * -> SDSC use byte addressing
@@ -150,6 +208,78 @@ namespace sdhc
         return true;
     };
 
+    auto Card::read_multiple_blocks(const uint32_t *buffer_begin, const uint32_t block, const uint32_t count) -> bool
+    {
+        /* The bus is used by the transfer in the background */
+        this->finish_transfer();
+
+        /* A single block has less command overhead */
+        if (count == 1)
+            return this->read_single_block(buffer_begin, block);
+
+        /*
+         * Get the address:
+         * -> SDSC use byte addressing
+         * -> SDHC use block addressing
+         */
+        const uint32_t address_adjusted = this->is_SDSC() ? block * BLOCKLENGTH : block;
+
+        /* Preset the number of blocks when the card supports it */
+        if (this->supports_CMD23 && !this->mybus->send_command_R1_response(CMD<23>(), count))
+            return false;
+
+        /* Send command to start multiple block transfer */
+        if (!this->mybus->send_command_R1_response(CMD<18>(), address_adjusted))
+            return false;
+
+        /* Receive the data of all blocks, buffer holds 4 bytes per entry */
+        const bool transferred = this->mybus->read_multiple_blocks(buffer_begin, buffer_begin + count * (BLOCKLENGTH / 4));
+
+        /* Stop the transfer, when the block count was not preset or the transfer failed */
+        if (!transferred || !this->supports_CMD23)
+            return this->stop_transmission() && transferred;
+        return true;
+    };
+
+    auto Card::start_read_multiple_blocks(const uint32_t *buffer_begin, const uint32_t block, const uint32_t count) -> bool
+    {
+        /* Without DMA the blocks are read immediately */
+        if (!this->mybus->has_dma())
+            return this->read_multiple_blocks(buffer_begin, block, count);
+
+        /* Only one transfer can use the bus */
+        this->finish_transfer();
+        if (!this->send_transfer_command(CMD<17>(), CMD<18>(), block, count))
+            return false;
+
+        /* Start receiving the data of all blocks, buffer holds 4 bytes per entry */
+        if (this->mybus->start_dma_read(buffer_begin, buffer_begin + count * (BLOCKLENGTH / 4)))
+        {
+            this->transfer_multiple = (count > 1);
+            this->transfer_running = true;
+            return true;
+        }
+
+        /* The data path did not start, only the command has to be stopped */
+        if (count > 1)
+            this->stop_transmission();
+        return false;
+    };
+
+    auto Card::is_transfer_finished() const -> bool
+    {
+        return !this->transfer_running || this->mybus->dma_transfer_finished();
+    };
+
+    auto Card::complete_transfer() -> bool
+    {
+        /* Report the result only once */
+        this->finish_transfer();
+        const bool success = this->transfer_success;
+        this->transfer_success = true;
+        return success;
+    };
+
     auto Card::reset() -> bool
     {
         return this->mybus->send_command_no_response(CMD<0>(), 0);
@@ -170,8 +300,74 @@ namespace sdhc
         }
     };
 
+    auto Card::stop_transmission() -> bool
+    {
+        return this->mybus->send_command_R1_response(CMD<12>(), 0).has_value();
+    };
+
+    auto Card::write_multiple_blocks(const uint32_t *buffer_begin, const uint32_t block, const uint32_t count) -> bool
+    {
+        /* The bus is used by the transfer in the background */
+        this->finish_transfer();
+
+        /* A single block has less command overhead */
+        if (count == 1)
+            return this->write_single_block(buffer_begin, block);
+
+        /*
+         * Get the address:
+         * -> SDSC use byte addressing
+         * -> SDHC use block addressing
+         */
+        const uint32_t address_adjusted = this->is_SDSC() ? block * BLOCKLENGTH : block;
+
+        /* Preset the number of blocks when the card supports it */
+        if (this->supports_CMD23 && !this->mybus->send_command_R1_response(CMD<23>(), count))
+            return false;
+
+        /* Send command to start multiple block transfer */
+        if (!this->mybus->send_command_R1_response(CMD<25>(), address_adjusted))
+            return false;
+
+        /* Write the data of all blocks, BLOCKLENGTH need to be divided by 4 -> 4 bytes per long */
+        const bool transferred = this->mybus->write_multiple_blocks(buffer_begin, buffer_begin + count * (BLOCKLENGTH / 4));
+
+        /* Stop the transfer, when the block count was not preset or the transfer failed */
+        if (!transferred || !this->supports_CMD23)
+            return this->stop_transmission() && transferred;
+        return true;
+    };
+
+    auto Card::start_write_multiple_blocks(const uint32_t *buffer_begin, const uint32_t block, const uint32_t count) -> bool
+    {
+        /* Without DMA the blocks are written immediately */
+        if (!this->mybus->has_dma())
+            return this->write_multiple_blocks(buffer_begin, block, count);
+
+        /* Only one transfer can use the bus */
+        this->finish_transfer();
+        if (!this->send_transfer_command(CMD<24>(), CMD<25>(), block, count))
+            return false;
+
+        /* Start sending the data of all blocks, BLOCKLENGTH need to be divided by 4 -> 4 bytes per long */
+        if (this->mybus->start_dma_write(buffer_begin, buffer_begin + count * (BLOCKLENGTH / 4)))
+        {
+            this->transfer_multiple = (count > 1);
+            this->transfer_running = true;
+            return true;
+        }
+
+        /* The data path did not start, only the command has to be stopped */
+        if (count > 1)
+            this->stop_transmission();
+        return false;
+    };
+
     auto Card::write_single_block(const uint32_t *buffer_begin, const uint32_t block) -> bool
     {
+        /* The bus is used by the transfer in the background */
+        this->finish_transfer();
+
         /*
          * Get the address:
          * -> SDSC use byte addressing
@@ -190,4 +386,59 @@ namespace sdhc
         /* Block was written successfully */
         return true;
     };
-}; // namespace sdhc
\ No newline at end of file
+
+    auto Card::send_app_command() -> bool
+    {
+        /* The card is addressed with its RCA, which is 0 during the identification */
+        auto response = this->mybus->send_command_R1_response(CMD<55>(), this->RCA << 16);
+
+        /* Check whether card respondend and accepted the subcommand */
+        return response.value_or(0) & R1::APP_CMD;
+    };
+
+    auto Card::switch_function(const uint32_t argument, std::array<uint32_t, 16> &status) -> bool
+    {
+        /* The switch status is sent as data with 64 bytes */
+        if (!this->mybus->send_command_R1_response(CMD<6>(), argument))
+            return false;
+        return this->mybus->read_single_block(status.begin(), status.end());
+    };
+
+    auto Card::send_transfer_command(const uint8_t command_single, const uint8_t command_multiple, const uint32_t block, const uint32_t count) -> bool
+    {
+        /*
+         * Get the address:
+         * -> SDSC use byte addressing
+         * -> SDHC use block addressing
+         */
+        const uint32_t address_adjusted = this->is_SDSC() ? block * BLOCKLENGTH : block;
+
+        /* A single block has less command overhead */
+        if (count == 1)
+            return this->mybus->send_command_R1_response(command_single, address_adjusted).has_value();
+
+        /* Preset the number of blocks when the card supports it */
+        if (this->supports_CMD23 && !this->mybus->send_command_R1_response(CMD<23>(), count))
+            return false;
+        return this->mybus->send_command_R1_response(command_multiple, address_adjusted).has_value();
+    };
+
+    void Card::finish_transfer()
+    {
+        if (!this->transfer_running)
+            return;
+
+        /* Wait for the DMA and release the data path */
+        while (!this->mybus->dma_transfer_finished())
+        {
+        };
+        this->transfer_running = false;
+        const bool transferred = this->mybus->complete_dma_transfer();
+
+        /* Stop the transfer, when the block count was not preset or the transfer failed */
+        if (this->transfer_multiple && (!transferred || !this->supports_CMD23))
+            this->transfer_success = this->stop_transmission() && transferred;
+        else
+            this->transfer_success = transferred;
+    };
+}; // namespace sdhc
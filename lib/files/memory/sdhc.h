@@ -28,6 +28,7 @@
 /* === Needed Interfaces === */
 #include <interface.h>
 #include <task.h>
+#include "drive.h"
 
 namespace sdhc
 {
@@ -68,6 +69,12 @@ namespace sdhc
         XPC = (1U << 28)  // Power Control (0: 0.36W; 1: 0.54W)
     };
 
+    enum CMD6 : uint32_t
+    {
+        Check_High_Speed = 0x00FFFFF1, // Check whether function 1 (high speed) of group 1 is supported
+        Switch_High_Speed = 0x80FFFFF1 // Switch group 1 to function 1 (high speed)
+    };
+
     /* Response bits */
     enum R1 : uint32_t
     {
@@ -89,6 +96,13 @@ namespace sdhc
         _3_0V = (1U << 17)
     };
 
+    /* The registers are sent MSB first, the bits are given within their byte */
+    enum SCR : uint8_t
+    {
+        BUS_WIDTH_4 = (1U << 2),  // Byte 1: Card supports the 4bit bus
+        CMD23_SUPPORT = (1U << 1) // Byte 3: Card supports setting the block count
+    };
+
     /* === Enums === */
     /* Card states */
     enum class State : uint32_t
@@ -120,6 +134,15 @@ namespace sdhc
         virtual auto send_command_R7_response(const uint8_t command, const uint32_t argument) -> std::optional<uint32_t> = 0;
         virtual auto read_single_block(const uint32_t *buffer_begin, const uint32_t *buffer_end) -> bool = 0;
         virtual auto write_single_block(const uint32_t *buffer_begin, const uint32_t *buffer_end) -> bool = 0;
+        virtual auto read_multiple_blocks(const uint32_t *buffer_begin, const uint32_t *buffer_end) -> bool = 0;
+        virtual auto write_multiple_blocks(const uint32_t *buffer_begin, const uint32_t *buffer_end) -> bool = 0;
+
+        /* Buses without DMA transfer the data blocks immediately */
+        virtual auto has_dma() const -> bool { return false; };
+        virtual auto start_dma_read([[maybe_unused]] const uint32_t *buffer_begin, [[maybe_unused]] const uint32_t *buffer_end) -> bool { return false; };
+        virtual auto start_dma_write([[maybe_unused]] const uint32_t *buffer_begin, [[maybe_unused]] const uint32_t *buffer_end) -> bool { return false; };
+        virtual auto dma_transfer_finished() const -> bool { return true; };
+        virtual auto complete_dma_transfer() -> bool { return true; };
     };
 
     /**
@@ -168,6 +191,34 @@ namespace sdhc
         {
             return sdio::write_single_block(*this->pimpl, buffer_begin, buffer_end);
         };
+        auto read_multiple_blocks(const uint32_t *buffer_begin, const uint32_t *buffer_end) -> bool final
+        {
+            return sdio::read_multiple_blocks(*this->pimpl, buffer_begin, buffer_end);
+        };
+        auto write_multiple_blocks(const uint32_t *buffer_begin, const uint32_t *buffer_end) -> bool final
+        {
+            return sdio::write_multiple_blocks(*this->pimpl, buffer_begin, buffer_end);
+        };
+        auto has_dma() const -> bool final
+        {
+            return sdio::has_dma(*this->pimpl);
+        };
+        auto start_dma_read(const uint32_t *buffer_begin, const uint32_t *buffer_end) -> bool final
+        {
+            return sdio::start_dma_read(*this->pimpl, buffer_begin, buffer_end);
+        };
+        auto start_dma_write(const uint32_t *buffer_begin, const uint32_t *buffer_end) -> bool final
+        {
+            return sdio::start_dma_write(*this->pimpl, buffer_begin, buffer_end);
+        };
+        auto dma_transfer_finished() const -> bool final
+        {
+            return sdio::dma_transfer_finished(*this->pimpl);
+        };
+        auto complete_dma_transfer() -> bool final
+        {
+            return sdio::complete_dma_transfer(*this->pimpl);
+        };
     };
 
     /**
@@ -207,6 +258,16 @@ namespace sdhc
          */
         auto set_bus_width_4bits() -> bool;
 
+        /**
+         * @brief Switch the card to the high-speed mode with CMD6.
+         * The card has to be selected and its SCR has to be read.
+         *
+         * Afterwards the bus clock can be raised to 50 MHz.
+         *
+         * @return Returns True when the card switched to the high-speed mode.
+         */
+        auto set_high_speed() -> bool;
+
         /* === Getters === */
         /**
          * @brief Read the RCA (Relative Card Address) of the connected
@@ -216,6 +277,25 @@ namespace sdhc
          */
         auto get_RCA() -> bool;
 
+        /**
+         * @brief Read the SD configuration register (SCR) of the
+         * selected card. It contains the supported bus widths,
+         * the version of the specification and whether the card
+         * supports CMD23.
+         *
+         * @return Returns True when the SCR was read successfully.
+         */
+        auto get_SCR() -> bool;
+
+        /**
+         * @brief Read the SD status register (SSR) of the
+         * selected card. It contains the speed class and the
+         * size of the allocation unit.
+         *
+         * @return Returns True when the SSR was read successfully.
+         */
+        auto get_SSR() -> bool;
+
         /**
          * @brief Check whether the card is a **SDSC** card.
          *
@@ -252,6 +332,50 @@ namespace sdhc
          */
         auto read_single_block(const uint32_t *buffer_begin, uint32_t block) -> bool;
 
+        /**
+         * @brief Read consecutive blocks from the Card with one command.
+         *
+         * Uses CMD18 and stops the transfer with CMD12. When the card
+         * supports CMD23, the block count is set beforehand instead.
+         *
+         * @param buffer_begin The begin iterator of the receive buffer. It has to hold count blocks.
+         * @param block The address of the first block to read from the card.
+         * @param count The number of blocks to read.
+         * @return Returns True when all blocks were read successfully.
+         */
+        auto read_multiple_blocks(const uint32_t *buffer_begin, uint32_t block, uint32_t count) -> bool;
+
+        /**
+         * @brief Start reading consecutive blocks from the Card in the background.
+         *
+         * The data is transferred with the DMA of the bus. Poll
+         * is_transfer_finished() and call complete_transfer() afterwards.
+         * The receive buffer has to stay valid until then. When the bus
+         * has no DMA, the blocks are read immediately.
+         *
+         * @param buffer_begin The begin iterator of the receive buffer. It has to hold count blocks.
+         * @param block The address of the first block to read from the card.
+         * @param count The number of blocks to read.
+         * @return Returns True when the transfer was started successfully.
+         */
+        auto start_read_multiple_blocks(const uint32_t *buffer_begin, uint32_t block, uint32_t count) -> bool;
+
+        /**
+         * @brief Check whether the transfer which was started in the
+         * background is finished.
+         *
+         * @return Returns True when no transfer is running anymore.
+         */
+        auto is_transfer_finished() const -> bool;
+
+        /**
+         * @brief Complete the transfer which was started in the background.
+         * Stops a multiple block transfer with CMD12 when needed.
+         *
+         * @return Returns True when all blocks were transferred successfully.
+         */
+        auto complete_transfer() -> bool;
+
         /**
          * @brief Reset the SDHC card.
          *
@@ -266,6 +390,13 @@ namespace sdhc
          */
         auto select() -> bool;
 
+        /**
+         * @brief Stop an ongoing multiple block transfer with CMD12.
+         *
+         * @return Returns True when the card responded.
+         */
+        auto stop_transmission() -> bool;
+
         /**
          * @brief Write a single block from the Card.
          *
@@ -275,14 +406,89 @@ namespace sdhc
          */
         auto write_single_block(const uint32_t *buffer_begin, uint32_t block) -> bool;
 
+        /**
+         * @brief Write consecutive blocks to the Card with one command.
+         *
+         * Uses CMD25 and stops the transfer with CMD12. When the card
+         * supports CMD23, the block count is set beforehand instead.
+         *
+         * @param buffer_begin The begin iterator of the data to send. It has to hold count blocks.
+         * @param block The address of the first block to write to the card.
+         * @param count The number of blocks to write.
+         * @return Returns True when all blocks were written successfully.
+         */
+        auto write_multiple_blocks(const uint32_t *buffer_begin, uint32_t block, uint32_t count) -> bool;
+
+        /**
+         * @brief Start writing consecutive blocks to the Card in the background.
+         *
+         * The data is transferred with the DMA of the bus. Poll
+         * is_transfer_finished() and call complete_transfer() afterwards.
+         * The data has to stay valid until then. When the bus has no
+         * DMA, the blocks are written immediately.
+         *
+         * @param buffer_begin The begin iterator of the data to send. It has to hold count blocks.
+         * @param block The address of the first block to write to the card.
+         * @param count The number of blocks to write.
+         * @return Returns True when the transfer was started successfully.
+         */
+        auto start_write_multiple_blocks(const uint32_t *buffer_begin, uint32_t block, uint32_t count) -> bool;
+
         /* === Properties === */
         bool type_sdsc{true};               /**< The type of the card, true for SDSC and false for SDHC. */
+        bool supports_CMD23{false};         /**< Whether the card supports setting the block count with CMD23. */
+        bool supports_4bits{false};         /**< Whether the card supports the 4bit bus. */
+        bool supports_high_speed{false};    /**< Whether the card supports the high-speed mode. */
         State state{State::Identification}; /**< The current state of the card. */
         uint16_t RCA{0};                    /**< The relative card address of the card. */
+        uint8_t spec_version{0};            /**< The version of the specification from the SCR, CMD6 needs at least 1. */
+        uint8_t speed_class{0};             /**< The speed class of the card from the SSR. */
+        uint32_t AU_size{0};                /**< [KiB] The size of the allocation unit from the SSR. */
 
       private:
+        /* === Methods === */
+        /**
+         * @brief Tell the card that the next command is an
+         * application specific command with CMD55.
+         *
+         * @return Returns True when the card accepts the next command as ACMD.
+         */
+        auto send_app_command() -> bool;
+
+        /**
+         * @brief Check or switch a function of the card with CMD6.
+         *
+         * @param argument The mode and the functions of the groups.
+         * @param status The buffer for the 64 bytes of the switch status.
+         * @return Returns True when the status was read successfully.
+         */
+        auto switch_function(uint32_t argument, std::array<uint32_t, 16> &status) -> bool;
+
+        /**
+         * @brief Send the commands which start a block transfer.
+         * Multiple blocks preset the block count with CMD23,
+         * when the card supports it.
+         *
+         * @param command_single The command for a single block.
+         * @param command_multiple The command for multiple blocks.
+         * @param block The address of the first block.
+         * @param count The number of blocks.
+         * @return Returns True when the card accepted the commands.
+         */
+        auto send_transfer_command(uint8_t command_single, uint8_t command_multiple, uint32_t block, uint32_t count) -> bool;
+
+        /**
+         * @brief Wait for the transfer in the background and release the bus.
+         * Every other access to the card finishes the transfer first,
+         * the result is kept for complete_transfer().
+         */
+        void finish_transfer();
+
         /* === Properties === */
-        interface *mybus; /**< The pointer to the bus controller implementing the bus interface. */
+        interface *mybus;              /**< The pointer to the bus controller implementing the bus interface. */
+        bool transfer_running{false};  /**< Whether a transfer is running in the background. */
+        bool transfer_multiple{false}; /**< Whether the running transfer uses multiple blocks. */
+        bool transfer_success{true};   /**< The result of the last transfer in the background. */
     };
 
     /**
@@ -319,6 +525,48 @@ namespace sdhc
             return true;
         }
 
+        /**
+         * @brief Switch the card and the bus controller to the fastest mode
+         * both support. Call this after the initialization:
+         * - The 4bit bus is used, when the card supports it.
+         * - The SCR and SSR of the card are read.
+         * - The clock is raised to 50 MHz in high-speed mode and
+         *   to 25 MHz otherwise. The bus controller has to keep
+         *   up with the data at this rate, e.g. the SDIO controller
+         *   stops the clock with its hardware flow control.
+         * - The data timeout is set to 250 ms, the maximum time
+         *   a SDHC card needs to write a block.
+         *
+         * @param mytask The task which waits for the card.
+         * @param use_4bits Set to false, when only DAT0 is connected.
+         * @return Returns True when the bus is configured.
+         */
+        auto configure_bus(OTOS::TimedTask &mytask, const bool use_4bits = true) -> bool
+        {
+            /* Read the capabilities of the card */
+            if (not this->card.get_SCR())
+                return false;
+
+            /* Negotiate the 4bit bus */
+            if (use_4bits and this->card.supports_4bits)
+            {
+                if (not this->card.set_bus_width_4bits())
+                    return false;
+                sdio::set_bus_width(this->bus, sdio::Width::_4Bit);
+                mytask.wait_ms(10);
+            }
+
+            /* The status is already read with the new bus width */
+            if (not this->card.get_SSR())
+                return false;
+
+            /* Retune the clock and the data timeout */
+            const uint32_t clock_rate = this->card.set_high_speed() ? 50'000'000 : 25'000'000;
+            sdio::set_clock(this->bus, clock_rate);
+            sdio::set_data_timeout(this->bus, clock_rate / 4);
+            return true;
+        }
+
         /* === Properties === */
         Card card;          /**< The used SDHC card. */
         Bus_Controller bus; /**< The used bus controller. */
@@ -328,4 +576,33 @@ namespace sdhc
         interface_impl<Bus_Controller> bus_impl; /**< The implementation of the bus controller interface. */
     };
 }; // namespace sdhc
+
+namespace drive
+{
+    /* === Transfer the blocks of SD cards in the background === */
+    inline bool start_read_multiple_blocks(sdhc::Card &card, const uint32_t *buffer, const uint32_t block, const uint32_t count)
+    {
+        return card.start_read_multiple_blocks(buffer, block, count);
+    };
+    inline bool is_read_finished(sdhc::Card &card)
+    {
+        return card.is_transfer_finished();
+    };
+    inline bool complete_read(sdhc::Card &card)
+    {
+        return card.complete_transfer();
+    };
+    inline bool start_write_multiple_blocks(sdhc::Card &card, const uint32_t *buffer, const uint32_t block, const uint32_t count)
+    {
+        return card.start_write_multiple_blocks(buffer, block, count);
+    };
+    inline bool is_write_finished(sdhc::Card &card)
+    {
+        return card.is_transfer_finished();
+    };
+    inline bool complete_write(sdhc::Card &card)
+    {
+        return card.complete_transfer();
+    };
+}; // namespace drive
 #endif // SDHC_H_
\ No newline at end of file
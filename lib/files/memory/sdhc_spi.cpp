@@ -0,0 +1,438 @@
+/**
+ * OTOS - Open Tec Operating System
+ * Copyright (c) 2021 - 2024 Sebastian Oberschwendtner, sebastian.oberschwendtner@gmail.com
+ *
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+/**
+ ==============================================================================
+ * @file    sdhc_spi.cpp
+ * @author  SO
+ * @version v5.2.0
+ * @date    18-October-2026
+ * @brief   Bus interface for SD cards in SPI mode.
+ ==============================================================================
+ */
+
+/* === Includes === */
+#include "memory/sdhc_spi.h"
+#include <drivers.h>
+
+/* Provide valid instantiations */
+template class sdhc::SPI_Bus<spi::Controller, gpio::Pin, dma::Stream>;
+
+namespace sdhc
+{
+    /* === Constructors === */
+    template <class bus_controller, class gpio, class dma_stream>
+    SPI_Bus<bus_controller, gpio, dma_stream>::SPI_Bus(
+        bus_controller &bus_used,
+        gpio &cs_used)
+        : mybus{&bus_used}, cs_pin{&cs_used}
+    {
+        this->cs_pin->set_high();
+    };
+
+    /* === Setters === */
+    template <class bus_controller, class gpio, class dma_stream>
+    auto SPI_Bus<bus_controller, gpio, dma_stream>::set_dma_streams(
+        dma_stream &rx,
+        dma_stream &tx) -> SPI_Bus &
+    {
+        this->rx_stream = &rx;
+        this->tx_stream = &tx;
+        return *this;
+    };
+
+    /* === Methods === */
+    template <class bus_controller, class gpio, class dma_stream>
+    auto SPI_Bus<bus_controller, gpio, dma_stream>::send_command_no_response(
+        const uint8_t command,
+        const uint32_t argument) -> bool
+    {
+        /* Only the reset is sent, the card cannot be put inactive in SPI mode */
+        if (command != CMD<0>())
+            return true;
+
+        /* The card needs at least 74 clocks with CS high before the first command */
+        this->cs_pin->set_high();
+        for (uint8_t i = 0; i < 10; i++)
+        {
+            if (!this->transfer(0xFF))
+                return false;
+        }
+
+        /* The reset with CS low switches the card to SPI mode, then it is idle */
+        const auto response = this->send_command(command, argument);
+        this->deselect();
+        return response.value_or(0) == R1_SPI::IDLE;
+    };
+
+    template <class bus_controller, class gpio, class dma_stream>
+    auto SPI_Bus<bus_controller, gpio, dma_stream>::send_command_R1_response(
+        const uint8_t command,
+        const uint32_t argument) -> std::optional<uint32_t>
+    {
+        const bool app_command = this->app_command;
+        this->app_command = false;
+
+        /*
+         * The card is selected by its chip select and the bus stops
+         * the multiple block transfers itself, so these commands
+         * are answered without sending them.
+         */
+        if (!app_command && ((command == CMD<7>()) || (command == CMD<12>()) || (command == CMD<23>())))
+            return 0;
+
+        const auto response = this->send_command(command, argument);
+        if (!response)
+        {
+            this->deselect();
+            return {};
+        }
+
+        /* ACMD13 has a R2 response in SPI mode, the second byte is not needed */
+        const bool failed = response.value() & R1_SPI::ERRORS;
+        if (!failed && app_command && (command == ACMD<13>()) && !this->transfer(0xFF))
+        {
+            this->deselect();
+            return {};
+        }
+
+        /* The card stays selected for the data, which is read or written next */
+        if (failed || !has_data(command, app_command))
+            this->deselect();
+        return this->to_card_status(command, response.value());
+    };
+
+    template <class bus_controller, class gpio, class dma_stream>
+    auto SPI_Bus<bus_controller, gpio, dma_stream>::send_command_R2_response(
+        [[maybe_unused]] const uint8_t command,
+        [[maybe_unused]] const uint32_t argument) -> std::optional<uint32_t>
+    {
+        /* There is no card identification in SPI mode */
+        return 0;
+    };
+
+    template <class bus_controller, class gpio, class dma_stream>
+    auto SPI_Bus<bus_controller, gpio, dma_stream>::send_command_R3_response(
+        const uint8_t command,
+        const uint32_t argument) -> std::optional<uint32_t>
+    {
+        /* ACMD41 only responds with R1 in SPI mode */
+        this->app_command = false;
+        auto response = this->send_command(command, argument);
+        this->deselect();
+        if (!response || (response.value() & R1_SPI::ERRORS))
+            return {};
+
+        /* The card is busy while it is idle */
+        if (response.value() & R1_SPI::IDLE)
+            return 0;
+
+        /* Enable the CRC check of the card, which is off by default in SPI mode */
+        response = this->send_command(CMD<59>(), 1);
+        this->deselect();
+        if (response.value_or(R1_SPI::ERRORS) != 0)
+            return {};
+
+        /* The OCR contains the busy bit and the capacity status */
+        response = this->send_command(CMD<58>(), 0);
+        const auto ocr = (response.value_or(R1_SPI::ERRORS) == 0) ? this->read_register() : std::nullopt;
+        this->deselect();
+        return ocr;
+    };
+
+    template <class bus_controller, class gpio, class dma_stream>
+    auto SPI_Bus<bus_controller, gpio, dma_stream>::send_command_R6_response(
+        [[maybe_unused]] const uint8_t command,
+        [[maybe_unused]] const uint32_t argument) -> std::optional<uint32_t>
+    {
+        /* The card has no RCA in SPI mode */
+        return 0;
+    };
+
+    template <class bus_controller, class gpio, class dma_stream>
+    auto SPI_Bus<bus_controller, gpio, dma_stream>::send_command_R7_response(
+        const uint8_t command,
+        const uint32_t argument) -> std::optional<uint32_t>
+    {
+        /* The R7 response is the R1 response followed by 4 bytes */
+        this->app_command = false;
+        const auto response = this->send_command(command, argument);
+        const auto echo = (response && !(response.value() & R1_SPI::ERRORS)) ? this->read_register() : std::nullopt;
+        this->deselect();
+        return echo;
+    };
+
+    template <class bus_controller, class gpio, class dma_stream>
+    auto SPI_Bus<bus_controller, gpio, dma_stream>::read_single_block(
+        const uint32_t *buffer_begin,
+        const uint32_t *buffer_end) -> bool
+    {
+        /* The data can be shorter than a block, e.g. for registers */
+        auto *data = reinterpret_cast<uint8_t *>(const_cast<uint32_t *>(buffer_begin));
+        const bool read = this->read_data(data, (buffer_end - buffer_begin) * 4);
+        this->deselect();
+        return read;
+    };
+
+    template <class bus_controller, class gpio, class dma_stream>
+    auto SPI_Bus<bus_controller, gpio, dma_stream>::write_single_block(
+        const uint32_t *buffer_begin,
+        const uint32_t *buffer_end) -> bool
+    {
+        const auto *data = reinterpret_cast<const uint8_t *>(buffer_begin);
+        const bool written = this->write_data(Token::Start_Block, data, (buffer_end - buffer_begin) * 4);
+        this->deselect();
+        return written;
+    };
+
+    template <class bus_controller, class gpio, class dma_stream>
+    auto SPI_Bus<bus_controller, gpio, dma_stream>::read_multiple_blocks(
+        const uint32_t *buffer_begin,
+        const uint32_t *buffer_end) -> bool
+    {
+        /* Every block has its own token and CRC */
+        auto *data = reinterpret_cast<uint8_t *>(const_cast<uint32_t *>(buffer_begin));
+        const auto *end = reinterpret_cast<const uint8_t *>(buffer_end);
+        bool read = true;
+        for (; read && (data < end); data += BLOCKLENGTH)
+            read = this->read_data(data, BLOCKLENGTH);
+
+        /* Stop the card from sending further blocks */
+        const bool stopped = (this->send_command(CMD<12>(), 0).value_or(R1_SPI::ERRORS) == 0) && this->wait_ready();
+        this->deselect();
+        return read && stopped;
+    };
+
+    template <class bus_controller, class gpio, class dma_stream>
+    auto SPI_Bus<bus_controller, gpio, dma_stream>::write_multiple_blocks(
+        const uint32_t *buffer_begin,
+        const uint32_t *buffer_end) -> bool
+    {
+        /* Every block has its own token and CRC */
+        const auto *data = reinterpret_cast<const uint8_t *>(buffer_begin);
+        const auto *end = reinterpret_cast<const uint8_t *>(buffer_end);
+        bool written = true;
+        for (; written && (data < end); data += BLOCKLENGTH)
+            written = this->write_data(Token::Start_Multiple_Write, data, BLOCKLENGTH);
+
+        /* The stop token is followed by one byte before the card is busy */
+        const bool stopped = this->transfer(Token::Stop_Multiple_Write) && this->transfer(0xFF) && this->wait_ready();
+        this->deselect();
+        return written && stopped;
+    };
+
+    template <class bus_controller, class gpio, class dma_stream>
+    void SPI_Bus<bus_controller, gpio, dma_stream>::deselect()
+    {
+        this->cs_pin->set_high();
+        this->transfer(0xFF);
+    };
+
+    template <class bus_controller, class gpio, class dma_stream>
+    auto SPI_Bus<bus_controller, gpio, dma_stream>::has_data(
+        const uint8_t command,
+        const bool app_command) -> bool
+    {
+        if (app_command)
+            return (command == ACMD<13>()) || (command == ACMD<22>()) || (command == ACMD<51>());
+        return (command == CMD<6>()) || (command == CMD<9>()) || (command == CMD<10>()) ||
+               (command == CMD<17>()) || (command == CMD<18>()) ||
+               (command == CMD<24>()) || (command == CMD<25>());
+    };
+
+    template <class bus_controller, class gpio, class dma_stream>
+    auto SPI_Bus<bus_controller, gpio, dma_stream>::read_data(
+        uint8_t *data,
+        const std::size_t length) -> bool
+    {
+        /* Wait for the start token, any other byte than 0xFF is an error token */
+        std::optional<uint8_t> token{0xFF};
+        for (uint32_t i = 0; (i < max_polls) && (token == 0xFF); i++)
+            token = this->transfer(0xFF);
+        if (token != Token::Start_Block)
+            return false;
+
+        /* Receive the data and check its CRC */
+        if (!this->transfer_block(data, nullptr, length))
+            return false;
+        const auto high = this->transfer(0xFF);
+        const auto low = this->transfer(0xFF);
+        if (!high || !low)
+            return false;
+        return ((high.value() << 8) | low.value()) == crc16(data, length);
+    };
+
+    template <class bus_controller, class gpio, class dma_stream>
+    auto SPI_Bus<bus_controller, gpio, dma_stream>::read_register() -> std::optional<uint32_t>
+    {
+        uint32_t value = 0;
+        for (uint8_t i = 0; i < 4; i++)
+        {
+            const auto byte = this->transfer(0xFF);
+            if (!byte)
+                return {};
+            value = (value << 8) | byte.value();
+        }
+        return value;
+    };
+
+    template <class bus_controller, class gpio, class dma_stream>
+    auto SPI_Bus<bus_controller, gpio, dma_stream>::send_command(
+        const uint8_t command,
+        const uint32_t argument) -> std::optional<uint8_t>
+    {
+        this->cs_pin->set_low();
+
+        /*
+         * Wait while the card is busy. Not for the reset, and not for
+         * CMD12 which interrupts the data the card is sending.
+         */
+        if ((command != CMD<0>()) && (command != CMD<12>()) && !this->wait_ready())
+            return {};
+
+        /* The frame is protected by a CRC7 */
+        std::array<uint8_t, 6> frame{
+            static_cast<uint8_t>(0x40 | command),
+            static_cast<uint8_t>(argument >> 24),
+            static_cast<uint8_t>(argument >> 16),
+            static_cast<uint8_t>(argument >> 8),
+            static_cast<uint8_t>(argument),
+            0};
+        frame[5] = (crc7(frame.data(), 5) << 1) | 1;
+        for (const uint8_t byte : frame)
+        {
+            if (!this->transfer(byte))
+                return {};
+        }
+
+        /* CMD12 is followed by a stuff byte */
+        if ((command == CMD<12>()) && !this->transfer(0xFF))
+            return {};
+
+        /* The response follows within 8 bytes and starts with a 0 */
+        for (uint8_t i = 0; i < 8; i++)
+        {
+            const auto response = this->transfer(0xFF);
+            if (!response)
+                return {};
+            if (!(response.value() & 0x80))
+                return response;
+        }
+        return {};
+    };
+
+    template <class bus_controller, class gpio, class dma_stream>
+    auto SPI_Bus<bus_controller, gpio, dma_stream>::to_card_status(
+        const uint8_t command,
+        const uint8_t response) -> uint32_t
+    {
+        uint32_t status = 0;
+        if (response & R1_SPI::ILLEGAL_COMMAND)
+            status |= R1::ILLEGAL_CMD;
+        if (response & R1_SPI::ERRORS)
+            status |= R1::ERROR;
+
+        /* The card accepts an application command next */
+        if ((command == CMD<55>()) && !(response & R1_SPI::ERRORS))
+        {
+            status |= R1::APP_CMD;
+            this->app_command = true;
+        }
+        return status;
+    };
+
+    template <class bus_controller, class gpio, class dma_stream>
+    auto SPI_Bus<bus_controller, gpio, dma_stream>::transfer(const uint8_t data) -> std::optional<uint8_t>
+    {
+        return bus::transfer_byte(*this->mybus, data);
+    };
+
+    template <class bus_controller, class gpio, class dma_stream>
+    auto SPI_Bus<bus_controller, gpio, dma_stream>::transfer_block(
+        uint8_t *rx,
+        const uint8_t *tx,
+        const std::size_t length) -> bool
+    {
+        /* Without DMA every byte is exchanged by the controller */
+        if (!this->rx_stream || !this->tx_stream)
+        {
+            for (std::size_t i = 0; i < length; i++)
+            {
+                const auto byte = this->transfer(tx ? tx[i] : 0xFF);
+                if (!byte)
+                    return false;
+                if (rx)
+                    rx[i] = byte.value();
+            }
+            return true;
+        }
+
+        /*
+         * The RX stream always runs, so that the receive buffer does
+         * not overrun. Without data the streams use a single byte.
+         */
+        this->rx_stream->assign_memory(rx ? *rx : this->discard, rx != nullptr).set_number_of_transfers(length);
+        this->tx_stream->assign_memory(tx ? *tx : this->fill, tx != nullptr).set_number_of_transfers(length);
+        bool complete = this->rx_stream->enable() && this->tx_stream->enable();
+
+        /* Wait until the last byte is received */
+        for (uint32_t i = 0; complete && !this->rx_stream->is_transfer_complete(); i++)
+        {
+            if ((i >= max_polls) || this->rx_stream->is_transfer_error() || this->tx_stream->is_transfer_error())
+                complete = false;
+        }
+        this->tx_stream->disable();
+        this->rx_stream->disable();
+        return complete;
+    };
+
+    template <class bus_controller, class gpio, class dma_stream>
+    auto SPI_Bus<bus_controller, gpio, dma_stream>::wait_ready() -> bool
+    {
+        /* The card holds the data line low while it is busy */
+        for (uint32_t i = 0; i < max_polls; i++)
+        {
+            const auto byte = this->transfer(0xFF);
+            if (!byte)
+                return false;
+            if (byte.value() == 0xFF)
+                return true;
+        }
+        return false;
+    };
+
+    template <class bus_controller, class gpio, class dma_stream>
+    auto SPI_Bus<bus_controller, gpio, dma_stream>::write_data(
+        const uint8_t token,
+        const uint8_t *data,
+        const std::size_t length) -> bool
+    {
+        /* The block is framed by the token and the CRC16 */
+        const uint16_t crc = crc16(data, length);
+        if (!this->transfer(token) || !this->transfer_block(nullptr, data, length) ||
+            !this->transfer(crc >> 8) || !this->transfer(crc & 0xFF))
+            return false;
+
+        /* The card responds whether it accepted the data and is busy while programming it */
+        const auto response = this->transfer(0xFF);
+        if ((response.value_or(0) & Token::Data_Response) != Token::Data_Accepted)
+            return false;
+        return this->wait_ready();
+    };
+}; // namespace sdhc
@@ -0,0 +1,254 @@
+/**
+ * OTOS - Open Tec Operating System
+ * Copyright (c) 2021 - 2024 Sebastian Oberschwendtner, sebastian.oberschwendtner@gmail.com
+ *
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef SDHC_SPI_H_
+#define SDHC_SPI_H_
+
+/* === Includes === */
+#include "memory/sdhc.h"
+
+namespace sdhc
+{
+    /* === Functions === */
+    /**
+     * @brief Compute the CRC7 which protects the commands
+     * in SPI mode.
+     *
+     * @param data The data.
+     * @param length The number of bytes.
+     * @return The CRC7 in the lower 7 bits.
+     */
+    inline auto crc7(const uint8_t *data, const std::size_t length) -> uint8_t
+    {
+        uint8_t crc = 0;
+        for (std::size_t i = 0; i < length; i++)
+        {
+            uint8_t byte = data[i];
+            for (uint8_t bit = 0; bit < 8; bit++)
+            {
+                crc <<= 1;
+                if ((byte ^ crc) & 0x80)
+                    crc ^= 0x09;
+                byte <<= 1;
+            }
+        }
+        return crc & 0x7F;
+    };
+
+    /**
+     * @brief Compute the CRC16 (CCITT) which protects
+     * the data blocks in SPI mode.
+     *
+     * @param data The data.
+     * @param length The number of bytes.
+     * @return The CRC16 of the data.
+     */
+    inline auto crc16(const uint8_t *data, const std::size_t length) -> uint16_t
+    {
+        /* Nibble table, which is a compromise between speed and flash size */
+        constexpr std::array<uint16_t, 16> table{
+            0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+            0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF};
+
+        uint16_t crc = 0;
+        for (std::size_t i = 0; i < length; i++)
+        {
+            crc = (crc << 4) ^ table[(crc >> 12) ^ (data[i] >> 4)];
+            crc = (crc << 4) ^ table[(crc >> 12) ^ (data[i] & 0x0F)];
+        }
+        return crc;
+    };
+
+    /* === Enums === */
+    /* The R1 response bits in SPI mode */
+    enum R1_SPI : uint8_t
+    {
+        IDLE = (1U << 0),            // Card is running the initialization
+        ILLEGAL_COMMAND = (1U << 2), // Illegal command
+        COM_CRC_ERROR = (1U << 3),   // CRC of the last command failed
+        ERRORS = 0b01111100          // All error bits
+    };
+
+    /* The tokens of the data transfers in SPI mode */
+    enum Token : uint8_t
+    {
+        Start_Block = 0xFE,          // Starts a data block, except for the blocks of a multiple block write
+        Start_Multiple_Write = 0xFC, // Starts a data block of a multiple block write
+        Stop_Multiple_Write = 0xFD,  // Stops a multiple block write
+        Data_Accepted = 0b00101,     // Data response when the block was accepted
+        Data_Response = 0b11111      // Mask for the status of the data response
+    };
+
+    /* === Classes === */
+    /**
+     * @brief Bus interface for SD cards in SPI mode, for
+     * microcontrollers without a SDIO peripheral:
+     *
+     * sdhc::SPI_Bus<spi::Controller, gpio::Pin, dma::Stream> bus{spi, cs};
+     * sdhc::Card card{bus};
+     *
+     * The bus translates the commands of the card to SPI mode,
+     * so the card and the volume are used as with the SDIO bus.
+     * SPI mode has no card identification, the card is selected
+     * with its chip select. Multiple block transfers are stopped
+     * by the bus, so CMD12 and CMD23 of the card are answered
+     * without sending them. The card only accepts a clock of up to
+     * 400 kHz until it is initialized.
+     *
+     * @tparam bus_controller The SPI controller class.
+     * @tparam gpio The pin class of the chip select.
+     * @tparam dma_stream The DMA stream class for the data blocks.
+     */
+    template <class bus_controller, class gpio, class dma_stream>
+    class SPI_Bus final : public interface
+    {
+      public:
+        /* === Constructors === */
+        SPI_Bus() = delete;
+
+        /**
+         * @brief Constructor for the SPI bus of a SD card.
+         * @param bus_used The reference to the used SPI controller.
+         * @param cs_used The reference to the chip select pin of the card.
+         */
+        SPI_Bus(bus_controller &bus_used, gpio &cs_used);
+
+        /* === Setters === */
+        /**
+         * @brief Transfer the data blocks with DMA. The streams
+         * have to be created with create_dma_stream() of the SPI
+         * controller, the RX stream with peripheral_to_memory and
+         * the TX stream with memory_to_peripheral. Without streams
+         * the blocks are transferred byte by byte.
+         *
+         * @param rx The stream which receives the data.
+         * @param tx The stream which clocks the data.
+         * @return SPI_Bus& Reference to the bus.
+         */
+        auto set_dma_streams(dma_stream &rx, dma_stream &tx) -> SPI_Bus &;
+
+        /* === Methods === */
+        auto send_command_no_response(uint8_t command, uint32_t argument) -> bool final;
+        auto send_command_R1_response(uint8_t command, uint32_t argument) -> std::optional<uint32_t> final;
+        auto send_command_R2_response(uint8_t command, uint32_t argument) -> std::optional<uint32_t> final;
+        auto send_command_R3_response(uint8_t command, uint32_t argument) -> std::optional<uint32_t> final;
+        auto send_command_R6_response(uint8_t command, uint32_t argument) -> std::optional<uint32_t> final;
+        auto send_command_R7_response(uint8_t command, uint32_t argument) -> std::optional<uint32_t> final;
+        auto read_single_block(const uint32_t *buffer_begin, const uint32_t *buffer_end) -> bool final;
+        auto write_single_block(const uint32_t *buffer_begin, const uint32_t *buffer_end) -> bool final;
+        auto read_multiple_blocks(const uint32_t *buffer_begin, const uint32_t *buffer_end) -> bool final;
+        auto write_multiple_blocks(const uint32_t *buffer_begin, const uint32_t *buffer_end) -> bool final;
+
+        /* === Parameters === */
+        static constexpr uint32_t max_polls = 500'000; /**< The number of bytes to wait for a busy card. */
+
+      private:
+        /* === Methods === */
+        /**
+         * @brief Release the chip select, the card releases
+         * the data line with the next clock.
+         */
+        void deselect();
+
+        /**
+         * @brief Check whether a command is followed by data.
+         * @param command The command index.
+         * @param app_command Whether the command is an application command.
+         * @return Returns True when the command has a data phase.
+         */
+        static auto has_data(uint8_t command, bool app_command) -> bool;
+
+        /**
+         * @brief Read a data block, which is started by a token
+         * and protected by a CRC16.
+         * @param data The buffer for the data.
+         * @param length The number of bytes.
+         * @return Returns True when the data was received.
+         */
+        auto read_data(uint8_t *data, std::size_t length) -> bool;
+
+        /**
+         * @brief Read a register which follows the R1 response.
+         * @return The register, MSB first.
+         */
+        auto read_register() -> std::optional<uint32_t>;
+
+        /**
+         * @brief Select the card and send a command frame.
+         * The card stays selected.
+         * @param command The command index.
+         * @param argument The argument of the command.
+         * @return The R1 response of the card.
+         */
+        auto send_command(uint8_t command, uint32_t argument) -> std::optional<uint8_t>;
+
+        /**
+         * @brief Convert a R1 response in SPI mode to the card
+         * status of the SD bus.
+         * @param command The command index.
+         * @param response The R1 response in SPI mode.
+         * @return The card status.
+         */
+        auto to_card_status(uint8_t command, uint8_t response) -> uint32_t;
+
+        /**
+         * @brief Exchange one byte with the card.
+         * @param data The byte to send.
+         * @return The received byte.
+         */
+        auto transfer(uint8_t data) -> std::optional<uint8_t>;
+
+        /**
+         * @brief Exchange the data of a block. Uses the DMA
+         * streams when they are set.
+         * @param rx The buffer for the received data, nullptr to discard it.
+         * @param tx The data to send, nullptr to send 0xFF.
+         * @param length The number of bytes.
+         * @return Returns True when the data was exchanged.
+         */
+        auto transfer_block(uint8_t *rx, const uint8_t *tx, std::size_t length) -> bool;
+
+        /**
+         * @brief Wait until the card releases the data line.
+         * @return Returns True when the card is ready.
+         */
+        auto wait_ready() -> bool;
+
+        /**
+         * @brief Write a data block with its token and the CRC16.
+         * @param token The start token of the block.
+         * @param data The data of the block.
+         * @param length The number of bytes.
+         * @return Returns True when the card accepted and programmed the data.
+         */
+        auto write_data(uint8_t token, const uint8_t *data, std::size_t length) -> bool;
+
+        /* === Properties === */
+        bus_controller *mybus;           /**< The SPI controller. */
+        gpio *cs_pin;                    /**< The chip select of the card. */
+        dma_stream *rx_stream{nullptr};  /**< The DMA stream which receives the data blocks. */
+        dma_stream *tx_stream{nullptr};  /**< The DMA stream which clocks the data blocks. */
+        bool app_command{false};         /**< The card accepted CMD55 for the next command. */
+        uint8_t fill{0xFF};              /**< The byte which clocks the card while receiving. */
+        uint8_t discard{0};              /**< The sink for received bytes which are not needed. */
+    };
+}; // namespace sdhc
+
+#endif // SDHC_SPI_H_
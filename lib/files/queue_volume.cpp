@@ -0,0 +1,39 @@
+/**
+ * OTOS - Open Tec Operating System
+ * Copyright (c) 2022 - 2024 Sebastian Oberschwendtner, sebastian.oberschwendtner@gmail.com
+ *
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ ==============================================================================
+ * @file    queue_volume.cpp
+ * @author  SO
+ * @version v5.2.0
+ * @date    18-October-2026
+ * @brief   Volumes and files of the clients of a storage thread.
+ ==============================================================================
+ */
+
+/* === Includes === */
+/* The functions to interface with the queue have to be known by the volume */
+#include "memory/queue.h"
+#include "volumes.cpp"
+#include "file.cpp"
+
+/* Provide valid template instantiations */
+template class fat32::Volume<drive::Queue_Memory<drive::Queue<sdhc::Card, 8>>>;
+template class fat32::File<fat32::Volume<drive::Queue_Memory<drive::Queue<sdhc::Card, 8>>>>;
@@ -29,9 +29,11 @@
 
 /* === Includes === */
 #include "volumes.h"
+#include <profile.h>
 
 /* Provide valid template instantiations */
 template class fat32::Volume<sdhc::Card>;
+template class fat32::Volume<drive::Cache<sdhc::Card, 8>>;
 
 namespace fat32
 {
@@ -46,6 +48,8 @@ namespace fat32
     template <class Memory>
     auto Volume<Memory>::read_cluster(Filehandler &file, const uint32_t cluster) -> bool
     {
+        OTOS_PROFILE("fat32.read_cluster");
+
         /* Set the current position in the filehandler */
         file.current.sector = 1;
         file.current.cluster = cluster;
@@ -61,24 +65,77 @@ namespace fat32
     };
 
     template <class Memory>
-    auto Volume<Memory>::read_FAT_entry(const uint32_t cluster) -> std::optional<uint32_t>
+    auto Volume<Memory>::read_sectors_of_cluster(
+        const uint32_t *buffer,
+        const uint32_t cluster,
+        const uint32_t sector,
+        const uint32_t count) -> bool
     {
-        /* Read the FAT */
-        const uint32_t block = this->partition.get_FAT_sector(cluster, 1);
+        OTOS_PROFILE("fat32.read_sectors");
 
-        /* When sector is not already in buffer read it from memory */
-        if (block != this->FAT_sector_in_buffer)
-        {
-            /* Convert the byte buffer to a 32-bit buffer for transfer with memory */
-            const uint32_t *buffer = reinterpret_cast<uint32_t *>(this->FAT.begin());
+        /* The sectors have to be within the cluster */
+        if ((count == 0) || (sector + count > this->partition.Sectors_per_Cluster))
+            return false;
 
-            /* Read the memory */
-            if (not drive::read_single_block(this->memory, buffer, block))
-                return {};
+        /* Read all sectors with one transfer */
+        const uint32_t block = this->partition.get_LBA_of_cluster(cluster) + sector;
+        return drive::read_multiple_blocks(this->memory, buffer, block, count);
+    };
 
-            /* Update the current sector in the buffer */
-            this->FAT_sector_in_buffer = block;
-        }
+    template <class Memory>
+    auto Volume<Memory>::start_read_sectors_of_cluster(
+        const uint32_t *buffer,
+        const uint32_t cluster,
+        const uint32_t sector,
+        const uint32_t count) -> bool
+    {
+        OTOS_PROFILE("fat32.start_read_sectors");
+
+        /* The sectors have to be within the cluster */
+        if ((count == 0) || (sector + count > this->partition.Sectors_per_Cluster))
+            return false;
+
+        /* Start the transfer of all sectors */
+        const uint32_t block = this->partition.get_LBA_of_cluster(cluster) + sector;
+        return drive::start_read_multiple_blocks(this->memory, buffer, block, count);
+    };
+
+    template <class Memory>
+    auto Volume<Memory>::complete_read() -> bool
+    {
+        YIELD_WHILE(not drive::is_read_finished(this->memory));
+        return drive::complete_read(this->memory);
+    };
+
+    template <class Memory>
+    auto Volume<Memory>::start_write_sectors_of_cluster(
+        const uint32_t *buffer,
+        const uint32_t cluster,
+        const uint32_t sector,
+        const uint32_t count) -> bool
+    {
+        /* The sectors have to be within the cluster */
+        if ((count == 0) || (sector + count > this->partition.Sectors_per_Cluster))
+            return false;
+
+        /* Start the transfer of all sectors */
+        const uint32_t block = this->partition.get_LBA_of_cluster(cluster) + sector;
+        return drive::start_write_multiple_blocks(this->memory, buffer, block, count);
+    };
+
+    template <class Memory>
+    auto Volume<Memory>::complete_write() -> bool
+    {
+        YIELD_WHILE(not drive::is_write_finished(this->memory));
+        return drive::complete_write(this->memory);
+    };
+
+    template <class Memory>
+    auto Volume<Memory>::read_FAT_entry(const uint32_t cluster) -> std::optional<uint32_t>
+    {
+        /* Read the FAT */
+        if (not this->load_FAT_sector(this->partition.get_FAT_sector(cluster, 1)))
+            return {};
 
         /* Read the FAT entry and return it. */
         const uint16_t position = this->partition.get_FAT_position(cluster);
@@ -91,38 +148,119 @@ namespace fat32
         const uint32_t FAT_Entry) -> bool
     {
         /* get the LBA address of the block containing the FAT entry */
-        uint32_t lba_address = this->partition.get_FAT_sector(cluster, 1);
-
-        /* Convert the byte buffer to a 32-bit buffer for transfer with memory */
-        const uint32_t *buffer = reinterpret_cast<uint32_t *>(this->FAT.begin());
+        const uint32_t lba_address = this->partition.get_FAT_sector(cluster, 1);
 
         /* When sector is not already in buffer read it from memory */
-        if (lba_address != this->FAT_sector_in_buffer)
-        {
-            /* Read the sector from memory */
-            if (not drive::read_single_block(this->memory, buffer, lba_address))
-                return false;
+        if (not this->load_FAT_sector(lba_address))
+            return false;
 
-            /* Update the current sector in the buffer */
-            this->FAT_sector_in_buffer = lba_address;
+        /* Keep track of allocated and freed clusters */
+        const uint16_t position = this->partition.get_FAT_position(cluster);
+        const uint32_t old_entry = this->partition.read_FAT(this->FAT.begin(), position);
+        if ((old_entry == FAT_Code::Empty) != (FAT_Entry == FAT_Code::Empty))
+        {
+            const bool freed = (FAT_Entry == FAT_Code::Empty);
+            const uint32_t sector = lba_address - this->partition.FAT_Begin;
+            if (this->free_count != FSInfo::UNKNOWN)
+                this->free_count += freed ? 1 : -1;
+            if (sector < this->scan_sector)
+                this->scan_free += freed ? 1 : -1;
+            if (freed)
+                this->set_FAT_sector_full(sector, false);
+            else
+                this->next_free = cluster + 1;
+            this->FS_info_changed = true;
         }
 
-        /* Write the new entry in the buffer */
-        const uint16_t position = this->partition.get_FAT_position(cluster);
+        /* Write the new entry in the buffer, the sector is written to the memory later */
         this->partition.write_FAT(this->FAT.begin(), position, FAT_Entry);
+        this->update_chains(cluster, FAT_Entry);
+        this->FAT_changed = true;
+        return true;
+    };
+
+    template <class Memory>
+    auto Volume<Memory>::load_FAT_sector(const uint32_t block) -> bool
+    {
+        /* The sector is already in the buffer */
+        if (block == this->FAT_sector_in_buffer)
+            return true;
+
+        /* Write the changed sector before the buffer is reused */
+        if (not this->flush_FAT())
+            return false;
+
+        /* Convert the byte buffer to a 32-bit buffer for transfer with memory */
+        const uint32_t *buffer = reinterpret_cast<uint32_t *>(this->FAT.begin());
+
+        /* Read the memory */
+        if (not drive::read_single_block(this->memory, buffer, block))
+            return false;
+
+        /* Update the current sector in the buffer */
+        this->FAT_sector_in_buffer = block;
+        return true;
+    };
+
+    template <class Memory>
+    auto Volume<Memory>::flush_FAT() -> bool
+    {
+        if (not this->FAT_changed)
+            return true;
+
+        /* Convert the byte buffer to a 32-bit buffer for transfer with memory */
+        const uint32_t *buffer = reinterpret_cast<uint32_t *>(this->FAT.begin());
+        const uint32_t block = this->FAT_sector_in_buffer;
 
         /* Write the new data to FAT 1 in the memory */
-        if (not drive::write_single_block(this->memory, buffer, lba_address))
+        if (not drive::write_single_block(this->memory, buffer, block))
             return false;
 
-        /* Write the new data to FAT 2 in the memory */
-        lba_address = this->partition.get_FAT_sector(cluster, 2);
-        return drive::write_single_block(this->memory, buffer, lba_address);
+        /* Write the new data to FAT 2 in the memory or remember the sector for the next sync */
+        if (this->mirror_on_sync)
+        {
+            this->mirror_begin = std::min(this->mirror_begin, block);
+            this->mirror_end = std::max(this->mirror_end, block);
+        }
+        else if (not drive::write_single_block(this->memory, buffer, block + this->partition.FAT_Size))
+            return false;
+
+        this->FAT_changed = false;
+        return true;
+    };
+
+    template <class Memory>
+    auto Volume<Memory>::mirror_FAT() -> bool
+    {
+        /* Convert the byte buffer to a 32-bit buffer for transfer with memory */
+        const uint32_t *buffer = reinterpret_cast<uint32_t *>(this->FAT.begin());
+
+        /* Copy the changed sectors of FAT 1 to FAT 2 */
+        for (; this->mirror_begin <= this->mirror_end; this->mirror_begin++)
+        {
+            if (not this->load_FAT_sector(this->mirror_begin))
+                return false;
+            if (not drive::write_single_block(this->memory, buffer, this->mirror_begin + this->partition.FAT_Size))
+                return false;
+        }
+
+        /* Both FATs are equal */
+        this->mirror_begin = 0xFFFFFFFF;
+        this->mirror_end = 0;
+        return true;
+    };
+
+    template <class Memory>
+    void Volume<Memory>::set_FAT_mirroring(const bool on_sync)
+    {
+        this->mirror_on_sync = on_sync;
     };
 
     template <class Memory>
     auto Volume<Memory>::read_next_sector_of_cluster(Filehandler &file) -> bool
     {
+        OTOS_PROFILE("fat32.read_next_sector");
+
         /* Convert the byte buffer to a 32-bit buffer for transfer with memory */
         const uint32_t *buffer = reinterpret_cast<uint32_t *>(file.block_buffer.begin());
 
@@ -137,40 +275,18 @@ namespace fat32
         }
         else /* Next cluster has to be read */
         {
-            /* Get the FAT entry of the current cluster */
-            const auto FAT_Entry = this->read_FAT_entry(file.current.cluster);
-
-            /* When FAT could not be read return false */
-            if (not FAT_Entry)
+            /* Get the next cluster from the known chain of the file or from the FAT */
+            Chain *chain = this->get_chain(file.start_cluster);
+            std::optional<uint32_t> next_cluster{};
+            if (chain != nullptr)
+                next_cluster = chain->get_next_cluster(file.current.cluster);
+            if (not next_cluster)
+                next_cluster = this->follow_chain(file.current.cluster, chain);
+
+            /* Read the next cluster and return */
+            if (not next_cluster)
                 return false;
-            else // Check the return code for valid content
-            {
-                /* Entry should not be zero */
-                if (FAT_Entry.value() == 0)
-                {
-                    this->error = error::Code::FAT_Corrupted;
-                    return false;
-                }
-
-                /* Get the return code and pad FAT16 entries with 1, so the same */
-                /* decoding of the entry can be used for both FATs */
-                const uint32_t code = this->partition.is_fat16 ? FAT_Entry.value() + 0xFFFF0000 : FAT_Entry.value();
-
-                /* Decode the entry */
-                if (code == FAT_Code::End_of_File)
-                {
-                    this->error = error::Code::End_of_File_Reached;
-                    return false;
-                }
-                else if (code == FAT_Code::Bad_Sector)
-                {
-                    this->error = error::Code::Bad_Sector;
-                    return false;
-                }
-            }
-
-            /* Read the next cluster according to the FAT and return */
-            return this->read_cluster(file, FAT_Entry.value());
+            return this->read_cluster(file, next_cluster.value());
         }
     };
 
@@ -189,6 +305,22 @@ namespace fat32
         return drive::write_single_block(this->memory, buffer, block);
     };
 
+    template <class Memory>
+    auto Volume<Memory>::write_sectors_of_cluster(
+        const uint32_t *buffer,
+        const uint32_t cluster,
+        const uint32_t sector,
+        const uint32_t count) -> bool
+    {
+        /* The sectors have to be within the cluster */
+        if ((count == 0) || (sector + count > this->partition.Sectors_per_Cluster))
+            return false;
+
+        /* Write all sectors with one transfer */
+        const uint32_t block = this->partition.get_LBA_of_cluster(cluster) + sector;
+        return drive::write_multiple_blocks(this->memory, buffer, block, count);
+    };
+
     template <class Memory>
     auto Volume<Memory>::get_file(Filehandler &file, const uint32_t id) -> bool
     {
@@ -200,8 +332,26 @@ namespace fat32
         }
 
         /* Set the ID of the files */
+        const uint32_t directory = file.start_cluster;
         file.id = id;
 
+        /* Use the remembered entry */
+        auto lookup = std::find_if(
+            this->lookups.begin(),
+            this->lookups.end(),
+            [directory, id](const Lookup &known)
+            { return (known.last_used != 0) && (known.directory == directory) && (known.entry.id == id); });
+        if (lookup != this->lookups.end())
+        {
+            lookup->last_used = ++this->lookup_access;
+            file.name = lookup->entry.name;
+            file.attributes = lookup->entry.attributes;
+            file.directory_cluster = lookup->cluster;
+            file.start_cluster = lookup->entry.start_cluster;
+            file.size = lookup->entry.size;
+            return true;
+        }
+
         /* Read the block from memory which contains the first file entry */
         if (not this->read_cluster(file, file.start_cluster))
             return false;
@@ -222,10 +372,56 @@ namespace fat32
         }
 
         /* When block was read, get the file properties */
+        this->remember_entry(file, id);
         file.update_properties_from_buffer();
         return true;
     };
 
+    template <class Memory>
+    auto Volume<Memory>::read_next_entry(
+        Filehandler &directory,
+        Directory_Entry &entry) -> bool
+    {
+        /* Only when provided filehandle is a directory */
+        if (directory.is_file())
+        {
+            this->error = error::Code::Not_a_Directory;
+            return false;
+        }
+
+        while (true)
+        {
+            /* Read the next sector when all entries of the current sector were checked */
+            if (directory.current.byte == 512)
+            {
+                if (not this->read_next_sector_of_cluster(directory))
+                    return false;
+                directory.current.byte = 0;
+            }
+
+            /* An empty entry marks the end of the directory */
+            const uint16_t offset = directory.current.byte;
+            const uint8_t marker = directory.block_buffer[offset];
+            if (marker == 0x00)
+            {
+                this->error = error::Code::End_of_File_Reached;
+                return false;
+            }
+
+            /* Move to the next entry */
+            const uint32_t id = directory.entry++;
+            directory.current.byte += 32;
+
+            /* Skip deleted entries and entries of long file names */
+            const uint8_t attributes = read_byte(directory.block_buffer.begin(), offset + DIR_Entry::Attributes);
+            if ((marker == 0xE5) || ((attributes & Attribute::Long_Name) == Attribute::Long_Name))
+                continue;
+
+            entry.read_from_buffer(directory.block_buffer.begin(), id);
+            return true;
+        }
+    };
+
     template <class Memory>
     auto Volume<Memory>::read_root(Filehandler &file) -> bool
     {
@@ -255,11 +451,98 @@ namespace fat32
         return true;
     };
 
+    template <class Memory>
+    auto Volume<Memory>::rewind_directory(Filehandler &directory) -> bool
+    {
+        /* Only when provided filehandle is a directory */
+        if (directory.is_file())
+        {
+            this->error = error::Code::Not_a_Directory;
+            return false;
+        }
+
+        /* Start at the first entry of the first sector */
+        directory.entry = 0;
+        directory.current.byte = 0;
+        return this->read_cluster(directory, directory.start_cluster);
+    };
+
+    template <class Memory>
+    auto Volume<Memory>::sync() -> bool
+    {
+        /* Write the changed FAT sectors to both FATs */
+        if (not this->flush_FAT() || not this->mirror_FAT())
+            return false;
+
+        /* Update the FSInfo sector */
+        if (this->FS_info_changed && (this->partition.FS_Info_Sector != 0))
+        {
+            /* Use the FAT buffer for the data transfer */
+            const uint32_t *buffer = reinterpret_cast<uint32_t *>(this->FAT.begin());
+            this->FAT_sector_in_buffer = 0xFFFFFFFF;
+            if (not drive::read_single_block(this->memory, buffer, this->partition.FS_Info_Sector))
+                return false;
+
+            /* Only write valid FSInfo sectors */
+            if (FSInfo::is_valid(this->FAT.begin()))
+            {
+                FSInfo::set_free_clusters(this->FAT.begin(), this->free_count, this->next_free);
+                if (not drive::write_single_block(this->memory, buffer, this->partition.FS_Info_Sector))
+                    return false;
+            }
+            this->FS_info_changed = false;
+        }
+
+        /* Write the data buffered by the memory */
+        return drive::sync(this->memory);
+    };
+
+    template <class Memory>
+    auto Volume<Memory>::scan_FAT(const uint32_t sectors) -> bool
+    {
+        const uint32_t entries = this->partition.is_fat16 ? 512 / 2 : 512 / 4;
+        const uint32_t max_cluster = this->partition.get_max_cluster();
+        const uint32_t last_sector = max_cluster / entries;
+
+        /* Count the free clusters of the next sectors */
+        for (uint32_t count = 0; (count < sectors) && (this->scan_sector <= last_sector); count++)
+        {
+            const uint32_t first = std::max(this->scan_sector * entries, 2U);
+            const uint32_t last = std::min(this->scan_sector * entries + entries - 1, max_cluster);
+            uint32_t free = 0;
+            for (uint32_t cluster = first; cluster <= last; cluster++)
+            {
+                const auto entry = this->read_FAT_entry(cluster);
+                if (not entry)
+                    return false;
+                if (entry.value() == FAT_Code::Empty)
+                    free++;
+            }
+            this->scan_free += free;
+            this->set_FAT_sector_full(this->scan_sector++, free == 0);
+        }
+
+        /* The scan is not finished yet */
+        if (this->scan_sector <= last_sector)
+            return false;
+
+        /* All sectors are scanned, so the free count is exact */
+        if (this->free_count != this->scan_free)
+        {
+            this->free_count = this->scan_free;
+            this->FS_info_changed = true;
+        }
+        return true;
+    };
+
     template <class Memory>
     auto Volume<Memory>::mount() -> bool
     {
-        /* Use the FAT buffer to read mount data */
+        /* Use the FAT buffer to read mount data, changes which were not synchronized are discarded */
         const uint32_t *buffer = reinterpret_cast<uint32_t *>(this->FAT.begin());
+        this->FAT_changed = false;
+        this->mirror_begin = 0xFFFFFFFF;
+        this->mirror_end = 0;
 
         /* Read first block */
         if (not drive::read_single_block(this->memory, buffer, 0))
@@ -286,6 +569,36 @@ namespace fat32
         if (not drive::read_single_block(this->memory, buffer, block_address))
             return false;
         this->partition = BPB::initialize_partition(this->FAT.begin(), block_address);
+
+        /* Reset the allocation state, the FAT buffer was used for the boot sectors */
+        this->FAT_sector_in_buffer = 0xFFFFFFFF;
+        this->free_count = FSInfo::UNKNOWN;
+        this->next_free = 2;
+        this->FS_info_changed = false;
+        this->FAT_map.reset();
+        this->scan_sector = 0;
+        this->scan_free = 0;
+        for (Chain &chain : this->chains)
+            chain.clear();
+        for (Lookup &lookup : this->lookups)
+            lookup.last_used = 0;
+
+        /* Read the free count and the allocation hint when the volume has a FSInfo sector */
+        if (this->partition.FS_Info_Sector == 0)
+            return true;
+        if (not drive::read_single_block(this->memory, buffer, this->partition.FS_Info_Sector))
+            return false;
+        if (FSInfo::is_valid(this->FAT.begin()))
+        {
+            /* Values out of range are ignored, they can be recovered with scan_FAT() */
+            const uint32_t max_cluster = this->partition.get_max_cluster();
+            const uint32_t count = FSInfo::get_free_count(this->FAT.begin());
+            const uint32_t hint = FSInfo::get_next_free(this->FAT.begin());
+            if (count < max_cluster)
+                this->free_count = count;
+            if ((hint >= 2) && (hint <= max_cluster))
+                this->next_free = hint;
+        }
         return true;
     };
 
@@ -327,24 +640,412 @@ namespace fat32
     };
 
     template <class Memory>
-    auto Volume<Memory>::get_next_empty_cluster() -> std::optional<uint32_t>
+    auto Volume<Memory>::get_cluster_of_file(
+        const Filehandler &file,
+        const uint32_t index) -> std::optional<uint32_t>
     {
-        /* Limit the number of clusters according to the filesystem */
-        const uint32_t max_cluster = this->partition.is_fat16 ? this->partition.FAT_Size * 512 / 16 : this->partition.FAT_Size * 512 / 32;
+        Chain *chain = this->get_chain(file.start_cluster);
+        uint32_t position = 0;
+        uint32_t cluster = file.start_cluster;
+
+        if (chain != nullptr)
+        {
+            /* The cluster is already known */
+            const auto known_cluster = chain->get_cluster(index);
+            if (known_cluster)
+                return known_cluster;
+
+            /* Otherwise continue at the end of the known chain */
+            position = chain->get_length() - 1;
+            cluster = chain->get_last_cluster();
+        }
 
-        /* Check FAT until cluster is empty, valid clusters start with number 2 */
-        for (uint32_t empty_cluster = 2; empty_cluster <= max_cluster; empty_cluster++)
+        /* Follow the FAT until the position is reached */
+        for (; position < index; position++)
         {
-            /* Check whether current cluster is empty */
-            if (this->read_FAT_entry(empty_cluster).value_or(1) == 0U)
-                return empty_cluster;
+            const auto next_cluster = this->follow_chain(cluster, chain);
+            if (not next_cluster)
+                return {};
+            cluster = next_cluster.value();
         }
+        return cluster;
+    };
+
+    template <class Memory>
+    auto Volume<Memory>::get_free_clusters() const -> std::optional<uint32_t>
+    {
+        if (this->free_count == FSInfo::UNKNOWN)
+            return {};
+        return this->free_count;
+    };
+
+    template <class Memory>
+    auto Volume<Memory>::get_next_empty_cluster() -> std::optional<uint32_t>
+    {
+        /* Limit the number of clusters according to the filesystem */
+        const uint32_t max_cluster = this->partition.get_max_cluster();
+
+        /* Start at the cursor and wrap around, valid clusters start with number 2 */
+        const uint32_t start = ((this->next_free >= 2) && (this->next_free <= max_cluster)) ? this->next_free : 2;
+        auto empty_cluster = this->find_empty_cluster(start, max_cluster);
+        if (not empty_cluster && (start > 2))
+            empty_cluster = this->find_empty_cluster(2, start - 1);
+        if (empty_cluster)
+            return empty_cluster;
 
         /* No empty cluster found -> drive is full */
         this->error = error::Code::No_Memory_Left;
         return {};
     };
 
+    template <class Memory>
+    auto Volume<Memory>::find_empty_cluster(
+        const uint32_t first,
+        const uint32_t last) -> std::optional<uint32_t>
+    {
+        const uint32_t entries = this->partition.is_fat16 ? 512 / 2 : 512 / 4;
+        const uint32_t max_cluster = this->partition.get_max_cluster();
+
+        /* Check the FAT sector by sector */
+        uint32_t cluster = first;
+        while (cluster <= last)
+        {
+            const uint32_t sector = cluster / entries;
+            const uint32_t sector_begin = std::max(sector * entries, 2U);
+            const uint32_t sector_end = std::min(sector * entries + entries - 1, max_cluster);
+            const uint32_t end = std::min(sector_end, last);
+
+            /* Skip sectors which are known to be full */
+            if (this->is_FAT_sector_full(sector))
+            {
+                cluster = end + 1;
+                continue;
+            }
+
+            /* Check whether one of the clusters is empty */
+            bool searched = (cluster == sector_begin) && (end == sector_end);
+            for (; cluster <= end; cluster++)
+            {
+                const auto entry = this->read_FAT_entry(cluster);
+                if (not entry)
+                    searched = false;
+                else if (entry.value() == FAT_Code::Empty)
+                    return cluster;
+            }
+
+            /* Remember the full sector */
+            if (searched)
+                this->set_FAT_sector_full(sector, true);
+        }
+        return {};
+    };
+
+    template <class Memory>
+    auto Volume<Memory>::find_empty_run(
+        const uint32_t first,
+        const uint32_t last,
+        const uint32_t count) -> std::optional<uint32_t>
+    {
+        uint32_t cluster = first;
+        while ((cluster <= last) && (last - cluster + 1 >= count))
+        {
+            /* The run starts at the next empty cluster */
+            const auto begin = this->find_empty_cluster(cluster, last);
+            if (not begin || (last - begin.value() + 1 < count))
+                return {};
+
+            /* Check whether the following clusters are empty as well */
+            uint32_t length = 1;
+            for (cluster = begin.value() + 1; length < count; cluster++, length++)
+            {
+                const auto entry = this->read_FAT_entry(cluster);
+                if (not entry)
+                    return {};
+                if (entry.value() != FAT_Code::Empty)
+                    break;
+            }
+            if (length == count)
+                return begin;
+
+            /* Continue the search behind the used cluster */
+            cluster++;
+        }
+        return {};
+    };
+
+    template <class Memory>
+    auto Volume<Memory>::preallocate(
+        Filehandler &file,
+        const uint32_t bytes) -> bool
+    {
+        /* Only files with a start cluster can be extended */
+        Chain *chain = this->get_chain(file.start_cluster);
+        if (file.is_directory() || (chain == nullptr))
+        {
+            this->error = error::Code::Not_a_File;
+            return false;
+        }
+
+        /* Find the end of the file */
+        uint32_t last_cluster = chain->get_last_cluster();
+        uint32_t allocated = chain->get_length();
+        auto next_cluster = this->follow_chain(last_cluster, chain);
+        while (next_cluster)
+        {
+            last_cluster = next_cluster.value();
+            allocated++;
+            next_cluster = this->follow_chain(last_cluster, chain);
+        }
+        if (this->error != error::Code::End_of_File_Reached)
+            return false;
+
+        /* The cluster behind the end of a file is always allocated, so writing can continue */
+        const uint64_t cluster_size = this->partition.Sectors_per_Cluster * 512;
+        const uint64_t needed = ((static_cast<uint64_t>(file.size) + bytes) / cluster_size) + 1;
+        if (needed <= allocated)
+            return true;
+        const uint32_t count = static_cast<uint32_t>(needed - allocated);
+
+        /* Search the run behind the file first, so the file stays contiguous */
+        const uint32_t max_cluster = this->partition.get_max_cluster();
+        const uint32_t start = last_cluster < max_cluster ? last_cluster + 1 : 2;
+        auto begin = this->find_empty_run(start, max_cluster, count);
+        if (not begin && (start > 2))
+            begin = this->find_empty_run(2, std::min(start + count - 2, max_cluster), count);
+        if (not begin)
+        {
+            this->error = error::Code::No_Memory_Left;
+            return false;
+        }
+
+        /* Link the run, the FAT sectors are written together when they leave the FAT buffer */
+        const uint32_t first = begin.value();
+        const uint32_t entry = this->partition.is_fat16 ? 0xFFFF : 0xFFFFFFFF;
+        for (uint32_t cluster = first; cluster < first + count - 1; cluster++)
+        {
+            if (not this->write_FAT_entry(cluster, cluster + 1))
+                return false;
+        }
+        if (not this->write_FAT_entry(first + count - 1, entry))
+            return false;
+
+        /* Append the run to the file */
+        if (not this->write_FAT_entry(last_cluster, first))
+            return false;
+
+        /* Remember the whole run, so writing does not have to read the FAT */
+        if (chain->is_used() && (chain->get_last_cluster() == first))
+        {
+            for (uint32_t cluster = first + 1; cluster < first + count; cluster++)
+                chain->append(cluster);
+            chain->complete = true;
+        }
+        return true;
+    };
+
+    template <class Memory>
+    auto Volume<Memory>::trim_file(Filehandler &file) -> bool
+    {
+        /* The cluster behind the end of a file is always allocated, so writing can continue */
+        const uint32_t cluster_size = this->partition.Sectors_per_Cluster * 512;
+        const auto last_cluster = this->get_cluster_of_file(file, file.size / cluster_size);
+        if (not last_cluster)
+            return false;
+
+        /* Check whether the file has more clusters */
+        auto next_cluster = this->get_cluster_of_file(file, (file.size / cluster_size) + 1);
+        if (not next_cluster)
+            return this->error == error::Code::End_of_File_Reached;
+
+        /* End the file first, so the freed clusters never belong to the file */
+        const uint32_t entry = this->partition.is_fat16 ? 0xFFFF : 0xFFFFFFFF;
+        if (not this->write_FAT_entry(last_cluster.value(), entry))
+            return false;
+
+        /* Free the remaining clusters */
+        while (next_cluster)
+        {
+            const uint32_t cluster = next_cluster.value();
+            next_cluster = this->follow_chain(cluster, nullptr);
+            if (not next_cluster && (this->error != error::Code::End_of_File_Reached))
+                return false;
+            if (not this->write_FAT_entry(cluster, FAT_Code::Empty))
+                return false;
+        }
+        return true;
+    };
+
+    template <class Memory>
+    auto Volume<Memory>::follow_chain(
+        const uint32_t cluster,
+        Chain *chain) -> std::optional<uint32_t>
+    {
+        /* The end of a complete chain is already known */
+        const bool is_last = (chain != nullptr) && (cluster == chain->get_last_cluster());
+        if (is_last && chain->complete)
+        {
+            this->error = error::Code::End_of_File_Reached;
+            return {};
+        }
+
+        /* Get the FAT entry of the current cluster */
+        const auto FAT_Entry = this->read_FAT_entry(cluster);
+
+        /* When FAT could not be read return false */
+        if (not FAT_Entry)
+            return {};
+
+        /* Entry should not be zero */
+        if (FAT_Entry.value() == 0)
+        {
+            this->error = error::Code::FAT_Corrupted;
+            return {};
+        }
+
+        /* Get the return code and pad FAT16 entries with 1, so the same */
+        /* decoding of the entry can be used for both FATs */
+        const uint32_t code = this->partition.is_fat16 ? FAT_Entry.value() + 0xFFFF0000 : FAT_Entry.value();
+
+        /* Decode the entry */
+        if (code == FAT_Code::Bad_Sector)
+        {
+            this->error = error::Code::Bad_Sector;
+            return {};
+        }
+
+        /* Entries beyond the last cluster, e.g. 0x0FFFFFFF, mark the end of the chain as well */
+        if ((code == FAT_Code::End_of_File) || (FAT_Entry.value() > this->partition.get_max_cluster()))
+        {
+            if (is_last)
+                chain->complete = true;
+            this->error = error::Code::End_of_File_Reached;
+            return {};
+        }
+
+        /* Remember the next cluster when it extends the known chain */
+        if (is_last)
+            chain->append(FAT_Entry.value());
+        return FAT_Entry.value();
+    };
+
+    template <class Memory>
+    auto Volume<Memory>::get_chain(const uint32_t start_cluster) -> Chain *
+    {
+        /* Valid clusters start with number 2 */
+        if (start_cluster < 2)
+            return nullptr;
+
+        /* Search the chain of the file */
+        auto chain = std::find_if(
+            this->chains.begin(),
+            this->chains.end(),
+            [start_cluster](const Chain &known)
+            { return known.is_used() && (known.extents[0].cluster == start_cluster); });
+
+        /* Replace the chain which was not used for the longest time */
+        if (chain == this->chains.end())
+        {
+            chain = std::min_element(
+                this->chains.begin(),
+                this->chains.end(),
+                [](const Chain &lhs, const Chain &rhs)
+                { return (lhs.is_used() ? lhs.last_used : 0) < (rhs.is_used() ? rhs.last_used : 0); });
+            chain->reset(start_cluster);
+        }
+        chain->last_used = ++this->chain_access;
+        return &*chain;
+    };
+
+    template <class Memory>
+    void Volume<Memory>::update_chains(
+        const uint32_t cluster,
+        const uint32_t FAT_Entry)
+    {
+        const uint32_t max_cluster = this->partition.get_max_cluster();
+        for (Chain &chain : this->chains)
+        {
+            if (not chain.is_used())
+                continue;
+
+            if (cluster == chain.get_last_cluster())
+            {
+                /* The file is extended, ends or is freed at the end of the known chain */
+                if (FAT_Entry == FAT_Code::Empty)
+                    chain.clear();
+                else if ((FAT_Entry >= 2) && (FAT_Entry <= max_cluster))
+                {
+                    chain.append(FAT_Entry);
+                    chain.complete = false;
+                }
+                else
+                    chain.complete = true;
+            }
+            else if (chain.contains(cluster))
+            {
+                /* The chain was changed before its end, so it has to be read again */
+                chain.clear();
+            }
+        }
+    };
+
+    template <class Memory>
+    auto Volume<Memory>::is_FAT_sector_full(const uint32_t sector) const -> bool
+    {
+        return (sector < this->FAT_map.size()) && this->FAT_map.test(sector);
+    };
+
+    template <class Memory>
+    void Volume<Memory>::set_FAT_sector_full(const uint32_t sector, const bool full)
+    {
+        if (sector < this->FAT_map.size())
+            this->FAT_map.set(sector, full);
+    };
+
+    template <class Memory>
+    auto Volume<Memory>::find_lookup(
+        const uint32_t directory,
+        const std::array<char, 12> &name) -> Lookup *
+    {
+        const uint32_t key = Lookup::get_key(name, directory);
+        auto lookup = std::find_if(
+            this->lookups.begin(),
+            this->lookups.end(),
+            [key, &name, directory](const Lookup &known)
+            { return known.matches(key, name, directory); });
+        if (lookup == this->lookups.end())
+            return nullptr;
+        lookup->last_used = ++this->lookup_access;
+        return &*lookup;
+    };
+
+    template <class Memory>
+    void Volume<Memory>::remember_entry(
+        const Filehandler &directory,
+        const uint32_t id)
+    {
+        /* Replace the entry with the same id or the one which was not used for the longest time */
+        auto lookup = std::find_if(
+            this->lookups.begin(),
+            this->lookups.end(),
+            [&directory, id](const Lookup &known)
+            { return (known.last_used != 0) && (known.directory == directory.start_cluster) && (known.entry.id == id); });
+        if (lookup == this->lookups.end())
+        {
+            lookup = std::min_element(
+                this->lookups.begin(),
+                this->lookups.end(),
+                [](const Lookup &lhs, const Lookup &rhs)
+                { return lhs.last_used < rhs.last_used; });
+        }
+
+        /* Read the entry from the loaded sector of the directory */
+        lookup->entry.read_from_buffer(directory.block_buffer.begin(), id);
+        lookup->key = Lookup::get_key(lookup->entry.name, directory.start_cluster);
+        lookup->directory = directory.start_cluster;
+        lookup->cluster = directory.current.cluster;
+        lookup->last_used = ++this->lookup_access;
+    };
+
     template <class Memory>
     auto Volume<Memory>::get_fileid(
         Filehandler &directory,
@@ -357,6 +1058,11 @@ namespace fat32
             return {};
         }
 
+        /* Use the remembered entry */
+        const Lookup *lookup = this->find_lookup(directory.start_cluster, filename);
+        if (lookup != nullptr)
+            return lookup->entry.id;
+
         /* The file id */
         uint32_t file_id = 0;
 
@@ -368,6 +1074,7 @@ namespace fat32
                     filename.end() - 1,
                     directory.block_buffer.begin() + entry * 32))
             {
+                this->remember_entry(directory, entry);
                 return static_cast<uint32_t>(entry);
             }
         }
@@ -386,6 +1093,7 @@ namespace fat32
                         filename.end() - 1,
                         directory.block_buffer.begin() + entry * 32))
                 {
+                    this->remember_entry(directory, file_id + entry);
                     return file_id + entry;
                 }
             }
@@ -402,19 +1110,11 @@ namespace fat32
         /* Get the number of clusters the file occupies */
         const uint32_t cluster_allocated = (file.size / 512) / this->partition.Sectors_per_Cluster;
 
-        /* Read the next clusters until the cluster where the file ends was found */
-        uint32_t cluster_offset = file.start_cluster;
-        for (uint32_t count = 0; count < cluster_allocated; count++)
-        {
-            /* Read the FAT to determine the next cluster */
-            auto next_cluster = this->read_FAT_entry(cluster_offset);
-
-            /* Check whether entry is valid */
-            if (next_cluster)
-                cluster_offset = next_cluster.value();
-            else
-                return false;
-        }
+        /* Get the cluster where the file ends from the known chain of the file */
+        const auto last_cluster = this->get_cluster_of_file(file, cluster_allocated);
+        if (not last_cluster)
+            return false;
+        const uint32_t cluster_offset = last_cluster.value();
 
         /* Get the sector address of the cluster where the file ends */
         const uint32_t cluster_lba = this->partition.get_LBA_of_cluster(cluster_offset);
@@ -440,73 +1140,117 @@ namespace fat32
     template <class Memory>
     auto Volume<Memory>::write_filesize_to_directory(Filehandler &file) -> bool
     {
+        /* The clusters of the file have to be allocated in the memory first */
+        if (not this->flush_FAT())
+            return false;
+
         /* Get the offset of the file id when sector containing it is read */
         /* 16 entries per sector, one sectors has 32 bytes */
         const uint16_t entry_offset = (file.id % 16) * 32;
 
+        /* The position of the file is restored afterwards, so writing can continue */
+        const Filehandler::Counter position = file.current;
+
         /* Read the directory cluster of the file */
-        if (not this->read_cluster(file, file.directory_cluster))
-            return false;
+        bool success = this->read_cluster(file, file.directory_cluster);
 
         /* Read additional sectors if necessary */
         const uint32_t sector_offset = file.id / 16;
-        for (uint32_t count = 0; count < sector_offset; count++)
+        for (uint32_t count = 0; success && (count < sector_offset); count++)
         {
             /* Keep reading sectors */
-            if (not this->read_next_sector_of_cluster(file))
-                return false;
+            success = this->read_next_sector_of_cluster(file);
         }
 
-        /* Update the entry */
-        write_long(file.block_buffer.begin(), entry_offset + DIR_Entry::Filesize, file.size);
+        /* Update the entry and write it to memory again */
+        if (success)
+        {
+            write_long(file.block_buffer.begin(), entry_offset + DIR_Entry::Filesize, file.size);
+            success = this->write_current_sector(file);
+        }
 
-        /* Write entry to memory again */
-        return this->write_current_sector(file);
+        /* Keep the remembered entry up to date */
+        for (Lookup &lookup : this->lookups)
+        {
+            if ((lookup.last_used != 0) && (lookup.cluster == file.directory_cluster) && (lookup.entry.id == file.id))
+                lookup.entry.size = file.size;
+        }
+        file.current = position;
+        return success;
     };
 
     template <class Memory>
     auto Volume<Memory>::write_file_to_memory(Filehandler &file) -> bool
     {
-        /* Get the current location of the file in memory */
-        const uint32_t cluster = file.current.cluster;
-        const uint32_t sector = file.current.sector;
-
         /* Write the file buffer to the memory location */
         if (not this->write_current_sector(file))
             return false;
 
         /* When the current sector is full, update the filehandle */
         if (file.current.byte == 512)
-        {
-            /* Reset the byte counter */
-            file.current.byte = 0;
+            return this->move_to_next_sector(file);
+        return true;
+    };
 
-            /* Check whether cluster is full */
-            if (sector < this->partition.Sectors_per_Cluster)
-                file.current.sector++;
-            else /* When current cluster is full, allocate the next empty cluster  */
-            {
-                /* Get next empty cluster */
-                auto next_cluster = this->get_next_empty_cluster();
+    template <class Memory>
+    auto Volume<Memory>::move_to_next_sector(Filehandler &file) -> bool
+    {
+        /* Get the current location of the file in memory */
+        const uint32_t cluster = file.current.cluster;
+        const uint32_t sector = file.current.sector;
 
-                /* When next cluster was found, allocate it */
-                if (not next_cluster)
-                    return false;
+        /* Reset the byte counter */
+        file.current.byte = 0;
 
-                /* Set current cluster */
-                if (not this->write_FAT_entry(cluster, next_cluster.value()))
-                    return false;
+        /* Check whether cluster is full */
+        if (sector < this->partition.Sectors_per_Cluster)
+        {
+            file.current.sector++;
+            return true;
+        }
 
-                /* Set next cluster to end-of-file */
-                const uint32_t entry = this->partition.is_fat16 ? 0xFFFF : 0xFFFFFFFF;
-                if (not this->write_FAT_entry(next_cluster.value(), entry))
-                    return false;
+        /* When current cluster is full, continue with the next cluster of the file */
+        /* The chain of the file is tracked, so new clusters are remembered */
+        Chain *chain = this->get_chain(file.start_cluster);
 
-                /* Update the filehandle */
-                file.current.cluster = next_cluster.value();
-                file.current.sector = 1;
+        /* Clusters which already belong to the file are overwritten */
+        std::optional<uint32_t> next_cluster{};
+        if (chain != nullptr)
+        {
+            next_cluster = chain->get_next_cluster(cluster);
+            if (not next_cluster && not chain->complete)
+            {
+                next_cluster = this->follow_chain(cluster, chain);
+                if (not next_cluster && (this->error != error::Code::End_of_File_Reached))
+                    return false;
             }
         }
+        if (next_cluster)
+        {
+            file.current.cluster = next_cluster.value();
+            file.current.sector = 1;
+            return true;
+        }
+
+        /* At the end of the file, allocate the next empty cluster */
+        next_cluster = this->get_next_empty_cluster();
+
+        /* When next cluster was found, allocate it */
+        if (not next_cluster)
+            return false;
+
+        /* Set current cluster */
+        if (not this->write_FAT_entry(cluster, next_cluster.value()))
+            return false;
+
+        /* Set next cluster to end-of-file */
+        const uint32_t entry = this->partition.is_fat16 ? 0xFFFF : 0xFFFFFFFF;
+        if (not this->write_FAT_entry(next_cluster.value(), entry))
+            return false;
+
+        /* Update the filehandle */
+        file.current.cluster = next_cluster.value();
+        file.current.sector = 1;
         return true;
     };
 
@@ -559,6 +1303,11 @@ namespace fat32
         write_long(directory.block_buffer.begin(), offset + DIR_Entry::Filesize, 0U);
 
         /* After updating the entry, write the sector of the directory to memory */
-        return this->write_current_sector(directory);
+        if (not this->write_current_sector(directory))
+            return false;
+
+        /* Remember the new entry, it replaces a remembered entry with the same id */
+        this->remember_entry(directory, id);
+        return true;
     };
 }; // namespace fat32
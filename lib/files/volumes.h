@@ -22,25 +22,50 @@
 #define VOLUMES_H_
 
 /* === Includes === */
+#include <bitset>
 #include <ctime>
 #include <optional>
 #include "filesystem/fat32.h"
+#include "memory/cache.h"
+#include "memory/drive.h"
 #include "memory/sdhc.h"
 
-namespace drive
-{
-    /* === Functions to interface with memory === */
-    template <class Memory>
-    bool read_single_block(Memory &memory, const uint32_t *buffer, const uint32_t block)
-    {
-        return memory.read_single_block(buffer, block);
-    };
-    template <class Memory>
-    bool write_single_block(Memory &memory, const uint32_t *buffer, const uint32_t block)
-    {
-        return memory.write_single_block(buffer, block);
-    };
-}; // namespace drive
+/* === Defines === */
+/** The number of FAT sectors for which the volume remembers whether
+ * they are full. Each sector needs one bit, the sectors after the
+ * map are always searched for free clusters.
+ */
+#ifndef OTOS_FAT_MAP_SIZE
+#ifdef OTOS_REDUCE_MEMORY_USAGE
+#define OTOS_FAT_MAP_SIZE 1024
+#else
+#define OTOS_FAT_MAP_SIZE 8192
+#endif // OTOS_REDUCE_MEMORY_USAGE
+#endif // OTOS_FAT_MAP_SIZE
+
+/** The number of files for which the volume remembers the
+ * cluster chain. When more files are used, the chain which
+ * was not used for the longest time is replaced.
+ */
+#ifndef OTOS_FAT_CHAINS
+#ifdef OTOS_REDUCE_MEMORY_USAGE
+#define OTOS_FAT_CHAINS 2
+#else
+#define OTOS_FAT_CHAINS 4
+#endif // OTOS_REDUCE_MEMORY_USAGE
+#endif // OTOS_FAT_CHAINS
+
+/** The number of directory entries which the volume remembers
+ * for opening files again. When more files are used, the entry
+ * which was not used for the longest time is replaced.
+ */
+#ifndef OTOS_FAT_LOOKUPS
+#ifdef OTOS_REDUCE_MEMORY_USAGE
+#define OTOS_FAT_LOOKUPS 4
+#else
+#define OTOS_FAT_LOOKUPS 8
+#endif // OTOS_REDUCE_MEMORY_USAGE
+#endif // OTOS_FAT_LOOKUPS
 
 namespace fat32
 {
@@ -57,7 +82,9 @@ namespace fat32
         Volume() = delete;
 
         /**
-         * @brief Construct a new Volume object
+         * @brief Construct a new Volume object. The volume
+         * accesses the memory by reference, so the memory has
+         * to outlive the volume.
          *
          * @param memory_used The object reference to the used memory.
          */
@@ -79,6 +106,9 @@ namespace fat32
          * @brief Read the entry of the given directory and store the entry in
          * the given filehandle.
          *
+         * When the entry is remembered from a previous access, the
+         * memory is not read and the current position is not changed.
+         *
          * @param file The filehandler to use for data access.
          * @param id The ID of the entry to read from the directory.
          * @return Returns True when the ID was found and the entry read successfully.
@@ -89,6 +119,9 @@ namespace fat32
          * @brief Read the current directory and get the fileid
          * of the file/directory specified by its name.
          *
+         * The entries which were found are remembered, so
+         * searching the same name again does not read the memory.
+         *
          * @param directory Filehandler of directory to use for memory access.
          * @param filename The name of the file to search for.
          * @return Returns the fileid of the file when it was found, returns False when
@@ -96,10 +129,35 @@ namespace fat32
          */
         auto get_fileid(Filehandler &directory, const std::array<char, 12> filename) -> std::optional<uint32_t>;
 
+        /**
+         * @brief Get the cluster at a position within the cluster chain of a file.
+         * The known part of the chain is remembered, so the FAT is only read
+         * for the part of the chain which was not used before.
+         *
+         * @param file The filehandler of the file.
+         * @param index The position of the cluster in the file, starting at 0.
+         * @return The cluster number, nothing when the chain ends before the position.
+         */
+        auto get_cluster_of_file(const Filehandler &file, uint32_t index) -> std::optional<uint32_t>;
+
+        /**
+         * @brief Get the number of free clusters of the volume.
+         * The count is read from the FSInfo sector when mounting
+         * and updated when clusters are allocated or freed.
+         *
+         * @return The number of free clusters, nothing when the count is not known yet.
+         */
+        auto get_free_clusters() const -> std::optional<uint32_t>;
+
         /**
          * @brief Read the FAT and get the next cluster which
          * is empty and can be allocated.
          *
+         * The search starts at the allocation cursor, which is
+         * initialized with the hint of the FSInfo sector and follows
+         * the allocated clusters. FAT sectors which are known to be
+         * full are skipped.
+         *
          * @return Returns the number of the next empty cluster, False when no cluster is empty.
          */
         auto get_next_empty_cluster() -> std::optional<uint32_t>;
@@ -135,6 +193,22 @@ namespace fat32
          */
         auto mount() -> bool;
 
+        /**
+         * @brief Reserve clusters for the next bytes written to a file.
+         * The missing clusters are allocated as one run of consecutive
+         * clusters, which is searched in one pass of the FAT starting
+         * behind the end of the file, and linked to the file at once.
+         *
+         * The run is remembered in the cluster chain of the file, so
+         * writing within the reserved clusters does not use the FAT.
+         * Release the clusters which were not used with trim_file().
+         *
+         * @param file The filehandler of the file.
+         * @param bytes The number of bytes to reserve behind the end of the file.
+         * @return Returns True when the clusters are allocated, False when no run of free clusters is large enough.
+         */
+        auto preallocate(Filehandler &file, uint32_t bytes) -> bool;
+
         /**
          * @brief Read the first sector of a specific cluster from memory.
          *
@@ -144,6 +218,65 @@ namespace fat32
          */
         auto read_cluster(Filehandler &file, uint32_t cluster) -> bool;
 
+        /**
+         * @brief Read consecutive sectors of a cluster from memory
+         * with one memory transfer. Use sector 0 and the number of
+         * sectors per cluster to read the whole cluster.
+         *
+         * The filehandlers are not changed.
+         *
+         * @param buffer The buffer for the data. It has to hold count * 512 bytes.
+         * @param cluster The cluster number to be read.
+         * @param sector The first sector to read within the cluster, starting at 0.
+         * @param count The number of sectors to read.
+         * @return Returns True when the sectors were read.
+         */
+        auto read_sectors_of_cluster(const uint32_t *buffer, uint32_t cluster, uint32_t sector, uint32_t count) -> bool;
+
+        /**
+         * @brief Start reading consecutive sectors of a cluster. Memories
+         * with a DMA path return immediately and transfer the data in
+         * the background, other memories read the sectors right away.
+         * Call complete_read() before the buffer is used.
+         *
+         * @param buffer The buffer for the data. It has to hold count * 512 bytes.
+         * @param cluster The cluster number to be read.
+         * @param sector The first sector to read within the cluster, starting at 0.
+         * @param count The number of sectors to read.
+         * @return Returns True when the read was started.
+         */
+        auto start_read_sectors_of_cluster(const uint32_t *buffer, uint32_t cluster, uint32_t sector, uint32_t count) -> bool;
+
+        /**
+         * @brief Wait for a read started with start_read_sectors_of_cluster().
+         * The calling thread yields until the transfer is finished.
+         *
+         * @return Returns True when the sectors were read.
+         */
+        auto complete_read() -> bool;
+
+        /**
+         * @brief Start writing consecutive sectors of a cluster. Memories
+         * with a DMA path return immediately and transfer the data in
+         * the background, other memories write the sectors right away.
+         * Call complete_write() before the buffer is changed.
+         *
+         * @param buffer The data to write. It has to hold count * 512 bytes.
+         * @param cluster The cluster number to be written.
+         * @param sector The first sector to write within the cluster, starting at 0.
+         * @param count The number of sectors to write.
+         * @return Returns True when the write was started.
+         */
+        auto start_write_sectors_of_cluster(const uint32_t *buffer, uint32_t cluster, uint32_t sector, uint32_t count) -> bool;
+
+        /**
+         * @brief Wait for a write started with start_write_sectors_of_cluster().
+         * The calling thread yields until the transfer is finished.
+         *
+         * @return Returns True when the sectors were written.
+         */
+        auto complete_write() -> bool;
+
         /**
          * @brief Get the next cluster of a current cluster, reading the FAT.
          * The internal FAT buffer is used for data transfer.
@@ -170,6 +303,22 @@ namespace fat32
          */
         auto read_next_sector_of_cluster(Filehandler &file) -> bool;
 
+        /**
+         * @brief Read the next entry of a directory which is in use.
+         * Deleted entries and the entries of long file names are
+         * skipped. The directory is read sector by sector, the
+         * position is kept in the filehandler between the calls,
+         * so listing a directory reads each sector only once.
+         *
+         * Start the iteration with rewind_directory() and do not use
+         * the filehandler for other accesses until the iteration ends.
+         *
+         * @param directory The filehandler of the directory.
+         * @param entry The entry to store the properties in.
+         * @return Returns True when an entry was read, False at the end of the directory.
+         */
+        auto read_next_entry(Filehandler &directory, Directory_Entry &entry) -> bool;
+
         /**
          * @brief Read the root directory of the file system
          * and determine the name of the volume.
@@ -179,6 +328,57 @@ namespace fat32
          */
         auto read_root(Filehandler &file) -> bool;
 
+        /**
+         * @brief Start iterating over the entries of a directory
+         * with read_next_entry(). Reads the first sector of the directory.
+         *
+         * @param directory The filehandler of the directory.
+         * @return Returns True when the first sector of the directory was read.
+         */
+        auto rewind_directory(Filehandler &directory) -> bool;
+
+        /**
+         * @brief Scan the next sectors of the FAT to count the free
+         * clusters and to remember which FAT sectors are full.
+         * Call this repeatedly in a low priority thread until it
+         * returns True, afterwards the free count is exact.
+         *
+         * The internal FAT buffer is used for data transfer.
+         *
+         * @param sectors The maximum number of FAT sectors to scan with this call.
+         * @return Returns True when the whole FAT was scanned.
+         */
+        auto scan_FAT(uint32_t sectors) -> bool;
+
+        /**
+         * @brief Set whether the second FAT is only updated when
+         * the volume is synchronized. Otherwise both FATs are
+         * written when a changed FAT sector leaves the FAT buffer.
+         *
+         * @param on_sync True to mirror the FAT only in sync().
+         */
+        void set_FAT_mirroring(bool on_sync);
+
+        /**
+         * @brief Write the changed FAT sector to both FATs, the
+         * free count and the allocation cursor to the FSInfo sector,
+         * when they changed, and write all data which is buffered
+         * by the memory, e.g. by a drive::Cache, to the memory.
+         *
+         * @return Returns True when all buffered data was written.
+         */
+        auto sync() -> bool;
+
+        /**
+         * @brief Free the clusters behind the cluster which contains
+         * the end of a file, e.g. the clusters which were reserved
+         * with preallocate() but not used.
+         *
+         * @param file The filehandler of the file.
+         * @return Returns True when the chain of the file ends with its last used cluster.
+         */
+        auto trim_file(Filehandler &file) -> bool;
+
         /**
          * @brief Write the current sector of a specific cluster to memory.
          *
@@ -187,8 +387,27 @@ namespace fat32
          */
         auto write_current_sector(Filehandler &file) -> bool;
 
+        /**
+         * @brief Write consecutive sectors of a cluster to memory
+         * with one memory transfer. Use sector 0 and the number of
+         * sectors per cluster to write the whole cluster.
+         *
+         * The filehandlers are not changed.
+         *
+         * @param buffer The data to write. It has to hold count * 512 bytes.
+         * @param cluster The cluster number to be written.
+         * @param sector The first sector to write within the cluster, starting at 0.
+         * @param count The number of sectors to write.
+         * @return Returns True when the sectors were written.
+         */
+        auto write_sectors_of_cluster(const uint32_t *buffer, uint32_t cluster, uint32_t sector, uint32_t count) -> bool;
+
         /**
          * @brief Set the state of a cluster writing to the FAT.
+         * The entry is changed in the FAT buffer, the sector is
+         * written to the memory when another FAT sector is used,
+         * before a directory entry is updated or when the volume
+         * is synchronized.
          *
          * @param cluster The number of the cluster to be update.
          * @param FAT_Entry The new state of the cluster.
@@ -202,7 +421,12 @@ namespace fat32
          *
          * The file buffer has to be written to the memory!
          * The file buffer is used for the directory access, so any
-         * data which is not written to the memory is lost.
+         * data which is not written to the memory is lost. The
+         * current position of the file is not changed.
+         *
+         * The changed FAT sector is written beforehand, so that
+         * the directory entry does not refer to clusters which are
+         * not allocated in the memory.
          *
          * @param file The filehandle of the file of which the directory entry should be updated.
          * @return Returns True when the directory entry was updated successfully.
@@ -222,15 +446,150 @@ namespace fat32
          */
         auto write_file_to_memory(Filehandler &file) -> bool;
 
+        /**
+         * @brief Move the filehandle to the sector after its full
+         * current sector without writing the block buffer. At the
+         * end of the file the next empty cluster is allocated.
+         *
+         * @param file The filehandle of the file.
+         * @return Returns True when the filehandle points to the next sector.
+         */
+        auto move_to_next_sector(Filehandler &file) -> bool;
+
         /* === Properties === */
-        Memory memory;                        /**< The memory used for the volume. */
+        Memory &memory;                       /**< The memory used for the volume. */
         std::array<uint8_t, 512> FAT{0};      /**< The FAT buffer. */
         Partition partition{};                /**< The partition of the volume. */
         error::Code error{error::Code::None}; /**< The error code of the volume. */
 
       private:
+        /* === Methods === */
+        /**
+         * @brief Search a range of clusters for an empty cluster.
+         * Marks the FAT sectors which were searched completely
+         * and contain no empty cluster.
+         *
+         * @param first The first cluster to check.
+         * @param last The last cluster to check.
+         * @return The number of the empty cluster, nothing when the range is full.
+         */
+        auto find_empty_cluster(uint32_t first, uint32_t last) -> std::optional<uint32_t>;
+
+        /**
+         * @brief Search a range of clusters for a run of consecutive
+         * empty clusters. The FAT is read once from the first to the
+         * last cluster at most.
+         *
+         * @param first The first cluster to check.
+         * @param last The last cluster to check.
+         * @param count The number of empty clusters needed.
+         * @return The first cluster of the run, nothing when the range contains no such run.
+         */
+        auto find_empty_run(uint32_t first, uint32_t last, uint32_t count) -> std::optional<uint32_t>;
+
+        /**
+         * @brief Write the FAT sector in the buffer to the memory
+         * when it was changed. The second FAT is updated as well,
+         * unless it is mirrored when the volume is synchronized.
+         *
+         * @return Returns True when the FAT buffer is not changed anymore.
+         */
+        auto flush_FAT() -> bool;
+
+        /**
+         * @brief Read a FAT sector to the FAT buffer, the changed
+         * sector in the buffer is written beforehand.
+         *
+         * @param block The block of the FAT sector.
+         * @return Returns True when the sector is in the buffer.
+         */
+        auto load_FAT_sector(uint32_t block) -> bool;
+
+        /**
+         * @brief Copy the sectors of the first FAT which changed
+         * since the last synchronization to the second FAT.
+         *
+         * @return Returns True when both FATs are equal.
+         */
+        auto mirror_FAT() -> bool;
+
+        /**
+         * @brief Read the next cluster of a cluster from the FAT.
+         * When the cluster is the last known cluster of the chain,
+         * the chain is extended with the result.
+         *
+         * @param cluster The current cluster.
+         * @param chain The chain of the file, can be nullptr.
+         * @return The next cluster, nothing when the chain ends or the FAT is invalid.
+         */
+        auto follow_chain(uint32_t cluster, Chain *chain) -> std::optional<uint32_t>;
+
+        /**
+         * @brief Get the remembered chain of a file. When the chain
+         * is not known yet, the least recently used chain is replaced.
+         *
+         * @param start_cluster The start cluster of the file.
+         * @return Pointer to the chain, nullptr when the file has no valid start cluster.
+         */
+        auto get_chain(uint32_t start_cluster) -> Chain *;
+
+        /**
+         * @brief Update the remembered chains after a FAT entry was changed.
+         *
+         * @param cluster The cluster of which the entry was changed.
+         * @param FAT_Entry The new entry of the cluster.
+         */
+        void update_chains(uint32_t cluster, uint32_t FAT_Entry);
+
+        /**
+         * @brief Check whether a FAT sector is known to contain no empty cluster.
+         * @param sector The index of the sector within the FAT.
+         * @return Returns True when the sector can be skipped.
+         */
+        auto is_FAT_sector_full(uint32_t sector) const -> bool;
+
+        /**
+         * @brief Remember whether a FAT sector contains no empty cluster.
+         * @param sector The index of the sector within the FAT.
+         * @param full True when the sector is full.
+         */
+        void set_FAT_sector_full(uint32_t sector, bool full);
+
+        /**
+         * @brief Find the remembered entry of a file name within a directory.
+         *
+         * @param directory The start cluster of the directory.
+         * @param name The name of the file.
+         * @return Pointer to the lookup, nullptr when the entry is not known.
+         */
+        auto find_lookup(uint32_t directory, const std::array<char, 12> &name) -> Lookup *;
+
+        /**
+         * @brief Remember an entry of a directory. A remembered entry
+         * with the same id is replaced, otherwise the entry which was
+         * not used for the longest time.
+         *
+         * @param directory Filehandler with the loaded directory sector which contains the entry.
+         * @param id The id of the entry.
+         */
+        void remember_entry(const Filehandler &directory, uint32_t id);
+
         /* === Properties === */
-        uint32_t FAT_sector_in_buffer{0xFFFFFFFF}; /**< The current FAT sector in the buffer. */
+        uint32_t FAT_sector_in_buffer{0xFFFFFFFF};      /**< The current FAT sector in the buffer. */
+        bool FAT_changed{false};                        /**< The FAT buffer has to be written to the memory. */
+        bool mirror_on_sync{false};                     /**< The second FAT is only updated in sync(). */
+        uint32_t mirror_begin{0xFFFFFFFF};              /**< The first sector of the first FAT which has to be mirrored. */
+        uint32_t mirror_end{0};                         /**< The last sector of the first FAT which has to be mirrored. */
+        uint32_t free_count{FSInfo::UNKNOWN};           /**< The number of free clusters. */
+        uint32_t next_free{2};                          /**< The allocation cursor where the search for empty clusters starts. */
+        bool FS_info_changed{false};                    /**< The free count or the cursor have to be written to the FSInfo. */
+        std::bitset<OTOS_FAT_MAP_SIZE> FAT_map{};       /**< The FAT sectors which contain no empty cluster. */
+        uint32_t scan_sector{0};                        /**< The next FAT sector to scan. */
+        uint32_t scan_free{0};                          /**< The free clusters in the scanned FAT sectors. */
+        std::array<Chain, OTOS_FAT_CHAINS> chains{};    /**< The known cluster chains of the recently used files. */
+        uint32_t chain_access{0};                       /**< Counter for the accesses of the chains. */
+        std::array<Lookup, OTOS_FAT_LOOKUPS> lookups{}; /**< The remembered directory entries. */
+        uint32_t lookup_access{0};                      /**< Counter for the accesses of the lookups. */
     };
 }; // namespace fat32
 
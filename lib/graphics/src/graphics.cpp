@@ -31,6 +31,7 @@
 #include "graphics.h"
 #include <cstdint>
 #include <cstdlib>
+#include <profile.h>
 #include <utility>
 
 namespace graphics
@@ -387,6 +388,8 @@ namespace graphics
 
     auto Canvas_BW::put(const char character) -> Canvas_BW &
     {
+        OTOS_PROFILE("graphics.put");
+
         /* get pixel size of font */
         uint8_t width = this->font->width_px;
         uint8_t height = this->font->height_px;
@@ -23,6 +23,7 @@
 #define KERNEL_H_
 
 /* === Includes === */
+#include "profile.h"
 #include "thread.h"
 #include <algorithm>
 #include <array>
@@ -42,14 +43,46 @@
 #define OTOS_NUMBER_THREADS 5 /* Maximum number of threads */
 #endif
 
+#ifndef OTOS_TICK_RATE_HZ
+#define OTOS_TICK_RATE_HZ 1000 /* Kernel tick rate in Hz */
+#endif
+
 namespace OTOS
 {
     /* === Parameters === */
     constexpr std::size_t stack_size = OTOS_STACK_SIZE;
     constexpr std::size_t number_threads = OTOS_NUMBER_THREADS;
-    constexpr u_base_t ms_per_tick = 1;
+    constexpr std::uint32_t tick_rate_hz = OTOS_TICK_RATE_HZ;
+    constexpr std::uint32_t cycles_per_tick = F_CPU / tick_rate_hz;
+    constexpr std::uint32_t us_per_tick = 1'000'000U / tick_rate_hz;
+    constexpr u_base_t ms_per_tick = (tick_rate_hz < 1'000U) ? (1'000U / tick_rate_hz) : 1U;
+    constexpr u_base_t ticks_per_ms = (tick_rate_hz > 1'000U) ? (tick_rate_hz / 1'000U) : 1U;
     constexpr u_base_t number_priorities = std::size(Available_Priorities);
 
+    /* === Checks of the tick rate === */
+    static_assert((F_CPU % tick_rate_hz) == 0, "OTOS: The kernel tick rate has to divide the CPU clock!");
+    static_assert(cycles_per_tick <= 0x0100'0000, "OTOS: The kernel tick rate is too low for the 24-bit SysTick timer!");
+    static_assert((1'000'000U % tick_rate_hz) == 0, "OTOS: The kernel tick has to be a whole number of micro-seconds!");
+    static_assert(((tick_rate_hz % 1'000U) == 0) || ((1'000U % tick_rate_hz) == 0),
+                  "OTOS: The kernel tick rate has to be a multiple or a divisor of 1 kHz!");
+
+    namespace check
+    {
+        /**
+         * @brief Constexpr to check whether a thread frequency can be
+         * represented by the kernel tick.
+         * @return The period of the thread in kernel ticks.
+         */
+        template <u_base_t Hz>
+        constexpr auto Frequency() -> u_base_t
+        {
+            static_assert(Hz > 0, "OTOS: The thread frequency has to be greater than 0 Hz!");
+            static_assert(Hz <= tick_rate_hz, "OTOS: The thread frequency is higher than the kernel tick rate!");
+            static_assert((tick_rate_hz % Hz) == 0, "OTOS: The thread period is not a whole number of kernel ticks!");
+            return tick_rate_hz / Hz;
+        };
+    }; // namespace check
+
     class Kernel
     {
       public:
@@ -91,6 +124,9 @@ namespace OTOS
         /**
          * @brief Add a thread schedule to the kernel and activate its execution.
          * The task is executed when calling this function!
+         * @note The period is rounded to the nearest number of kernel ticks and
+         * is at least one tick. Use the overload with the frequency as template
+         * parameter to check the frequency at compile time.
          * @tparam stack_size The size of the thread stack in words.
          * @param TaskFunc Function pointer to the task of the thread.
          * @param Priority Priority of the scheduled thread.
@@ -100,15 +136,52 @@ namespace OTOS
         template <u_base_t stack_size>
         auto schedule_thread(const taskpointer_t TaskFunc, const Priority Priority, const u_base_t Frequency) -> Kernel &
         {
-            /* Calculate the thread timing and schedule it */
-            const u_base_t time_ms = 1000 / Frequency;
-            const u_base_t schedule = time_ms / ms_per_tick;
+            /* Calculate the thread period in ticks and schedule it */
+            const u_base_t schedule = std::max<u_base_t>((tick_rate_hz + (Frequency / 2)) / Frequency, 1U);
             this->schedule_thread(TaskFunc, check::StackSize<stack_size>(), Priority, schedule);
 
             /* Return the reference to the kernel */
             return *this;
         };
 
+        /**
+         * @brief Add a thread schedule to the kernel and activate its execution.
+         * The task is executed when calling this function!
+         * The compiler checks whether the frequency can be represented by the
+         * kernel tick rate.
+         * @tparam stack_size The size of the thread stack in words.
+         * @tparam frequency The frequency of execution in [Hz].
+         * @param TaskFunc Function pointer to the task of the thread.
+         * @param Priority Priority of the scheduled thread.
+         * @return Kernel& Returns a reference to the kernel object.
+         */
+        template <u_base_t stack_size, u_base_t frequency>
+        auto schedule_thread(const taskpointer_t TaskFunc, const Priority Priority) -> Kernel &
+        {
+            /* Schedule the thread with the checked period in ticks */
+            this->schedule_thread(TaskFunc, check::StackSize<stack_size>(), Priority, check::Frequency<frequency>());
+
+            /* Return the reference to the kernel */
+            return *this;
+        };
+
+        /**
+         * @brief Supervise the calling thread with a heartbeat.
+         * Call this from within the thread. The thread then has to call
+         * heartbeat() at least once within the given interval, otherwise
+         * it is considered stalled.
+         * @param max_interval_ms The maximum interval between heartbeats in [ms].
+         */
+        void register_heartbeat(u_base_t max_interval_ms);
+
+        /**
+         * @brief Set the function which kicks the watchdog.
+         * The kernel calls the function every tick, as long as no
+         * supervised thread is stalled.
+         * @param kick Function pointer to kick the watchdog, e.g. watchdog::kick.
+         */
+        void set_watchdog(void (*kick)());
+
         /* === Getters === */
         /**
          * @brief Get the current size of the allocated stack.
@@ -126,18 +199,89 @@ namespace OTOS
          */
         auto get_next_thread() const -> std::optional<u_base_t>;
 
+        /**
+         * @brief Get the first supervised thread which is currently stalled.
+         * @return Returns the number of the stalled thread. The optional
+         * evaluates to false, when all supervised threads are alive.
+         */
+        auto get_stalled_thread() const -> std::optional<u_base_t>;
+
+        /**
+         * @brief Get the supervision data of one thread.
+         * @param thread_id The number of the thread.
+         * @return Returns a reference to the thread.
+         */
+        auto get_thread(u_base_t thread_id) const -> const Thread &;
+
         /**
          * @brief Get the current system time in milli-seconds.
          * @return Returns the current time in milli-seconds.
          */
         static auto get_time_ms() -> std::uint32_t;
 
+        /**
+         * @brief Get the monotonic system time in micro-seconds.
+         *
+         * The time combines the kernel ticks with the cycles of the
+         * SysTick timer which elapsed since the last tick. It does not
+         * wrap during the lifetime of the device and can be called
+         * from threads as well as from interrupts.
+         *
+         * @return Returns the current time in micro-seconds.
+         */
+        static auto get_time_us() -> std::uint64_t;
+
+        /**
+         * @brief Get the monotonic system time in core clock cycles.
+         * @return Returns the number of core clock cycles since the
+         * kernel started counting ticks.
+         */
+        static auto get_time_cycles() -> std::uint64_t;
+
         /* === Methods === */
         /**
-         * @brief Increase the milli-seconds timer by one milli-second.
+         * @brief Count one kernel tick. Call this in the SysTick interrupt.
+         * This counts the 64-bit tick counter of the monotonic clock and
+         * the milli-seconds timer.
+         */
+        static void count_tick();
+
+        /**
+         * @brief Increase the milli-seconds timer by one kernel tick.
+         * @deprecated Use count_tick(). This is the same function and only
+         * kept for compatibility.
          */
         static void count_time_ms();
 
+        /**
+         * @brief Write the supervision data of all supervised threads
+         * to an output stream. Every thread is written as one line with
+         * "thread <id>: stalls <count>, worst <interval> ms, zone <name>".
+         *
+         * @tparam o_device The output device of the stream.
+         * @param out The output stream to write to.
+         */
+        template <class o_device>
+        void dump_supervision(ostream<o_device> &out) const
+        {
+            for (u_base_t id = 0; id < this->thread_count; id++)
+            {
+                const Thread &thread = this->Threads[id];
+                if (thread.get_worst_heartbeat() == 0)
+                    continue;
+                const char *zone = thread.get_stall_zone();
+                out << "thread " << id << ": stalls " << thread.get_stall_count()
+                    << ", worst " << (thread.get_worst_heartbeat() * ms_per_tick) / ticks_per_ms
+                    << " ms, zone " << ((zone != nullptr) ? zone : "-") << endl;
+            }
+        };
+
+        /**
+         * @brief Signal that the calling thread is alive.
+         * Call this from within a supervised thread.
+         */
+        void heartbeat();
+
         /**
          * @brief Start the kernel execution.
          */
@@ -151,7 +295,8 @@ namespace OTOS
 
         /**
          * @brief Update the thread tick counters and determine which
-         * thread is runnable.
+         * thread is runnable. Also checks the heartbeats of the supervised
+         * threads and kicks the watchdog when all of them are alive.
          */
         void update_schedule();
 
@@ -180,12 +325,30 @@ namespace OTOS
          */
         auto find_next_thread(OTOS::Priority thread_priority) const -> std::optional<u_base_t>;
 
+        /**
+         * @brief Take a consistent sample of the tick counter and
+         * the cycles elapsed since that tick.
+         *
+         * The tick counter is read again after sampling the timer.
+         * When a tick interrupt occurred in between, the sample is
+         * repeated. This avoids torn reads of the 64-bit counter
+         * without disabling interrupts.
+         *
+         * @param ticks The sampled tick count.
+         * @param cycles The sampled cycles since the tick.
+         */
+        static void sample_clock(std::uint64_t &ticks, std::uint32_t &cycles);
+
         /* === Properties === */
         u_base_t thread_count{0};                               /**< Number of scheduled threads */
+        u_base_t current_thread{0};                             /**< The ID of the thread which ran last */
+        void (*watchdog_kick)(){nullptr};                       /**< Function to kick the watchdog */
         std::array<Thread, number_threads> Threads{};           /**< Array with stack data and schedule of each thread */
         std::array<u_base_t, stack_size> Stack{0};              /**< The total stack for the threads */
         std::array<u_base_t, number_priorities> last_thread{0}; /**< The ID of the last thread which ran for every priority level */
         static std::uint32_t Time_ms;                           /**< Kernel timer with ms resolution */
+        static volatile std::uint64_t Ticks;                    /**< Kernel ticks since start, does not wrap */
+        static u_base_t Ticks_in_ms;                            /**< Kernel ticks counted in the current ms */
     };
 
     /* === Functions === */
@@ -201,5 +364,17 @@ namespace OTOS
      */
     auto get_time_ms() -> std::uint32_t;
 
+    /**
+     * @brief Get the monotonic system time in micro-seconds
+     * as a function call.
+     *
+     * Use this as the time base for profiling and protocol
+     * timing, which need a finer resolution than the kernel
+     * tick. The function is safe to call from interrupts.
+     *
+     * @return Returns the current time in micro-seconds.
+     */
+    auto get_time_us() -> std::uint64_t;
+
 };     // namespace OTOS
 #endif // KERNEL_H_
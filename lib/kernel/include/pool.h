@@ -0,0 +1,366 @@
+/**
+ * OTOS - Open Tec Operating System
+ * Copyright (c) 2021 - 2024 Sebastian Oberschwendtner,
+ * sebastian.oberschwendtner@gmail.com
+ *
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef POOL_H_
+#define POOL_H_
+
+/* === Includes === */
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+#include <misc/types.h>
+
+/* === Defines === */
+/** Define OTOS_POOL_POISON before including pool.h to fill freed
+ * blocks with the poison pattern and check the pattern when the
+ * block is allocated again.
+ */
+#ifdef OTOS_POOL_POISON
+#define OTOS_POOL_POISON_ENABLED true
+#else
+#define OTOS_POOL_POISON_ENABLED false
+#endif
+
+namespace OTOS
+{
+    /**
+     * @class CriticalSection
+     * @brief RAII lock which disables all interrupts while it exists.
+     * The previous interrupt mask is restored on destruction, so critical
+     * sections can be nested and used within interrupt handlers.
+     */
+    class CriticalSection
+    {
+      public:
+        /* === Constructors === */
+        CriticalSection(const CriticalSection &) = delete;
+        CriticalSection(CriticalSection &&) = delete;
+        auto operator=(const CriticalSection &) -> CriticalSection & = delete;
+        auto operator=(CriticalSection &&) -> CriticalSection & = delete;
+
+        /**
+         * @brief Enter the critical section.
+         */
+        CriticalSection()
+            : primask{__get_PRIMASK()}
+        {
+            __disable_irq();
+        };
+
+        /* === Destructor === */
+        /**
+         * @brief Leave the critical section.
+         */
+        ~CriticalSection()
+        {
+            __set_PRIMASK(this->primask);
+        };
+
+      private:
+        /* === Properties === */
+        const std::uint32_t primask; /**< The interrupt mask before entering the section. */
+    };
+
+    /**
+     * @class BlockPool
+     * @brief Statically allocated pool of fixed-size memory blocks.
+     * Allocating and freeing a block takes constant time and is
+     * protected by a critical section, so the pool can be used
+     * from threads and interrupt handlers.
+     *
+     * The pool is constant initialized, so it can be used by other
+     * static objects. Blocks which were never used are handed out
+     * in order, freed blocks are kept in an intrusive free list.
+     *
+     * @tparam size The minimum size of one block in bytes.
+     * @tparam count The number of blocks in the pool.
+     * @tparam align The alignment of the blocks in bytes.
+     */
+    template <std::size_t size, std::size_t count, std::size_t align = alignof(std::max_align_t)>
+    class BlockPool
+    {
+      private:
+        /* === Types === */
+        struct Free_Block
+        {
+            Free_Block *next; /**< The next free block in the list. */
+        };
+
+      public:
+        /* === Parameters === */
+        static constexpr std::size_t block_align = std::max(align, alignof(Free_Block));
+        static constexpr std::size_t block_size =
+            ((std::max(size, sizeof(Free_Block)) + block_align - 1) / block_align) * block_align;
+        static constexpr std::size_t block_count = count;
+        static constexpr std::uint8_t poison = 0xA5;
+
+        static_assert(count > 0, "OTOS: A memory pool needs at least one block!");
+        static_assert((align & (align - 1)) == 0, "OTOS: The block alignment has to be a power of 2!");
+
+        /* === Constructors === */
+        constexpr BlockPool() = default;
+        BlockPool(const BlockPool &) = delete;
+        BlockPool(BlockPool &&) = delete;
+        auto operator=(const BlockPool &) -> BlockPool & = delete;
+        auto operator=(BlockPool &&) -> BlockPool & = delete;
+
+        /* === Getters === */
+        /**
+         * @brief Get the number of allocated blocks.
+         * @return The number of blocks in use.
+         */
+        auto get_used() const -> std::size_t { return this->used; };
+
+        /**
+         * @brief Get the number of blocks which can still be allocated.
+         * @return The number of free blocks.
+         */
+        auto get_free() const -> std::size_t { return count - this->used; };
+
+        /**
+         * @brief Get the maximum number of blocks which were in use at the same time.
+         * Use this to dimension the pool for the worst case.
+         * @return The high-water mark of the pool.
+         */
+        auto get_high_water() const -> std::size_t { return this->high_water; };
+
+        /**
+         * @brief Get the number of freed blocks which were written to
+         * before they were allocated again.
+         * @note Only counted when OTOS_POOL_POISON is defined.
+         * @return The number of detected use-after-free writes.
+         */
+        auto get_poison_errors() const -> std::size_t { return this->poison_errors; };
+
+        /**
+         * @brief Check whether a pointer points to a block of this pool.
+         * @param block The pointer to check.
+         * @return Returns True when the pointer is the start of a block.
+         */
+        auto owns(const void *block) const -> bool
+        {
+            const auto address = reinterpret_cast<std::uintptr_t>(block);
+            const auto begin = reinterpret_cast<std::uintptr_t>(this->storage.data());
+            return (address >= begin) && (address < begin + this->storage.size()) && (((address - begin) % block_size) == 0);
+        };
+
+        /* === Methods === */
+        /**
+         * @brief Allocate one block of the pool.
+         * @return Pointer to the block, nullptr when the pool is exhausted.
+         */
+        auto allocate() -> void *
+        {
+            CriticalSection lock;
+
+            /* Prefer the recently freed blocks */
+            void *block = nullptr;
+            if (this->free_list != nullptr)
+            {
+                Free_Block *head = this->free_list;
+                this->free_list = head->next;
+                if constexpr (OTOS_POOL_POISON_ENABLED)
+                    this->check_poison(head);
+                block = head;
+            }
+            else if (this->untouched < count)
+                block = &this->storage[block_size * this->untouched++];
+            else
+                return nullptr;
+
+            /* Update the statistics */
+            this->used++;
+            this->high_water = std::max(this->high_water, this->used);
+            return block;
+        };
+
+        /**
+         * @brief Return a block to the pool.
+         * Pointers which do not belong to the pool are ignored.
+         * @param block The block to free.
+         */
+        void deallocate(void *block)
+        {
+            if (!this->owns(block))
+                return;
+
+            if constexpr (OTOS_POOL_POISON_ENABLED)
+                std::fill_n(static_cast<std::uint8_t *>(block), block_size, poison);
+
+            CriticalSection lock;
+            auto *head = static_cast<Free_Block *>(block);
+            head->next = this->free_list;
+            this->free_list = head;
+            this->used--;
+        };
+
+      private:
+        /* === Methods === */
+        /**
+         * @brief Check whether the poison pattern of a free block is intact.
+         * The first bytes are skipped, since they store the free list.
+         * @param block The block to check.
+         */
+        void check_poison(const Free_Block *block)
+        {
+            const auto *begin = reinterpret_cast<const std::uint8_t *>(block);
+            const bool intact = std::all_of(
+                begin + sizeof(Free_Block), begin + block_size,
+                [](const std::uint8_t byte) { return byte == poison; });
+            if (!intact)
+                this->poison_errors++;
+        };
+
+        /* === Properties === */
+        alignas(block_align) std::array<std::uint8_t, block_size * count> storage{}; /**< The memory of the blocks. */
+        Free_Block *free_list{nullptr};                                                /**< The list of freed blocks. */
+        std::size_t untouched{0};                                                      /**< The index of the first block which was never allocated. */
+        std::size_t used{0};                                                           /**< The number of allocated blocks. */
+        std::size_t high_water{0};                                                     /**< The maximum number of allocated blocks. */
+        std::size_t poison_errors{0};                                                  /**< The number of corrupted free blocks. */
+    };
+
+    /**
+     * @class Pool
+     * @brief Statically allocated pool of objects with the type T.
+     * @tparam T The type of the objects in the pool.
+     * @tparam N The number of objects in the pool.
+     */
+    template <typename T, std::size_t N>
+    class Pool : public BlockPool<sizeof(T), N, alignof(T)>
+    {
+      public:
+        /* === Methods === */
+        /**
+         * @brief Construct an object in the pool.
+         * @param args The arguments for the constructor of T.
+         * @return Pointer to the object, nullptr when the pool is exhausted.
+         */
+        template <typename... Args>
+        auto create(Args &&...args) -> T *
+        {
+            void *block = this->allocate();
+            if (block == nullptr)
+                return nullptr;
+            return new (block) T(std::forward<Args>(args)...);
+        };
+
+        /**
+         * @brief Destroy an object and return its memory to the pool.
+         * @param object The object to destroy, nullptr is ignored.
+         */
+        void destroy(T *object)
+        {
+            if (!this->owns(object))
+                return;
+            object->~T();
+            this->deallocate(object);
+        };
+    };
+
+    /**
+     * @class PoolAllocator
+     * @brief STL compatible allocator which draws its memory from a block pool.
+     * Every allocation takes one block, so use it with node based
+     * containers like std::list, std::forward_list or std::map.
+     * @note The project is built without exceptions. An allocation which
+     * does not fit into one block or exceeds the pool returns nullptr,
+     * so dimension the pool for the worst case using its high-water mark.
+     *
+     * @tparam T The type of the allocated objects.
+     * @tparam pool_t The type of the block pool.
+     */
+    template <typename T, class pool_t>
+    class PoolAllocator
+    {
+      public:
+        /* === Types === */
+        using value_type = T;
+
+        /* === Constructors === */
+        /**
+         * @brief Create an allocator for the given pool.
+         * @param pool The pool to allocate the memory from.
+         */
+        explicit PoolAllocator(pool_t &pool) noexcept
+            : pool{&pool} {};
+
+        /**
+         * @brief Rebind an allocator of another type to the same pool.
+         * @param other The allocator to copy the pool from.
+         */
+        template <typename U>
+        PoolAllocator(const PoolAllocator<U, pool_t> &other) noexcept
+            : pool{other.get_pool()} {};
+
+        /* === Getters === */
+        /**
+         * @brief Get the pool of the allocator.
+         * @return Pointer to the pool.
+         */
+        auto get_pool() const noexcept -> pool_t * { return this->pool; };
+
+        /* === Methods === */
+        /**
+         * @brief Allocate memory for n objects.
+         * @param n The number of objects.
+         * @return Pointer to the memory, nullptr when the objects do not fit into one block.
+         */
+        auto allocate(std::size_t n) -> T *
+        {
+            if ((n * sizeof(T) > pool_t::block_size) || (alignof(T) > pool_t::block_align))
+                return nullptr;
+            return static_cast<T *>(this->pool->allocate());
+        };
+
+        /**
+         * @brief Return the memory of n objects to the pool.
+         * @param p Pointer to the memory.
+         * @param n The number of objects.
+         */
+        void deallocate(T *p, [[maybe_unused]] std::size_t n) noexcept
+        {
+            this->pool->deallocate(p);
+        };
+
+      private:
+        /* === Properties === */
+        pool_t *pool; /**< The pool the memory is allocated from. */
+    };
+
+    /* === Operators === */
+    template <typename T, typename U, class pool_t>
+    auto operator==(const PoolAllocator<T, pool_t> &lhs, const PoolAllocator<U, pool_t> &rhs) noexcept -> bool
+    {
+        return lhs.get_pool() == rhs.get_pool();
+    };
+
+    template <typename T, typename U, class pool_t>
+    auto operator!=(const PoolAllocator<T, pool_t> &lhs, const PoolAllocator<U, pool_t> &rhs) noexcept -> bool
+    {
+        return !(lhs == rhs);
+    };
+}; // namespace OTOS
+
+#endif // POOL_H_
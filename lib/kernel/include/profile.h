@@ -0,0 +1,204 @@
+/**
+ * OTOS - Open Tec Operating System
+ * Copyright (c) 2021 - 2024 Sebastian Oberschwendtner,
+ * sebastian.oberschwendtner@gmail.com
+ *
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef PROFILE_H_
+#define PROFILE_H_
+
+/* === Includes === */
+#include "iostream.h"
+#include <array>
+#include <cstdint>
+#include <limits>
+
+/* === Defines === */
+/** The defines are just default values here.
+ * They can be overwritten by defining them before including profile.h
+ */
+#ifndef OTOS_PROFILE_ZONES
+#define OTOS_PROFILE_ZONES 16 /* Maximum number of profiling zones */
+#endif
+
+/**
+ * @brief Profile the execution time of the enclosing scope.
+ * Each zone is registered once in the static zone table. The
+ * macro expands to nothing, when OTOS_DISABLE_PROFILING is defined.
+ *
+ * @param name The name of the zone, e.g. "fat32.read_cluster".
+ */
+#ifndef OTOS_DISABLE_PROFILING
+#define OTOS_PROFILE_CONCAT_(a, b) a##b
+#define OTOS_PROFILE_CONCAT(a, b) OTOS_PROFILE_CONCAT_(a, b)
+#define OTOS_PROFILE(name)                                                                                          \
+    static OTOS::profile::Zone *const OTOS_PROFILE_CONCAT(otos_zone_, __LINE__) = OTOS::profile::get_zone(name); \
+    const OTOS::Profile OTOS_PROFILE_CONCAT(otos_profile_, __LINE__) { OTOS_PROFILE_CONCAT(otos_zone_, __LINE__) }
+#else
+#define OTOS_PROFILE(name)
+#endif
+
+namespace OTOS
+{
+    namespace profile
+    {
+        /* === Parameters === */
+        constexpr std::size_t number_zones = OTOS_PROFILE_ZONES;
+
+        /**
+         * @brief The recorded statistics of one profiling zone.
+         * All times are in core clock cycles. In the native
+         * environment the host clock in ns is used instead.
+         */
+        struct Zone
+        {
+            /* === Methods === */
+            /**
+             * @brief Get the mean execution time of the zone.
+             * @return The mean time in cycles, 0 when the zone was not executed yet.
+             */
+            auto mean() const -> std::uint32_t;
+
+            /**
+             * @brief Add one execution of the zone to the statistics.
+             * @param cycles The execution time in cycles.
+             */
+            void record(std::uint32_t cycles);
+
+            /* === Properties === */
+            const char *name{nullptr};                                    /**< The name of the zone, nullptr when the entry is unused. */
+            std::uint32_t count{0};                                       /**< The number of executions of the zone. */
+            std::uint32_t min{std::numeric_limits<std::uint32_t>::max()}; /**< The minimum execution time. */
+            std::uint32_t max{0};                                         /**< The maximum execution time. */
+            std::uint64_t total{0};                                       /**< The accumulated execution time. */
+        };
+
+        /* === Functions === */
+        /**
+         * @brief Get the current time stamp of the profiling clock.
+         * Uses DWT CYCCNT on ARM Cortex M3 and above, the kernel cycle
+         * clock on other ARM cores and the host clock in the native
+         * environment.
+         * @return The current time stamp in cycles.
+         */
+        auto get_cycles() -> std::uint32_t;
+
+        /**
+         * @brief Get the zone with the given name from the zone table.
+         * When the zone does not exist yet, it is created. The first call
+         * also enables the profiling clock.
+         * @param name The name of the zone. The string has to outlive the zone table.
+         * @return Pointer to the zone, nullptr when the zone table is full.
+         */
+        auto get_zone(const char *name) -> Zone *;
+
+        /**
+         * @brief Get the name of the zone which was entered last.
+         * @return The name of the zone, nullptr when no zone was entered yet.
+         */
+        auto get_last_zone() -> const char *;
+
+        /**
+         * @brief Get the table with all profiling zones.
+         * @return Reference to the zone table.
+         */
+        auto get_table() -> const std::array<Zone, number_zones> &;
+
+        /**
+         * @brief Reset the statistics of all zones.
+         * The zones stay registered.
+         */
+        void reset();
+
+        /**
+         * @brief Write the zone table to an output stream.
+         * Every registered zone is written as one line with
+         * "name: count min mean max".
+         *
+         * @tparam o_device The output device of the stream.
+         * @param out The output stream to write to.
+         */
+        template <class o_device>
+        void dump(ostream<o_device> &out)
+        {
+            out << "zone: count min mean max" << endl;
+            for (const Zone &zone : get_table())
+            {
+                if (zone.name == nullptr)
+                    continue;
+                out << zone.name << ": " << zone.count << " "
+                    << (zone.count ? zone.min : 0U) << " "
+                    << zone.mean() << " " << zone.max << endl;
+            }
+        };
+
+        namespace detail
+        {
+            /**
+             * @brief Remember the zone which was entered last.
+             * @param zone The zone which is entered.
+             */
+            void set_last_zone(const Zone *zone);
+        }; // namespace detail
+    }; // namespace profile
+
+    /**
+     * @class Profile
+     * @brief RAII profiling zone. The time between construction and
+     * destruction is recorded in the given zone.
+     * @note Use the macro OTOS_PROFILE() instead of using the class directly.
+     */
+    class Profile
+    {
+      public:
+        /* === Constructors === */
+        Profile() = delete;
+        Profile(const Profile &) = delete;
+        Profile(Profile &&) = delete;
+        auto operator=(const Profile &) -> Profile & = delete;
+        auto operator=(Profile &&) -> Profile & = delete;
+
+        /**
+         * @brief Enter the profiling zone.
+         * @param zone The zone to record the time to. Nothing is recorded when nullptr.
+         */
+        explicit Profile(profile::Zone *zone)
+            : zone{zone}
+        {
+            profile::detail::set_last_zone(zone);
+            this->start = profile::get_cycles();
+        };
+
+        /* === Destructor === */
+        /**
+         * @brief Leave the profiling zone and record the elapsed time.
+         */
+        ~Profile()
+        {
+            const std::uint32_t elapsed = profile::get_cycles() - this->start;
+            if (this->zone != nullptr)
+                this->zone->record(elapsed);
+        };
+
+      private:
+        /* === Properties === */
+        profile::Zone *const zone; /**< The zone the time is recorded to. */
+        std::uint32_t start{0};    /**< The time stamp when the zone was entered. */
+    };
+}; // namespace OTOS
+#endif // PROFILE_H_
@@ -89,6 +89,19 @@ namespace OTOS
          */
         void set_blocked();
 
+        /**
+         * @brief Set the maximum interval between two heartbeats of the thread.
+         * The supervision starts with this call.
+         * @param ticks The maximum heartbeat interval in ticks. 0 disables the supervision.
+         */
+        void set_heartbeat_interval(u_base_t ticks);
+
+        /**
+         * @brief Set the name of the profiling zone the thread entered last.
+         * @param zone The name of the profiling zone.
+         */
+        void set_last_zone(const char *zone);
+
         /**
          * @brief Set the thread to the running state.
          */
@@ -120,6 +133,27 @@ namespace OTOS
          */
         auto get_priority() const -> Priority;
 
+        /**
+         * @brief Get the number of stalls of the thread, i.e. how often
+         * the heartbeat interval was exceeded.
+         * @return The number of stalls.
+         */
+        auto get_stall_count() const -> u_base_t;
+
+        /**
+         * @brief Get the name of the profiling zone the thread was in
+         * when it stalled last.
+         * @return The name of the zone, nullptr when unknown.
+         */
+        auto get_stall_zone() const -> const char *;
+
+        /**
+         * @brief Get the longest interval between two heartbeats
+         * which was observed so far.
+         * @return The longest heartbeat interval in ticks.
+         */
+        auto get_worst_heartbeat() const -> u_base_t;
+
         /**
          * @brief Get the allocated stack size of the thread.
          * @return Allocated stack size of the thread in words.
@@ -138,12 +172,30 @@ namespace OTOS
          */
         auto is_runnable() const -> bool;
 
+        /**
+         * @brief Check whether the thread exceeded its heartbeat interval.
+         * @return Returns true, when the thread is supervised and stalled.
+         */
+        auto is_stalled() const -> bool;
+
         /* === Methods === */
         /**
          * @brief Count SysTicks to determine whether the thread is runnable.
          */
         void count_tick();
 
+        /**
+         * @brief Count one tick of the heartbeat supervision.
+         * @param running_zone The profiling zone which was entered last by the running thread.
+         * @return Returns true, when the thread is not stalled.
+         */
+        auto count_heartbeat(const char *running_zone) -> bool;
+
+        /**
+         * @brief Signal that the thread is alive and reset the heartbeat interval.
+         */
+        void heartbeat();
+
         /* === Properties === */
         stackpointer_t Stack_pointer{0}; /* Pointer to the current top of stack of the thread */
 
@@ -155,6 +207,12 @@ namespace OTOS
         Priority priority{Priority::Low}; /**< Priority of task */
         u_base_t schedule_ticks{0};       /**< The scheduled execution time of thread */
         u_base_t counter_ticks{0};        /**< Ticks since last execution of thread */
+        u_base_t heartbeat_ticks{0};      /**< Maximum interval between heartbeats, 0 when not supervised */
+        u_base_t heartbeat_counter{0};    /**< Ticks since the last heartbeat */
+        u_base_t heartbeat_worst{0};      /**< Longest observed interval between heartbeats */
+        u_base_t stall_count{0};          /**< Number of exceeded heartbeat intervals */
+        const char *last_zone{nullptr};   /**< Profiling zone the thread entered last */
+        const char *stall_zone{nullptr};  /**< Profiling zone the thread was in when it stalled */
     };
 }; // namespace OTOS
 #endif
@@ -35,6 +35,8 @@ namespace OTOS
 {
     /* === Static Variables === */
     std::uint32_t Kernel::Time_ms = 0; /* Initialize the kernel time with 0 */
+    volatile std::uint64_t Kernel::Ticks = 0; /* Initialize the kernel ticks with 0 */
+    u_base_t Kernel::Ticks_in_ms = 0;         /* Initialize the ticks of the current ms with 0 */
 
     /* === Constructors === */
     Kernel::Kernel()
@@ -75,14 +77,88 @@ namespace OTOS
         return {};
     };
 
+    auto Kernel::get_stalled_thread() const -> std::optional<u_base_t>
+    {
+        /* Find the first stalled thread */
+        auto stalled = std::find_if(
+            this->Threads.cbegin(),
+            this->Threads.cbegin() + this->thread_count,
+            [](const Thread &thread)
+            { return thread.is_stalled(); });
+
+        /* Check whether a thread was found */
+        if (stalled != (this->Threads.cbegin() + this->thread_count))
+            return std::distance(this->Threads.cbegin(), stalled);
+        return {};
+    };
+
+    auto Kernel::get_thread(const u_base_t thread_id) const -> const Thread &
+    {
+        return this->Threads[thread_id];
+    };
+
     auto Kernel::get_time_ms() -> std::uint32_t
     {
         return Kernel::Time_ms;
     };
 
+    auto Kernel::get_time_us() -> std::uint64_t
+    {
+        /* Get consistent sample of the clock */
+        std::uint64_t ticks{0};
+        std::uint32_t cycles{0};
+        Kernel::sample_clock(ticks, cycles);
+
+        /* Convert the ticks and the cycles to micro-seconds */
+        const std::uint64_t us_since_tick = (static_cast<std::uint64_t>(cycles) * 1'000'000U) / F_CPU;
+        return (ticks * us_per_tick) + us_since_tick;
+    };
+
+    auto Kernel::get_time_cycles() -> std::uint64_t
+    {
+        /* Get consistent sample of the clock */
+        std::uint64_t ticks{0};
+        std::uint32_t cycles{0};
+        Kernel::sample_clock(ticks, cycles);
+
+        /* Convert the ticks to cycles */
+        return (ticks * cycles_per_tick) + cycles;
+    };
+
+    void Kernel::count_tick()
+    {
+        Kernel::Ticks = Kernel::Ticks + 1;
+
+        /* When the tick rate is faster than 1 kHz, count the ticks until 1 ms is over */
+        if constexpr (ticks_per_ms > 1)
+        {
+            if (++Kernel::Ticks_in_ms < ticks_per_ms)
+                return;
+            Kernel::Ticks_in_ms = 0;
+        }
+        Kernel::Time_ms += ms_per_tick;
+    };
+
     void Kernel::count_time_ms()
     {
-        Kernel::Time_ms++;
+        Kernel::count_tick();
+    };
+
+    void Kernel::heartbeat()
+    {
+        this->Threads[this->current_thread].heartbeat();
+    };
+
+    void Kernel::register_heartbeat(const u_base_t max_interval_ms)
+    {
+        /* Convert the interval to ticks, at least one tick */
+        const u_base_t ticks = std::max<u_base_t>((max_interval_ms * ticks_per_ms) / ms_per_tick, 1U);
+        this->Threads[this->current_thread].set_heartbeat_interval(ticks);
+    };
+
+    void Kernel::set_watchdog(void (*kick)())
+    {
+        this->watchdog_kick = kick;
     };
 
     void Kernel::start()
@@ -104,21 +180,37 @@ namespace OTOS
         /* Remember active thread */
         const u_base_t index = static_cast<u_base_t>(this->Threads[next_thread].get_priority());
         this->last_thread[index] = next_thread;
+        this->current_thread = next_thread;
 
         /* Invoke the assembler function to switch context */
         this->Threads[next_thread].set_running();
         this->Threads[next_thread].Stack_pointer = __otos_switch(this->Threads[next_thread].Stack_pointer);
         this->Threads[next_thread].set_blocked();
+
+        /* Remember where the thread yielded for the supervision */
+        this->Threads[next_thread].set_last_zone(profile::get_last_zone());
     };
 
     void Kernel::update_schedule()
     {
-        /* Update the ticks of every active thread */
+        /* The zone which was entered last belongs to the running thread */
+        const char *running_zone = profile::get_last_zone();
+        bool all_alive = true;
+
+        /* Update the ticks and the heartbeats of every active thread */
         std::for_each(
             this->Threads.begin(),
             this->Threads.begin() + this->thread_count,
-            [](Thread &thread)
-            { thread.count_tick(); });
+            [running_zone, &all_alive](Thread &thread)
+            {
+                thread.count_tick();
+                if (!thread.count_heartbeat(running_zone))
+                    all_alive = false;
+            });
+
+        /* Only kick the watchdog when no supervised thread is stalled */
+        if (all_alive && (this->watchdog_kick != nullptr))
+            this->watchdog_kick();
     };
 
     void Kernel::schedule_thread(
@@ -209,9 +301,24 @@ namespace OTOS
         return {};
     };
 
+    void Kernel::sample_clock(std::uint64_t &ticks, std::uint32_t &cycles)
+    {
+        /* Repeat until no tick occurred while sampling the timer */
+        do
+        {
+            ticks = Kernel::Ticks;
+            cycles = __otos_get_systick_elapsed();
+        } while (ticks != Kernel::Ticks);
+    };
+
     /* === Functions === */
     auto get_time_ms() -> std::uint32_t
     {
         return Kernel::get_time_ms();
     };
+
+    auto get_time_us() -> std::uint64_t
+    {
+        return Kernel::get_time_us();
+    };
 }; // namespace OTOS
\ No newline at end of file
@@ -0,0 +1,147 @@
+/**
+ * OTOS - Open Tec Operating System
+ * Copyright (c) 2021 - 2024 Sebastian Oberschwendtner, sebastian.oberschwendtner@gmail.com
+ *
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+/**
+ ==============================================================================
+ * @file    profile.cpp
+ * @author  SO
+ * @version v5.2.0
+ * @date    18-October-2026
+ * @brief   Scoped profiling zones with cycle accurate timing.
+ ==============================================================================
+ */
+
+/* === Includes === */
+#include "profile.h"
+#include <algorithm>
+#include <cstring>
+#include <misc/types.h>
+
+#if defined(__CORTEX_M)
+#include "kernel.h"
+#else
+#include <chrono>
+#endif
+
+namespace OTOS
+{
+    namespace profile
+    {
+        /* === Static Variables === */
+        namespace
+        {
+            std::array<Zone, number_zones> zones{}; /**< The table with all profiling zones. */
+            const Zone *last_zone{nullptr};         /**< The zone which was entered last. */
+            bool clock_enabled{false};              /**< Whether the profiling clock is enabled. */
+
+            /**
+             * @brief Enable the profiling clock.
+             * On ARM Cortex M3 and above this enables the DWT cycle counter.
+             */
+            void enable_clock()
+            {
+#if defined(__CORTEX_M) && (__CORTEX_M >= 3)
+                CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+                DWT->CYCCNT = 0;
+                DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+                clock_enabled = true;
+            };
+        }; // namespace
+
+        /* === Methods === */
+        auto Zone::mean() const -> std::uint32_t
+        {
+            if (this->count == 0)
+                return 0;
+            return static_cast<std::uint32_t>(this->total / this->count);
+        };
+
+        void Zone::record(const std::uint32_t cycles)
+        {
+            this->count++;
+            this->total += cycles;
+            this->min = std::min(this->min, cycles);
+            this->max = std::max(this->max, cycles);
+        };
+
+        /* === Functions === */
+        auto get_cycles() -> std::uint32_t
+        {
+#if defined(__CORTEX_M) && (__CORTEX_M >= 3)
+            /* Use the DWT cycle counter */
+            return DWT->CYCCNT;
+#elif defined(__CORTEX_M)
+            /* No DWT available, use the cycle clock of the kernel */
+            return static_cast<std::uint32_t>(Kernel::get_time_cycles());
+#else
+            /* Use the host clock in the native environment */
+            const auto now = std::chrono::steady_clock::now().time_since_epoch();
+            return static_cast<std::uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+#endif
+        };
+
+        auto get_zone(const char *name) -> Zone *
+        {
+            /* The first zone enables the profiling clock */
+            if (!clock_enabled)
+                enable_clock();
+
+            /* Find the zone with the same name or the first unused entry */
+            for (Zone &zone : zones)
+            {
+                if (zone.name == nullptr)
+                {
+                    zone.name = name;
+                    return &zone;
+                }
+                if ((zone.name == name) || (std::strcmp(zone.name, name) == 0))
+                    return &zone;
+            }
+
+            /* The zone table is full */
+            return nullptr;
+        };
+
+        auto get_last_zone() -> const char *
+        {
+            if (last_zone == nullptr)
+                return nullptr;
+            return last_zone->name;
+        };
+
+        auto get_table() -> const std::array<Zone, number_zones> &
+        {
+            return zones;
+        };
+
+        void reset()
+        {
+            /* Keep the names, but reset the statistics */
+            for (Zone &zone : zones)
+                zone = Zone{zone.name};
+        };
+
+        void detail::set_last_zone(const Zone *zone)
+        {
+            if (zone != nullptr)
+                last_zone = zone;
+        };
+    }; // namespace profile
+}; // namespace OTOS
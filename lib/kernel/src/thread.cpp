@@ -45,6 +45,17 @@ namespace OTOS
             this->state = State::Runnable;
     };
 
+    void Thread::set_heartbeat_interval(const u_base_t ticks)
+    {
+        this->heartbeat_ticks = ticks;
+        this->heartbeat_counter = 0;
+    };
+
+    void Thread::set_last_zone(const char *zone)
+    {
+        this->last_zone = zone;
+    };
+
     void Thread::set_running()
     {
         this->state = State::Running;
@@ -90,12 +101,32 @@ namespace OTOS
         return (u_base_t)(this->Stack_top - this->Stack_pointer) >= this->Stacksize;
     };
 
+    auto Thread::get_stall_count() const -> u_base_t
+    {
+        return this->stall_count;
+    };
+
+    auto Thread::get_stall_zone() const -> const char *
+    {
+        return this->stall_zone;
+    };
+
+    auto Thread::get_worst_heartbeat() const -> u_base_t
+    {
+        return this->heartbeat_worst;
+    };
+
     auto Thread::is_runnable() const -> bool
     {
         /* Return whether task is runnable */
         return this->state == State::Runnable;
     };
 
+    auto Thread::is_stalled() const -> bool
+    {
+        return (this->heartbeat_ticks > 0) && (this->heartbeat_counter > this->heartbeat_ticks);
+    };
+
     void Thread::count_tick()
     {
         /* Only count, when counter is not already at 0 */
@@ -108,4 +139,29 @@ namespace OTOS
                 this->state = State::Runnable;
         }
     };
-}; // namespace OTOS
\ No newline at end of file
+
+    auto Thread::count_heartbeat(const char *running_zone) -> bool
+    {
+        /* Threads without supervision are always alive */
+        if (this->heartbeat_ticks == 0)
+            return true;
+
+        /* Count the ticks since the last heartbeat */
+        this->heartbeat_counter++;
+        if (this->heartbeat_counter > this->heartbeat_worst)
+            this->heartbeat_worst = this->heartbeat_counter;
+
+        /* Remember where the thread was when it just stalled */
+        if (this->heartbeat_counter == (this->heartbeat_ticks + 1))
+        {
+            this->stall_count++;
+            this->stall_zone = (this->state == State::Running) ? running_zone : this->last_zone;
+        }
+        return this->heartbeat_counter <= this->heartbeat_ticks;
+    };
+
+    void Thread::heartbeat()
+    {
+        this->heartbeat_counter = 0;
+    };
+}; // namespace OTOS
@@ -53,7 +53,9 @@ namespace error {
         USART_Timeout               = -120,
         USART_BUS_Busy_Error        = -121,
         SDIO_Timeout                = -130,
-        SDIO_BUS_Busy_Error         = -131
+        SDIO_BUS_Busy_Error         = -131,
+        SDIO_Data_Error             = -132,
+        SDIO_No_DMA_Stream          = -133
     };
 }; // namespace error
 
@@ -135,5 +135,22 @@ void __otos_init_kernel(uint32_t* ThreadStack)
     inlined here as a hardcoded function.
     -------------------------------------------------------------------------------------*/
 };
+
+uint32_t __otos_get_systick_elapsed(void)
+{
+    /* Sample the SysTick counter which counts down to 0 */
+    const uint32_t reload = SysTick->LOAD;
+    uint32_t count = SysTick->VAL;
+
+    /* When a reload is pending, the counter might have wrapped after sampling */
+    if (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk)
+    {
+        count = SysTick->VAL;
+        return (reload - count) + (reload + 1U);
+    }
+
+    /* Return the elapsed cycles since the last reload */
+    return reload - count;
+};
 #endif // __CORTEX_M == 4
 #endif // __CORTEX_M
\ No newline at end of file
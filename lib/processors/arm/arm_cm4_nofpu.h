@@ -69,6 +69,18 @@ extern "C"
      */
     void __otos_init_kernel(uint32_t *ThreadStack);
 
+    /**
+     * @brief Get the number of core clock cycles which elapsed since
+     * the SysTick timer was last reloaded. When a reload is pending
+     * but not yet serviced by the SysTick interrupt, one full period
+     * is added to the returned value. This keeps the value continuous
+     * when called with interrupts disabled or from a higher priority
+     * interrupt.
+     * @return Returns the elapsed core clock cycles.
+     * @details Thread Mode or Handler Mode, Stack: any
+     */
+    uint32_t __otos_get_systick_elapsed(void);
+
 #ifdef __cplusplus
 }
 #endif // __cplusplus
@@ -66,6 +66,16 @@ namespace OTOS {
          */
         explicit TimedTask(std::uint32_t(*timer_handle)());
 
+        /**
+         * @brief Construct a new timed Task object with an additional
+         * micro-second timer. Use OTOS::get_time_us for the monotonic
+         * clock of the kernel.
+         *
+         * @param timer_handle The function handle to the timer which provides the time in ms.
+         * @param timer_handle_us The function handle to the timer which provides the time in us.
+         */
+        TimedTask(std::uint32_t(*timer_handle)(), std::uint64_t(*timer_handle_us)());
+
         /* === Methods === */
         /**
          * @brief Wait for a specified amount of time. The
@@ -88,6 +98,22 @@ namespace OTOS {
             while(this->time_elapsed_ms() < static_cast<std::uint32_t>(time_ms));
         };
 
+        /**
+         * @brief Wait for a specified amount of time in micro-seconds.
+         * The task blocks execution as long as the wait time is not over.
+         * 
+         * @param time_us The wait time in [us].
+         * @details Blocking function
+         */
+        void block_us(const uint64_t time_us)
+        {
+            /* Remember the time when the function was called */
+            this->tic();
+
+            /* Block the task until the wait time is over */
+            while(this->time_elapsed_us() < time_us);
+        };
+
         /**
          * @brief Start a time measurement by saving the current time.
          */
@@ -100,6 +126,15 @@ namespace OTOS {
          */
         auto time_elapsed_ms() const -> std::uint32_t;
 
+        /**
+         * @brief Measure the elapsed time since tic() was called
+         * with micro-second resolution. When no micro-second timer
+         * is assigned, the milli-second timer is used.
+         *
+         * @return std::uint64_t Elapsed time in [us].
+         */
+        auto time_elapsed_us() const -> std::uint64_t;
+
         /**
          * @brief Return the current time of the assigned timer in ms.
          *
@@ -120,6 +155,19 @@ namespace OTOS {
                 this->yield();
         };
 
+        /**
+         * @brief Wait for a specified amount of time in micro-seconds.
+         * The task yields as long as the wait time is not over.
+         * 
+         * @param time_us The wait time in [us].
+         */
+        void wait_us(const uint64_t time_us)
+        {
+            this->tic();
+            while(this->time_elapsed_us() < time_us)
+                this->yield();
+        };
+
         /**
          * @brief Yield execution and give control to kernel.
          */
@@ -128,7 +176,9 @@ namespace OTOS {
     private:
         /* === Properties === */
         std::uint32_t time_last{0}; /**< The last time the tic function was called. */
+        std::uint64_t time_last_us{0}; /**< The last time the tic function was called in us. */
         std::uint32_t (*const get_time_ms)(); /**< Function pointer to get the current time in ms. */
+        std::uint64_t (*const get_time_us)(){nullptr}; /**< Function pointer to get the current time in us. */
     };
 }; // namespace OTOS
 
@@ -36,10 +36,16 @@ namespace OTOS
     TimedTask::TimedTask(std::uint32_t (*timer_handle)())
         : get_time_ms{timer_handle} {};
 
+    TimedTask::TimedTask(std::uint32_t (*timer_handle)(), std::uint64_t (*timer_handle_us)())
+        : get_time_ms{timer_handle}
+        , get_time_us{timer_handle_us} {};
+
     /* === Methods === */
     void TimedTask::tic()
     {
         this->time_last = this->get_time_ms();
+        if (this->get_time_us != nullptr)
+            this->time_last_us = this->get_time_us();
     };
 
     auto TimedTask::time_elapsed_ms() const -> std::uint32_t
@@ -47,6 +53,15 @@ namespace OTOS
         return this->get_time_ms() - this->time_last;
     };
 
+    auto TimedTask::time_elapsed_us() const -> std::uint64_t
+    {
+        /* Fall back to the ms timer when no us timer is available */
+        if (this->get_time_us == nullptr)
+            return static_cast<std::uint64_t>(this->time_elapsed_ms()) * 1'000U;
+
+        return this->get_time_us() - this->time_last_us;
+    };
+
     auto TimedTask::toc() const -> std::uint32_t
     {
         return this->get_time_ms();
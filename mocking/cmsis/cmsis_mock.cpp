@@ -35,6 +35,8 @@ Mock::Callable<bool> CMSIS_NVIC_EnableIRQ;
 Mock::Callable<bool> CMSIS_NVIC_DisableIRQ;
 Mock::Callable<bool> CMSIS_NVIC_SetPriority;
 Mock::Callable<uint32_t> CMSIS_SysTick_Config;
+Mock::Callable<bool> CMSIS_disable_irq;
+uint32_t CMSIS_PRIMASK = 0;
 
 // === Functions ===
 
@@ -76,4 +78,31 @@ auto SysTick_Config(uint32_t ticks) -> uint32_t
 {
     CMSIS_SysTick_Config.add_call(static_cast<int>(ticks));
     return 0;
-};
\ No newline at end of file
+};
+
+/**
+ * @brief Mock reading the PRIMASK register.
+ * @return The current interrupt mask.
+ */
+auto __get_PRIMASK() -> uint32_t
+{
+    return CMSIS_PRIMASK;
+};
+
+/**
+ * @brief Mock writing the PRIMASK register.
+ * @param priMask The new interrupt mask.
+ */
+void __set_PRIMASK(uint32_t priMask)
+{
+    CMSIS_PRIMASK = priMask;
+};
+
+/**
+ * @brief Mock disabling all interrupts.
+ */
+void __disable_irq()
+{
+    CMSIS_disable_irq.add_call(0);
+    CMSIS_PRIMASK = 1;
+};
@@ -142,6 +142,9 @@ void NVIC_EnableIRQ(IRQn_Type IRQn);
 void NVIC_DisableIRQ(IRQn_Type IRQn);
 void NVIC_SetPriority(IRQn_Type IRQn, uint32_t priority);
 auto SysTick_Config(uint32_t ticks) -> uint32_t;
+auto __get_PRIMASK() -> uint32_t;
+void __set_PRIMASK(uint32_t priMask);
+void __disable_irq();
 
 #endif
 
@@ -35,6 +35,8 @@ Mock::Callable<uint32_t> otos_switch;
 Mock::Callable<bool> otos_yield;
 Mock::Callable<bool> otos_call_kernel;
 Mock::Callable<bool> otos_init_kernel;
+Mock::Callable<uint32_t> otos_get_systick_elapsed;
+std::uint32_t otos_systick_elapsed{0}; /* Injection point for the elapsed SysTick cycles */
 
 
 // *** Functions ***
@@ -102,4 +104,15 @@ void SVC_Handler(void)
 void __otos_init_kernel(std::uintptr_t* ThreadStack)
 {
     otos_init_kernel.add_call(0);
-};
\ No newline at end of file
+};
+
+/**
+ * @brief Get the number of core clock cycles which elapsed since
+ * the SysTick timer was last reloaded.
+ * @return Returns the value of the injection point otos_systick_elapsed.
+ */
+std::uint32_t __otos_get_systick_elapsed(void)
+{
+    otos_get_systick_elapsed.add_call(0);
+    return otos_systick_elapsed;
+};
@@ -30,5 +30,6 @@ std::uintptr_t*  __otos_switch       (std::uintptr_t* ThreadStack);
 void            __otos_yield        (void);
 void            __otos_call_kernel  (void);
 void            __otos_init_kernel  (std::uintptr_t* ThreadStack);
+std::uint32_t   __otos_get_systick_elapsed(void);
 
 #endif
\ No newline at end of file
@@ -47,6 +47,7 @@
     #include "../stm32/timer_stm32_fake.h"
     #include "../stm32/usart_stm32_fake.h"
     #include "../stm32/dma_stm32_fake.h"
+    #include "../stm32/iwdg_stm32_fake.h"
 
 #endif
 
@@ -0,0 +1,134 @@
+/**
+ * OTOS - Open Tec Operating System
+ * Copyright (c) 2021 - 2024 Sebastian Oberschwendtner, sebastian.oberschwendtner@gmail.com
+ *
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/**
+ ==============================================================================
+ * @file    async_memory.cpp
+ * @author  SO
+ * @version v5.2.0
+ * @date    18-October-2026
+ * @brief   Memory for the native environment which transfers in the background.
+ ==============================================================================
+ */
+
+/* === Includes === */
+#include "async_memory.h"
+
+namespace host
+{
+    /* === Methods === */
+    auto Async_Memory::read_single_block(const uint32_t *buffer, const uint32_t block) -> bool
+    {
+        this->interrupt_transfer();
+        return this->image->read_single_block(buffer, block);
+    };
+
+    auto Async_Memory::write_single_block(const uint32_t *buffer, const uint32_t block) -> bool
+    {
+        this->interrupt_transfer();
+        return this->image->write_single_block(buffer, block);
+    };
+
+    auto Async_Memory::read_multiple_blocks(const uint32_t *buffer, const uint32_t block, const uint32_t count) -> bool
+    {
+        this->interrupt_transfer();
+        return this->image->read_multiple_blocks(buffer, block, count);
+    };
+
+    auto Async_Memory::write_multiple_blocks(const uint32_t *buffer, const uint32_t block, const uint32_t count) -> bool
+    {
+        this->interrupt_transfer();
+        return this->image->write_multiple_blocks(buffer, block, count);
+    };
+
+    auto Async_Memory::start_read_multiple_blocks(const uint32_t *buffer, const uint32_t block, const uint32_t count) -> bool
+    {
+        return this->start_transfer(false, buffer, block, count);
+    };
+
+    auto Async_Memory::start_write_multiple_blocks(const uint32_t *buffer, const uint32_t block, const uint32_t count) -> bool
+    {
+        return this->start_transfer(true, buffer, block, count);
+    };
+
+    auto Async_Memory::is_transfer_finished() -> bool
+    {
+        if (not this->running)
+            return true;
+
+        /* The data is transferred after the latency */
+        if (++this->polls < this->latency)
+        {
+            this->statistics.waits++;
+            return false;
+        }
+        this->finish_transfer();
+        return true;
+    };
+
+    auto Async_Memory::complete_transfer() -> bool
+    {
+        /* Report the result only once */
+        this->finish_transfer();
+        const bool result = this->success;
+        this->success = true;
+        return result;
+    };
+
+    auto Async_Memory::start_transfer(
+        const bool write,
+        const uint32_t *buffer,
+        const uint32_t block,
+        const uint32_t count) -> bool
+    {
+        /* Only one transfer can run */
+        this->interrupt_transfer();
+        if ((count == 0) || (block + count > this->image->get_block_count()))
+            return false;
+
+        this->running = true;
+        this->write = write;
+        this->buffer = buffer;
+        this->block = block;
+        this->count = count;
+        this->polls = 0;
+        this->statistics.started++;
+        return true;
+    };
+
+    void Async_Memory::finish_transfer()
+    {
+        if (not this->running)
+            return;
+
+        this->running = false;
+        if (this->write)
+            this->success = this->image->write_multiple_blocks(this->buffer, this->block, this->count);
+        else
+            this->success = this->image->read_multiple_blocks(this->buffer, this->block, this->count);
+    };
+
+    void Async_Memory::interrupt_transfer()
+    {
+        if (this->running)
+            this->statistics.interrupted++;
+        this->finish_transfer();
+    };
+}; // namespace host
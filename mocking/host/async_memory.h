@@ -0,0 +1,189 @@
+/**
+ * OTOS - Open Tec Operating System
+ * Copyright (c) 2021 - 2024 Sebastian Oberschwendtner, sebastian.oberschwendtner@gmail.com
+ *
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef ASYNC_MEMORY_H_
+#define ASYNC_MEMORY_H_
+
+/* === Includes === */
+#include <cstdint>
+#include "image_memory.h"
+#include "memory/drive.h"
+
+namespace host
+{
+    /**
+     * @brief Memory for the native environment which transfers the
+     * blocks of started transfers in the background, like a memory
+     * with DMA. It uses an image memory for the blocks:
+     *
+     * host::Async_Memory memory{image, 2};
+     * fat32::Volume<host::Async_Memory> volume{memory};
+     *
+     * A started transfer is only finished after it was polled with
+     * is_transfer_finished() for the given latency. The data is copied
+     * when the transfer finishes, so a buffer which is changed or used
+     * while its transfer is running shows up in the image. Every other
+     * access finishes the running transfer first.
+     *
+     * Include this header before the volume, so the volume uses the
+     * transfer in the background.
+     */
+    class Async_Memory
+    {
+      public:
+        /* === Types === */
+        /**
+         * @brief Counters for the transfers in the background.
+         */
+        struct Statistics
+        {
+            uint32_t started{0};     /**< The number of started transfers. */
+            uint32_t waits{0};       /**< The number of polls while a transfer was running. */
+            uint32_t interrupted{0}; /**< The number of transfers which were finished by another access. */
+        };
+
+        /* === Constructors === */
+        Async_Memory() = delete;
+
+        /**
+         * @brief Construct a new Async_Memory object.
+         *
+         * @param image_used The image memory which stores the blocks.
+         * @param latency The number of polls until a started transfer is finished.
+         */
+        Async_Memory(Image_Memory &image_used, const uint32_t latency)
+            : image{&image_used}, latency{latency} {};
+
+        /* === Getters === */
+        /**
+         * @brief Get the counters for the transfers in the background.
+         * @return The statistics of the memory.
+         */
+        auto get_statistics() const -> Statistics { return this->statistics; };
+
+        /* === Methods === */
+        auto read_single_block(const uint32_t *buffer, uint32_t block) -> bool;
+        auto write_single_block(const uint32_t *buffer, uint32_t block) -> bool;
+        auto read_multiple_blocks(const uint32_t *buffer, uint32_t block, uint32_t count) -> bool;
+        auto write_multiple_blocks(const uint32_t *buffer, uint32_t block, uint32_t count) -> bool;
+
+        /**
+         * @brief Start reading consecutive blocks in the background.
+         *
+         * @param buffer The buffer for the blocks, it has to stay valid until the transfer is completed.
+         * @param block The address of the first block.
+         * @param count The number of blocks.
+         * @return Returns True when the transfer was started.
+         */
+        auto start_read_multiple_blocks(const uint32_t *buffer, uint32_t block, uint32_t count) -> bool;
+
+        /**
+         * @brief Start writing consecutive blocks in the background.
+         *
+         * @param buffer The data of the blocks, it has to stay valid until the transfer is completed.
+         * @param block The address of the first block.
+         * @param count The number of blocks.
+         * @return Returns True when the transfer was started.
+         */
+        auto start_write_multiple_blocks(const uint32_t *buffer, uint32_t block, uint32_t count) -> bool;
+
+        /**
+         * @brief Poll the running transfer. Each poll counts
+         * towards the latency of the transfer.
+         *
+         * @return Returns True when no transfer is running anymore.
+         */
+        auto is_transfer_finished() -> bool;
+
+        /**
+         * @brief Complete the transfer which was started in the background.
+         *
+         * @return Returns True when the blocks were transferred.
+         */
+        auto complete_transfer() -> bool;
+
+      private:
+        /* === Methods === */
+        /**
+         * @brief Start a transfer in the background.
+         *
+         * @param write Whether the blocks are written.
+         * @param buffer The buffer of the blocks.
+         * @param block The address of the first block.
+         * @param count The number of blocks.
+         * @return Returns True when the transfer was started.
+         */
+        auto start_transfer(bool write, const uint32_t *buffer, uint32_t block, uint32_t count) -> bool;
+
+        /**
+         * @brief Copy the data of the running transfer, the result
+         * is kept for complete_transfer().
+         */
+        void finish_transfer();
+
+        /**
+         * @brief Finish the running transfer before another access.
+         */
+        void interrupt_transfer();
+
+        /* === Properties === */
+        Image_Memory *image;             /**< The image memory which stores the blocks. */
+        uint32_t latency;                /**< The number of polls until a transfer is finished. */
+        Statistics statistics{};         /**< The counters for the transfers. */
+        bool running{false};             /**< Whether a transfer is running. */
+        bool write{false};               /**< Whether the running transfer writes the blocks. */
+        const uint32_t *buffer{nullptr}; /**< The buffer of the running transfer. */
+        uint32_t block{0};               /**< The first block of the running transfer. */
+        uint32_t count{0};               /**< The number of blocks of the running transfer. */
+        uint32_t polls{0};               /**< The number of polls of the running transfer. */
+        bool success{true};              /**< The result of the last transfer. */
+    };
+}; // namespace host
+
+namespace drive
+{
+    /* === Transfer the blocks of the host memory in the background === */
+    inline bool start_read_multiple_blocks(host::Async_Memory &memory, const uint32_t *buffer, const uint32_t block, const uint32_t count)
+    {
+        return memory.start_read_multiple_blocks(buffer, block, count);
+    };
+    inline bool is_read_finished(host::Async_Memory &memory)
+    {
+        return memory.is_transfer_finished();
+    };
+    inline bool complete_read(host::Async_Memory &memory)
+    {
+        return memory.complete_transfer();
+    };
+    inline bool start_write_multiple_blocks(host::Async_Memory &memory, const uint32_t *buffer, const uint32_t block, const uint32_t count)
+    {
+        return memory.start_write_multiple_blocks(buffer, block, count);
+    };
+    inline bool is_write_finished(host::Async_Memory &memory)
+    {
+        return memory.is_transfer_finished();
+    };
+    inline bool complete_write(host::Async_Memory &memory)
+    {
+        return memory.complete_transfer();
+    };
+}; // namespace drive
+
+#endif // ASYNC_MEMORY_H_
@@ -0,0 +1,223 @@
+/**
+ * OTOS - Open Tec Operating System
+ * Copyright (c) 2021 - 2024 Sebastian Oberschwendtner, sebastian.oberschwendtner@gmail.com
+ *
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+/**
+ ==============================================================================
+ * @file    image_memory.cpp
+ * @author  SO
+ * @version v5.2.0
+ * @date    18-October-2026
+ * @brief   Memory backed by a disk image file for the native environment.
+ ==============================================================================
+ */
+
+/* === Includes === */
+#include "image_memory.h"
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define OTOS_IMAGE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace host
+{
+    /* === Types === */
+    /**
+     * @brief The mapped image file. Hosts without mmap() read
+     * the whole image to RAM and write it back when it is closed.
+     */
+    struct Image_Memory::Mapping
+    {
+        uint8_t *data{nullptr};  /**< The content of the image. */
+        uint64_t size{0};        /**< [bytes] The size of the image. */
+        Statistics statistics{}; /**< The counters for the accesses. */
+#ifdef OTOS_IMAGE_MMAP
+        int file{-1}; /**< The descriptor of the image file. */
+
+        ~Mapping()
+        {
+            if (this->data != nullptr)
+                munmap(this->data, this->size);
+            if (this->file >= 0)
+                ::close(this->file);
+        };
+
+        auto map(const char *path) -> bool
+        {
+            this->file = ::open(path, O_RDWR);
+            if (this->file < 0)
+                return false;
+            struct stat status{};
+            if ((fstat(this->file, &status) != 0) || (status.st_size < static_cast<off_t>(block_size)))
+                return false;
+            this->size = static_cast<uint64_t>(status.st_size);
+            void *address = mmap(nullptr, this->size, PROT_READ | PROT_WRITE, MAP_SHARED, this->file, 0);
+            if (address == MAP_FAILED)
+                return false;
+            this->data = static_cast<uint8_t *>(address);
+            return true;
+        };
+#else
+        std::vector<uint8_t> content{}; /**< The copy of the image. */
+        std::FILE *file{nullptr};       /**< The image file. */
+
+        ~Mapping()
+        {
+            if (this->file == nullptr)
+                return;
+            std::rewind(this->file);
+            std::fwrite(this->content.data(), 1, this->content.size(), this->file);
+            std::fclose(this->file);
+        };
+
+        auto map(const char *path) -> bool
+        {
+            this->file = std::fopen(path, "r+b");
+            if (this->file == nullptr)
+                return false;
+            std::fseek(this->file, 0, SEEK_END);
+            const long length = std::ftell(this->file);
+            if (length < static_cast<long>(block_size))
+                return false;
+            this->content.resize(static_cast<std::size_t>(length));
+            std::rewind(this->file);
+            if (std::fread(this->content.data(), 1, this->content.size(), this->file) != this->content.size())
+                return false;
+            this->data = this->content.data();
+            this->size = this->content.size();
+            return true;
+        };
+#endif
+    };
+
+    /* === Getters === */
+    auto Image_Memory::get_block_count() const -> uint32_t
+    {
+        if (this->mapping == nullptr)
+            return 0;
+        return static_cast<uint32_t>(this->mapping->size / block_size);
+    };
+
+    auto Image_Memory::get_statistics() const -> Statistics
+    {
+        if (this->mapping == nullptr)
+            return {};
+        return this->mapping->statistics;
+    };
+
+    auto Image_Memory::get_block(const uint32_t block) const -> uint8_t *
+    {
+        if (not this->contains(block, 1))
+            return nullptr;
+        return this->mapping->data + static_cast<uint64_t>(block) * block_size;
+    };
+
+    /* === Methods === */
+    void Image_Memory::close()
+    {
+        this->mapping.reset();
+    };
+
+    auto Image_Memory::create(const char *path, const uint32_t blocks) -> bool
+    {
+        this->close();
+        if (blocks == 0)
+            return false;
+
+        /* Extend the empty file to the size of the image, the skipped blocks read as zeros */
+        std::FILE *file = std::fopen(path, "wb");
+        if (file == nullptr)
+            return false;
+        const long last_byte = static_cast<long>(static_cast<uint64_t>(blocks) * block_size - 1);
+        const bool success = (std::fseek(file, last_byte, SEEK_SET) == 0) && (std::fputc(0, file) == 0);
+        std::fclose(file);
+        return success && this->open(path);
+    };
+
+    auto Image_Memory::open(const char *path) -> bool
+    {
+        this->close();
+        auto image = std::make_shared<Mapping>();
+        if (not image->map(path))
+            return false;
+        this->mapping = image;
+        return true;
+    };
+
+    void Image_Memory::reset_statistics()
+    {
+        if (this->mapping != nullptr)
+            this->mapping->statistics = {};
+    };
+
+    auto Image_Memory::read_single_block(const uint32_t *buffer, const uint32_t block) -> bool
+    {
+        return this->read_multiple_blocks(buffer, block, 1);
+    };
+
+    auto Image_Memory::write_single_block(const uint32_t *buffer, const uint32_t block) -> bool
+    {
+        return this->write_multiple_blocks(buffer, block, 1);
+    };
+
+    auto Image_Memory::read_multiple_blocks(const uint32_t *buffer, const uint32_t block, const uint32_t count) -> bool
+    {
+        if ((count == 0) || not this->contains(block, count))
+            return false;
+
+        /* Copy the blocks to the buffer */
+        const uint8_t *begin = this->get_block(block);
+        std::copy(begin, begin + count * block_size, reinterpret_cast<uint8_t *>(const_cast<uint32_t *>(buffer)));
+
+        /* Count the access */
+        Statistics &statistics = this->mapping->statistics;
+        statistics.reads++;
+        statistics.blocks_read += count;
+        statistics.bytes_read += count * block_size;
+        return true;
+    };
+
+    auto Image_Memory::write_multiple_blocks(const uint32_t *buffer, const uint32_t block, const uint32_t count) -> bool
+    {
+        if ((count == 0) || not this->contains(block, count))
+            return false;
+
+        /* Copy the buffer to the blocks */
+        const auto *begin = reinterpret_cast<const uint8_t *>(buffer);
+        std::copy(begin, begin + count * block_size, this->get_block(block));
+
+        /* Count the access */
+        Statistics &statistics = this->mapping->statistics;
+        statistics.writes++;
+        statistics.blocks_written += count;
+        statistics.bytes_written += count * block_size;
+        return true;
+    };
+
+    auto Image_Memory::contains(const uint32_t block, const uint32_t count) const -> bool
+    {
+        return (this->mapping != nullptr) && (static_cast<uint64_t>(block) + count <= this->get_block_count());
+    };
+}; // namespace host
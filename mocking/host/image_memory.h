@@ -0,0 +1,174 @@
+/**
+ * OTOS - Open Tec Operating System
+ * Copyright (c) 2021 - 2024 Sebastian Oberschwendtner, sebastian.oberschwendtner@gmail.com
+ *
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef IMAGE_MEMORY_H_
+#define IMAGE_MEMORY_H_
+
+/* === Includes === */
+#include <cstdint>
+#include <memory>
+
+namespace host
+{
+    /**
+     * @brief Memory for the native environment which stores its
+     * blocks in a disk image file on the host, e.g. an image which
+     * was formatted with mkfs.vfat:
+     *
+     * host::Image_Memory image;
+     * image.open("card.img");
+     * fat32::Volume<host::Image_Memory> volume{image};
+     *
+     * The image is memory-mapped, so accessing a block copies the
+     * data without a system call. Copies of the object share the
+     * image and its statistics, so the copy which is kept by a
+     * volume counts the accesses for the original object.
+     */
+    class Image_Memory
+    {
+      public:
+        /* === Types === */
+        /**
+         * @brief Counters for the accesses of the memory.
+         * One transfer of multiple blocks counts as one operation.
+         */
+        struct Statistics
+        {
+            uint32_t reads{0};          /**< The number of read operations. */
+            uint32_t writes{0};         /**< The number of write operations. */
+            uint32_t blocks_read{0};    /**< The number of blocks which were read. */
+            uint32_t blocks_written{0}; /**< The number of blocks which were written. */
+            uint64_t bytes_read{0};     /**< The number of bytes which were read. */
+            uint64_t bytes_written{0};  /**< The number of bytes which were written. */
+        };
+
+        /* === Parameters === */
+        static constexpr uint32_t block_size = 512; /**< The size of one block in bytes. */
+
+        /* === Getters === */
+        /**
+         * @brief Get the number of blocks of the image.
+         * @return The number of blocks, 0 when no image is open.
+         */
+        auto get_block_count() const -> uint32_t;
+
+        /**
+         * @brief Get the counters for the accesses of the image.
+         * @return The statistics of all copies of the memory.
+         */
+        auto get_statistics() const -> Statistics;
+
+        /**
+         * @brief Get the data of a block, e.g. to prepare or
+         * check an image without counting the access.
+         * @param block The address of the block.
+         * @return Pointer to the 512 bytes of the block, nullptr when the block is not in the image.
+         */
+        auto get_block(uint32_t block) const -> uint8_t *;
+
+        /* === Methods === */
+        /**
+         * @brief Close the image. The changed blocks are
+         * written to the file when the last copy of the
+         * memory closes the image.
+         */
+        void close();
+
+        /**
+         * @brief Create a new image file filled with zeros and open it.
+         * An existing file is overwritten. The file is created sparse
+         * on most hosts, so large images only occupy the used blocks.
+         *
+         * @param path The path to the image file.
+         * @param blocks The number of blocks of the image.
+         * @return Returns True when the image was created.
+         */
+        auto create(const char *path, uint32_t blocks) -> bool;
+
+        /**
+         * @brief Open an existing image file.
+         *
+         * @param path The path to the image file.
+         * @return Returns True when the image was opened.
+         */
+        auto open(const char *path) -> bool;
+
+        /**
+         * @brief Reset the counters for the accesses of the image.
+         */
+        void reset_statistics();
+
+        /**
+         * @brief Read one block of the image.
+         *
+         * @param buffer The buffer for the block, it has to hold 512 bytes.
+         * @param block The address of the block.
+         * @return Returns True when the block was read.
+         */
+        auto read_single_block(const uint32_t *buffer, uint32_t block) -> bool;
+
+        /**
+         * @brief Write one block of the image.
+         *
+         * @param buffer The data of the block, it has to hold 512 bytes.
+         * @param block The address of the block.
+         * @return Returns True when the block was written.
+         */
+        auto write_single_block(const uint32_t *buffer, uint32_t block) -> bool;
+
+        /**
+         * @brief Read consecutive blocks of the image.
+         *
+         * @param buffer The buffer for the blocks, it has to hold count * 512 bytes.
+         * @param block The address of the first block.
+         * @param count The number of blocks.
+         * @return Returns True when the blocks were read.
+         */
+        auto read_multiple_blocks(const uint32_t *buffer, uint32_t block, uint32_t count) -> bool;
+
+        /**
+         * @brief Write consecutive blocks of the image.
+         *
+         * @param buffer The data of the blocks, it has to hold count * 512 bytes.
+         * @param block The address of the first block.
+         * @param count The number of blocks.
+         * @return Returns True when the blocks were written.
+         */
+        auto write_multiple_blocks(const uint32_t *buffer, uint32_t block, uint32_t count) -> bool;
+
+      private:
+        /* === Types === */
+        struct Mapping;
+
+        /* === Methods === */
+        /**
+         * @brief Check whether blocks are within the image.
+         * @param block The address of the first block.
+         * @param count The number of blocks.
+         * @return Returns True when all blocks can be accessed.
+         */
+        auto contains(uint32_t block, uint32_t count) const -> bool;
+
+        /* === Properties === */
+        std::shared_ptr<Mapping> mapping{}; /**< The mapped image, shared by all copies. */
+    };
+}; // namespace host
+
+#endif // IMAGE_MEMORY_H_
@@ -115,4 +115,52 @@ void DMA_Stream_TypeDef::registers_to_default(void)
     this->M0AR = 0;
     this->M1AR = 0;
     this->FCR = 0;
-};
\ No newline at end of file
+};
+
+/**
+ * @brief Get the fake of a stream and the offset of its interrupt flags.
+ * @param dma The DMA controller of the stream.
+ * @param stream The number of the stream.
+ * @param flags Returns the pointer to the interrupt status register of the stream.
+ * @param offset Returns the bit offset of the stream flags.
+ * @return The fake stream.
+ */
+static DMA_Stream_TypeDef *get_stream(DMA_TypeDef *dma, uint8_t stream, Fake::Register_t *&flags, uint8_t &offset)
+{
+    static DMA_Stream_TypeDef *const streams[2][8] = {
+        {DMA1_Stream0, DMA1_Stream1, DMA1_Stream2, DMA1_Stream3, DMA1_Stream4, DMA1_Stream5, DMA1_Stream6, DMA1_Stream7},
+        {DMA2_Stream0, DMA2_Stream1, DMA2_Stream2, DMA2_Stream3, DMA2_Stream4, DMA2_Stream5, DMA2_Stream6, DMA2_Stream7}};
+    static const uint8_t offsets[4] = {0, 6, 16, 22};
+    flags = (stream < 4) ? &dma->LISR : &dma->HISR;
+    offset = offsets[stream % 4];
+    return streams[(dma == DMA1) ? 0 : 1][stream];
+};
+
+/**
+ * @brief Simulate a completed transfer of a stream.
+ * Sets the transfer complete flag and disables the stream.
+ * @param stream The number of the stream.
+ */
+void DMA_TypeDef::finish_transfer(uint8_t stream)
+{
+    Fake::Register_t *flags = nullptr;
+    uint8_t offset = 0;
+    DMA_Stream_TypeDef *instance = get_stream(this, stream, flags, offset);
+    *flags |= (DMA_LISR_TCIF0 << offset);
+    instance->CR &= ~DMA_SxCR_EN;
+    instance->NDTR = 0;
+};
+
+/**
+ * @brief Simulate a transfer error of a stream.
+ * Sets the transfer error flag and disables the stream.
+ * @param stream The number of the stream.
+ */
+void DMA_TypeDef::fail_transfer(uint8_t stream)
+{
+    Fake::Register_t *flags = nullptr;
+    uint8_t offset = 0;
+    DMA_Stream_TypeDef *instance = get_stream(this, stream, flags, offset);
+    *flags |= (DMA_LISR_TEIF0 << offset);
+    instance->CR &= ~DMA_SxCR_EN;
+};
@@ -57,6 +57,10 @@ public:
     // Methods for unit testing
     void registers_to_default(void) override;
 
+    // Methods to simulate the end of a transfer of a stream
+    void finish_transfer(uint8_t stream);
+    void fail_transfer(uint8_t stream);
+
     // Fake registers of DMA
     Fake::Register_t LISR;  /*!< DMA low interrupt status register,      Address offset: 0x00 */
     Fake::Register_t HISR;  /*!< DMA high interrupt status register,     Address offset: 0x04 */
@@ -0,0 +1,64 @@
+/**
+ * OTOS - Open Tec Operating System
+ * Copyright (c) 2021 Sebastian Oberschwendtner, sebastian.oberschwendtner@gmail.com
+ *
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+/**
+ ==============================================================================
+ * @file    iwdg_stm32_fake.cpp
+ * @author  SO
+ * @version v5.2.0
+ * @date    18-October-2026
+ * @brief   Fakes for the stm32 IWDG peripheral for unit testing.
+ ==============================================================================
+ */
+
+// *** Includes ***
+#include "iwdg_stm32_fake.h"
+
+// *** Fakes ***
+// Peripheral objects
+static IWDG_TypeDef IWDG_Fake;
+
+// Pointer to peripherals
+IWDG_TypeDef* IWDG = &IWDG_Fake;
+
+// Base addresses to peripherals
+std::uintptr_t IWDG_BASE = reinterpret_cast<std::uintptr_t>(IWDG);
+
+// *** Methods ***
+
+/**
+ * @brief Constructor for watchdog object which initializes
+ * the watchdog to default values.
+ */
+IWDG_TypeDef::IWDG_TypeDef()
+{
+    // Reinit to default values
+    registers_to_default();
+};
+
+/**
+ * @brief Reset all the registers to the default values
+ */
+void IWDG_TypeDef::registers_to_default(void)
+{
+    this->KR  = 0x00;
+    this->PR  = 0x00;
+    this->RLR = 0xFFF;
+    this->SR  = 0x00;
+};
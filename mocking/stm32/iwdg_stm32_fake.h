@@ -0,0 +1,76 @@
+/**
+ * OTOS - Open Tec Operating System
+ * Copyright (c) 2021 Sebastian Oberschwendtner, sebastian.oberschwendtner@gmail.com
+ *
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * @attention
+ * All the peripheral type definition are taken from the peripheral library
+ * files provided by ST.
+ * 
+ * Copyright:
+ * <h2><center>&copy; COPYRIGHT(c) 2017 STMicroelectronics</center></h2>
+ */
+
+#ifndef IWDG_STM32_FAKE_H_
+#define IWDG_STM32_FAKE_H_
+
+// *** Includes ***
+#include "../base/fake.h"
+#include <cstdint>
+
+// *** The peripheral typedefs
+/** 
+  * @brief Independent WATCHDOG
+  */
+
+class IWDG_TypeDef: public Fake::Peripheral
+{
+public:
+  // Constructor to mimic device initialization
+  IWDG_TypeDef();
+
+  // Methods for unit testing
+  void registers_to_default(void) override;
+
+  // Fake registers of peripheral
+  Fake::Register_t KR;   /*!< IWDG Key register,       Address offset: 0x00 */
+  Fake::Register_t PR;   /*!< IWDG Prescaler register, Address offset: 0x04 */
+  Fake::Register_t RLR;  /*!< IWDG Reload register,    Address offset: 0x08 */
+  Fake::Register_t SR;   /*!< IWDG Status register,    Address offset: 0x0C */
+};
+
+// *** Public references to fake peripherals
+// Fake peripheral pointers
+extern IWDG_TypeDef* IWDG;
+
+// Fake addresses
+extern std::uintptr_t IWDG_BASE;
+
+// *** Register bits
+#define IWDG_PR_PR_Pos      (0U)
+#define IWDG_PR_PR_Msk      (0x7UL << IWDG_PR_PR_Pos)
+#define IWDG_PR_PR          IWDG_PR_PR_Msk
+#define IWDG_RLR_RL_Pos     (0U)
+#define IWDG_RLR_RL_Msk     (0xFFFUL << IWDG_RLR_RL_Pos)
+#define IWDG_RLR_RL         IWDG_RLR_RL_Msk
+#define IWDG_SR_PVU_Pos     (0U)
+#define IWDG_SR_PVU_Msk     (0x1UL << IWDG_SR_PVU_Pos)
+#define IWDG_SR_PVU         IWDG_SR_PVU_Msk
+#define IWDG_SR_RVU_Pos     (1U)
+#define IWDG_SR_RVU_Msk     (0x1UL << IWDG_SR_RVU_Pos)
+#define IWDG_SR_RVU         IWDG_SR_RVU_Msk
+
+#endif
@@ -77,4 +77,15 @@ void SDIO_TypeDef::registers_to_default(void)
     this->MASK = 0;
     this->FIFOCNT = 0;
     this->FIFO = 0;
-};
\ No newline at end of file
+};
+
+/**
+ * @brief Simulate the end of a data transfer.
+ * The data counter reaches zero and the data path is idle.
+ */
+void SDIO_TypeDef::finish_data_transfer(void)
+{
+    this->DCOUNT = 0;
+    this->STA &= ~(SDIO_STA_RXACT | SDIO_STA_TXACT);
+    this->STA |= SDIO_STA_DATAEND | SDIO_STA_DBCKEND;
+};
@@ -400,6 +400,9 @@ struct SDIO_TypeDef: Fake::Peripheral
     // *** Methods ***
     void registers_to_default(void) override;
 
+    // Methods to simulate the data path
+    void finish_data_transfer(void);
+
     // *** Register Fakes ***
     Fake::Register_t POWER;          /*!< SDIO power control register,    Address offset: 0x00 */
     Fake::Register_t CLKCR;          /*!< SDI clock control register,     Address offset: 0x04 */
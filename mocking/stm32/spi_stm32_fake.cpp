@@ -29,6 +29,7 @@
 
 // *** Includes ***
 #include "spi_stm32_fake.h"
+#include <algorithm>
 
 // *** Fakes ***
 // Fake Peripheral
@@ -83,4 +84,287 @@ void SPI_TypeDef::registers_to_default(void)
     this->TXCRCR = 0;
     this->I2SCFGR = 0;
     this->I2SPR = 0;
-};
\ No newline at end of file
+};
+// *** SD card in SPI mode ***
+/**
+ * @brief Compute the CRC7 of a command bit by bit.
+ */
+static uint8_t fake_crc7(const uint8_t *data, uint32_t length)
+{
+    uint8_t crc = 0;
+    for (uint32_t i = 0; i < length * 8; i++)
+    {
+        const bool bit = (data[i / 8] >> (7 - (i % 8))) & 1;
+        const bool msb = (crc >> 6) & 1;
+        crc = (crc << 1) & 0x7F;
+        if (bit != msb)
+            crc ^= 0x09;
+    }
+    return crc;
+};
+
+/**
+ * @brief Compute the CRC16 (CCITT) of data bit by bit.
+ */
+static uint16_t fake_crc16(const uint8_t *data, uint32_t length)
+{
+    uint16_t crc = 0;
+    for (uint32_t i = 0; i < length; i++)
+    {
+        crc ^= data[i] << 8;
+        for (uint8_t bit = 0; bit < 8; bit++)
+            crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+    }
+    return crc;
+};
+
+/**
+ * @brief Constructor for the fake SD card.
+ * @param block_count The number of blocks of the card.
+ */
+Fake::SD_Card::SD_Card(const uint32_t block_count)
+    : blocks(block_count * 512, 0)
+{
+};
+
+/**
+ * @brief Set the chip select of the card.
+ * A command which is not complete is discarded.
+ */
+void Fake::SD_Card::select(const bool selected)
+{
+    this->selected = selected;
+    this->frame_length = 0;
+};
+
+/**
+ * @brief Exchange one byte with the host.
+ * @param mosi The byte which is sent by the host.
+ * @return The byte which is sent by the card.
+ */
+auto Fake::SD_Card::exchange(const uint8_t mosi) -> uint8_t
+{
+    // The card does not drive the data line without chip select
+    if (!this->selected)
+    {
+        this->idle_clocks++;
+        return 0xFF;
+    }
+
+    // Continue sending blocks until the host stops the transfer
+    if (this->output.empty() && (this->state == State::Read_Stream))
+        this->queue_block(this->address++);
+
+    uint8_t miso = 0xFF;
+    if (!this->output.empty())
+    {
+        miso = this->output.front();
+        this->output.pop_front();
+    }
+
+    switch (this->state)
+    {
+    case State::Write_Token:
+        if ((mosi == 0xFE) || (mosi == 0xFC))
+        {
+            this->received.clear();
+            this->state = State::Write_Data;
+        }
+        else if ((mosi == 0xFD) && this->multiple)
+        {
+            this->output.assign({0xFF, 0x00, 0x00});
+            this->state = State::Command;
+        }
+        return miso;
+
+    case State::Write_Data:
+        this->received.push_back(mosi);
+        if (this->received.size() == 514)
+            this->finish_write();
+        return miso;
+
+    default:
+        // Commands start with 0b01
+        if ((this->frame_length == 0) && ((mosi & 0xC0) != 0x40))
+            return miso;
+        this->frame[this->frame_length++] = mosi;
+        if (this->frame_length == 6)
+        {
+            this->frame_length = 0;
+            this->execute();
+        }
+        return miso;
+    }
+};
+
+/**
+ * @brief Get the data of a block.
+ * @param block The address of the block.
+ * @return Pointer to the 512 bytes of the block.
+ */
+auto Fake::SD_Card::get_block(const uint32_t block) -> uint8_t *
+{
+    return this->blocks.data() + block * 512;
+};
+
+/**
+ * @brief Execute the received command.
+ */
+void Fake::SD_Card::execute()
+{
+    const uint8_t index = this->frame[0] & 0x3F;
+    const uint32_t argument = (this->frame[1] << 24) | (this->frame[2] << 16) | (this->frame[3] << 8) | this->frame[4];
+    const bool app = this->app_command;
+    this->app_command = false;
+    this->commands.push_back(index);
+
+    // The CRC of CMD0 and CMD8 is always checked
+    const bool check_crc = this->crc_enabled || (index == 0) || (index == 8);
+    if (check_crc && (this->frame[5] != ((fake_crc7(this->frame, 5) << 1) | 1)))
+    {
+        this->respond({static_cast<uint8_t>(this->get_R1() | 0x08)});
+        return;
+    }
+
+    // The SCR of a card with specification 3.0, 4bit bus and CMD23
+    static const uint8_t scr[8]{0x02, 0x35, 0x80, 0x03, 0, 0, 0, 0};
+    uint8_t status[64]{0};
+
+    switch (index)
+    {
+    case 0:
+        this->idle = true;
+        this->crc_enabled = false;
+        this->state = State::Command;
+        this->output.clear();
+        this->respond({0x01});
+        break;
+    case 6:
+        if (app)
+        {
+            this->respond({static_cast<uint8_t>(this->get_R1() | 0x04)});
+            break;
+        }
+        // High speed is supported and selected
+        status[13] = 0b10;
+        status[16] = 0x01;
+        this->respond({this->get_R1()});
+        this->queue_data(status, 64);
+        break;
+    case 8:
+        this->respond({this->get_R1(), 0x00, 0x00, 0x01, static_cast<uint8_t>(argument)});
+        break;
+    case 12:
+        // The response follows a stuff byte, then the card is busy
+        this->state = State::Command;
+        this->output.assign({0x3F, 0xFF, this->get_R1(), 0x00, 0x00});
+        break;
+    case 13:
+        // Speed class 10 with 4 MiB allocation units
+        status[8] = 4;
+        status[10] = 0x90;
+        this->respond({this->get_R1(), 0x00});
+        this->queue_data(status, 64);
+        break;
+    case 17:
+        this->respond({this->get_R1()});
+        this->queue_block(argument);
+        break;
+    case 18:
+        this->respond({this->get_R1()});
+        this->address = argument;
+        this->state = State::Read_Stream;
+        break;
+    case 24:
+    case 25:
+        this->respond({this->get_R1()});
+        this->address = argument;
+        this->multiple = (index == 25);
+        this->state = State::Write_Token;
+        break;
+    case 41:
+        if (this->init_polls > 0)
+            this->init_polls--;
+        else
+            this->idle = false;
+        this->respond({this->get_R1()});
+        break;
+    case 51:
+        this->respond({this->get_R1()});
+        this->queue_data(scr, 8);
+        break;
+    case 55:
+        this->app_command = true;
+        this->respond({this->get_R1()});
+        break;
+    case 58:
+        // Power up is finished for a SDHC card, 3.0V
+        this->respond({this->get_R1(), static_cast<uint8_t>(this->idle ? 0x00 : 0xC0), 0x02, 0x00, 0x00});
+        break;
+    case 59:
+        this->crc_enabled = argument & 1;
+        this->respond({this->get_R1()});
+        break;
+    default:
+        this->respond({static_cast<uint8_t>(this->get_R1() | 0x04)});
+        break;
+    }
+};
+
+/**
+ * @brief Queue a response, which follows one byte after the command.
+ */
+void Fake::SD_Card::respond(std::initializer_list<uint8_t> response)
+{
+    this->output.assign({0xFF});
+    this->output.insert(this->output.end(), response);
+};
+
+/**
+ * @brief Queue data with its start token and CRC.
+ */
+void Fake::SD_Card::queue_data(const uint8_t *data, const uint32_t length)
+{
+    uint16_t crc = fake_crc16(data, length);
+    if (this->corrupt_crc)
+    {
+        crc = ~crc;
+        this->corrupt_crc = false;
+    }
+    this->output.insert(this->output.end(), {0xFF, 0xFF, 0xFE});
+    this->output.insert(this->output.end(), data, data + length);
+    this->output.insert(this->output.end(), {static_cast<uint8_t>(crc >> 8), static_cast<uint8_t>(crc)});
+};
+
+/**
+ * @brief Queue a block, blocks out of range send an error token.
+ */
+void Fake::SD_Card::queue_block(const uint32_t block)
+{
+    if (block >= (this->blocks.size() / 512))
+    {
+        this->output.insert(this->output.end(), {0xFF, 0x08});
+        this->state = State::Command;
+        return;
+    }
+    this->queue_data(this->get_block(block), 512);
+};
+
+/**
+ * @brief Check and store the received block.
+ */
+void Fake::SD_Card::finish_write()
+{
+    this->state = this->multiple ? State::Write_Token : State::Command;
+    const uint16_t crc = (this->received[512] << 8) | this->received[513];
+    if (this->crc_enabled && (crc != fake_crc16(this->received.data(), 512)))
+    {
+        // Data rejected due to a CRC error
+        this->output.assign({0x0B});
+        return;
+    }
+    if (this->address < (this->blocks.size() / 512))
+        std::copy(this->received.begin(), this->received.begin() + 512, this->get_block(this->address));
+    this->address++;
+    this->output.assign({0x05, 0x00, 0x00, 0x00});
+};
@@ -30,6 +30,9 @@
 // *** Includes ***
 #include "../base/fake.h"
 #include <cstdint>
+#include <deque>
+#include <initializer_list>
+#include <vector>
 
 /******************************************************************************/
 /*                                                                            */
@@ -248,4 +251,66 @@ extern std::uintptr_t SPI4_BASE;
 extern std::uintptr_t SPI5_BASE;
 extern std::uintptr_t SPI6_BASE;
 
+// *** Protocol fakes ***
+namespace Fake
+{
+    /**
+     * @brief Model of a SDHC card in SPI mode. The data register
+     * of the fake peripheral cannot intercept the transfers, so the
+     * test bus passes every byte, which is clocked by the host, to
+     * exchange(). The card responds with the timing of a real card:
+     * One byte before the responses and the data tokens and busy
+     * bytes after writes and stops.
+     */
+    class SD_Card
+    {
+    public:
+        // Constructor
+        SD_Card(uint32_t block_count = 64);
+
+        // Methods for unit testing
+        void select(bool selected);
+        auto exchange(uint8_t mosi) -> uint8_t;
+        auto get_block(uint32_t block) -> uint8_t *;
+
+        // Properties
+        std::vector<uint8_t> blocks;   // The data of the card
+        std::vector<uint8_t> commands; // The indices of all received commands
+        uint32_t idle_clocks{0};       // The bytes which were clocked without chip select
+        uint32_t init_polls{2};        // How often ACMD41 responds with idle
+        bool crc_enabled{false};       // Whether the card checks the CRC of all commands and data
+        bool corrupt_crc{false};       // Send a wrong CRC with the next data
+
+    private:
+        // Types
+        enum class State
+        {
+            Command,
+            Read_Stream,
+            Write_Token,
+            Write_Data
+        };
+
+        // Methods
+        void execute();
+        void respond(std::initializer_list<uint8_t> response);
+        void queue_data(const uint8_t *data, uint32_t length);
+        void queue_block(uint32_t block);
+        void finish_write();
+        auto get_R1() const -> uint8_t { return this->idle ? 0x01 : 0x00; };
+
+        // Properties
+        std::deque<uint8_t> output{};    // The bytes which are sent next
+        std::vector<uint8_t> received{}; // The data of the block which is written
+        uint8_t frame[6]{0};
+        uint8_t frame_length{0};
+        uint32_t address{0};
+        State state{State::Command};
+        bool selected{false};
+        bool idle{true};
+        bool app_command{false};
+        bool multiple{false};
+    };
+};
+
 #endif
\ No newline at end of file
@@ -84,12 +84,12 @@ OTOS::Kernel OS;
 auto main() -> int
 {
     stm_core::switch_system_clock<stm_core::Clock::PLL_HSI, F_CPU/1000000, F_APB1/1000000, F_APB2/1000000>();
-    // Configure SysTick timer for interrupts every 1 ms
-    timer::SysTick_Configure();
+    // Configure SysTick timer for interrupts with the kernel tick rate
+    timer::SysTick_Configure(OTOS::tick_rate_hz);
 
     // Schedule Threads
-    OS.schedule_thread<128U>(&Blink_LED3, OTOS::Priority::Normal, 1U);
-    OS.schedule_thread<128U>(&Blink_LED4, OTOS::Priority::Normal, 5U);
+    OS.schedule_thread<128U, 1U>(&Blink_LED3, OTOS::Priority::Normal);
+    OS.schedule_thread<128U, 5U>(&Blink_LED4, OTOS::Priority::Normal);
 
     // Start the task execution
     OS.start();
@@ -100,10 +100,10 @@ auto main() -> int
 
 /** 
  * @brief Provide a Interrupt handler for the systick timer,
- * which gets called every 1 ms.
+ * which gets called every kernel tick.
  */
 extern "C" void SysTick_Handler()
 {
-    OS.count_time_ms();
+    OS.count_tick();
     OS.update_schedule();
 };
\ No newline at end of file
@@ -0,0 +1,243 @@
+/**
+ * OTOS - Open Tec Operating System
+ * Copyright (c) 2021 Sebastian Oberschwendtner, sebastian.oberschwendtner@gmail.com
+ *
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+/**
+ ==============================================================================
+ * @file    test_append.cpp
+ * @author  SO
+ * @version v5.2.0
+ * @date    18-October-2026
+ * @brief   Benchmark for appending to a file on a mostly full FAT32 volume.
+ ==============================================================================
+ */
+
+/* === Includes === */
+#include <unity.h>
+#include <mock.h>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <unordered_map>
+#include "volumes.h"
+#include "volumes.cpp"
+#include "file.h"
+#include "file.cpp"
+
+/** === Test List ===
+ * ✓ Append 100 MiB to a 4 GiB volume which is 90 % full.
+ * ✓ The FAT is searched only once for the allocation.
+ * ✓ The FSInfo sector is updated when the file is closed.
+ * ✓ Reopening the file for append does not read the FAT.
+*/
+
+/* === Fixtures === */
+namespace image
+{
+    /* Geometry of the volume */
+    constexpr uint32_t partition_begin = 2048;
+    constexpr uint32_t reserved_sectors = 32;
+    constexpr uint32_t sectors_per_cluster = 64;
+    constexpr uint32_t clusters = 131072;
+    constexpr uint32_t FAT_size = (((clusters + 2) * 4) + 511) / 512;
+    constexpr uint32_t FAT_begin = partition_begin + reserved_sectors;
+    constexpr uint32_t data_begin = FAT_begin + 2 * FAT_size;
+    constexpr uint32_t total_sectors = reserved_sectors + 2 * FAT_size + clusters * sectors_per_cluster;
+    constexpr uint32_t used_clusters = clusters * 9 / 10;
+};
+
+/**
+ * @brief Image of a FAT32 volume in RAM. Only the system
+ * area and the root directory are stored, the content of
+ * the files is discarded.
+ */
+struct Sparse_Memory
+{
+    using Block = std::array<uint32_t, 128>;
+    std::unordered_map<uint32_t, Block> blocks{};
+    uint32_t FAT_reads{0};
+    uint32_t data_writes{0};
+
+    auto byte_block(uint32_t block) -> uint8_t *
+    {
+        return reinterpret_cast<uint8_t *>(blocks[block].data());
+    };
+    bool read_single_block(const uint32_t *buffer, const uint32_t block)
+    {
+        if ((block >= image::FAT_begin) && (block < image::FAT_begin + image::FAT_size))
+            FAT_reads++;
+        auto *data = const_cast<uint32_t *>(buffer);
+        const auto entry = blocks.find(block);
+        if (entry == blocks.end())
+            std::fill(data, data + 128, 0);
+        else
+            std::copy(entry->second.begin(), entry->second.end(), data);
+        return true;
+    };
+    bool write_single_block(const uint32_t *buffer, const uint32_t block)
+    {
+        if (block >= image::data_begin + image::sectors_per_cluster)
+        {
+            data_writes++;
+            return true;
+        }
+        std::copy(buffer, buffer + 128, blocks[block].begin());
+        return true;
+    };
+    bool read_multiple_blocks(const uint32_t *buffer, const uint32_t block, const uint32_t count)
+    {
+        for (uint32_t i = 0; i < count; i++)
+            read_single_block(buffer + i * 128, block + i);
+        return true;
+    };
+    bool write_multiple_blocks(const uint32_t *buffer, const uint32_t block, const uint32_t count)
+    {
+        for (uint32_t i = 0; i < count; i++)
+            write_single_block(buffer + i * 128, block + i);
+        return true;
+    };
+
+    /**
+     * @brief Format the image and allocate the first 90 % of the clusters.
+     * The FSInfo does not provide a hint for the next free cluster.
+     */
+    void format()
+    {
+        /* MBR */
+        uint8_t *mbr = byte_block(0);
+        fat32::write_byte(mbr, fat32::PART1_TYPE, 0x0C);
+        fat32::write_long(mbr, fat32::PART1_LBA_BEGIN, image::partition_begin);
+        fat32::write_short(mbr, fat32::MAGIC_NUMBER, 0xAA55);
+
+        /* BPB */
+        uint8_t *bpb = byte_block(image::partition_begin);
+        fat32::write_short(bpb, fat32::BYTES_PER_SECTOR, 512);
+        fat32::write_byte(bpb, fat32::SEC_PER_CLUSTER, image::sectors_per_cluster);
+        fat32::write_short(bpb, fat32::RESERVED_SEC, image::reserved_sectors);
+        fat32::write_byte(bpb, fat32::NUMBER_OF_FAT, 2);
+        fat32::write_long(bpb, fat32::TOT_SECTORS_32, image::total_sectors);
+        fat32::write_long(bpb, fat32::FAT_SIZE_32, image::FAT_size);
+        fat32::write_long(bpb, fat32::ROOT_DIR_CLUSTER, 2);
+        fat32::write_short(bpb, fat32::FS_INFO_SECTOR, 1);
+        fat32::write_short(bpb, fat32::MAGIC_NUMBER, 0xAA55);
+
+        /* FSInfo */
+        uint8_t *info = byte_block(image::partition_begin + 1);
+        fat32::write_long(info, fat32::LEAD_SIGNATURE, 0x41615252);
+        fat32::write_long(info, fat32::STRUCT_SIGNATURE, 0x61417272);
+        fat32::write_long(info, fat32::TRAIL_SIGNATURE, 0xAA550000);
+        fat32::FSInfo::set_free_clusters(info, image::clusters - image::used_clusters, fat32::FSInfo::UNKNOWN);
+
+        /* Both FATs, the root directory and the files end in their first cluster */
+        for (uint32_t cluster = 0; cluster < image::used_clusters + 2; cluster++)
+        {
+            const uint32_t sector = (cluster * 4) / 512;
+            const uint32_t entry = (cluster == 0) ? 0x0FFFFFF8 : 0x0FFFFFFF;
+            fat32::write_long(byte_block(image::FAT_begin + sector), (cluster * 4) % 512, entry);
+            fat32::write_long(byte_block(image::FAT_begin + image::FAT_size + sector), (cluster * 4) % 512, entry);
+        }
+    };
+};
+
+/* === Tests === */
+void setUp() {
+    /* set stuff up here */
+};
+
+void tearDown() {
+    /* clean stuff up here */
+};
+
+/** 
+ * @brief Append 100 MiB to a file on a mostly full volume
+ */
+void test_append_to_full_volume()
+{
+    /* Setup Test */
+    static Sparse_Memory image;
+    image.format();
+
+    /* The volume uses the memory by reference */
+    static fat32::Volume<Sparse_Memory> volume(image);
+    Sparse_Memory &memory = volume.memory;
+    TEST_ASSERT_TRUE( volume.mount() );
+    const uint32_t free_before = volume.get_free_clusters().value();
+
+    /* Create a file in the root directory */
+    fat32::Filehandler handle{};
+    TEST_ASSERT_TRUE( volume.read_root(handle) );
+    const auto id = volume.get_empty_id(handle);
+    const auto start_cluster = volume.get_next_empty_cluster();
+    TEST_ASSERT_TRUE( id && start_cluster );
+    TEST_ASSERT_EQUAL( image::used_clusters + 2, start_cluster.value() );
+    TEST_ASSERT_TRUE( volume.write_FAT_entry(start_cluster.value(), 0x0FFFFFFF) );
+    TEST_ASSERT_TRUE( volume.make_directory_entry(
+        handle, id.value(), start_cluster.value(), {"APPEND  BIN"}, fat32::Attribute::Archive, 0) );
+    TEST_ASSERT_TRUE( volume.get_file(handle, id.value()) );
+    TEST_ASSERT_TRUE( volume.read_cluster(handle, handle.start_cluster) );
+    fat32::File file{handle, volume, files::State::Open};
+
+    /* Append the data */
+    std::array<char, 4096> chunk{};
+    chunk.fill('A');
+    constexpr uint32_t total_bytes = 100 * 1024 * 1024;
+    const uint32_t FAT_reads_before = memory.FAT_reads;
+    const auto begin = std::chrono::steady_clock::now();
+    for (uint32_t written = 0; written < total_bytes; written += chunk.size())
+        file.write(chunk.data(), chunk.size());
+    TEST_ASSERT_TRUE( file.close() );
+    const auto end = std::chrono::steady_clock::now();
+
+    /* Report the results */
+    const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count();
+    const uint32_t FAT_reads = memory.FAT_reads - FAT_reads_before;
+    std::printf("append: %u MiB in %ld ms, %u FAT sector reads, %u data blocks\n",
+        total_bytes / (1024 * 1024), static_cast<long>(duration), FAT_reads, memory.data_writes);
+
+    /* Filling a cluster allocates the next one, so the file has one cluster more than its data */
+    const uint32_t allocated = total_bytes / (512 * image::sectors_per_cluster);
+    TEST_ASSERT_EQUAL( total_bytes, file.size() );
+    TEST_ASSERT_EQUAL( free_before - allocated - 1, volume.get_free_clusters().value() );
+
+    /* The clusters are consecutive, so the FAT sectors are only read when the allocation enters them */
+    TEST_ASSERT_LESS_THAN( 4 * (allocated / 128 + 1), FAT_reads );
+
+    /* The FSInfo sector was updated */
+    const uint8_t *info = memory.byte_block(image::partition_begin + 1);
+    TEST_ASSERT_EQUAL( free_before - allocated - 1, fat32::FSInfo::get_free_count(info) );
+    TEST_ASSERT_EQUAL( start_cluster.value() + allocated + 1, fat32::FSInfo::get_next_free(info) );
+
+    /* The end of the reopened file is found with the remembered chain */
+    fat32::Filehandler reopened{};
+    TEST_ASSERT_TRUE( volume.read_root(reopened) );
+    TEST_ASSERT_TRUE( volume.get_file(reopened, id.value()) );
+    const uint32_t FAT_reads_reopen = memory.FAT_reads;
+    TEST_ASSERT_TRUE( volume.read_last_sector_of_file(reopened) );
+    TEST_ASSERT_EQUAL( 0, memory.FAT_reads - FAT_reads_reopen );
+    TEST_ASSERT_EQUAL( start_cluster.value() + allocated, reopened.current.cluster );
+    TEST_ASSERT_EQUAL( 1, reopened.current.sector );
+    TEST_ASSERT_EQUAL( 0, reopened.current.byte );
+};
+
+/* === Main === */
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_append_to_full_volume);
+    return UNITY_END();
+};
@@ -0,0 +1,628 @@
+/**
+ * OTOS - Open Tec Operating System
+ * Copyright (c) 2021 Sebastian Oberschwendtner, sebastian.oberschwendtner@gmail.com
+ *
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+/**
+ ==============================================================================
+ * @file    test_benchmark.cpp
+ * @author  SO
+ * @version v5.2.0
+ * @date    18-October-2026
+ * @brief   Benchmark of the block accesses of filesystem workloads.
+ ==============================================================================
+ */
+
+/* === Includes === */
+#include <unity.h>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include "image_memory.h"
+#include "async_memory.h"
+#include "volumes.h"
+#include "volumes.cpp"
+#include "file.h"
+#include "file.cpp"
+
+/** === Test List ===
+ * ✓ Sequential write of 1 MiB.
+ * ✓ Sequential write of 1 MiB with write behind.
+ * ✓ Appending bursts of 4 KiB, the file is opened and closed for every burst.
+ * ✓ Reading a 1 MiB file.
+ * ✓ Streaming a 1 MiB file byte by byte with read ahead.
+ * ✓ Listing a directory with 100 files.
+ * ✓ Opening and closing files repeatedly.
+ * ✓ Writing 1 MiB to a volume which is 90 % full.
+ * ✓ Appending to existing files, also to a file which fills its last cluster.
+ * ✓ Writing within a sector after the file was synchronized.
+ * ✓ Closing a file after reading whole sectors to a buffer.
+ * ✓ Writing after reading up to the end of a sector.
+ * ✓ Writing behind and reading ahead with a memory which transfers in the background.
+ *
+ * Each workload reports the blocks which were read and written per
+ * logical KiB and its wall time. The workload fails when it accesses
+ * more blocks than its budget, so update the budget when a change
+ * reduces the block count.
+ *
+ * The files which are written by the workloads are read back
+ * afterwards to check their size and content.
+*/
+
+/* === Fixtures === */
+namespace image
+{
+    /* Geometry of the volume */
+    constexpr const char *path = "otos_benchmark.img";
+    constexpr uint32_t partition_begin = 2048;
+    constexpr uint32_t reserved_sectors = 32;
+    constexpr uint32_t sectors_per_cluster = 8;
+    constexpr uint32_t clusters = 70000;
+    constexpr uint32_t FAT_size = (((clusters + 2) * 4) + 511) / 512;
+    constexpr uint32_t FAT_begin = partition_begin + reserved_sectors;
+    constexpr uint32_t total_sectors = reserved_sectors + 2 * FAT_size + clusters * sectors_per_cluster;
+};
+
+/**
+ * @brief The maximum number of blocks a workload may access.
+ */
+struct Budget
+{
+    uint32_t blocks_read;    /**< The maximum number of blocks read. */
+    uint32_t blocks_written; /**< The maximum number of blocks written. */
+};
+
+using Volume_t = fat32::Volume<host::Image_Memory>;
+static host::Image_Memory memory;
+static std::array<char, 4096> chunk{};
+
+/**
+ * @brief Create and format the image of a FAT32 volume. The root
+ * directory is empty, the used clusters are allocated as files
+ * which end in their first cluster.
+ *
+ * @param used_clusters The number of allocated clusters besides the root directory.
+ */
+void format(const uint32_t used_clusters)
+{
+    TEST_ASSERT_TRUE(memory.create(image::path, image::partition_begin + image::total_sectors));
+
+    /* MBR */
+    uint8_t *mbr = memory.get_block(0);
+    fat32::write_byte(mbr, fat32::PART1_TYPE, 0x0C);
+    fat32::write_long(mbr, fat32::PART1_LBA_BEGIN, image::partition_begin);
+    fat32::write_short(mbr, fat32::MAGIC_NUMBER, 0xAA55);
+
+    /* BPB */
+    uint8_t *bpb = memory.get_block(image::partition_begin);
+    fat32::write_short(bpb, fat32::BYTES_PER_SECTOR, 512);
+    fat32::write_byte(bpb, fat32::SEC_PER_CLUSTER, image::sectors_per_cluster);
+    fat32::write_short(bpb, fat32::RESERVED_SEC, image::reserved_sectors);
+    fat32::write_byte(bpb, fat32::NUMBER_OF_FAT, 2);
+    fat32::write_long(bpb, fat32::TOT_SECTORS_32, image::total_sectors);
+    fat32::write_long(bpb, fat32::FAT_SIZE_32, image::FAT_size);
+    fat32::write_long(bpb, fat32::ROOT_DIR_CLUSTER, 2);
+    fat32::write_short(bpb, fat32::FS_INFO_SECTOR, 1);
+    fat32::write_short(bpb, fat32::MAGIC_NUMBER, 0xAA55);
+
+    /* FSInfo, the hint for the next free cluster is only known for an empty volume */
+    uint8_t *info = memory.get_block(image::partition_begin + 1);
+    fat32::write_long(info, fat32::LEAD_SIGNATURE, 0x41615252);
+    fat32::write_long(info, fat32::STRUCT_SIGNATURE, 0x61417272);
+    fat32::write_long(info, fat32::TRAIL_SIGNATURE, 0xAA550000);
+    const uint32_t hint = (used_clusters == 0) ? 3 : fat32::FSInfo::UNKNOWN;
+    fat32::FSInfo::set_free_clusters(info, image::clusters - used_clusters - 1, hint);
+
+    /* Both FATs */
+    for (uint32_t cluster = 0; cluster < used_clusters + 3; cluster++)
+    {
+        const uint32_t sector = (cluster * 4) / 512;
+        const uint32_t entry = (cluster == 0) ? 0x0FFFFFF8 : 0x0FFFFFFF;
+        fat32::write_long(memory.get_block(image::FAT_begin + sector), (cluster * 4) % 512, entry);
+        fat32::write_long(memory.get_block(image::FAT_begin + image::FAT_size + sector), (cluster * 4) % 512, entry);
+    }
+};
+
+/**
+ * @brief Create a file in the root directory and write data to it.
+ *
+ * @param volume The mounted volume.
+ * @param path The path of the file.
+ * @param bytes The number of bytes to write.
+ */
+void write_file(Volume_t &volume, const char *path, const uint32_t bytes)
+{
+    auto file = fat32::open(volume, path, files::Mode::app);
+    TEST_ASSERT_EQUAL(files::State::Open, file.state);
+    for (uint32_t written = 0; written < bytes; written += chunk.size())
+        TEST_ASSERT_TRUE(file.write(chunk.data(), std::min<uint32_t>(chunk.size(), bytes - written)));
+    TEST_ASSERT_TRUE(file.close());
+};
+
+/**
+ * @brief Check the size of a file and that its content
+ * is the repeated chunk, as written by write_file().
+ *
+ * @param volume The mounted volume.
+ * @param path The path of the file.
+ * @param bytes The expected size of the file.
+ */
+void check_file(Volume_t &volume, const char *path, const uint32_t bytes)
+{
+    std::array<char, 4096> data{};
+    auto file = fat32::open(volume, path, files::Mode::in);
+    TEST_ASSERT_EQUAL(bytes, file.size());
+    for (uint32_t read = 0; read < bytes; read += data.size())
+    {
+        const uint32_t count = std::min<uint32_t>(data.size(), bytes - read);
+        TEST_ASSERT_EQUAL(count, file.read(data.data(), count));
+        TEST_ASSERT_EQUAL_MEMORY(chunk.data(), data.data(), count);
+    }
+    TEST_ASSERT_TRUE(file.close());
+};
+
+/**
+ * @brief Run a workload, report its block accesses and
+ * check them against the budget of the workload.
+ *
+ * @param name The name of the workload.
+ * @param logical_bytes The number of bytes the workload transfers for the application.
+ * @param budget The maximum number of blocks the workload may access.
+ * @param workload The function which runs the workload.
+ */
+template <typename Workload>
+void run_workload(const char *name, const uint32_t logical_bytes, const Budget &budget, Workload workload)
+{
+    /* Run the workload */
+    memory.reset_statistics();
+    const auto begin = std::chrono::steady_clock::now();
+    workload();
+    const auto end = std::chrono::steady_clock::now();
+
+    /* Report the results */
+    const auto statistics = memory.get_statistics();
+    const double kilobytes = static_cast<double>(logical_bytes) / 1024.0;
+    const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count();
+    std::printf("%-10s %6u reads %6u blocks read (%7.2f/KiB) %6u writes %6u blocks written (%7.2f/KiB) %8.3f ms\n",
+        name, statistics.reads, statistics.blocks_read, statistics.blocks_read / kilobytes,
+        statistics.writes, statistics.blocks_written, statistics.blocks_written / kilobytes,
+        static_cast<double>(duration) / 1000.0);
+
+    /* Regression check */
+    TEST_ASSERT_LESS_OR_EQUAL_MESSAGE(budget.blocks_read, statistics.blocks_read, name);
+    TEST_ASSERT_LESS_OR_EQUAL_MESSAGE(budget.blocks_written, statistics.blocks_written, name);
+};
+
+/* === Tests === */
+void setUp() {
+    /* set stuff up here */
+    for (std::size_t index = 0; index < chunk.size(); index++)
+        chunk[index] = static_cast<char>('A' + index % 26);
+};
+
+void tearDown() {
+    /* clean stuff up here */
+    memory.close();
+    std::remove(image::path);
+};
+
+/**
+ * @brief Write 1 MiB to a new file
+ */
+void test_sequential_write()
+{
+    /* Setup Test */
+    format(0);
+    Volume_t volume(memory);
+    TEST_ASSERT_TRUE( volume.mount() );
+
+    run_workload("write", 1024 * 1024, {2067, 4618}, [&]()
+        { write_file(volume, "0:/WRITE.BIN", 1024 * 1024); });
+    check_file(volume, "0:/WRITE.BIN", 1024 * 1024);
+};
+
+/**
+ * @brief Write 1 MiB to a new file with write behind
+ */
+void test_write_behind()
+{
+    /* Setup Test */
+    format(0);
+    Volume_t volume(memory);
+    TEST_ASSERT_TRUE( volume.mount() );
+    std::array<uint32_t, 16 * 128> sectors{};
+
+    run_workload("behind", 1024 * 1024, {147, 2440}, [&]()
+        {
+            auto file = fat32::open(volume, "0:/BEHIND.BIN", files::Mode::app);
+            file.set_write_behind(sectors.data(), 16);
+            file.set_sync_policy({16});
+            for (uint32_t written = 0; written < 1024 * 1024; written += chunk.size())
+                TEST_ASSERT_TRUE( file.write(chunk.data(), chunk.size()) );
+            TEST_ASSERT_TRUE( file.close() );
+        });
+    check_file(volume, "0:/BEHIND.BIN", 1024 * 1024);
+};
+
+/**
+ * @brief Append bursts of 4 KiB to a file
+ */
+void test_append_bursts()
+{
+    /* Setup Test */
+    format(0);
+    Volume_t volume(memory);
+    TEST_ASSERT_TRUE( volume.mount() );
+
+    run_workload("append", 64 * chunk.size(), {903, 1347}, [&]()
+        {
+            for (uint32_t burst = 0; burst < 64; burst++)
+                write_file(volume, "0:/APPEND.BIN", chunk.size());
+        });
+    check_file(volume, "0:/APPEND.BIN", 64 * chunk.size());
+};
+
+/**
+ * @brief Read a file of 1 MiB
+ */
+void test_full_read()
+{
+    /* Setup Test */
+    format(0);
+    Volume_t volume(memory);
+    TEST_ASSERT_TRUE( volume.mount() );
+    write_file(volume, "0:/READ.BIN", 1024 * 1024);
+
+    run_workload("read", 1024 * 1024, {2049, 0}, [&]()
+        {
+            auto file = fat32::open(volume, "0:/READ.BIN", files::Mode::in);
+            uint32_t read = 0;
+            while (read < file.size())
+                read += file.read(chunk.data(), chunk.size());
+            TEST_ASSERT_EQUAL( 1024 * 1024, read );
+        });
+};
+
+/**
+ * @brief Stream a file of 1 MiB byte by byte with read ahead
+ */
+void test_read_ahead_stream()
+{
+    /* Setup Test */
+    format(0);
+    Volume_t volume(memory);
+    TEST_ASSERT_TRUE( volume.mount() );
+    write_file(volume, "0:/STREAM.BIN", 1024 * 1024);
+    std::array<uint32_t, 8 * 128> sectors{};
+
+    run_workload("stream", 1024 * 1024, {2049, 0}, [&]()
+        {
+            auto file = fat32::open(volume, "0:/STREAM.BIN", files::Mode::in);
+            file.set_read_ahead(sectors.data(), 8);
+            uint32_t matching = 0;
+            while (file.tell() < file.size())
+            {
+                const auto expected = static_cast<uint8_t>(chunk[file.tell() % chunk.size()]);
+                matching += (file.read() == expected) ? 1 : 0;
+            }
+            TEST_ASSERT_EQUAL( 1024 * 1024, matching );
+        });
+};
+
+/**
+ * @brief List a directory with 100 files
+ */
+void test_directory_listing()
+{
+    /* Setup Test */
+    format(0);
+    Volume_t volume(memory);
+    TEST_ASSERT_TRUE( volume.mount() );
+    std::array<char, 16> path{};
+    for (uint32_t count = 0; count < 100; count++)
+    {
+        std::snprintf(path.data(), path.size(), "0:/F%03u.TXT", count);
+        write_file(volume, path.data(), 0);
+    }
+
+    run_workload("list", 100 * 32, {8, 0}, [&]()
+        {
+            fat32::Filehandler directory{};
+            fat32::Directory_Entry entry{};
+            uint32_t count = 0;
+            TEST_ASSERT_TRUE( volume.read_root(directory) );
+            TEST_ASSERT_TRUE( volume.rewind_directory(directory) );
+            while (volume.read_next_entry(directory, entry))
+                count++;
+            TEST_ASSERT_EQUAL( 100, count );
+        });
+};
+
+/**
+ * @brief Open and close the same files repeatedly
+ */
+void test_open_close_churn()
+{
+    /* Setup Test */
+    format(0);
+    Volume_t volume(memory);
+    TEST_ASSERT_TRUE( volume.mount() );
+    std::array<char, 16> path{};
+    for (uint32_t count = 0; count < 64; count++)
+    {
+        std::snprintf(path.data(), path.size(), "0:/F%03u.TXT", count);
+        write_file(volume, path.data(), 100);
+    }
+
+    /* Open the last files of the directory, their entries are found last */
+    run_workload("churn", 64 * 100, {128, 0}, [&]()
+        {
+            for (uint32_t count = 0; count < 64; count++)
+            {
+                std::snprintf(path.data(), path.size(), "0:/F%03u.TXT", 60 + (count % 4));
+                auto file = fat32::open(volume, path.data(), files::Mode::in);
+                TEST_ASSERT_EQUAL( 100, file.size() );
+                TEST_ASSERT_TRUE( file.close() );
+            }
+        });
+};
+
+/**
+ * @brief Write 1 MiB to a volume which is mostly full
+ */
+void test_near_full_allocation()
+{
+    /* Setup Test */
+    format(image::clusters * 9 / 10);
+    Volume_t volume(memory);
+    TEST_ASSERT_TRUE( volume.mount() );
+
+    run_workload("full", 1024 * 1024, {2559, 4618}, [&]()
+        { write_file(volume, "0:/FULL.BIN", 1024 * 1024); });
+    check_file(volume, "0:/FULL.BIN", 1024 * 1024);
+};
+
+/**
+ * @brief Append to files which already exist on the volume
+ */
+void test_append_to_existing_file()
+{
+    /* Setup Test */
+    format(0);
+    chunk.fill('A');
+    std::array<char, 4196> data{};
+    std::array<char, 16> path{};
+    {
+        /* read_root() reads the first sector of the root directory at the number of its cluster,
+         * so the files are placed in the second sector to be found after mounting again. */
+        Volume_t volume(memory);
+        TEST_ASSERT_TRUE( volume.mount() );
+        for (uint32_t count = 0; count < 16; count++)
+        {
+            std::snprintf(path.data(), path.size(), "0:/F%03u.TXT", count);
+            write_file(volume, path.data(), 0);
+        }
+        write_file(volume, "0:/SHORT.BIN", 100);
+        write_file(volume, "0:/FULL.BIN", 4096);
+    }
+
+    /* FULL.BIN fills its cluster and ends there, as when it is written by another system */
+    const uint8_t *entry = memory.get_block(image::FAT_begin + 2 * image::FAT_size + 1) + 32;
+    const uint32_t cluster = fat32::read_short(entry, fat32::DIR_Entry::First_Cluster_L);
+    for (const uint32_t FAT : {image::FAT_begin, image::FAT_begin + image::FAT_size})
+    {
+        fat32::write_long(memory.get_block(FAT + (cluster * 4) / 512), (cluster * 4) % 512, 0x0FFFFFFF);
+        fat32::write_long(memory.get_block(FAT + ((cluster + 1) * 4) / 512), ((cluster + 1) * 4) % 512, 0);
+    }
+    Volume_t volume(memory);
+    TEST_ASSERT_TRUE( volume.mount() );
+
+    /* The data is added at the end of the files */
+    chunk.fill('B');
+    write_file(volume, "0:/SHORT.BIN", 100);
+    write_file(volume, "0:/FULL.BIN", 100);
+
+    auto file = fat32::open(volume, "0:/SHORT.BIN", files::Mode::in);
+    TEST_ASSERT_EQUAL( 200, file.size() );
+    TEST_ASSERT_EQUAL( 200, file.read(data.data(), 200) );
+    TEST_ASSERT_EQUAL( 'A', data[99] );
+    TEST_ASSERT_EQUAL( 'B', data[100] );
+    TEST_ASSERT_EQUAL( 'B', data[199] );
+
+    file = fat32::open(volume, "0:/FULL.BIN", files::Mode::in);
+    TEST_ASSERT_EQUAL( 4196, file.size() );
+    TEST_ASSERT_EQUAL( 4196, file.read(data.data(), data.size()) );
+    TEST_ASSERT_EQUAL( 'A', data[4095] );
+    TEST_ASSERT_EQUAL( 'B', data[4096] );
+    TEST_ASSERT_EQUAL( 'B', data[4195] );
+};
+
+/**
+ * @brief Continue writing within a sector after the file was synchronized
+ */
+void test_sync_within_sector()
+{
+    /* Setup Test */
+    format(0);
+    Volume_t volume(memory);
+    TEST_ASSERT_TRUE( volume.mount() );
+    std::array<char, 100> data{};
+
+    /* Updating the directory entry does not change the sector of the file */
+    auto file = fat32::open(volume, "0:/SYNC.BIN", files::Mode::app);
+    data.fill('A');
+    TEST_ASSERT_TRUE( file.write(data.data(), data.size()) );
+    TEST_ASSERT_TRUE( file.sync() );
+    data.fill('B');
+    TEST_ASSERT_TRUE( file.write(data.data(), data.size()) );
+    TEST_ASSERT_TRUE( file.close() );
+
+    std::array<char, 200> content{};
+    file = fat32::open(volume, "0:/SYNC.BIN", files::Mode::in);
+    TEST_ASSERT_EQUAL( 200, file.size() );
+    TEST_ASSERT_EQUAL( 200, file.read(content.data(), content.size()) );
+    TEST_ASSERT_EQUAL( 'A', content[0] );
+    TEST_ASSERT_EQUAL( 'A', content[99] );
+    TEST_ASSERT_EQUAL( 'B', content[100] );
+    TEST_ASSERT_EQUAL( 'B', content[199] );
+};
+
+/**
+ * @brief Close a file after whole sectors were read directly to a buffer
+ */
+void test_close_after_bulk_read()
+{
+    /* Setup Test */
+    format(0);
+    Volume_t volume(memory);
+    TEST_ASSERT_TRUE( volume.mount() );
+    write_file(volume, "0:/BULK.BIN", 4096);
+    alignas(4) std::array<char, 4 * 512> data{};
+
+    /* The block buffer does not contain the sectors which were read, so it is not written */
+    for (const files::openmode mode : {files::Mode::in, files::Mode::out})
+    {
+        auto file = fat32::open(volume, "0:/BULK.BIN", mode);
+        TEST_ASSERT_EQUAL( data.size(), file.read(data.data(), data.size()) );
+        TEST_ASSERT_EQUAL_MEMORY( chunk.data(), data.data(), data.size() );
+        TEST_ASSERT_TRUE( file.close() );
+        check_file(volume, "0:/BULK.BIN", 4096);
+    }
+
+    /* The changed data is written before the following sectors are read */
+    auto file = fat32::open(volume, "0:/BULK.BIN", files::Mode::out);
+    TEST_ASSERT_TRUE( file.write("abc", 3) );
+    TEST_ASSERT_EQUAL( 509, file.read(data.data(), 509) );
+    TEST_ASSERT_EQUAL( 3 * 512, file.read(data.data(), 3 * 512) );
+    TEST_ASSERT_EQUAL_MEMORY( chunk.data() + 512, data.data(), 3 * 512 );
+    TEST_ASSERT_TRUE( file.close() );
+
+    std::copy_n("abc", 3, chunk.begin());
+    check_file(volume, "0:/BULK.BIN", 4096);
+};
+
+/**
+ * @brief Write after the file was read up to the end of a sector
+ */
+void test_write_at_sector_end()
+{
+    /* Setup Test */
+    format(0);
+    Volume_t volume(memory);
+    TEST_ASSERT_TRUE( volume.mount() );
+    write_file(volume, "0:/MIXED.BIN", 4096);
+    alignas(4) std::array<char, 2 * 512> data{};
+
+    /* Writing continues in the next sector after a read, a bulk read and a read of single bytes */
+    auto file = fat32::open(volume, "0:/MIXED.BIN", files::Mode::out);
+    TEST_ASSERT_EQUAL( 512, file.pread(0, data.data(), 512) );
+    TEST_ASSERT_TRUE( file.write("abcd", 4) );
+    TEST_ASSERT_EQUAL( 508, file.read(data.data(), 508) );
+    TEST_ASSERT_EQUAL( 2 * 512, file.read(data.data(), 2 * 512) );
+    TEST_ASSERT_TRUE( file.put('e') );
+    for (uint32_t count = 0; count < 511; count++)
+        file.read();
+    TEST_ASSERT_TRUE( file.write("fg", 2) );
+    TEST_ASSERT_EQUAL( 5 * 512 + 2, file.tell() );
+    TEST_ASSERT_TRUE( file.close() );
+
+    std::copy_n("abcd", 4, chunk.begin() + 512);
+    chunk[4 * 512] = 'e';
+    std::copy_n("fg", 2, chunk.begin() + 5 * 512);
+    check_file(volume, "0:/MIXED.BIN", 4096);
+
+    /* Writing at the end of a file which ends with a full sector adds the data */
+    file = fat32::open(volume, "0:/MIXED.BIN", files::Mode::out);
+    TEST_ASSERT_EQUAL( 512, file.pread(4096 - 512, data.data(), 512) );
+    TEST_ASSERT_TRUE( file.write("hi", 2) );
+    TEST_ASSERT_EQUAL( 4098, file.size() );
+    TEST_ASSERT_TRUE( file.close() );
+
+    file = fat32::open(volume, "0:/MIXED.BIN", files::Mode::in);
+    TEST_ASSERT_EQUAL( 4098, file.size() );
+    TEST_ASSERT_EQUAL( 2, file.pread(4096, data.data(), 10) );
+    TEST_ASSERT_EQUAL_MEMORY( "hi", data.data(), 2 );
+};
+
+/**
+ * @brief Write behind and read ahead with a memory which finishes
+ * the started transfers later, so the file continues while they run
+ */
+void test_background_transfers()
+{
+    /* Setup Test */
+    format(0);
+    host::Async_Memory background{memory, 3};
+    fat32::Volume<host::Async_Memory> volume(background);
+    TEST_ASSERT_TRUE( volume.mount() );
+    std::array<uint32_t, 16 * 128> sectors{};
+
+    /* Every sector has different data, so stale buffers are noticed */
+    const auto pattern = [](const uint32_t position)
+    { return static_cast<char>(position + 7 * (position / 512)); };
+
+    /* The next half is collected while the transfer of the full half runs */
+    auto file = fat32::open(volume, "0:/ASYNC.BIN", files::Mode::app);
+    file.set_write_behind(sectors.data(), 16);
+    file.set_sync_policy({16});
+    for (uint32_t written = 0; written < 256 * 1024; written += chunk.size())
+    {
+        for (std::size_t index = 0; index < chunk.size(); index++)
+            chunk[index] = pattern(written + index);
+        TEST_ASSERT_TRUE( file.write(chunk.data(), chunk.size()) );
+    }
+    TEST_ASSERT_TRUE( file.close() );
+    const auto written = background.get_statistics();
+    TEST_ASSERT_GREATER_THAN( 0, written.waits );
+    TEST_ASSERT_GREATER_THAN( written.interrupted, written.started );
+
+    /* The sectors which are read ahead are only used after their transfer finished */
+    file = fat32::open(volume, "0:/ASYNC.BIN", files::Mode::in);
+    TEST_ASSERT_EQUAL( 256 * 1024, file.size() );
+    file.set_read_ahead(sectors.data(), 8);
+    uint32_t matching = 0;
+    while (file.tell() < file.size())
+    {
+        const char expected = pattern(file.tell());
+        matching += (file.read() == static_cast<uint8_t>(expected)) ? 1 : 0;
+    }
+    TEST_ASSERT_EQUAL( 256 * 1024, matching );
+    const auto read = background.get_statistics();
+    TEST_ASSERT_GREATER_THAN( written.waits, read.waits );
+    TEST_ASSERT_GREATER_THAN( read.interrupted - written.interrupted, read.started - written.started );
+    TEST_ASSERT_TRUE( file.close() );
+};
+
+/* === Main === */
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_sequential_write);
+    RUN_TEST(test_write_behind);
+    RUN_TEST(test_append_bursts);
+    RUN_TEST(test_full_read);
+    RUN_TEST(test_read_ahead_stream);
+    RUN_TEST(test_directory_listing);
+    RUN_TEST(test_open_close_churn);
+    RUN_TEST(test_near_full_allocation);
+    RUN_TEST(test_append_to_existing_file);
+    RUN_TEST(test_sync_within_sector);
+    RUN_TEST(test_close_after_bulk_read);
+    RUN_TEST(test_write_at_sector_end);
+    RUN_TEST(test_background_transfers);
+    return UNITY_END();
+};
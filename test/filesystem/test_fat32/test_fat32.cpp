@@ -390,6 +390,60 @@ void test_get_file_properties()
     TEST_ASSERT_EQUAL(0x04030201, file.size);
 };
 
+/** 
+ * @brief Test compressing a cluster chain into extents
+ */
+void test_chain()
+{
+    /* Create chain */
+    fat32::Chain chain;
+    TEST_ASSERT_FALSE(chain.is_used());
+
+    /* A new chain only knows its start cluster */
+    chain.reset(10);
+    TEST_ASSERT_TRUE(chain.is_used());
+    TEST_ASSERT_EQUAL(1, chain.get_length());
+    TEST_ASSERT_EQUAL(10, chain.get_last_cluster());
+    TEST_ASSERT_FALSE(chain.complete);
+
+    /* Consecutive clusters extend the extent */
+    TEST_ASSERT_TRUE(chain.append(11));
+    TEST_ASSERT_TRUE(chain.append(12));
+    TEST_ASSERT_EQUAL(1, chain.count);
+    TEST_ASSERT_EQUAL(3, chain.get_length());
+
+    /* A jump starts a new extent */
+    TEST_ASSERT_TRUE(chain.append(40));
+    TEST_ASSERT_TRUE(chain.append(41));
+    TEST_ASSERT_EQUAL(2, chain.count);
+    TEST_ASSERT_EQUAL(5, chain.get_length());
+    TEST_ASSERT_EQUAL(41, chain.get_last_cluster());
+
+    /* Get the clusters by their position in the file */
+    TEST_ASSERT_EQUAL(10, chain.get_cluster(0).value());
+    TEST_ASSERT_EQUAL(12, chain.get_cluster(2).value());
+    TEST_ASSERT_EQUAL(40, chain.get_cluster(3).value());
+    TEST_ASSERT_FALSE(chain.get_cluster(5));
+
+    /* Get the successor of a cluster */
+    TEST_ASSERT_EQUAL(11, chain.get_next_cluster(10).value());
+    TEST_ASSERT_EQUAL(40, chain.get_next_cluster(12).value());
+    TEST_ASSERT_FALSE(chain.get_next_cluster(41));
+    TEST_ASSERT_FALSE(chain.get_next_cluster(13));
+    TEST_ASSERT_TRUE(chain.contains(11));
+    TEST_ASSERT_FALSE(chain.contains(20));
+
+    /* The chain is not extended when all extents are used */
+    for (uint32_t extent = chain.count; extent < OTOS_FAT_EXTENTS; extent++)
+        TEST_ASSERT_TRUE(chain.append(100 + 2 * extent));
+    TEST_ASSERT_FALSE(chain.append(500));
+    TEST_ASSERT_TRUE(chain.append(chain.get_last_cluster() + 1));
+
+    /* Clear the chain */
+    chain.clear();
+    TEST_ASSERT_FALSE(chain.is_used());
+};
+
 /* === Main === */
 int main(int argc, char **argv)
 {
@@ -401,5 +455,6 @@ int main(int argc, char **argv)
     RUN_TEST(test_read_BPB);
     RUN_TEST(test_partition);
     RUN_TEST(test_get_file_properties);
+    RUN_TEST(test_chain);
     return UNITY_END();
 };
\ No newline at end of file
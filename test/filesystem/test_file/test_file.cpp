@@ -45,20 +45,36 @@ struct Mock_Volume
     fat32::Filehandler file_return{};
     std::optional<uint32_t> id_return{0};
     std::optional<uint32_t> cluster_return{0};
+    uint8_t sector_data{0xAB};
+    uint32_t read_count{0};
+    uint32_t write_count{0};
+    uint8_t write_data{0};
+    fat32::Partition partition{};
 
     /* === Track calls === */
     Mock::Callable<bool> call_get_fileid;
     Mock::Callable<bool> call_get_file;
     Mock::Callable<bool> call_get_empty_id;
     Mock::Callable<bool> call_get_next_empty_cluster;
+    Mock::Callable<bool> call_get_cluster_of_file;
     Mock::Callable<bool> call_read_last_sector_of_file;
     Mock::Callable<bool> call_read_root;
     Mock::Callable<bool> call_read_cluster;
     Mock::Callable<bool> call_read_next_sector_of_cluster;
+    Mock::Callable<bool> call_read_sectors_of_cluster;
+    Mock::Callable<bool> call_start_read_sectors_of_cluster;
+    Mock::Callable<bool> call_complete_read;
+    Mock::Callable<bool> call_start_write_sectors_of_cluster;
+    Mock::Callable<bool> call_complete_write;
+    Mock::Callable<bool> call_move_to_next_sector;
     Mock::Callable<bool> call_write_FAT_entry;
     Mock::Callable<bool> call_make_directory_entry;
     Mock::Callable<bool> call_write_filesize_to_directory;
     Mock::Callable<bool> call_write_file_to_memory;
+    Mock::Callable<bool> call_write_current_sector;
+    Mock::Callable<bool> call_sync;
+    Mock::Callable<bool> call_preallocate;
+    Mock::Callable<bool> call_trim_file;
 
         /* === Provide the expected interface === */
         std::optional<uint32_t>
@@ -87,6 +103,59 @@ struct Mock_Volume
         return {12};
     };
 
+    std::optional<uint32_t> get_cluster_of_file(const fat32::Filehandler &file, const uint32_t index)
+    {
+        call_get_cluster_of_file.add_call(static_cast<int>(index));
+        return cluster_return;
+    };
+
+    bool read_sectors_of_cluster(const uint32_t *buffer, const uint32_t cluster, const uint32_t sector, const uint32_t count)
+    {
+        auto *data = reinterpret_cast<uint8_t *>(const_cast<uint32_t *>(buffer));
+        std::fill(data, data + count * 512, sector_data);
+        return call_read_sectors_of_cluster(sector);
+    };
+
+    bool start_read_sectors_of_cluster(const uint32_t *buffer, const uint32_t cluster, const uint32_t sector, const uint32_t count)
+    {
+        /* Each sector is filled with its number within the cluster */
+        auto *data = reinterpret_cast<uint8_t *>(const_cast<uint32_t *>(buffer));
+        for (uint32_t index = 0; index < count; index++)
+            std::fill(data + index * 512, data + (index + 1) * 512, static_cast<uint8_t>(sector + index));
+        read_count = count;
+        return call_start_read_sectors_of_cluster(sector);
+    };
+
+    bool complete_read()
+    {
+        return call_complete_read(0);
+    };
+
+    bool start_write_sectors_of_cluster(const uint32_t *buffer, const uint32_t cluster, const uint32_t sector, const uint32_t count)
+    {
+        /* Remember the data of the last sector */
+        write_count = count;
+        write_data = reinterpret_cast<const uint8_t *>(buffer + (count - 1) * 128)[511];
+        return call_start_write_sectors_of_cluster(sector);
+    };
+
+    bool complete_write()
+    {
+        return call_complete_write(0);
+    };
+
+    bool move_to_next_sector(fat32::Filehandler &file)
+    {
+        file.current.byte = 0;
+        file.current.sector++;
+        if (file.current.sector > partition.Sectors_per_Cluster)
+        {
+            file.current.cluster++;
+            file.current.sector = 1;
+        }
+        return call_move_to_next_sector(file.current.sector);
+    };
+
     bool read_last_sector_of_file(fat32::Filehandler &file)
     {
         return call_read_last_sector_of_file(file.id);
@@ -122,6 +191,26 @@ struct Mock_Volume
         return call_write_file_to_memory(file.id);
     };
 
+    bool write_current_sector(fat32::Filehandler &file)
+    {
+        return call_write_current_sector(file.id);
+    };
+
+    bool sync()
+    {
+        return call_sync(0);
+    };
+
+    bool preallocate(fat32::Filehandler &file, const uint32_t bytes)
+    {
+        return call_preallocate(static_cast<int>(bytes));
+    };
+
+    bool trim_file(fat32::Filehandler &file)
+    {
+        return call_trim_file(file.id);
+    };
+
     bool make_directory_entry(
         fat32::Filehandler &directory,
         const uint32_t id,
@@ -134,6 +223,8 @@ struct Mock_Volume
     };
 };
 Mock_Volume volume;
+uint32_t time_ms = 0;
+uint32_t get_time_ms() { return time_ms; };
 
 /* === UUT === */
 #include "file.cpp"
@@ -144,6 +235,7 @@ void setUp()
 {
     /* set stuff up here */
     volume = {};
+    volume.partition.Sectors_per_Cluster = 1;
 };
 
 void tearDown(){
@@ -258,6 +350,177 @@ void test_read_file_and_sector()
     volume.call_read_next_sector_of_cluster.assert_called_once();
 };
 
+/** 
+ * @brief Test reading data from the file to a buffer
+ */
+void test_read_file_to_buffer()
+{
+    /* Setup data */
+    setUp();
+    volume.partition.Sectors_per_Cluster = 4;
+    volume.cluster_return = 7;
+    fat32::Filehandler dummy;
+    dummy.block_buffer.fill(5);
+    dummy.size = 3000;
+    fat32::File file(dummy, volume);
+    alignas(4) std::array<char, 3000> buffer{};
+
+    /* The first sector is copied from the block buffer */
+    TEST_ASSERT_EQUAL(512, file.read(buffer.data(), 512));
+    TEST_ASSERT_EQUAL(5, buffer[511]);
+    TEST_ASSERT_EQUAL(0, volume.call_read_sectors_of_cluster.call_count);
+
+    /* Whole sectors are read directly, the rest with the block buffer */
+    TEST_ASSERT_EQUAL(1100, file.read(buffer.data(), 1100));
+    TEST_ASSERT_EQUAL(1612, file.tell());
+    volume.call_get_cluster_of_file.assert_called_once_with(0);
+    volume.call_read_sectors_of_cluster.assert_called_once_with(1);
+    volume.call_read_next_sector_of_cluster.assert_called_once();
+    TEST_ASSERT_EQUAL(static_cast<char>(0xAB), buffer[1023]);
+
+    /* Reading stops at the end of the file */
+    TEST_ASSERT_EQUAL(1388, file.read(buffer.data(), buffer.size()));
+    TEST_ASSERT_EQUAL(3000, file.tell());
+    TEST_ASSERT_EQUAL(0, file.read(buffer.data(), buffer.size()));
+
+    /* Unaligned buffers are read with the block buffer */
+    setUp();
+    fat32::File unaligned(dummy, volume);
+    TEST_ASSERT_EQUAL(1024, unaligned.read(buffer.data() + 1, 1024));
+    TEST_ASSERT_EQUAL(0, volume.call_read_sectors_of_cluster.call_count);
+    volume.call_read_next_sector_of_cluster.assert_called_once();
+};
+
+/** 
+ * @brief Test reading sectors ahead
+ */
+void test_read_ahead()
+{
+    /* Setup data */
+    setUp();
+    volume.partition.Sectors_per_Cluster = 8;
+    volume.cluster_return = 7;
+    fat32::Filehandler dummy;
+    dummy.block_buffer.fill(5);
+    dummy.size = 8 * 512 + 100;
+    fat32::File file(dummy, volume);
+    std::array<uint32_t, 4 * 128> sectors{};
+    file.set_read_ahead(sectors.data(), 4);
+
+    /* Reading the next sector loads the following sectors with one transfer */
+    for (uint32_t count = 0; count < 512; count++)
+        file.read();
+    TEST_ASSERT_EQUAL(1, file.read());
+    volume.call_start_read_sectors_of_cluster.assert_called_last_with(1);
+    TEST_ASSERT_EQUAL(4, volume.read_count);
+    TEST_ASSERT_EQUAL(0, volume.call_read_next_sector_of_cluster.call_count);
+
+    /* The buffered sectors are read without a transfer */
+    for (uint32_t count = 1; count < 3 * 512; count++)
+        file.read();
+    TEST_ASSERT_EQUAL(1, volume.call_start_read_sectors_of_cluster.call_count);
+
+    /* The next sectors are loaded when the last buffered sector is used, up to the end of the cluster */
+    TEST_ASSERT_EQUAL(4, file.read());
+    TEST_ASSERT_EQUAL(2, volume.call_start_read_sectors_of_cluster.call_count);
+    volume.call_start_read_sectors_of_cluster.assert_called_last_with(5);
+    TEST_ASSERT_EQUAL(3, volume.read_count);
+    for (uint32_t count = 1; count < 512; count++)
+        file.read();
+    TEST_ASSERT_EQUAL(5, file.read());
+
+    /* The last sector of the file is in the next cluster */
+    for (uint32_t count = 1; count < 3 * 512; count++)
+        file.read();
+    TEST_ASSERT_EQUAL(0, file.read());
+    TEST_ASSERT_EQUAL(3, volume.call_start_read_sectors_of_cluster.call_count);
+    TEST_ASSERT_EQUAL(1, volume.read_count);
+    TEST_ASSERT_EQUAL(3, volume.call_complete_read.call_count);
+    TEST_ASSERT_EQUAL(0, volume.call_read_next_sector_of_cluster.call_count);
+
+    /* Reads after a seek only load one sector until the access is sequential */
+    TEST_ASSERT_TRUE(file.seekg(2 * 512 + 10));
+    for (uint32_t count = 0; count < 502; count++)
+        file.read();
+    TEST_ASSERT_EQUAL(3, file.read());
+    TEST_ASSERT_EQUAL(4, volume.call_start_read_sectors_of_cluster.call_count);
+    TEST_ASSERT_EQUAL(1, volume.read_count);
+    for (uint32_t count = 1; count < 512; count++)
+        file.read();
+    TEST_ASSERT_EQUAL(4, file.read());
+    TEST_ASSERT_EQUAL(5, volume.call_start_read_sectors_of_cluster.call_count);
+    TEST_ASSERT_EQUAL(4, volume.read_count);
+
+    /* Without read ahead the sectors are read one by one */
+    file.set_read_ahead(nullptr, 4);
+    TEST_ASSERT_TRUE(file.seekg(511));
+    file.read();
+    file.read();
+    volume.call_read_next_sector_of_cluster.assert_called_once();
+};
+
+/** 
+ * @brief Test writing sectors behind
+ */
+void test_write_behind()
+{
+    /* Setup data */
+    setUp();
+    volume.partition.Sectors_per_Cluster = 8;
+    fat32::Filehandler dummy;
+    dummy.current.cluster = 7;
+    dummy.current.sector = 1;
+    fat32::File file(dummy, volume, files::State::Open);
+    file.set_sync_policy({0});
+    std::array<uint32_t, 4 * 128> sectors{};
+    file.set_write_behind(sectors.data(), 4);
+    std::array<char, 512> data{};
+
+    /* The first full sector is collected */
+    data.fill(1);
+    TEST_ASSERT_TRUE(file.write(data.data(), data.size()));
+    TEST_ASSERT_EQUAL(0, volume.call_write_file_to_memory.call_count);
+    TEST_ASSERT_EQUAL(0, volume.call_start_write_sectors_of_cluster.call_count);
+    volume.call_move_to_next_sector.assert_called_once_with(2);
+
+    /* The full half is written with one transfer */
+    data.fill(2);
+    TEST_ASSERT_TRUE(file.write(data.data(), data.size()));
+    volume.call_start_write_sectors_of_cluster.assert_called_once_with(0);
+    TEST_ASSERT_EQUAL(2, volume.write_count);
+    TEST_ASSERT_EQUAL(2, volume.write_data);
+    TEST_ASSERT_EQUAL(0, volume.call_complete_write.call_count);
+
+    /* The producer only waits when both halves are in use */
+    data.fill(3);
+    TEST_ASSERT_TRUE(file.write(data.data(), data.size()));
+    TEST_ASSERT_EQUAL(0, volume.call_complete_write.call_count);
+    data.fill(4);
+    TEST_ASSERT_TRUE(file.write(data.data(), data.size()));
+    volume.call_complete_write.assert_called_once();
+    volume.call_start_write_sectors_of_cluster.assert_called_once_with(2);
+    TEST_ASSERT_EQUAL(4, volume.write_data);
+
+    /* Flushing writes the collected sectors and the current sector */
+    file.put(5);
+    file.flush();
+    TEST_ASSERT_EQUAL(0, volume.call_start_write_sectors_of_cluster.call_count);
+    volume.call_complete_write.assert_called_once();
+    volume.call_write_current_sector.assert_called_once();
+    volume.call_write_filesize_to_directory.assert_called_once();
+
+    /* Sectors of different clusters are written separately */
+    dummy.current.sector = 8;
+    fat32::File last(dummy, volume, files::State::Open);
+    last.set_sync_policy({0});
+    last.set_write_behind(sectors.data(), 4);
+    TEST_ASSERT_TRUE(last.write(data.data(), data.size()));
+    TEST_ASSERT_EQUAL(0, volume.call_start_write_sectors_of_cluster.call_count);
+    TEST_ASSERT_TRUE(last.write(data.data(), data.size()));
+    volume.call_start_write_sectors_of_cluster.assert_called_once_with(7);
+    TEST_ASSERT_EQUAL(1, volume.write_count);
+};
+
 /** 
  * @brief Test creating files
  */
@@ -328,6 +591,39 @@ void test_write_file()
     TEST_ASSERT_EQUAL(0, file.tell());
 };
 
+/** 
+ * @brief Test appending to a file which exists
+ */
+void test_append_file()
+{
+    /* Setup Test */
+    setUp();
+    volume.partition.Sectors_per_Cluster = 4;
+    volume.cluster_return = 7;
+    volume.id_return = 3;
+    volume.file_return.id = 3;
+    volume.file_return.size = 5000;
+    volume.file_return.start_cluster = 4;
+
+    /* Appending starts at the end of the file */
+    auto file = fat32::open(volume, "0:/Test.txt", files::Mode::app);
+    TEST_ASSERT_EQUAL(files::State::Open, file.state);
+    TEST_ASSERT_EQUAL(5000, file.tell());
+    volume.call_get_cluster_of_file.assert_called_once_with(2);
+    volume.call_read_sectors_of_cluster.assert_called_once_with(1);
+
+    /* The data is added to the file */
+    TEST_ASSERT_TRUE(file.put(5));
+    TEST_ASSERT_EQUAL(5001, file.size());
+    TEST_ASSERT_EQUAL(5001, file.tell());
+
+    /* Writing starts at the beginning of the file */
+    file = fat32::open(volume, "0:/Test.txt", files::Mode::out);
+    TEST_ASSERT_EQUAL(0, file.tell());
+    TEST_ASSERT_TRUE(file.put(5));
+    TEST_ASSERT_EQUAL(5000, file.size());
+};
+
 /** 
  * @brief Test closing a file
  */
@@ -347,8 +643,192 @@ void test_close_file()
     /* close the file */
     TEST_ASSERT_TRUE(file.close());
     TEST_ASSERT_EQUAL(files::State::Closed, file.state);
-    TEST_ASSERT_EQUAL(1, volume.call_write_file_to_memory.call_count);
+    TEST_ASSERT_EQUAL(1, volume.call_write_current_sector.call_count);
+    TEST_ASSERT_EQUAL(1, volume.call_write_filesize_to_directory.call_count);
+    TEST_ASSERT_EQUAL(1, volume.call_sync.call_count);
+
+    /* Files which were only read are not written, also at the end of their cluster */
+    setUp();
+    volume.id_return = 3;
+    volume.file_return.id = 3;
+    volume.file_return.size = 512;
+    volume.file_return.start_cluster = 4;
+    for (const files::openmode mode : {files::Mode::in, files::Mode::out})
+    {
+        file = fat32::open(volume, "0:/Test.txt", mode);
+        for (uint32_t count = 0; count < 512; count++)
+            file.read();
+        file.flush();
+        TEST_ASSERT_TRUE(file.sync());
+        TEST_ASSERT_TRUE(file.close());
+    }
+    TEST_ASSERT_EQUAL(0, volume.call_write_current_sector.call_count);
+    TEST_ASSERT_EQUAL(0, volume.call_write_file_to_memory.call_count);
+    TEST_ASSERT_EQUAL(0, volume.call_write_filesize_to_directory.call_count);
+    TEST_ASSERT_EQUAL(0, volume.call_move_to_next_sector.call_count);
+    TEST_ASSERT_EQUAL(0, volume.call_read_sectors_of_cluster.call_count);
+    TEST_ASSERT_EQUAL(4, volume.call_sync.call_count);
+};
+
+/** 
+ * @brief Test moving the access position of a file
+ */
+void test_seek_file()
+{
+    /* Setup Test */
+    setUp();
+    volume.partition.Sectors_per_Cluster = 4;
+    volume.cluster_return = 7;
+    fat32::Filehandler dummy;
+    dummy.size = 5000;
+    dummy.start_cluster = 4;
+    fat32::File file(dummy, volume, files::State::Read_only);
+
+    /* Seek from the beginning of the file */
+    TEST_ASSERT_TRUE(file.seekg(2600));
+    TEST_ASSERT_EQUAL(2600, file.tell());
+    volume.call_get_cluster_of_file.assert_called_once_with(1);
+    volume.call_read_sectors_of_cluster.assert_called_once_with(1);
+    TEST_ASSERT_EQUAL(0xAB, file.read());
+
+    /* Seek relative to the current position and the end */
+    TEST_ASSERT_TRUE(file.seek(-101, files::Seek::cur));
+    TEST_ASSERT_EQUAL(2500, file.tell());
+    TEST_ASSERT_TRUE(file.seek(-8, files::Seek::end));
+    TEST_ASSERT_EQUAL(4992, file.tell());
+    volume.call_get_cluster_of_file.assert_called_last_with(2);
+    volume.call_read_sectors_of_cluster.assert_called_last_with(1);
+
+    /* Positions outside of the file are rejected */
+    TEST_ASSERT_FALSE(file.seek(1, files::Seek::end));
+    TEST_ASSERT_FALSE(file.seek(-1, files::Seek::beg));
+    TEST_ASSERT_FALSE(file.seekg(5001));
+    TEST_ASSERT_EQUAL(4992, file.tell());
+
+    /* Seeking fails when the chain of the file is too short */
+    volume.cluster_return = {};
+    TEST_ASSERT_FALSE(file.seekp(0));
+    TEST_ASSERT_EQUAL(4992, file.tell());
+};
+
+/** 
+ * @brief Test reading and writing at a position of the file
+ */
+void test_positioned_access()
+{
+    /* Setup Test */
+    setUp();
+    volume.partition.Sectors_per_Cluster = 4;
+    volume.cluster_return = 7;
+    fat32::Filehandler dummy;
+    dummy.size = 5000;
+    dummy.start_cluster = 4;
+    fat32::File file(dummy, volume, files::State::Read_only);
+    std::array<char, 20> buffer{};
+
+    /* Reading stops at the end of the file */
+    TEST_ASSERT_EQUAL(10, file.pread(4990, buffer.data(), buffer.size()));
+    TEST_ASSERT_EQUAL(static_cast<char>(0xAB), buffer[9]);
+    TEST_ASSERT_EQUAL(0, buffer[10]);
+    TEST_ASSERT_EQUAL(5000, file.tell());
+
+    /* Read-only files are not written */
+    TEST_ASSERT_FALSE(file.pwrite(10, "abc", 3));
+
+    /* Writing within the file does not change its size */
+    file.state = files::State::Open;
+    TEST_ASSERT_TRUE(file.pwrite(10, "abc", 3));
+    TEST_ASSERT_EQUAL(5000, file.size());
+    TEST_ASSERT_EQUAL(13, file.tell());
+    TEST_ASSERT_EQUAL(files::State::Changed, file.state);
+
+    /* The changed data is written before seeking */
+    TEST_ASSERT_TRUE(file.seekg(0));
+    TEST_ASSERT_EQUAL(1, volume.call_write_current_sector.call_count);
+    TEST_ASSERT_EQUAL(files::State::Open, file.state);
+
+    /* Writing at the end of the file appends the data */
+    TEST_ASSERT_TRUE(file.pwrite(4999, "xy", 2));
+    TEST_ASSERT_EQUAL(5001, file.size());
+};
+
+/** 
+ * @brief Test updating the directory entry according to the sync policy
+ */
+void test_sync_policy()
+{
+    /* Setup Test */
+    setUp();
+    volume.id_return = {};
+    volume.file_return.id = 3;
+    volume.file_return.size = 0;
+    volume.file_return.start_cluster = 4;
+    std::array<char, 512> sector{};
+
+    /* Update the entry every 4 sectors */
+    auto file = fat32::open(volume, "0:/Test.txt", files::Mode::app);
+    file.set_sync_policy({4});
+    for (uint32_t count = 0; count < 3; count++)
+        file.write(sector.data(), sector.size());
+    TEST_ASSERT_EQUAL(3, volume.call_write_file_to_memory.call_count);
+    TEST_ASSERT_EQUAL(0, volume.call_write_filesize_to_directory.call_count);
+    file.write(sector.data(), sector.size());
+    TEST_ASSERT_EQUAL(4, volume.call_write_file_to_memory.call_count);
     TEST_ASSERT_EQUAL(1, volume.call_write_filesize_to_directory.call_count);
+
+    /* Flush the file after an interval */
+    time_ms = 1000;
+    file.set_sync_policy({0, 100, get_time_ms});
+    file.write(sector.data(), 10);
+    TEST_ASSERT_EQUAL(4, volume.call_write_file_to_memory.call_count);
+    time_ms = 1100;
+    file.put(5);
+    TEST_ASSERT_EQUAL(4, volume.call_write_file_to_memory.call_count);
+    TEST_ASSERT_EQUAL(1, volume.call_write_current_sector.call_count);
+    TEST_ASSERT_EQUAL(2, volume.call_write_filesize_to_directory.call_count);
+    file.put(5);
+    TEST_ASSERT_EQUAL(1, volume.call_write_current_sector.call_count);
+
+    /* Only update the entry explicitly */
+    file.set_sync_policy({0});
+    for (uint32_t count = 0; count < 8; count++)
+        file.write(sector.data(), sector.size());
+    TEST_ASSERT_EQUAL(12, volume.call_write_file_to_memory.call_count);
+    TEST_ASSERT_EQUAL(2, volume.call_write_filesize_to_directory.call_count);
+    TEST_ASSERT_TRUE(file.sync());
+    TEST_ASSERT_EQUAL(2, volume.call_write_current_sector.call_count);
+    TEST_ASSERT_EQUAL(3, volume.call_write_filesize_to_directory.call_count);
+    TEST_ASSERT_EQUAL(1, volume.call_sync.call_count);
+    TEST_ASSERT_EQUAL(files::State::Open, file.state);
+};
+
+/** 
+ * @brief Test reserving clusters for a file
+ */
+void test_preallocate_file()
+{
+    /* Setup Test */
+    setUp();
+    volume.id_return = {3};
+    volume.file_return.id = 3;
+    volume.file_return.size = 0;
+    volume.file_return.start_cluster = 4;
+
+    /* Read-only files cannot be extended */
+    auto file = fat32::open(volume, "0:/Test.txt", files::Mode::in);
+    TEST_ASSERT_FALSE(file.preallocate(4096));
+    TEST_ASSERT_EQUAL(0, volume.call_preallocate.call_count);
+    TEST_ASSERT_TRUE(file.close());
+    TEST_ASSERT_EQUAL(0, volume.call_trim_file.call_count);
+
+    /* Reserve clusters and free the unused ones when closing */
+    file = fat32::open(volume, "0:/Test.txt", files::Mode::app);
+    TEST_ASSERT_TRUE(file.preallocate(4096));
+    volume.call_preallocate.assert_called_once_with(4096);
+    file.put(5);
+    TEST_ASSERT_TRUE(file.close());
+    volume.call_trim_file.assert_called_once_with(3);
+    TEST_ASSERT_EQUAL(2, volume.call_sync.call_count);
 };
 
 /* === Main === */
@@ -359,8 +839,16 @@ int main(int argc, char **argv)
     RUN_TEST(test_open_file);
     RUN_TEST(test_read_file);
     RUN_TEST(test_read_file_and_sector);
+    RUN_TEST(test_read_file_to_buffer);
+    RUN_TEST(test_read_ahead);
+    RUN_TEST(test_write_behind);
     RUN_TEST(test_create_file);
     RUN_TEST(test_write_file);
+    RUN_TEST(test_append_file);
     RUN_TEST(test_close_file);
+    RUN_TEST(test_seek_file);
+    RUN_TEST(test_positioned_access);
+    RUN_TEST(test_sync_policy);
+    RUN_TEST(test_preallocate_file);
     return UNITY_END();
 };
@@ -47,6 +47,9 @@ struct Mock_Memory
 };
 Mock::Callable<bool> read_single_block;
 Mock::Callable<bool> write_single_block;
+Mock::Callable<bool> read_multiple_blocks;
+Mock::Callable<bool> write_multiple_blocks;
+uint32_t multiple_blocks_count = 0;
 
 namespace drive
 {
@@ -60,6 +63,18 @@ namespace drive
         ::write_single_block.add_call(static_cast<int>(block));
         return true; 
     };
+    bool read_multiple_blocks(Mock_Memory& memory, const uint32_t* buffer, const uint32_t block, const uint32_t count)
+    {
+        ::read_multiple_blocks.add_call(static_cast<int>(block));
+        ::multiple_blocks_count = count;
+        return true; 
+    };
+    bool write_multiple_blocks(Mock_Memory& memory, const uint32_t* buffer, const uint32_t block, const uint32_t count)
+    {
+        ::write_multiple_blocks.add_call(static_cast<int>(block));
+        ::multiple_blocks_count = count;
+        return true; 
+    };
 }
 
 #include "volumes.h"
@@ -71,6 +86,9 @@ void setUp() {
     /* set stuff up here */
     ::read_single_block.reset();
     ::write_single_block.reset();
+    ::read_multiple_blocks.reset();
+    ::write_multiple_blocks.reset();
+    ::multiple_blocks_count = 0;
 };
 
 void tearDown() {
@@ -132,6 +150,39 @@ void test_write_current_sector()
     ::write_single_block.assert_called_once_with( 0x12 );
 };
 
+/** 
+ * @brief Test transferring multiple sectors of a cluster
+ */
+void test_sectors_of_cluster()
+{
+    /* Setup Test */
+    setUp();
+    Mock_Memory memory;
+    std::array<uint32_t, 4 * 128> buffer{0};
+
+    /* Create volume */
+    fat32::Volume<Mock_Memory> UUT(memory);
+    UUT.partition.First_Data_Sector = 0x12;
+    UUT.partition.Sectors_per_Cluster = 4;
+
+    /* Test reading the whole cluster */
+    TEST_ASSERT_TRUE( UUT.read_sectors_of_cluster(buffer.begin(), 3, 0, 4) );
+    ::read_multiple_blocks.assert_called_once_with( 0x12 + 4 );
+    TEST_ASSERT_EQUAL( 4, ::multiple_blocks_count );
+
+    /* Test writing the end of the cluster */
+    TEST_ASSERT_TRUE( UUT.write_sectors_of_cluster(buffer.begin(), 3, 1, 3) );
+    ::write_multiple_blocks.assert_called_once_with( 0x12 + 5 );
+    TEST_ASSERT_EQUAL( 3, ::multiple_blocks_count );
+
+    /* Sectors beyond the cluster are not transferred */
+    setUp();
+    TEST_ASSERT_FALSE( UUT.read_sectors_of_cluster(buffer.begin(), 3, 2, 3) );
+    TEST_ASSERT_FALSE( UUT.write_sectors_of_cluster(buffer.begin(), 3, 0, 0) );
+    TEST_ASSERT_EQUAL( 0, ::read_multiple_blocks.call_count );
+    TEST_ASSERT_EQUAL( 0, ::write_multiple_blocks.call_count );
+};
+
 /** 
  * @brief Test reading the FAT and getting the next sector of a cluster
  */
@@ -419,6 +470,10 @@ void test_set_cluster()
     TEST_ASSERT_TRUE( UUT.write_FAT_entry(8, 0x14) );
     TEST_ASSERT_EQUAL(0x14, UUT.FAT[32] );
     ::read_single_block.assert_called_once_with( 0x12 );
+
+    /* Test writing the FAT to both FATs when the volume is synchronized */
+    TEST_ASSERT_EQUAL( 0, ::write_single_block.call_count );
+    TEST_ASSERT_TRUE( UUT.sync() );
     TEST_ASSERT_EQUAL( 2, ::write_single_block.call_count );
     ::write_single_block.assert_called_last_with( 0x12 + 0x88 );
 };
@@ -733,6 +788,509 @@ void test_make_file_entry()
     TEST_ASSERT_EQUAL( 0x1C, directory.block_buffer[id*32 + fat32::DIR_Entry::Access_Date + 1]);
 };
 
+/** 
+ * @brief Test reading and updating the FSInfo sector
+ */
+void test_FSInfo()
+{
+    /* Setup Test */
+    setUp();
+    Mock_Memory memory;
+
+    /* Create volume */
+    fat32::Volume<Mock_Memory> UUT(memory);
+
+    /* The mock memory does not change the buffer, so one buffer contains the MBR, the BPB and the FSInfo */
+    fat32::write_byte(UUT.FAT.begin(), fat32::PART1_TYPE, 0x0C);
+    fat32::write_long(UUT.FAT.begin(), fat32::PART1_LBA_BEGIN, 0x800);
+    fat32::write_short(UUT.FAT.begin(), fat32::BYTES_PER_SECTOR, 512);
+    fat32::write_byte(UUT.FAT.begin(), fat32::SEC_PER_CLUSTER, 0x40);
+    fat32::write_short(UUT.FAT.begin(), fat32::RESERVED_SEC, 0x20);
+    fat32::write_byte(UUT.FAT.begin(), fat32::NUMBER_OF_FAT, 2);
+    fat32::write_long(UUT.FAT.begin(), fat32::TOT_SECTORS_32, 0x00800000);
+    fat32::write_long(UUT.FAT.begin(), fat32::FAT_SIZE_32, 0x100);
+    fat32::write_short(UUT.FAT.begin(), fat32::FS_INFO_SECTOR, 1);
+    fat32::write_long(UUT.FAT.begin(), fat32::LEAD_SIGNATURE, 0x41615252);
+    fat32::write_long(UUT.FAT.begin(), fat32::STRUCT_SIGNATURE, 0x61417272);
+    fat32::write_long(UUT.FAT.begin(), fat32::TRAIL_SIGNATURE, 0xAA550000);
+    fat32::write_long(UUT.FAT.begin(), fat32::FREE_COUNT, 0x1234);
+    fat32::write_long(UUT.FAT.begin(), fat32::NEXT_FREE, 0x100);
+    const auto boot_sector = UUT.FAT;
+
+    /* Test mounting reads the FSInfo */
+    TEST_ASSERT_TRUE( UUT.mount() );
+    TEST_ASSERT_EQUAL( 3, ::read_single_block.call_count );
+    ::read_single_block.assert_called_last_with( 0x801 );
+    TEST_ASSERT_EQUAL( 0x801, UUT.partition.FS_Info_Sector );
+    TEST_ASSERT_EQUAL( 0x1234, UUT.get_free_clusters().value() );
+
+    /* The search for empty clusters starts at the hint */
+    setUp();
+    UUT.FAT.fill(0xFF);
+    fat32::write_long(UUT.FAT.begin(), (0x105 * 4) % 512, 0);
+    TEST_ASSERT_EQUAL( 0x105, UUT.get_next_empty_cluster().value() );
+    ::read_single_block.assert_called_once_with( 0x820 + 2 );
+
+    /* Allocating the cluster updates the free count */
+    TEST_ASSERT_TRUE( UUT.write_FAT_entry(0x105, 0x0FFFFFFF) );
+    TEST_ASSERT_EQUAL( 0x1233, UUT.get_free_clusters().value() );
+
+    /* Synchronizing writes the FSInfo */
+    setUp();
+    UUT.FAT = boot_sector;
+    TEST_ASSERT_TRUE( UUT.sync() );
+    ::read_single_block.assert_called_once_with( 0x801 );
+
+    /* The changed FAT sector is written to both FATs before the FSInfo */
+    TEST_ASSERT_EQUAL( 3, ::write_single_block.call_count );
+    ::write_single_block.assert_called_last_with( 0x801 );
+    TEST_ASSERT_EQUAL( 0x1233, fat32::FSInfo::get_free_count(UUT.FAT.begin()) );
+    TEST_ASSERT_EQUAL( 0x106, fat32::FSInfo::get_next_free(UUT.FAT.begin()) );
+
+    /* Nothing changed, so nothing is written */
+    setUp();
+    TEST_ASSERT_TRUE( UUT.sync() );
+    TEST_ASSERT_EQUAL( 0, ::write_single_block.call_count );
+
+    /* Invalid FSInfo sectors are not used */
+    setUp();
+    UUT.FAT = boot_sector;
+    fat32::write_long(UUT.FAT.begin(), fat32::STRUCT_SIGNATURE, 0);
+    TEST_ASSERT_TRUE( UUT.mount() );
+    TEST_ASSERT_FALSE( UUT.get_free_clusters() );
+};
+
+/** 
+ * @brief Test skipping the full sectors of the FAT
+ */
+void test_FAT_map()
+{
+    /* Setup Test */
+    setUp();
+    Mock_Memory memory;
+
+    /* Create volume */
+    fat32::Volume<Mock_Memory> UUT(memory);
+    UUT.partition.FAT_Size = 4;
+    UUT.FAT.fill(0x11);
+
+    /* Searching the full FAT reads all sectors */
+    TEST_ASSERT_FALSE( UUT.get_next_empty_cluster() );
+    TEST_ASSERT_EQUAL( 4, ::read_single_block.call_count );
+
+    /* The sectors are not read again */
+    setUp();
+    TEST_ASSERT_FALSE( UUT.get_next_empty_cluster() );
+    TEST_ASSERT_EQUAL( 0, ::read_single_block.call_count );
+    TEST_ASSERT_EQUAL( error::Code::No_Memory_Left, UUT.error );
+
+    /* Freeing a cluster makes its sector searchable again */
+    TEST_ASSERT_TRUE( UUT.write_FAT_entry(300, 0) );
+    TEST_ASSERT_EQUAL( 300, UUT.get_next_empty_cluster().value() );
+};
+
+/** 
+ * @brief Test counting the free clusters by scanning the FAT
+ */
+void test_scan_FAT()
+{
+    /* Setup Test */
+    setUp();
+    Mock_Memory memory;
+
+    /* Create volume */
+    fat32::Volume<Mock_Memory> UUT(memory);
+    UUT.partition.FAT_Size = 2;
+    UUT.FAT.fill(0x11);
+    std::fill(UUT.FAT.begin() + 10 * 4, UUT.FAT.begin() + 20 * 4, 0);
+
+    /* The free count is not known before the scan */
+    TEST_ASSERT_FALSE( UUT.get_free_clusters() );
+    TEST_ASSERT_FALSE( UUT.scan_FAT(1) );
+    TEST_ASSERT_FALSE( UUT.get_free_clusters() );
+
+    /* Each sector contains 10 free clusters */
+    TEST_ASSERT_TRUE( UUT.scan_FAT(1) );
+    TEST_ASSERT_EQUAL( 20, UUT.get_free_clusters().value() );
+
+    /* The count is updated when clusters are allocated */
+    TEST_ASSERT_TRUE( UUT.write_FAT_entry(10, 0x0FFFFFFF) );
+    TEST_ASSERT_EQUAL( 19, UUT.get_free_clusters().value() );
+    TEST_ASSERT_TRUE( UUT.scan_FAT(1) );
+    TEST_ASSERT_EQUAL( 19, UUT.get_free_clusters().value() );
+};
+
+/** 
+ * @brief Test using a volume with a block cache
+ */
+void test_volume_with_cache()
+{
+    /* Setup Test */
+    setUp();
+    Mock_Memory memory;
+    fat32::Filehandler file{};
+
+    /* Create volume */
+    drive::Cache<Mock_Memory, 2> cache{memory};
+    fat32::Volume<drive::Cache<Mock_Memory, 2>> UUT(cache);
+    UUT.partition.First_Data_Sector = 0x12;
+    file.current.sector = 1;
+    file.current.cluster = 2;
+
+    /* The sector is read from memory only once */
+    TEST_ASSERT_TRUE( UUT.read_cluster(file, 2) );
+    TEST_ASSERT_TRUE( UUT.read_cluster(file, 2) );
+    ::read_single_block.assert_called_once_with( 0x12 );
+
+    /* Written sectors are written to memory when the volume is synchronized */
+    TEST_ASSERT_TRUE( UUT.write_current_sector(file) );
+    TEST_ASSERT_EQUAL( 0, ::write_single_block.call_count );
+    TEST_ASSERT_TRUE( UUT.sync() );
+    ::write_single_block.assert_called_once_with( 0x12 );
+
+    /* The volume uses the cache and not a copy of it */
+    TEST_ASSERT_EQUAL_PTR( &cache, &UUT.memory );
+    TEST_ASSERT_EQUAL( 1, cache.get_write_backs() );
+
+    /* A volume without a cache has nothing to synchronize */
+    fat32::Volume<Mock_Memory> uncached(memory);
+    TEST_ASSERT_TRUE( uncached.sync() );
+};
+
+/** 
+ * @brief Test remembering the cluster chain of a file
+ */
+void test_cluster_chain()
+{
+    /* Setup Test */
+    setUp();
+    Mock_Memory memory;
+    fat32::Filehandler file{};
+    file.start_cluster = 4;
+
+    /* Create volume with the chain 4 -> 5 -> 6 */
+    fat32::Volume<Mock_Memory> UUT(memory);
+    UUT.partition.FAT_Size = 1;
+    UUT.partition.First_Data_Sector = 0x12;
+    UUT.partition.Sectors_per_Cluster = 0x40;
+    fat32::write_long(UUT.FAT.begin(), 4 * 4, 5);
+    fat32::write_long(UUT.FAT.begin(), 5 * 4, 6);
+    fat32::write_long(UUT.FAT.begin(), 6 * 4, fat32::FAT_Code::End_of_File);
+
+    /* Following the chain reads the FAT */
+    TEST_ASSERT_EQUAL( 6, UUT.get_cluster_of_file(file, 2).value() );
+    TEST_ASSERT_EQUAL( 1, ::read_single_block.call_count );
+    TEST_ASSERT_FALSE( UUT.get_cluster_of_file(file, 3) );
+    TEST_ASSERT_EQUAL( error::Code::End_of_File_Reached, UUT.error );
+
+    /* The known chain is used without the FAT */
+    setUp();
+    UUT.FAT.fill(0);
+    UUT.error = error::Code::None;
+    TEST_ASSERT_EQUAL( 5, UUT.get_cluster_of_file(file, 1).value() );
+    TEST_ASSERT_FALSE( UUT.get_cluster_of_file(file, 3) );
+    TEST_ASSERT_EQUAL( error::Code::End_of_File_Reached, UUT.error );
+    file.current.cluster = 4;
+    file.current.sector = UUT.partition.Sectors_per_Cluster;
+    TEST_ASSERT_TRUE( UUT.read_next_sector_of_cluster(file) );
+    ::read_single_block.assert_called_once_with( 0x12 + 3 * 0x40 );
+
+    /* Allocating clusters extends the chain */
+    TEST_ASSERT_TRUE( UUT.write_FAT_entry(6, 7) );
+    TEST_ASSERT_TRUE( UUT.write_FAT_entry(7, 20) );
+    TEST_ASSERT_TRUE( UUT.write_FAT_entry(20, fat32::FAT_Code::End_of_File) );
+    setUp();
+    TEST_ASSERT_EQUAL( 20, UUT.get_cluster_of_file(file, 4).value() );
+    TEST_ASSERT_FALSE( UUT.get_cluster_of_file(file, 5) );
+    file.current.cluster = 7;
+    file.current.sector = UUT.partition.Sectors_per_Cluster;
+    TEST_ASSERT_TRUE( UUT.read_next_sector_of_cluster(file) );
+    ::read_single_block.assert_called_once_with( 0x12 + 18 * 0x40 );
+
+    /* Changing the chain before its end forgets the chain */
+    TEST_ASSERT_TRUE( UUT.write_FAT_entry(5, 0) );
+    setUp();
+    TEST_ASSERT_FALSE( UUT.get_cluster_of_file(file, 1) );
+    TEST_ASSERT_EQUAL( error::Code::FAT_Corrupted, UUT.error );
+};
+
+/** 
+ * @brief Test writing a full cluster within a file
+ */
+void test_overwrite_cluster()
+{
+    /* Setup Test */
+    setUp();
+    Mock_Memory memory;
+    fat32::Filehandler file{};
+    file.start_cluster = 4;
+
+    /* Create volume with the chain 4 -> 9 */
+    fat32::Volume<Mock_Memory> UUT(memory);
+    UUT.partition.FAT_Size = 1;
+    UUT.partition.Sectors_per_Cluster = 0x40;
+    fat32::write_long(UUT.FAT.begin(), 4 * 4, 9);
+    fat32::write_long(UUT.FAT.begin(), 9 * 4, 0x0FFFFFFF);
+
+    /* The write continues with the next cluster of the file */
+    file.current.cluster = 4;
+    file.current.sector = UUT.partition.Sectors_per_Cluster;
+    file.current.byte = 512;
+    TEST_ASSERT_TRUE( UUT.write_file_to_memory(file) );
+    TEST_ASSERT_EQUAL( 9, file.current.cluster );
+    TEST_ASSERT_EQUAL( 1, file.current.sector );
+    TEST_ASSERT_EQUAL( 1, ::write_single_block.call_count );
+
+    /* At the end of the file a new cluster is allocated */
+    setUp();
+    file.current.sector = UUT.partition.Sectors_per_Cluster;
+    file.current.byte = 512;
+    TEST_ASSERT_TRUE( UUT.write_file_to_memory(file) );
+    TEST_ASSERT_EQUAL( 2, file.current.cluster );
+    TEST_ASSERT_EQUAL( 1, ::write_single_block.call_count );
+    TEST_ASSERT_EQUAL( 2, UUT.get_cluster_of_file(file, 2).value() );
+};
+
+/** 
+ * @brief Test batching the changes of the FAT
+ */
+void test_FAT_buffer()
+{
+    /* Setup Test */
+    setUp();
+    Mock_Memory memory;
+    fat32::Filehandler file{};
+    file.directory_cluster = 2;
+
+    /* Create volume */
+    fat32::Volume<Mock_Memory> UUT(memory);
+    UUT.partition.Sectors_per_Cluster = 0x40;
+    UUT.partition.FAT_Begin = 0x12;
+    UUT.partition.FAT_Size = 0x88;
+
+    /* Changes of the same sector are written together */
+    TEST_ASSERT_TRUE( UUT.write_FAT_entry(8, 9) );
+    TEST_ASSERT_TRUE( UUT.write_FAT_entry(9, 0x0FFFFFFF) );
+    TEST_ASSERT_EQUAL( 0, ::write_single_block.call_count );
+
+    /* The sector is written when another sector is read */
+    TEST_ASSERT_TRUE( UUT.read_FAT_entry(200) );
+    TEST_ASSERT_EQUAL( 2, ::write_single_block.call_count );
+    ::write_single_block.assert_called_last_with( 0x12 + 0x88 );
+    ::read_single_block.assert_called_last_with( 0x13 );
+
+    /* The sector is written before a directory entry is updated */
+    setUp();
+    TEST_ASSERT_TRUE( UUT.write_FAT_entry(200, 0x0FFFFFFF) );
+    TEST_ASSERT_TRUE( UUT.write_filesize_to_directory(file) );
+    TEST_ASSERT_EQUAL( 3, ::write_single_block.call_count );
+    TEST_ASSERT_TRUE( UUT.sync() );
+    TEST_ASSERT_EQUAL( 3, ::write_single_block.call_count );
+
+    /* The second FAT can be mirrored when the volume is synchronized */
+    setUp();
+    UUT.set_FAT_mirroring(true);
+    TEST_ASSERT_TRUE( UUT.write_FAT_entry(8, 0x0FFFFFFF) );
+    TEST_ASSERT_TRUE( UUT.write_FAT_entry(200, 0x0FFFFFFF) );
+    ::write_single_block.assert_called_once_with( 0x12 );
+    TEST_ASSERT_TRUE( UUT.sync() );
+    TEST_ASSERT_EQUAL( 3, ::write_single_block.call_count );
+    ::write_single_block.assert_called_last_with( 0x13 + 0x88 );
+
+    /* Both FATs are equal, so nothing is written */
+    setUp();
+    TEST_ASSERT_TRUE( UUT.sync() );
+    TEST_ASSERT_EQUAL( 0, ::write_single_block.call_count );
+};
+
+/** 
+ * @brief Test reserving consecutive clusters for a file
+ */
+void test_preallocate()
+{
+    /* Setup Test */
+    setUp();
+    Mock_Memory memory;
+    fat32::Filehandler file{};
+    file.start_cluster = 4;
+    file.size = 700;
+
+    /* Create volume with the chain 4 -> 5 and the used cluster 6 */
+    fat32::Volume<Mock_Memory> UUT(memory);
+    UUT.partition.FAT_Size = 1;
+    UUT.partition.Sectors_per_Cluster = 1;
+    fat32::write_long(UUT.FAT.begin(), 4 * 4, 5);
+    fat32::write_long(UUT.FAT.begin(), 5 * 4, 0x0FFFFFFF);
+    fat32::write_long(UUT.FAT.begin(), 6 * 4, 0x0FFFFFFF);
+
+    /* The run starts behind the used cluster and is linked to the file */
+    TEST_ASSERT_TRUE( UUT.preallocate(file, 2000) );
+    TEST_ASSERT_EQUAL( 7, fat32::read_long(UUT.FAT.begin(), 5 * 4) );
+    TEST_ASSERT_EQUAL( 8, fat32::read_long(UUT.FAT.begin(), 7 * 4) );
+    TEST_ASSERT_EQUAL( 9, fat32::read_long(UUT.FAT.begin(), 8 * 4) );
+    TEST_ASSERT_EQUAL( 10, fat32::read_long(UUT.FAT.begin(), 9 * 4) );
+    TEST_ASSERT_EQUAL( 0xFFFFFFFF, fat32::read_long(UUT.FAT.begin(), 10 * 4) );
+    TEST_ASSERT_EQUAL( 0, fat32::read_long(UUT.FAT.begin(), 11 * 4) );
+
+    /* The whole chain is written with one FAT sector */
+    setUp();
+    TEST_ASSERT_TRUE( UUT.sync() );
+    TEST_ASSERT_EQUAL( 2, ::write_single_block.call_count );
+
+    /* The reserved clusters are known without reading the FAT */
+    setUp();
+    TEST_ASSERT_EQUAL( 10, UUT.get_cluster_of_file(file, 5).value() );
+    file.current.cluster = 5;
+    file.current.sector = 1;
+    file.current.byte = 512;
+    TEST_ASSERT_TRUE( UUT.write_file_to_memory(file) );
+    TEST_ASSERT_EQUAL( 7, file.current.cluster );
+    TEST_ASSERT_TRUE( UUT.write_filesize_to_directory(file) );
+    TEST_ASSERT_EQUAL( 1, ::read_single_block.call_count );
+    TEST_ASSERT_EQUAL( 2, ::write_single_block.call_count );
+
+    /* Enough clusters are reserved already */
+    setUp();
+    TEST_ASSERT_TRUE( UUT.preallocate(file, 2000) );
+    TEST_ASSERT_EQUAL( 0, ::read_single_block.call_count );
+
+    /* The volume has no run which is large enough */
+    TEST_ASSERT_FALSE( UUT.preallocate(file, 200 * 512) );
+    TEST_ASSERT_EQUAL( error::Code::No_Memory_Left, UUT.error );
+
+    /* The clusters behind the end of the file are freed */
+    file.size = 3 * 512 + 10;
+    TEST_ASSERT_TRUE( UUT.trim_file(file) );
+    TEST_ASSERT_EQUAL( 0xFFFFFFFF, fat32::read_long(UUT.FAT.begin(), 8 * 4) );
+    TEST_ASSERT_EQUAL( 0, fat32::read_long(UUT.FAT.begin(), 9 * 4) );
+    TEST_ASSERT_EQUAL( 0, fat32::read_long(UUT.FAT.begin(), 10 * 4) );
+    TEST_ASSERT_EQUAL( 8, UUT.get_cluster_of_file(file, 3).value() );
+    TEST_ASSERT_FALSE( UUT.get_cluster_of_file(file, 4) );
+
+    /* Files without reserved clusters are not changed */
+    setUp();
+    TEST_ASSERT_TRUE( UUT.trim_file(file) );
+    TEST_ASSERT_TRUE( UUT.sync() );
+    TEST_ASSERT_EQUAL( 2, ::write_single_block.call_count );
+};
+
+/** 
+ * @brief Test iterating over the entries of a directory
+ */
+void test_directory_iterator()
+{
+    /* Setup Test */
+    setUp();
+    Mock_Memory memory;
+    fat32::Filehandler directory;
+    fat32::Directory_Entry entry;
+    directory.start_cluster = 2;
+
+    /* Every sector contains files, a deleted entry, a long file name and a directory */
+    for (uint8_t id = 0; id < 16; id++)
+        std::copy_n("FILE    TXT", 11, directory.block_buffer.begin() + 32 * id);
+    directory.block_buffer[32 * 1] = 0xE5;
+    directory.block_buffer[32 * 2 + fat32::DIR_Entry::Attributes] = fat32::Attribute::Long_Name;
+    directory.block_buffer[32 * 3 + fat32::DIR_Entry::Attributes] = fat32::Attribute::is_Directory;
+    fat32::write_short(directory.block_buffer.begin(), 32 * 4 + fat32::DIR_Entry::First_Cluster_L, 0x1234);
+    fat32::write_short(directory.block_buffer.begin(), 32 * 4 + fat32::DIR_Entry::First_Cluster_H, 0x0001);
+    fat32::write_long(directory.block_buffer.begin(), 32 * 4 + fat32::DIR_Entry::Filesize, 42);
+
+    /* Create volume */
+    fat32::Volume<Mock_Memory> UUT(memory);
+    UUT.partition.Sectors_per_Cluster = 0x40;
+
+    /* Test iterating when filehandle is not a directory */
+    TEST_ASSERT_FALSE( UUT.rewind_directory(directory) );
+    TEST_ASSERT_EQUAL( error::Code::Not_a_Directory, UUT.error );
+
+    /* The deleted entry and the long file name are skipped */
+    directory.attributes = fat32::Attribute::is_Directory;
+    TEST_ASSERT_TRUE( UUT.rewind_directory(directory) );
+    TEST_ASSERT_TRUE( UUT.read_next_entry(directory, entry) );
+    TEST_ASSERT_EQUAL( 0, entry.id );
+    TEST_ASSERT_EQUAL_STRING( "FILE    TXT", entry.name.data() );
+    TEST_ASSERT_TRUE( UUT.read_next_entry(directory, entry) );
+    TEST_ASSERT_EQUAL( 3, entry.id );
+    TEST_ASSERT_TRUE( entry.is_directory() );
+    TEST_ASSERT_TRUE( UUT.read_next_entry(directory, entry) );
+    TEST_ASSERT_EQUAL( 4, entry.id );
+    TEST_ASSERT_FALSE( entry.is_directory() );
+    TEST_ASSERT_EQUAL( 0x11234, entry.start_cluster );
+    TEST_ASSERT_EQUAL( 42, entry.size );
+
+    /* Each sector is read once */
+    for (uint8_t id = 5; id < 16; id++)
+        TEST_ASSERT_TRUE( UUT.read_next_entry(directory, entry) );
+    TEST_ASSERT_EQUAL( 1, ::read_single_block.call_count );
+    TEST_ASSERT_TRUE( UUT.read_next_entry(directory, entry) );
+    TEST_ASSERT_EQUAL( 16, entry.id );
+    TEST_ASSERT_EQUAL( 2, ::read_single_block.call_count );
+    ::read_single_block.assert_called_last_with( UUT.partition.get_LBA_of_cluster(2) + 1 );
+
+    /* An empty entry ends the directory */
+    directory.block_buffer[32 * 1] = 0x00;
+    TEST_ASSERT_FALSE( UUT.read_next_entry(directory, entry) );
+    TEST_ASSERT_EQUAL( error::Code::End_of_File_Reached, UUT.error );
+    TEST_ASSERT_FALSE( UUT.read_next_entry(directory, entry) );
+    TEST_ASSERT_EQUAL( 16, entry.id );
+    TEST_ASSERT_EQUAL( 2, ::read_single_block.call_count );
+};
+
+/** 
+ * @brief Test remembering the entries of opened files
+ */
+void test_lookup()
+{
+    /* Setup Test */
+    setUp();
+    Mock_Memory memory;
+    fat32::Filehandler directory;
+    directory.attributes = fat32::Attribute::is_Directory;
+    directory.start_cluster = 2;
+    std::copy_n("TEST    TXT", 11, directory.block_buffer.begin() + 32);
+    fat32::write_short(directory.block_buffer.begin(), 32 + fat32::DIR_Entry::First_Cluster_L, 5);
+    fat32::write_long(directory.block_buffer.begin(), 32 + fat32::DIR_Entry::Filesize, 10);
+    const std::array<char, 12> filename = {"TEST    TXT"};
+    const std::array<char, 12> new_filename = {"NEW     TXT"};
+
+    /* Create volume */
+    fat32::Volume<Mock_Memory> UUT(memory);
+    UUT.partition.Sectors_per_Cluster = 0x40;
+
+    /* The entry is remembered when it is found */
+    TEST_ASSERT_EQUAL( 1, UUT.get_fileid(directory, filename).value() );
+
+    /* Searching and loading the entry again does not read the memory */
+    directory.block_buffer.fill(0);
+    TEST_ASSERT_EQUAL( 1, UUT.get_fileid(directory, filename).value() );
+    fat32::Filehandler file = directory;
+    TEST_ASSERT_TRUE( UUT.get_file(file, 1) );
+    TEST_ASSERT_EQUAL( 0, ::read_single_block.call_count );
+    TEST_ASSERT_EQUAL_STRING( "TEST    TXT", file.name.data() );
+    TEST_ASSERT_EQUAL( 5, file.start_cluster );
+    TEST_ASSERT_EQUAL( 10, file.size );
+    TEST_ASSERT_TRUE( file.is_file() );
+
+    /* The remembered size is updated with the directory entry */
+    file.size = 20;
+    TEST_ASSERT_TRUE( UUT.write_filesize_to_directory(file) );
+    file = directory;
+    TEST_ASSERT_TRUE( UUT.get_file(file, 1) );
+    TEST_ASSERT_EQUAL( 20, file.size );
+
+    /* A new entry with the same id replaces the remembered entry */
+    setUp();
+    TEST_ASSERT_TRUE( UUT.make_directory_entry(directory, 1, 7, new_filename, fat32::Attribute::Archive, 0) );
+    TEST_ASSERT_EQUAL( 1, UUT.get_fileid(directory, new_filename).value() );
+    file = directory;
+    TEST_ASSERT_TRUE( UUT.get_file(file, 1) );
+    TEST_ASSERT_EQUAL_STRING( "NEW     TXT", file.name.data() );
+    TEST_ASSERT_EQUAL( 7, file.start_cluster );
+    TEST_ASSERT_EQUAL( 0, ::read_single_block.call_count );
+    TEST_ASSERT_FALSE( UUT.get_fileid(directory, filename) );
+};
+
 /* === Main === */
 int main(int argc, char **argv)
 {
@@ -740,6 +1298,7 @@ int main(int argc, char **argv)
     RUN_TEST(test_constructor);
     RUN_TEST(test_read_cluster);
     RUN_TEST(test_write_current_sector);
+    RUN_TEST(test_sectors_of_cluster);
     RUN_TEST(test_get_FAT_entry);
     RUN_TEST(test_read_next_sector);
     RUN_TEST(test_get_file_with_id);
@@ -753,5 +1312,15 @@ int main(int argc, char **argv)
     RUN_TEST(test_update_filesize);
     RUN_TEST(test_write_file_content);
     RUN_TEST(test_make_file_entry);
+    RUN_TEST(test_volume_with_cache);
+    RUN_TEST(test_FSInfo);
+    RUN_TEST(test_FAT_map);
+    RUN_TEST(test_scan_FAT);
+    RUN_TEST(test_cluster_chain);
+    RUN_TEST(test_overwrite_cluster);
+    RUN_TEST(test_FAT_buffer);
+    RUN_TEST(test_preallocate);
+    RUN_TEST(test_directory_iterator);
+    RUN_TEST(test_lookup);
     return UNITY_END();
 };
\ No newline at end of file
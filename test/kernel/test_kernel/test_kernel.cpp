@@ -34,6 +34,22 @@
 
 /* === Text Fixtures === */
 extern Mock::Callable<uint32_t> otos_switch;
+extern std::uint32_t otos_systick_elapsed;
+Mock::Callable<bool> watchdog_kick;
+void kick_watchdog() { watchdog_kick.add_call(0); };
+
+struct Dummy_IO
+{
+    std::array<char, 128> char_buffer{0};
+    std::size_t index{0};
+    void put(char c) { char_buffer[index++] = c; };
+    void flush(void) { char_buffer.fill(0); index = 0; };
+    void write(const char *str, std::size_t len)
+    {
+        std::copy_n(str, len, char_buffer.begin() + index);
+        index += len;
+    };
+};
 
 void setUp() {
 /* set stuff up here */
@@ -197,6 +213,95 @@ void test_scheduling_with_timing_with_priority()
     UUT.switch_to_thread(2);
 };
 
+/**
+ * @brief Test scheduling threads with a period in kernel ticks.
+ */
+void test_scheduling_in_ticks()
+{
+    /* Create UUT */
+    OTOS::Kernel UUT;
+
+    /* Check the period of the frequencies at compile time */
+    static_assert(OTOS::check::Frequency<OTOS::tick_rate_hz>() == 1);
+    static_assert(OTOS::check::Frequency<500>() == 2);
+    TEST_ASSERT_EQUAL(OTOS::tick_rate_hz / 250, OTOS::check::Frequency<250>());
+
+    /* Thread with the maximum frequency is runnable every tick */
+    UUT.schedule_thread<256, OTOS::tick_rate_hz>(0, OTOS::Priority::High);
+    UUT.schedule_thread<256>(0, OTOS::Priority::Normal);
+    TEST_ASSERT_EQUAL(1, UUT.get_next_thread().value_or(-1));
+    UUT.switch_to_thread(1);
+    UUT.update_schedule();
+    TEST_ASSERT_EQUAL(0, UUT.get_next_thread().value_or(-1));
+    UUT.switch_to_thread(0);
+    TEST_ASSERT_EQUAL(1, UUT.get_next_thread().value_or(-1));
+    UUT.switch_to_thread(1);
+    UUT.update_schedule();
+    TEST_ASSERT_EQUAL(0, UUT.get_next_thread().value_or(-1));
+    UUT.switch_to_thread(0);
+
+    /* Frequencies above the tick rate are limited to the tick rate and not always runnable */
+    OTOS::Kernel UUT_fast;
+    UUT_fast.schedule_thread<256>(0, OTOS::Priority::High, 2 * OTOS::tick_rate_hz);
+    TEST_ASSERT_FALSE(UUT_fast.get_next_thread());
+    UUT_fast.update_schedule();
+    TEST_ASSERT_EQUAL(0, UUT_fast.get_next_thread().value_or(-1));
+};
+
+/**
+ * @brief Test the heartbeat supervision of the threads.
+ */
+void test_heartbeat_supervision()
+{
+    /* Create UUT */
+    OTOS::Kernel UUT;
+    watchdog_kick.reset();
+    UUT.set_watchdog(&kick_watchdog);
+    UUT.schedule_thread<256>(0, OTOS::Priority::Normal);
+    UUT.schedule_thread<256>(0, OTOS::Priority::Normal);
+
+    /* Without supervised threads the watchdog is kicked every tick */
+    UUT.update_schedule();
+    watchdog_kick.assert_called_once();
+
+    /* Thread 1 registers a heartbeat interval of 2 ms */
+    UUT.switch_to_thread(1);
+    UUT.register_heartbeat(2);
+    UUT.update_schedule();
+    UUT.update_schedule();
+    TEST_ASSERT_EQUAL(2, watchdog_kick.call_count);
+    TEST_ASSERT_FALSE(UUT.get_stalled_thread());
+
+    /* The thread stalls when the interval is exceeded */
+    watchdog_kick.reset();
+    for (u_base_t tick = 0; tick < OTOS::ticks_per_ms; tick++)
+        UUT.update_schedule();
+    TEST_ASSERT_EQUAL(OTOS::ticks_per_ms - 1, watchdog_kick.call_count);
+    TEST_ASSERT_EQUAL(1, UUT.get_stalled_thread().value_or(-1));
+    TEST_ASSERT_EQUAL(1, UUT.get_thread(1).get_stall_count());
+    TEST_ASSERT_EQUAL(0, UUT.get_thread(0).get_stall_count());
+
+    /* The watchdog is not kicked as long as the thread is stalled */
+    watchdog_kick.reset();
+    UUT.update_schedule();
+    TEST_ASSERT_EQUAL(0, watchdog_kick.call_count);
+    TEST_ASSERT_EQUAL(1, UUT.get_thread(1).get_stall_count());
+
+    /* The heartbeat revives the thread */
+    UUT.switch_to_thread(1);
+    UUT.heartbeat();
+    UUT.update_schedule();
+    watchdog_kick.assert_called_once();
+    TEST_ASSERT_FALSE(UUT.get_stalled_thread());
+    TEST_ASSERT_EQUAL(2 * OTOS::ticks_per_ms + 2, UUT.get_thread(1).get_worst_heartbeat());
+
+    /* The supervision data can be written to a stream */
+    Dummy_IO io;
+    OTOS::ostream out{io};
+    UUT.dump_supervision(out);
+    TEST_ASSERT_EQUAL_STRING("thread 1: stalls 1, worst 4 ms, zone -\n", io.char_buffer.data());
+};
+
 /**
  * @brief Test the ms timer of the kernel.
  */
@@ -213,6 +318,44 @@ void test_Time_ms()
     UUT.count_time_ms();
     TEST_ASSERT_EQUAL( 1, UUT.get_time_ms());
     TEST_ASSERT_EQUAL( 1, OTOS::get_time_ms());
+
+    /* Counting the ticks of 1 ms increases the time by 1 ms */
+    for (u_base_t tick = 0; tick < OTOS::ticks_per_ms; tick++)
+        UUT.count_tick();
+    TEST_ASSERT_EQUAL( 1 + OTOS::ms_per_tick, UUT.get_time_ms());
+};
+
+/**
+ * @brief Test the monotonic us and cycle clock of the kernel.
+ */
+void test_Time_us()
+{
+    /* Create UUT */
+    OTOS::Kernel UUT;
+    otos_systick_elapsed = 0;
+    const std::uint64_t start_us = UUT.get_time_us();
+    const std::uint64_t start_cycles = UUT.get_time_cycles();
+
+    /* The time is a multiple of the ticks when no cycles elapsed */
+    TEST_ASSERT_EQUAL( 0, start_us % OTOS::us_per_tick );
+    TEST_ASSERT_EQUAL( 0, start_cycles % OTOS::cycles_per_tick );
+
+    /* The elapsed cycles of the SysTick are added to the time */
+    otos_systick_elapsed = F_CPU / 1'000'000 * 250;
+    TEST_ASSERT_EQUAL( start_us + 250, UUT.get_time_us() );
+    TEST_ASSERT_EQUAL( start_cycles + otos_systick_elapsed, UUT.get_time_cycles() );
+    TEST_ASSERT_EQUAL( start_us + 250, OTOS::get_time_us() );
+
+    /* Counting a tick advances the time by one tick */
+    otos_systick_elapsed = 0;
+    UUT.count_tick();
+    TEST_ASSERT_EQUAL( start_us + OTOS::us_per_tick, UUT.get_time_us() );
+    TEST_ASSERT_EQUAL( start_cycles + OTOS::cycles_per_tick, UUT.get_time_cycles() );
+
+    /* A pending reload which is not yet counted keeps the time monotonic */
+    otos_systick_elapsed = OTOS::cycles_per_tick + F_CPU / 1'000'000;
+    TEST_ASSERT_EQUAL( start_us + 2 * OTOS::us_per_tick + 1, UUT.get_time_us() );
+    otos_systick_elapsed = 0;
 };
 
 /* === Perform the tests === */
@@ -225,6 +368,9 @@ int main(int argc, char** argv)
     RUN_TEST(test_scheduling_no_timing_no_priority);
     RUN_TEST(test_scheduling_with_timing_no_priority);
     RUN_TEST(test_scheduling_with_timing_with_priority);
+    RUN_TEST(test_scheduling_in_ticks);
+    RUN_TEST(test_heartbeat_supervision);
     RUN_TEST(test_Time_ms);
+    RUN_TEST(test_Time_us);
     return UNITY_END();
 }
@@ -0,0 +1,259 @@
+/**
+ * OTOS - Open Tec Operating System
+ * Copyright (c) 2021 - 2024 Sebastian Oberschwendtner, sebastian.oberschwendtner@gmail.com
+ *
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+/**
+ ==============================================================================
+ * @file    test_pool.cpp
+ * @author  SO
+ * @version v5.2.0
+ * @date    18-October-2026
+ * @brief   Unit tests for the memory pools of the OTOS.
+ ==============================================================================
+ */
+
+/* === Includes === */
+#define OTOS_POOL_POISON
+#include <unity.h>
+#include <mock.h>
+#include <list>
+#include <map>
+#include <pool.h>
+
+/* === Mocks === */
+extern Mock::Callable<bool> CMSIS_disable_irq;
+extern uint32_t CMSIS_PRIMASK;
+
+/* === Fixtures === */
+struct Tracked
+{
+    static int instances;
+    int value;
+    explicit Tracked(int value) : value{value} { instances++; };
+    ~Tracked() { instances--; };
+};
+int Tracked::instances = 0;
+
+void setUp()
+{
+    /* set stuff up here */
+    CMSIS_disable_irq.reset();
+    CMSIS_PRIMASK = 0;
+};
+
+void tearDown(){
+    /* clean stuff up here */
+};
+
+/* === Define Tests === */
+/**
+ * @brief Test the critical section restores the interrupt mask.
+ */
+void test_critical_section()
+{
+    {
+        OTOS::CriticalSection outer;
+        TEST_ASSERT_EQUAL(1, CMSIS_PRIMASK);
+        {
+            OTOS::CriticalSection inner;
+            TEST_ASSERT_EQUAL(1, CMSIS_PRIMASK);
+        }
+        /* The nested section must not enable the interrupts */
+        TEST_ASSERT_EQUAL(1, CMSIS_PRIMASK);
+    }
+    TEST_ASSERT_EQUAL(0, CMSIS_PRIMASK);
+    TEST_ASSERT_EQUAL(2, CMSIS_disable_irq.call_count);
+};
+
+/**
+ * @brief Test the block size and alignment of the pool.
+ */
+void test_block_size()
+{
+    TEST_ASSERT_EQUAL(sizeof(void *), (OTOS::BlockPool<1, 4, 1>::block_size));
+    TEST_ASSERT_EQUAL(16, (OTOS::BlockPool<10, 4, 8>::block_size));
+    TEST_ASSERT_EQUAL(32, (OTOS::BlockPool<24, 4, 16>::block_size));
+};
+
+/**
+ * @brief Test allocating and freeing blocks.
+ */
+void test_allocate()
+{
+    /* Create UUT */
+    static OTOS::BlockPool<16, 3> UUT;
+    TEST_ASSERT_EQUAL(0, UUT.get_used());
+    TEST_ASSERT_EQUAL(3, UUT.get_free());
+
+    /* Allocate all blocks */
+    void *block1 = UUT.allocate();
+    void *block2 = UUT.allocate();
+    void *block3 = UUT.allocate();
+    TEST_ASSERT_NOT_NULL(block1);
+    TEST_ASSERT_NOT_NULL(block2);
+    TEST_ASSERT_NOT_NULL(block3);
+    TEST_ASSERT_TRUE(block1 != block2);
+    TEST_ASSERT_TRUE(block2 != block3);
+    TEST_ASSERT_EQUAL(0, reinterpret_cast<std::uintptr_t>(block1) % UUT.block_align);
+    TEST_ASSERT_EQUAL(3, UUT.get_used());
+    TEST_ASSERT_EQUAL(0, CMSIS_PRIMASK);
+
+    /* The pool is exhausted */
+    TEST_ASSERT_NULL(UUT.allocate());
+    TEST_ASSERT_EQUAL(3, UUT.get_used());
+
+    /* Free a block and allocate it again */
+    UUT.deallocate(block2);
+    TEST_ASSERT_EQUAL(2, UUT.get_used());
+    TEST_ASSERT_EQUAL_PTR(block2, UUT.allocate());
+
+    /* Pointers which do not belong to the pool are ignored */
+    int foreign = 0;
+    UUT.deallocate(&foreign);
+    UUT.deallocate(static_cast<std::uint8_t *>(block1) + 1);
+    UUT.deallocate(nullptr);
+    TEST_ASSERT_EQUAL(3, UUT.get_used());
+    TEST_ASSERT_TRUE(UUT.owns(block3));
+    TEST_ASSERT_FALSE(UUT.owns(&foreign));
+};
+
+/**
+ * @brief Test the high-water mark of the pool.
+ */
+void test_high_water()
+{
+    /* Create UUT */
+    static OTOS::BlockPool<8, 4> UUT;
+    TEST_ASSERT_EQUAL(0, UUT.get_high_water());
+
+    void *block1 = UUT.allocate();
+    void *block2 = UUT.allocate();
+    TEST_ASSERT_EQUAL(2, UUT.get_high_water());
+
+    /* Freeing does not lower the high-water mark */
+    UUT.deallocate(block1);
+    UUT.deallocate(block2);
+    TEST_ASSERT_EQUAL(0, UUT.get_used());
+    TEST_ASSERT_EQUAL(2, UUT.get_high_water());
+
+    /* Reusing freed blocks does not raise it */
+    block1 = UUT.allocate();
+    block2 = UUT.allocate();
+    TEST_ASSERT_EQUAL(2, UUT.get_high_water());
+    UUT.allocate();
+    TEST_ASSERT_EQUAL(3, UUT.get_high_water());
+};
+
+/**
+ * @brief Test the poisoning of freed blocks.
+ */
+void test_poison()
+{
+    /* Create UUT */
+    static OTOS::BlockPool<16, 2> UUT;
+    auto *block = static_cast<std::uint8_t *>(UUT.allocate());
+    std::fill_n(block, UUT.block_size, 0x00);
+
+    /* Freed blocks are poisoned */
+    UUT.deallocate(block);
+    TEST_ASSERT_EQUAL_HEX8(UUT.poison, block[UUT.block_size - 1]);
+
+    /* An intact block is not reported */
+    block = static_cast<std::uint8_t *>(UUT.allocate());
+    TEST_ASSERT_EQUAL(0, UUT.get_poison_errors());
+
+    /* Writing to a freed block is detected */
+    UUT.deallocate(block);
+    block[UUT.block_size - 1] = 0x42;
+    UUT.allocate();
+    TEST_ASSERT_EQUAL(1, UUT.get_poison_errors());
+};
+
+/**
+ * @brief Test the typed object pool.
+ */
+void test_object_pool()
+{
+    /* Create UUT */
+    static OTOS::Pool<Tracked, 2> UUT;
+
+    Tracked *object = UUT.create(42);
+    TEST_ASSERT_NOT_NULL(object);
+    TEST_ASSERT_EQUAL(42, object->value);
+    TEST_ASSERT_EQUAL(1, Tracked::instances);
+    TEST_ASSERT_EQUAL(0, reinterpret_cast<std::uintptr_t>(object) % alignof(Tracked));
+
+    UUT.create(1);
+    TEST_ASSERT_NULL(UUT.create(2));
+    TEST_ASSERT_EQUAL(2, Tracked::instances);
+
+    UUT.destroy(object);
+    TEST_ASSERT_EQUAL(1, Tracked::instances);
+    TEST_ASSERT_EQUAL(1, UUT.get_used());
+    UUT.destroy(nullptr);
+    TEST_ASSERT_EQUAL(1, UUT.get_used());
+};
+
+/**
+ * @brief Test using the pool with standard containers.
+ */
+void test_allocator()
+{
+    /* Create UUT */
+    using Pool_t = OTOS::BlockPool<64, 8>;
+    static Pool_t UUT;
+    OTOS::PoolAllocator<int, Pool_t> allocator{UUT};
+
+    {
+        /* Every node of the list takes one block */
+        std::list<int, OTOS::PoolAllocator<int, Pool_t>> list{allocator};
+        for (int i = 0; i < 5; i++)
+            list.push_back(i);
+        TEST_ASSERT_EQUAL(5, UUT.get_used());
+        list.pop_front();
+        TEST_ASSERT_EQUAL(4, UUT.get_used());
+
+        /* Rebinding keeps the pool */
+        using Map_Allocator = OTOS::PoolAllocator<std::pair<const int, int>, Pool_t>;
+        std::map<int, int, std::less<int>, Map_Allocator> map{Map_Allocator{UUT}};
+        map[1] = 2;
+        map[3] = 4;
+        TEST_ASSERT_EQUAL(6, UUT.get_used());
+        TEST_ASSERT_EQUAL(2, map[1]);
+    }
+    TEST_ASSERT_EQUAL(0, UUT.get_used());
+    TEST_ASSERT_EQUAL(6, UUT.get_high_water());
+
+    /* Allocations larger than one block fail */
+    TEST_ASSERT_NULL(allocator.allocate(17));
+    TEST_ASSERT_TRUE(allocator == (OTOS::PoolAllocator<char, Pool_t>{UUT}));
+};
+
+/* === Main === */
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_critical_section);
+    RUN_TEST(test_block_size);
+    RUN_TEST(test_allocate);
+    RUN_TEST(test_high_water);
+    RUN_TEST(test_poison);
+    RUN_TEST(test_object_pool);
+    RUN_TEST(test_allocator);
+    return UNITY_END();
+};
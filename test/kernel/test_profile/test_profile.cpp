@@ -0,0 +1,190 @@
+/**
+ * OTOS - Open Tec Operating System
+ * Copyright (c) 2021 - 2024 Sebastian Oberschwendtner, sebastian.oberschwendtner@gmail.com
+ *
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+/**
+ ==============================================================================
+ * @file    test_profile.cpp
+ * @author  SO
+ * @version v5.2.0
+ * @date    18-October-2026
+ * @brief   Unit tests for the profiling zones of the OTOS.
+ ==============================================================================
+ */
+
+/* === Includes === */
+#include <unity.h>
+#include <mock.h>
+#include <algorithm>
+#include <array>
+#include <string_view>
+#include <profile.h>
+
+/* === Fixtures === */
+struct Dummy_IO
+{
+    std::array<char, 256> char_buffer{0};
+    std::size_t index{0};
+    void put(char c) { char_buffer[index++] = c; };
+    void flush(void) { char_buffer.fill(0); index = 0; };
+    void write(const char *str, std::size_t len)
+    {
+        std::copy_n(str, len, char_buffer.begin() + index);
+        index += len;
+    };
+};
+
+void profiled_function()
+{
+    OTOS_PROFILE("test.function");
+};
+
+void setUp()
+{
+    /* set stuff up here */
+    OTOS::profile::reset();
+};
+
+void tearDown(){
+    /* clean stuff up here */
+};
+
+/* === Define Tests === */
+/**
+ * @brief Test recording the statistics of a zone.
+ */
+void test_zone_record()
+{
+    setUp();
+    OTOS::profile::Zone zone{"zone"};
+
+    /* A zone without executions has no mean */
+    TEST_ASSERT_EQUAL(0, zone.mean());
+
+    /* Record some executions */
+    zone.record(10);
+    zone.record(30);
+    zone.record(20);
+    TEST_ASSERT_EQUAL(3, zone.count);
+    TEST_ASSERT_EQUAL(10, zone.min);
+    TEST_ASSERT_EQUAL(30, zone.max);
+    TEST_ASSERT_EQUAL(20, zone.mean());
+    TEST_ASSERT_EQUAL(60, zone.total);
+};
+
+/**
+ * @brief Test registering zones in the zone table.
+ */
+void test_get_zone()
+{
+    setUp();
+
+    /* Registering a zone twice returns the same zone */
+    auto *zone = OTOS::profile::get_zone("test.zone");
+    TEST_ASSERT_NOT_NULL(zone);
+    char name[] = "test.zone";
+    TEST_ASSERT_EQUAL_PTR(zone, OTOS::profile::get_zone(name));
+
+    /* A different name gets a different zone */
+    TEST_ASSERT_NOT_EQUAL(zone, OTOS::profile::get_zone("test.other"));
+};
+
+/**
+ * @brief Test registering more zones than the zone table holds.
+ * @note Run this test last, the zone table is full afterwards.
+ */
+void test_zone_table_full()
+{
+    setUp();
+
+    /* Registering more zones than the table holds returns nullptr */
+    static std::array<std::array<char, 8>, OTOS::profile::number_zones> names{};
+    OTOS::profile::Zone *last = nullptr;
+    for (std::size_t i = 0; i < names.size(); i++)
+    {
+        names[i] = {'z', static_cast<char>('A' + i), 0};
+        last = OTOS::profile::get_zone(names[i].data());
+    }
+    TEST_ASSERT_NULL(last);
+};
+
+/**
+ * @brief Test profiling a scope with the macro.
+ */
+void test_profile_scope()
+{
+    setUp();
+
+    /* Execute the profiled function */
+    profiled_function();
+    profiled_function();
+#ifndef OTOS_DISABLE_PROFILING
+
+    /* Find the zone in the table */
+    const auto &table = OTOS::profile::get_table();
+    auto zone = std::find_if(table.begin(), table.end(),
+                             [](const OTOS::profile::Zone &zone)
+                             { return (zone.name != nullptr) && (std::string_view{zone.name} == "test.function"); });
+    TEST_ASSERT_TRUE(zone != table.end());
+    TEST_ASSERT_EQUAL(2, zone->count);
+    TEST_ASSERT_TRUE(zone->min <= zone->max);
+    TEST_ASSERT_EQUAL_STRING("test.function", OTOS::profile::get_last_zone());
+#endif
+
+    /* Profiling with a full table does nothing */
+    {
+        const char *last_zone = OTOS::profile::get_last_zone();
+        OTOS::Profile UUT{nullptr};
+        TEST_ASSERT_EQUAL_PTR(last_zone, OTOS::profile::get_last_zone());
+    }
+};
+
+/**
+ * @brief Test writing the zone table to an output stream.
+ */
+void test_dump()
+{
+    setUp();
+    Dummy_IO io;
+    OTOS::ostream out{io};
+
+    /* Record known values */
+    OTOS::profile::get_zone("test.other");
+    auto *zone = OTOS::profile::get_zone("test.zone");
+    zone->record(4);
+    zone->record(8);
+
+    /* Dump the table */
+    OTOS::profile::dump(out);
+    std::string_view result{io.char_buffer.data()};
+    TEST_ASSERT_EQUAL(0, result.find("zone: count min mean max\n"));
+    TEST_ASSERT_TRUE(result.find("test.zone: 2 4 6 8\n") != std::string_view::npos);
+    TEST_ASSERT_TRUE(result.find("test.other: 0 0 0 0\n") != std::string_view::npos);
+};
+
+/* === Main === */
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_zone_record);
+    RUN_TEST(test_get_zone);
+    RUN_TEST(test_profile_scope);
+    RUN_TEST(test_dump);
+    RUN_TEST(test_zone_table_full);
+    return UNITY_END();
+};
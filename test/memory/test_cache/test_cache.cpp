@@ -0,0 +1,264 @@
+/**
+ * OTOS - Open Tec Operating System
+ * Copyright (c) 2021 Sebastian Oberschwendtner, sebastian.oberschwendtner@gmail.com
+ *
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+/**
+ ==============================================================================
+ * @file    test_cache.cpp
+ * @author  SO
+ * @version v5.2.0
+ * @date    18-October-2026
+ * @brief   Unit tests for the write-back block cache.
+ ==============================================================================
+ */
+
+/* === Includes === */
+#include <unity.h>
+#include <mock.h>
+#include <array>
+#include <map>
+#include "memory/cache.h"
+
+/** === Test List ===
+ * ✓ Blocks are read once and served from the cache afterwards.
+ * ✓ Written blocks are kept until they are replaced or synchronized.
+ * ✓ The least recently used block is replaced.
+ * ✓ Transfers of multiple blocks are coherent with the cache.
+ * ✓ Errors of the memory are passed on.
+*/
+
+/* === Fixtures === */
+struct Mock_Memory
+{
+    using Block = std::array<uint32_t, 128>;
+    std::map<uint32_t, Block> blocks{};
+    bool responding{true};
+
+    Mock::Callable<bool> call_read_single_block;
+    Mock::Callable<bool> call_write_single_block;
+    Mock::Callable<bool> call_read_multiple_blocks;
+    Mock::Callable<bool> call_write_multiple_blocks;
+
+    bool read_single_block(const uint32_t *buffer, const uint32_t block)
+    {
+        call_read_single_block.add_call(static_cast<int>(block));
+        std::copy(blocks[block].begin(), blocks[block].end(), const_cast<uint32_t *>(buffer));
+        return responding;
+    };
+    bool write_single_block(const uint32_t *buffer, const uint32_t block)
+    {
+        call_write_single_block.add_call(static_cast<int>(block));
+        std::copy(buffer, buffer + 128, blocks[block].begin());
+        return responding;
+    };
+    bool read_multiple_blocks(const uint32_t *buffer, const uint32_t block, const uint32_t count)
+    {
+        call_read_multiple_blocks.add_call(static_cast<int>(block));
+        for (uint32_t i = 0; i < count; i++)
+            std::copy(blocks[block + i].begin(), blocks[block + i].end(), const_cast<uint32_t *>(buffer) + i * 128);
+        return responding;
+    };
+    bool write_multiple_blocks(const uint32_t *buffer, const uint32_t block, const uint32_t count)
+    {
+        call_write_multiple_blocks.add_call(static_cast<int>(block));
+        for (uint32_t i = 0; i < count; i++)
+            std::copy(buffer + i * 128, buffer + (i + 1) * 128, blocks[block + i].begin());
+        return responding;
+    };
+};
+
+/* === Tests === */
+void setUp() {
+    /* set stuff up here */
+};
+
+void tearDown() {
+    /* clean stuff up here */
+};
+
+/** 
+ * @brief Test reading blocks through the cache
+ */
+void test_read_block()
+{
+    /* Setup Test */
+    Mock_Memory memory;
+    memory.blocks[5].fill(0x55);
+    memory.blocks[6].fill(0x66);
+    std::array<uint32_t, 128> buffer{0};
+
+    /* Create cache */
+    drive::Cache<Mock_Memory, 2> UUT{memory};
+
+    /* The first access reads the memory */
+    TEST_ASSERT_TRUE( drive::read_single_block(UUT, buffer.data(), 5) );
+    memory.call_read_single_block.assert_called_once_with(5);
+    TEST_ASSERT_EQUAL_HEX32( 0x55, buffer[127] );
+    TEST_ASSERT_EQUAL( 0, UUT.get_hits() );
+    TEST_ASSERT_EQUAL( 1, UUT.get_misses() );
+
+    /* The following accesses are served by the cache */
+    buffer.fill(0);
+    TEST_ASSERT_TRUE( drive::read_single_block(UUT, buffer.data(), 5) );
+    TEST_ASSERT_EQUAL( 0, memory.call_read_single_block.call_count );
+    TEST_ASSERT_EQUAL_HEX32( 0x55, buffer[0] );
+    TEST_ASSERT_EQUAL( 1, UUT.get_hits() );
+
+    /* Reset the statistics */
+    UUT.reset_statistics();
+    TEST_ASSERT_EQUAL( 0, UUT.get_hits() );
+    TEST_ASSERT_EQUAL( 0, UUT.get_misses() );
+
+    /* Errors of the memory are passed on and the block is not cached */
+    memory.responding = false;
+    TEST_ASSERT_FALSE( drive::read_single_block(UUT, buffer.data(), 6) );
+    memory.responding = true;
+    TEST_ASSERT_TRUE( drive::read_single_block(UUT, buffer.data(), 6) );
+    TEST_ASSERT_EQUAL( 2, memory.call_read_single_block.call_count );
+    TEST_ASSERT_EQUAL_HEX32( 0x66, buffer[0] );
+};
+
+/** 
+ * @brief Test writing blocks to the cache
+ */
+void test_write_back()
+{
+    /* Setup Test */
+    Mock_Memory memory;
+    std::array<uint32_t, 128> buffer{0};
+
+    /* Create cache */
+    drive::Cache<Mock_Memory, 2> UUT{memory};
+
+    /* Written blocks stay in the cache */
+    buffer.fill(0x12);
+    TEST_ASSERT_TRUE( drive::write_single_block(UUT, buffer.data(), 3) );
+    buffer.fill(0x13);
+    TEST_ASSERT_TRUE( drive::write_single_block(UUT, buffer.data(), 3) );
+    TEST_ASSERT_EQUAL( 0, memory.call_write_single_block.call_count );
+    TEST_ASSERT_EQUAL( 0, memory.call_read_single_block.call_count );
+    TEST_ASSERT_EQUAL( 1, UUT.get_dirty() );
+
+    /* Reading returns the written data */
+    buffer.fill(0);
+    TEST_ASSERT_TRUE( drive::read_single_block(UUT, buffer.data(), 3) );
+    TEST_ASSERT_EQUAL_HEX32( 0x13, buffer[0] );
+
+    /* Synchronizing writes the dirty block once */
+    TEST_ASSERT_TRUE( drive::sync(UUT) );
+    memory.call_write_single_block.assert_called_once_with(3);
+    TEST_ASSERT_EQUAL_HEX32( 0x13, memory.blocks[3][0] );
+    TEST_ASSERT_EQUAL( 0, UUT.get_dirty() );
+    TEST_ASSERT_EQUAL( 1, UUT.get_write_backs() );
+    TEST_ASSERT_TRUE( UUT.sync() );
+    TEST_ASSERT_EQUAL( 0, memory.call_write_single_block.call_count );
+
+    /* Failed write backs keep the block dirty */
+    TEST_ASSERT_TRUE( drive::write_single_block(UUT, buffer.data(), 4) );
+    memory.responding = false;
+    TEST_ASSERT_FALSE( UUT.sync() );
+    TEST_ASSERT_EQUAL( 1, UUT.get_dirty() );
+    memory.responding = true;
+    TEST_ASSERT_TRUE( UUT.sync() );
+    TEST_ASSERT_EQUAL( 0, UUT.get_dirty() );
+};
+
+/** 
+ * @brief Test the replacement of the least recently used block
+ */
+void test_replacement()
+{
+    /* Setup Test */
+    Mock_Memory memory;
+    std::array<uint32_t, 128> buffer{0};
+
+    /* Create cache */
+    drive::Cache<Mock_Memory, 2> UUT{memory};
+
+    /* Fill the cache, block 1 is used last */
+    buffer.fill(0x01);
+    drive::write_single_block(UUT, buffer.data(), 1);
+    drive::read_single_block(UUT, buffer.data(), 2);
+    drive::read_single_block(UUT, buffer.data(), 1);
+    memory.call_read_single_block.reset();
+
+    /* Block 2 is replaced by block 3 */
+    drive::read_single_block(UUT, buffer.data(), 3);
+    memory.call_read_single_block.assert_called_once_with(3);
+    TEST_ASSERT_EQUAL( 0, memory.call_write_single_block.call_count );
+    drive::read_single_block(UUT, buffer.data(), 1);
+    TEST_ASSERT_EQUAL( 0, memory.call_read_single_block.call_count );
+
+    /* Block 3 is replaced by block 4, block 1 is dirty and written when it is replaced */
+    drive::read_single_block(UUT, buffer.data(), 4);
+    drive::read_single_block(UUT, buffer.data(), 5);
+    memory.call_write_single_block.assert_called_once_with(1);
+    TEST_ASSERT_EQUAL_HEX32( 0x01, memory.blocks[1][0] );
+    TEST_ASSERT_EQUAL( 1, UUT.get_write_backs() );
+};
+
+/** 
+ * @brief Test transferring multiple blocks
+ */
+void test_multiple_blocks()
+{
+    /* Setup Test */
+    Mock_Memory memory;
+    std::array<uint32_t, 3 * 128> buffer{0};
+    std::array<uint32_t, 128> block{0};
+
+    /* Create cache */
+    drive::Cache<Mock_Memory, 2> UUT{memory};
+
+    /* Reading returns the dirty blocks of the cache */
+    memory.blocks[10].fill(0x10);
+    memory.blocks[11].fill(0x11);
+    block.fill(0xAB);
+    drive::write_single_block(UUT, block.data(), 11);
+    TEST_ASSERT_TRUE( drive::read_multiple_blocks(UUT, buffer.data(), 10, 3) );
+    memory.call_read_multiple_blocks.assert_called_once_with(10);
+    TEST_ASSERT_EQUAL_HEX32( 0x10, buffer[0] );
+    TEST_ASSERT_EQUAL_HEX32( 0xAB, buffer[128] );
+    TEST_ASSERT_EQUAL_HEX32( 0x00, buffer[256] );
+
+    /* Writing updates the cached blocks, which are clean afterwards */
+    buffer.fill(0xCD);
+    TEST_ASSERT_TRUE( drive::write_multiple_blocks(UUT, buffer.data(), 10, 3) );
+    memory.call_write_multiple_blocks.assert_called_once_with(10);
+    TEST_ASSERT_EQUAL( 0, UUT.get_dirty() );
+    TEST_ASSERT_TRUE( drive::read_single_block(UUT, block.data(), 11) );
+    TEST_ASSERT_EQUAL_HEX32( 0xCD, block[0] );
+    TEST_ASSERT_EQUAL( 0, memory.call_read_single_block.call_count );
+
+    /* Blocks before the transfer are not affected */
+    block.fill(0xEF);
+    drive::write_single_block(UUT, block.data(), 9);
+    TEST_ASSERT_TRUE( drive::write_multiple_blocks(UUT, buffer.data(), 10, 3) );
+    TEST_ASSERT_EQUAL( 1, UUT.get_dirty() );
+};
+
+/* === Main === */
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_read_block);
+    RUN_TEST(test_write_back);
+    RUN_TEST(test_replacement);
+    RUN_TEST(test_multiple_blocks);
+    return UNITY_END();
+};
@@ -0,0 +1,187 @@
+/**
+ * OTOS - Open Tec Operating System
+ * Copyright (c) 2021 Sebastian Oberschwendtner, sebastian.oberschwendtner@gmail.com
+ *
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+/**
+ ==============================================================================
+ * @file    test_image.cpp
+ * @author  SO
+ * @version v5.2.0
+ * @date    18-October-2026
+ * @brief   Unit tests for the memory backed by a disk image file.
+ ==============================================================================
+ */
+
+/* === Includes === */
+#include <unity.h>
+#include <array>
+#include <cstdio>
+#include "memory/drive.h"
+#include "image_memory.h"
+
+/** === Test List ===
+ * ✓ Images are created, opened and closed.
+ * ✓ Single and multiple blocks are read and written.
+ * ✓ Accesses outside of the image fail.
+ * ✓ The accesses are counted for all copies of the memory.
+ * ✓ The data is kept in the image file.
+*/
+
+/* === Fixtures === */
+constexpr const char *path = "otos_test_image.img";
+
+void setUp() {
+    /* set stuff up here */
+};
+
+void tearDown() {
+    /* clean stuff up here */
+    std::remove(path);
+};
+
+/* === Define Tests === */
+/**
+ * @brief Test creating and opening an image
+ */
+void test_create_image()
+{
+    /* Setup Test */
+    host::Image_Memory UUT;
+    TEST_ASSERT_EQUAL(0, UUT.get_block_count());
+    TEST_ASSERT_NULL(UUT.get_block(0));
+
+    /* Missing files cannot be opened */
+    TEST_ASSERT_FALSE(UUT.open(path));
+    TEST_ASSERT_FALSE(UUT.create(path, 0));
+
+    /* Create an empty image */
+    TEST_ASSERT_TRUE(UUT.create(path, 100));
+    TEST_ASSERT_EQUAL(100, UUT.get_block_count());
+    TEST_ASSERT_NOT_NULL(UUT.get_block(99));
+    TEST_ASSERT_NULL(UUT.get_block(100));
+    TEST_ASSERT_EQUAL(0, UUT.get_block(50)[511]);
+
+    /* Close the image */
+    UUT.close();
+    TEST_ASSERT_EQUAL(0, UUT.get_block_count());
+    TEST_ASSERT_TRUE(UUT.open(path));
+    TEST_ASSERT_EQUAL(100, UUT.get_block_count());
+};
+
+/**
+ * @brief Test reading and writing blocks
+ */
+void test_read_write()
+{
+    /* Setup Test */
+    host::Image_Memory UUT;
+    TEST_ASSERT_TRUE(UUT.create(path, 100));
+    std::array<uint32_t, 3 * 128> buffer{};
+    buffer.fill(0x12345678);
+
+    /* Write and read a single block */
+    TEST_ASSERT_TRUE(drive::write_single_block(UUT, buffer.data(), 10));
+    TEST_ASSERT_EQUAL_HEX8(0x78, UUT.get_block(10)[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x12, UUT.get_block(10)[511]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, UUT.get_block(11)[0]);
+    buffer.fill(0);
+    TEST_ASSERT_TRUE(drive::read_single_block(UUT, buffer.data(), 10));
+    TEST_ASSERT_EQUAL_HEX32(0x12345678, buffer[127]);
+    TEST_ASSERT_EQUAL_HEX32(0, buffer[128]);
+
+    /* Write and read multiple blocks */
+    buffer.fill(0xCAFEBABE);
+    TEST_ASSERT_TRUE(drive::write_multiple_blocks(UUT, buffer.data(), 97, 3));
+    TEST_ASSERT_EQUAL_HEX8(0xCA, UUT.get_block(99)[511]);
+    buffer.fill(0);
+    TEST_ASSERT_TRUE(drive::read_multiple_blocks(UUT, buffer.data(), 96, 3));
+    TEST_ASSERT_EQUAL_HEX32(0, buffer[127]);
+    TEST_ASSERT_EQUAL_HEX32(0xCAFEBABE, buffer[128]);
+    TEST_ASSERT_EQUAL_HEX32(0xCAFEBABE, buffer[3 * 128 - 1]);
+
+    /* Accesses outside of the image fail */
+    TEST_ASSERT_FALSE(drive::read_single_block(UUT, buffer.data(), 100));
+    TEST_ASSERT_FALSE(drive::write_multiple_blocks(UUT, buffer.data(), 98, 3));
+    TEST_ASSERT_FALSE(drive::read_multiple_blocks(UUT, buffer.data(), 0, 0));
+    UUT.close();
+    TEST_ASSERT_FALSE(drive::read_single_block(UUT, buffer.data(), 0));
+};
+
+/**
+ * @brief Test counting the accesses
+ */
+void test_statistics()
+{
+    /* Setup Test */
+    host::Image_Memory UUT;
+    TEST_ASSERT_TRUE(UUT.create(path, 100));
+    std::array<uint32_t, 4 * 128> buffer{};
+
+    /* Copies share the counters, failed accesses are not counted */
+    host::Image_Memory copy = UUT;
+    TEST_ASSERT_TRUE(copy.read_single_block(buffer.data(), 0));
+    TEST_ASSERT_TRUE(copy.read_multiple_blocks(buffer.data(), 1, 4));
+    TEST_ASSERT_TRUE(copy.write_multiple_blocks(buffer.data(), 1, 2));
+    TEST_ASSERT_FALSE(copy.write_single_block(buffer.data(), 200));
+    const auto statistics = UUT.get_statistics();
+    TEST_ASSERT_EQUAL(2, statistics.reads);
+    TEST_ASSERT_EQUAL(1, statistics.writes);
+    TEST_ASSERT_EQUAL(5, statistics.blocks_read);
+    TEST_ASSERT_EQUAL(2, statistics.blocks_written);
+    TEST_ASSERT_EQUAL(5 * 512, statistics.bytes_read);
+    TEST_ASSERT_EQUAL(2 * 512, statistics.bytes_written);
+
+    /* Reset the counters */
+    UUT.reset_statistics();
+    TEST_ASSERT_EQUAL(0, copy.get_statistics().reads);
+    TEST_ASSERT_EQUAL(0, copy.get_statistics().bytes_written);
+};
+
+/**
+ * @brief Test keeping the data in the image file
+ */
+void test_persistence()
+{
+    /* Setup Test */
+    std::array<uint32_t, 128> buffer{};
+    buffer.fill(0xA5A5A5A5);
+    {
+        host::Image_Memory UUT;
+        TEST_ASSERT_TRUE(UUT.create(path, 16));
+        TEST_ASSERT_TRUE(UUT.write_single_block(buffer.data(), 15));
+    }
+
+    /* Open the image again */
+    host::Image_Memory UUT;
+    TEST_ASSERT_TRUE(UUT.open(path));
+    buffer.fill(0);
+    TEST_ASSERT_TRUE(UUT.read_single_block(buffer.data(), 15));
+    TEST_ASSERT_EQUAL_HEX32(0xA5A5A5A5, buffer[0]);
+    TEST_ASSERT_EQUAL_HEX32(0xA5A5A5A5, buffer[127]);
+};
+
+/* === Main === */
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_create_image);
+    RUN_TEST(test_read_write);
+    RUN_TEST(test_statistics);
+    RUN_TEST(test_persistence);
+    return UNITY_END();
+};
@@ -0,0 +1,354 @@
+/**
+ * OTOS - Open Tec Operating System
+ * Copyright (c) 2021 Sebastian Oberschwendtner, sebastian.oberschwendtner@gmail.com
+ *
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+/**
+ ==============================================================================
+ * @file    test_log.cpp
+ * @author  SO
+ * @version v5.2.0
+ * @date    18-October-2026
+ * @brief   Unit tests for the append-only log on raw blocks.
+ ==============================================================================
+ */
+
+/* === Includes === */
+#include <unity.h>
+#include <array>
+#include <map>
+#include <vector>
+#include "memory/log.h"
+
+/** === Test List ===
+ * ✓ The CRC of the block headers is the CRC-32 of IEEE 802.3.
+ * ✓ Logs are formatted and mounted.
+ * ✓ Records are appended with multi-block transfers and read back.
+ * ✓ Mounting finds the newest block with a binary search.
+ * ✓ The oldest blocks are overwritten when the log wraps around.
+ * ✓ A power loss only loses the block which was written.
+*/
+
+/* === Fixtures === */
+struct Transfer
+{
+    bool write;
+    uint32_t block;
+    uint32_t count;
+};
+
+struct Mock_Memory
+{
+    using Block = std::array<uint32_t, 128>;
+    std::map<uint32_t, Block> blocks{};
+    std::vector<Transfer> transfers{};
+    uint32_t blocks_until_power_loss{0xFFFFFFFF};
+
+    bool read_single_block(const uint32_t *buffer, const uint32_t block)
+    {
+        return read_multiple_blocks(buffer, block, 1);
+    };
+    bool write_single_block(const uint32_t *buffer, const uint32_t block)
+    {
+        return write_multiple_blocks(buffer, block, 1);
+    };
+    bool read_multiple_blocks(const uint32_t *buffer, const uint32_t block, const uint32_t count)
+    {
+        transfers.push_back({false, block, count});
+        for (uint32_t i = 0; i < count; i++)
+            std::copy(blocks[block + i].begin(), blocks[block + i].end(), const_cast<uint32_t *>(buffer) + i * 128);
+        return true;
+    };
+    bool write_multiple_blocks(const uint32_t *buffer, const uint32_t block, const uint32_t count)
+    {
+        transfers.push_back({true, block, count});
+        for (uint32_t i = 0; i < count; i++)
+        {
+            /* The power fails in the middle of a block */
+            if (blocks_until_power_loss == 0)
+            {
+                std::copy(buffer + i * 128, buffer + i * 128 + 64, blocks[block + i].begin());
+                return false;
+            }
+            blocks_until_power_loss--;
+            std::copy(buffer + i * 128, buffer + (i + 1) * 128, blocks[block + i].begin());
+        }
+        return true;
+    };
+    auto count_transfers(const bool write) const -> uint32_t
+    {
+        return std::count_if(transfers.begin(), transfers.end(), [write](const Transfer &transfer)
+            { return transfer.write == write; });
+    };
+};
+
+/**
+ * @brief Append the records with the numbers [first, last).
+ */
+template <class Log>
+void append_records(Log &log, const uint32_t first, const uint32_t last)
+{
+    for (uint32_t number = first; number < last; number++)
+    {
+        std::array<uint32_t, 3> record{number, ~number, number * 3};
+        TEST_ASSERT_TRUE(log.append(record.data(), sizeof(record)));
+    }
+};
+
+/**
+ * @brief Read all records and return their numbers.
+ */
+template <class Log>
+auto read_records(Log &log) -> std::vector<uint32_t>
+{
+    std::vector<uint32_t> numbers{};
+    typename Log::Reader reader{log};
+    std::array<uint32_t, 3> record{};
+    while (auto length = reader.next(record.data(), sizeof(record)))
+    {
+        TEST_ASSERT_EQUAL(sizeof(record), length.value());
+        TEST_ASSERT_EQUAL_HEX32(~record[0], record[1]);
+        TEST_ASSERT_EQUAL(record[0] * 3, record[2]);
+        numbers.push_back(record[0]);
+    }
+    return numbers;
+};
+
+/* === Tests === */
+void setUp() {
+    /* set stuff up here */
+};
+
+void tearDown() {
+    /* clean stuff up here */
+};
+
+/**
+ * @brief Test the CRC of the block headers
+ */
+void test_crc32()
+{
+    const std::array<uint8_t, 9> check{'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, drive::crc32(check.data(), check.size()));
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, drive::crc32(check.data() + 4, 5, drive::crc32(check.data(), 4)));
+    TEST_ASSERT_EQUAL_HEX32(0, drive::crc32(check.data(), 0));
+};
+
+/**
+ * @brief Test formatting and mounting a log
+ */
+void test_format_mount()
+{
+    /* Setup Test */
+    Mock_Memory memory;
+    using Log = drive::Log<Mock_Memory, 4>;
+    Log UUT{memory, 100, 64};
+    uint32_t record = 0;
+
+    /* An empty memory contains no log and records cannot be appended */
+    TEST_ASSERT_FALSE(UUT.mount());
+    TEST_ASSERT_EQUAL(0, UUT.get_sequence());
+    TEST_ASSERT_FALSE(UUT.append(&record, sizeof(record)));
+    TEST_ASSERT_FALSE(UUT.sync());
+
+    /* Format the log, the first block is written */
+    TEST_ASSERT_TRUE(UUT.format());
+    TEST_ASSERT_EQUAL(1, UUT.get_epoch());
+    TEST_ASSERT_EQUAL(1, UUT.get_sequence());
+    TEST_ASSERT_EQUAL(1, memory.count_transfers(true));
+    TEST_ASSERT_EQUAL(100, memory.transfers.back().block);
+    TEST_ASSERT_EQUAL_HEX32(Log::magic, memory.blocks[100][0]);
+
+    /* Mount the empty log */
+    Log log{memory, 100, 64};
+    TEST_ASSERT_TRUE(log.mount());
+    TEST_ASSERT_EQUAL(1, log.get_epoch());
+    TEST_ASSERT_EQUAL(1, log.get_sequence());
+    TEST_ASSERT_TRUE(read_records(log).empty());
+
+    /* Formatting again starts a new epoch */
+    TEST_ASSERT_TRUE(log.format());
+    TEST_ASSERT_EQUAL(2, log.get_epoch());
+
+    /* Invalid logs and records */
+    Log tiny{memory, 0, 1};
+    TEST_ASSERT_FALSE(tiny.format());
+    std::array<uint8_t, 491> large{};
+    TEST_ASSERT_FALSE(log.append(large.data(), 0));
+    TEST_ASSERT_FALSE(log.append(large.data(), large.size()));
+    TEST_ASSERT_TRUE(log.append(large.data(), large.size() - 1));
+};
+
+/**
+ * @brief Test appending and reading records
+ */
+void test_append_read()
+{
+    /* Setup Test */
+    Mock_Memory memory;
+    drive::Log<Mock_Memory, 4> UUT{memory, 100, 64};
+    TEST_ASSERT_TRUE(UUT.format());
+    memory.transfers.clear();
+
+    /* 35 records with 14 bytes fit into one block, full buffers are written with one transfer */
+    append_records(UUT, 0, 35 * 8);
+    TEST_ASSERT_EQUAL(1, memory.count_transfers(true));
+    TEST_ASSERT_EQUAL(101, memory.transfers.back().block);
+    TEST_ASSERT_EQUAL(4, memory.transfers.back().count);
+    TEST_ASSERT_EQUAL(5, UUT.get_sequence());
+
+    /* Synchronizing writes the collected records */
+    append_records(UUT, 35 * 8, 300);
+    TEST_ASSERT_TRUE(UUT.sync());
+    TEST_ASSERT_EQUAL(3, memory.count_transfers(true));
+    TEST_ASSERT_EQUAL(109, memory.transfers.back().block);
+    TEST_ASSERT_EQUAL(1, memory.transfers.back().count);
+    TEST_ASSERT_EQUAL(10, UUT.get_sequence());
+
+    /* The next records start a new block */
+    append_records(UUT, 300, 310);
+    TEST_ASSERT_TRUE(UUT.sync());
+    TEST_ASSERT_EQUAL(110, memory.transfers.back().block);
+    TEST_ASSERT_EQUAL(11, UUT.get_sequence());
+
+    /* Read the records back */
+    const auto numbers = read_records(UUT);
+    TEST_ASSERT_EQUAL(310, numbers.size());
+    for (uint32_t number = 0; number < numbers.size(); number++)
+        TEST_ASSERT_EQUAL(number, numbers[number]);
+};
+
+/**
+ * @brief Test finding the newest block when mounting
+ */
+void test_mount_binary_search()
+{
+    /* Setup Test */
+    Mock_Memory memory;
+    drive::Log<Mock_Memory, 8> UUT{memory, 0, 1024};
+    TEST_ASSERT_TRUE(UUT.format());
+    append_records(UUT, 0, 35 * 700);
+    TEST_ASSERT_TRUE(UUT.sync());
+    TEST_ASSERT_EQUAL(701, UUT.get_sequence());
+
+    /* Mounting reads the first block and log2(1024) blocks */
+    memory.transfers.clear();
+    drive::Log<Mock_Memory, 8> log{memory, 0, 1024};
+    TEST_ASSERT_TRUE(log.mount());
+    TEST_ASSERT_EQUAL(701, log.get_sequence());
+    TEST_ASSERT_EQUAL(11, memory.count_transfers(false));
+
+    /* Continue the log */
+    append_records(log, 35 * 700, 35 * 700 + 10);
+    TEST_ASSERT_TRUE(log.sync());
+    TEST_ASSERT_EQUAL(702, log.get_sequence());
+    TEST_ASSERT_EQUAL(35 * 700 + 10, read_records(log).size());
+};
+
+/**
+ * @brief Test overwriting the oldest blocks
+ */
+void test_wrap_around()
+{
+    /* Setup Test */
+    Mock_Memory memory;
+    drive::Log<Mock_Memory, 2> UUT{memory, 10, 7};
+    TEST_ASSERT_TRUE(UUT.format());
+
+    /* Write 20 blocks, the transfers are split at the end of the log */
+    append_records(UUT, 0, 35 * 19);
+    TEST_ASSERT_TRUE(UUT.sync());
+    TEST_ASSERT_EQUAL(20, UUT.get_sequence());
+    for (const auto &transfer : memory.transfers)
+    {
+        TEST_ASSERT_GREATER_OR_EQUAL(10, transfer.block);
+        TEST_ASSERT_LESS_OR_EQUAL(17, transfer.block + transfer.count);
+    }
+
+    /* Only the newest 7 blocks are kept */
+    auto numbers = read_records(UUT);
+    TEST_ASSERT_EQUAL(35 * 7, numbers.size());
+    TEST_ASSERT_EQUAL(35 * 12, numbers.front());
+    TEST_ASSERT_EQUAL(35 * 19 - 1, numbers.back());
+
+    /* The newest block is found after the log wrapped around */
+    drive::Log<Mock_Memory, 2> log{memory, 10, 7};
+    TEST_ASSERT_TRUE(log.mount());
+    TEST_ASSERT_EQUAL(20, log.get_sequence());
+    TEST_ASSERT_EQUAL(35 * 7, read_records(log).size());
+};
+
+/**
+ * @brief Test losing the power while writing
+ */
+void test_power_loss()
+{
+    /* Setup Test */
+    Mock_Memory memory;
+    drive::Log<Mock_Memory, 4> UUT{memory, 0, 16};
+    TEST_ASSERT_TRUE(UUT.format());
+    append_records(UUT, 0, 35 * 4);
+    TEST_ASSERT_TRUE(UUT.sync());
+    TEST_ASSERT_EQUAL(5, UUT.get_sequence());
+
+    /* The power fails while writing the second block of the next transfer */
+    memory.blocks_until_power_loss = 1;
+    append_records(UUT, 35 * 4, 35 * 7);
+    TEST_ASSERT_FALSE(UUT.sync());
+
+    /* The records up to the torn block survive */
+    memory.blocks_until_power_loss = 0xFFFFFFFF;
+    drive::Log<Mock_Memory, 4> log{memory, 0, 16};
+    TEST_ASSERT_TRUE(log.mount());
+    TEST_ASSERT_EQUAL(6, log.get_sequence());
+    auto numbers = read_records(log);
+    TEST_ASSERT_EQUAL(35 * 5, numbers.size());
+    TEST_ASSERT_EQUAL(35 * 5 - 1, numbers.back());
+
+    /* The torn block is overwritten by the next records */
+    append_records(log, 1000, 1010);
+    TEST_ASSERT_TRUE(log.sync());
+    numbers = read_records(log);
+    TEST_ASSERT_EQUAL(35 * 5 + 10, numbers.size());
+    TEST_ASSERT_EQUAL(1009, numbers.back());
+
+    /* The power fails while the log wraps around to its first block */
+    append_records(log, 0, 35 * 9);
+    TEST_ASSERT_TRUE(log.sync());
+    TEST_ASSERT_EQUAL(16, log.get_sequence());
+    memory.blocks_until_power_loss = 0;
+    append_records(log, 0, 35 * 4);
+    TEST_ASSERT_FALSE(log.sync());
+    memory.blocks_until_power_loss = 0xFFFFFFFF;
+    drive::Log<Mock_Memory, 4> wrapped{memory, 0, 16};
+    TEST_ASSERT_TRUE(wrapped.mount());
+    TEST_ASSERT_EQUAL(16, wrapped.get_sequence());
+    TEST_ASSERT_EQUAL(35 * 14 + 10, read_records(wrapped).size());
+};
+
+/* === Main === */
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_crc32);
+    RUN_TEST(test_format_mount);
+    RUN_TEST(test_append_read);
+    RUN_TEST(test_mount_binary_search);
+    RUN_TEST(test_wrap_around);
+    RUN_TEST(test_power_loss);
+    return UNITY_END();
+};
@@ -0,0 +1,333 @@
+/**
+ * OTOS - Open Tec Operating System
+ * Copyright (c) 2021 Sebastian Oberschwendtner, sebastian.oberschwendtner@gmail.com
+ *
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+/**
+ ==============================================================================
+ * @file    test_queue.cpp
+ * @author  SO
+ * @version v5.2.0
+ * @date    18-October-2026
+ * @brief   Unit tests for the queue of block requests.
+ ==============================================================================
+ */
+
+/* === Includes === */
+#include <unity.h>
+#include <mock.h>
+#include <array>
+#include <map>
+#include <vector>
+#include "memory/queue.h"
+
+/** === Test List ===
+ * ✓ Requests are submitted, served and polled.
+ * ✓ Requests are served in elevator order.
+ * ✓ Adjacent requests are merged into one transfer.
+ * ✓ Sync requests and overlapping requests are not reordered.
+ * ✓ The storage thread accesses the memory through the queue.
+*/
+
+/* === Fixtures === */
+struct Transfer
+{
+    bool write;
+    uint32_t block;
+    uint32_t count;
+};
+
+struct Mock_Memory
+{
+    using Block = std::array<uint32_t, 128>;
+    std::map<uint32_t, Block> blocks{};
+    std::vector<Transfer> transfers{};
+    bool responding{true};
+
+    bool read_single_block(const uint32_t *buffer, const uint32_t block)
+    {
+        return read_multiple_blocks(buffer, block, 1);
+    };
+    bool write_single_block(const uint32_t *buffer, const uint32_t block)
+    {
+        return write_multiple_blocks(buffer, block, 1);
+    };
+    bool read_multiple_blocks(const uint32_t *buffer, const uint32_t block, const uint32_t count)
+    {
+        transfers.push_back({false, block, count});
+        for (uint32_t i = 0; i < count; i++)
+            std::copy(blocks[block + i].begin(), blocks[block + i].end(), const_cast<uint32_t *>(buffer) + i * 128);
+        return responding;
+    };
+    bool write_multiple_blocks(const uint32_t *buffer, const uint32_t block, const uint32_t count)
+    {
+        transfers.push_back({true, block, count});
+        for (uint32_t i = 0; i < count; i++)
+            std::copy(buffer + i * 128, buffer + (i + 1) * 128, blocks[block + i].begin());
+        return responding;
+    };
+};
+
+using Block = std::array<uint32_t, 128>;
+
+/* === Tests === */
+void setUp() {
+    /* set stuff up here */
+};
+
+void tearDown() {
+    /* clean stuff up here */
+};
+
+/** 
+ * @brief Test submitting and serving requests
+ */
+void test_submit_request()
+{
+    /* Setup Test */
+    Mock_Memory memory;
+    memory.blocks[5].fill(0x55);
+    Block buffer{0};
+    drive::Queue<Mock_Memory, 2> UUT{memory};
+
+    /* Submit a request, it is pending until it is served */
+    drive::Request read{drive::Operation::Read, 5, 1, buffer.data()};
+    TEST_ASSERT_TRUE( UUT.submit(read) );
+    TEST_ASSERT_EQUAL( drive::Status::Pending, read.status );
+    TEST_ASSERT_FALSE( read.is_done() );
+    TEST_ASSERT_FALSE( UUT.submit(read) );
+    TEST_ASSERT_EQUAL( 1, UUT.get_pending() );
+    TEST_ASSERT_EQUAL( 0, memory.transfers.size() );
+
+    /* Serve the request */
+    TEST_ASSERT_EQUAL( 1, UUT.process() );
+    TEST_ASSERT_EQUAL( drive::Status::Done, read.status );
+    TEST_ASSERT_TRUE( UUT.wait(read) );
+    TEST_ASSERT_EQUAL_HEX32( 0x55, buffer[127] );
+    TEST_ASSERT_EQUAL( 0, UUT.get_pending() );
+    TEST_ASSERT_EQUAL( 1, UUT.get_transfers() );
+    TEST_ASSERT_EQUAL( 0, UUT.process() );
+
+    /* Invalid requests and requests to a full queue are rejected */
+    drive::Request empty{drive::Operation::Write, 1, 0, buffer.data()};
+    drive::Request missing{drive::Operation::Write, 1, 1, nullptr};
+    drive::Request first{drive::Operation::Write, 1, 1, buffer.data()};
+    drive::Request second{drive::Operation::Write, 2, 1, buffer.data()};
+    TEST_ASSERT_FALSE( UUT.submit(empty) );
+    TEST_ASSERT_FALSE( UUT.submit(missing) );
+    TEST_ASSERT_TRUE( UUT.submit(first) );
+    TEST_ASSERT_TRUE( UUT.submit(second) );
+    TEST_ASSERT_FALSE( UUT.submit(read) );
+
+    /* Errors of the memory fail the request */
+    memory.responding = false;
+    UUT.process();
+    TEST_ASSERT_EQUAL( drive::Status::Failed, first.status );
+    TEST_ASSERT_TRUE( first.is_done() );
+    TEST_ASSERT_FALSE( UUT.wait(second) );
+};
+
+/** 
+ * @brief Test serving the requests in elevator order
+ */
+void test_elevator_order()
+{
+    /* Setup Test */
+    Mock_Memory memory;
+    std::array<Block, 4> buffer{};
+    drive::Queue<Mock_Memory, 4> UUT{memory};
+
+    /* The requests are served in ascending order */
+    drive::Request request_30{drive::Operation::Write, 30, 1, buffer[0].data()};
+    drive::Request request_10{drive::Operation::Write, 10, 1, buffer[1].data()};
+    drive::Request request_20{drive::Operation::Read, 20, 2, buffer[2].data()};
+    UUT.submit(request_30);
+    UUT.submit(request_10);
+    UUT.submit(request_20);
+    TEST_ASSERT_EQUAL( 3, UUT.process() );
+    TEST_ASSERT_EQUAL( 3, memory.transfers.size() );
+    TEST_ASSERT_EQUAL( 10, memory.transfers[0].block );
+    TEST_ASSERT_EQUAL( 20, memory.transfers[1].block );
+    TEST_ASSERT_EQUAL( 2, memory.transfers[1].count );
+    TEST_ASSERT_EQUAL( 30, memory.transfers[2].block );
+
+    /* The next requests start at the last accessed block and wrap around */
+    memory.transfers.clear();
+    drive::Request request_5{drive::Operation::Write, 5, 1, buffer[0].data()};
+    drive::Request request_40{drive::Operation::Write, 40, 1, buffer[1].data()};
+    drive::Request request_31{drive::Operation::Read, 31, 1, buffer[2].data()};
+    drive::Request request_25{drive::Operation::Read, 25, 1, buffer[3].data()};
+    UUT.submit(request_5);
+    UUT.submit(request_40);
+    UUT.submit(request_31);
+    UUT.submit(request_25);
+    TEST_ASSERT_EQUAL( 4, UUT.process() );
+    TEST_ASSERT_EQUAL( 31, memory.transfers[0].block );
+    TEST_ASSERT_EQUAL( 40, memory.transfers[1].block );
+    TEST_ASSERT_EQUAL( 5, memory.transfers[2].block );
+    TEST_ASSERT_EQUAL( 25, memory.transfers[3].block );
+};
+
+/** 
+ * @brief Test merging adjacent requests
+ */
+void test_merge_requests()
+{
+    /* Setup Test */
+    Mock_Memory memory;
+    std::array<Block, 4> buffer{};
+    for (uint32_t i = 0; i < 4; i++)
+        buffer[i].fill(0x10 + i);
+    drive::Queue<Mock_Memory, 4, 3> UUT{memory};
+
+    /* Adjacent writes are one transfer up to the merge limit */
+    std::array<drive::Request, 4> writes{};
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        writes[i] = drive::Request{drive::Operation::Write, 13 - i, 1, buffer[3 - i].data()};
+        UUT.submit(writes[i]);
+    }
+    TEST_ASSERT_EQUAL( 4, UUT.process() );
+    TEST_ASSERT_EQUAL( 2, memory.transfers.size() );
+    TEST_ASSERT_TRUE( memory.transfers[0].write );
+    TEST_ASSERT_EQUAL( 10, memory.transfers[0].block );
+    TEST_ASSERT_EQUAL( 3, memory.transfers[0].count );
+    TEST_ASSERT_EQUAL( 13, memory.transfers[1].block );
+    TEST_ASSERT_EQUAL( 2, UUT.get_merged() );
+    TEST_ASSERT_EQUAL( 2, UUT.get_transfers() );
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        TEST_ASSERT_EQUAL( drive::Status::Done, writes[i].status );
+        TEST_ASSERT_EQUAL_HEX32( 0x10 + i, memory.blocks[10 + i][0] );
+    }
+
+    /* Adjacent reads are distributed to their buffers */
+    memory.transfers.clear();
+    UUT.reset_statistics();
+    std::array<Block, 2> read_buffer{};
+    drive::Request read_11{drive::Operation::Read, 11, 1, read_buffer[1].data()};
+    drive::Request read_10{drive::Operation::Read, 10, 1, read_buffer[0].data()};
+    drive::Request write_20{drive::Operation::Write, 20, 1, buffer[0].data()};
+    UUT.submit(read_11);
+    UUT.submit(write_20);
+    UUT.submit(read_10);
+    TEST_ASSERT_EQUAL( 3, UUT.process() );
+    TEST_ASSERT_EQUAL( 2, memory.transfers.size() );
+    TEST_ASSERT_EQUAL( 20, memory.transfers[0].block );
+    TEST_ASSERT_FALSE( memory.transfers[1].write );
+    TEST_ASSERT_EQUAL( 10, memory.transfers[1].block );
+    TEST_ASSERT_EQUAL( 2, memory.transfers[1].count );
+    TEST_ASSERT_EQUAL_HEX32( 0x10, read_buffer[0][127] );
+    TEST_ASSERT_EQUAL_HEX32( 0x11, read_buffer[1][0] );
+    TEST_ASSERT_EQUAL( 1, UUT.get_merged() );
+};
+
+/** 
+ * @brief Test the order of sync requests and overlapping requests
+ */
+void test_barriers()
+{
+    /* Setup Test */
+    Mock_Memory memory;
+    std::array<Block, 2> buffer{};
+    buffer[0].fill(0xAA);
+    drive::Queue<Mock_Memory, 4> UUT{memory};
+
+    /* Requests are not moved in front of a sync request */
+    drive::Request write_20{drive::Operation::Write, 20, 1, buffer[0].data()};
+    drive::Request sync{drive::Operation::Sync, 0, 0, nullptr};
+    drive::Request write_10{drive::Operation::Write, 10, 1, buffer[0].data()};
+    UUT.submit(write_20);
+    UUT.submit(sync);
+    UUT.submit(write_10);
+    TEST_ASSERT_EQUAL( 1, UUT.process() );
+    TEST_ASSERT_EQUAL( drive::Status::Pending, sync.status );
+    TEST_ASSERT_EQUAL( 1, UUT.process() );
+    TEST_ASSERT_EQUAL( drive::Status::Done, sync.status );
+    TEST_ASSERT_EQUAL( drive::Status::Pending, write_10.status );
+    TEST_ASSERT_EQUAL( 1, UUT.process() );
+    TEST_ASSERT_EQUAL( 20, memory.transfers[0].block );
+    TEST_ASSERT_EQUAL( 10, memory.transfers[1].block );
+
+    /* A read of a block which is written before returns the new data */
+    std::array<uint32_t, 2 * 128> data{};
+    data.fill(0xAA);
+    drive::Request write_30{drive::Operation::Write, 30, 2, data.data()};
+    drive::Request read_31{drive::Operation::Read, 31, 1, buffer[1].data()};
+    drive::Request write_25{drive::Operation::Write, 25, 1, buffer[0].data()};
+    UUT.submit(write_30);
+    UUT.submit(read_31);
+    UUT.submit(write_25);
+    TEST_ASSERT_EQUAL( 1, UUT.process() );
+    TEST_ASSERT_EQUAL( drive::Status::Pending, read_31.status );
+    TEST_ASSERT_EQUAL( 2, UUT.process() );
+    TEST_ASSERT_EQUAL_HEX32( 0xAA, buffer[1][0] );
+};
+
+/** 
+ * @brief Test the memory interface of the storage thread
+ */
+void test_queue_memory()
+{
+    /* Setup Test */
+    Mock_Memory memory;
+    std::array<Block, 2> buffer{};
+    buffer[0].fill(0x77);
+    drive::Queue<Mock_Memory, 2> queue{memory};
+    drive::Queue_Memory<drive::Queue<Mock_Memory, 2>> UUT{queue};
+
+    /* Accesses are served immediately together with the pending requests */
+    drive::Request client{drive::Operation::Write, 8, 1, buffer[0].data()};
+    queue.submit(client);
+    TEST_ASSERT_TRUE( drive::write_single_block(UUT, buffer[0].data(), 9) );
+    TEST_ASSERT_EQUAL( drive::Status::Done, client.status );
+    TEST_ASSERT_EQUAL( 1, memory.transfers.size() );
+    TEST_ASSERT_EQUAL( 2, memory.transfers[0].count );
+    TEST_ASSERT_EQUAL( 0, queue.get_pending() );
+
+    /* Transfers of multiple blocks and synchronization */
+    TEST_ASSERT_TRUE( drive::read_multiple_blocks(UUT, buffer[1].data() - 128, 8, 2) );
+    TEST_ASSERT_EQUAL_HEX32( 0x77, buffer[1][0] );
+    TEST_ASSERT_TRUE( drive::write_multiple_blocks(UUT, buffer[0].data(), 8, 2) );
+    TEST_ASSERT_TRUE( drive::read_single_block(UUT, buffer[1].data(), 8) );
+    TEST_ASSERT_TRUE( drive::sync(UUT) );
+
+    /* A full queue is served first */
+    drive::Request first{drive::Operation::Write, 1, 1, buffer[0].data()};
+    drive::Request second{drive::Operation::Write, 2, 1, buffer[0].data()};
+    queue.submit(first);
+    queue.submit(second);
+    TEST_ASSERT_TRUE( drive::read_single_block(UUT, buffer[1].data(), 3) );
+    TEST_ASSERT_TRUE( first.is_done() );
+    TEST_ASSERT_TRUE( second.is_done() );
+
+    /* Errors of the memory are passed on */
+    memory.responding = false;
+    TEST_ASSERT_FALSE( drive::read_single_block(UUT, buffer[1].data(), 3) );
+};
+
+/* === Main === */
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_submit_request);
+    RUN_TEST(test_elevator_order);
+    RUN_TEST(test_merge_requests);
+    RUN_TEST(test_barriers);
+    RUN_TEST(test_queue_memory);
+    return UNITY_END();
+};
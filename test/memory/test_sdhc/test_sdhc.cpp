@@ -48,12 +48,22 @@ struct Mock_SDIO : public sdhc::interface
     Mock::Callable<bool> call_command_R7_response;
     Mock::Callable<bool> call_read_single_block;
     Mock::Callable<bool> call_write_single_block;
+    Mock::Callable<bool> call_read_multiple_blocks;
+    Mock::Callable<bool> call_write_multiple_blocks;
+    Mock::Callable<bool> call_start_dma_read;
+    Mock::Callable<bool> call_start_dma_write;
+    Mock::Callable<bool> call_complete_dma_transfer;
+    bool dma = false;
+    bool dma_finished = false;
+    bool dma_success = true;
     uint32_t last_argument = 0;
+    uint32_t first_argument = 0;
     uint32_t R1_response = 0;
     uint32_t R2_response = 0;
     uint32_t R3_response = 0;
     uint32_t R6_response = 0;
     uint32_t R7_response = 0;
+    std::array<uint8_t, 64> data{0};
     bool send_command_no_response(const uint8_t command, const uint32_t argument) override
     {
         last_argument = argument;
@@ -61,6 +71,8 @@ struct Mock_SDIO : public sdhc::interface
     };
     std::optional<uint32_t> send_command_R1_response(const uint8_t command, const uint32_t argument) override
     {
+        if (call_command_R1_response.call_count == 0)
+            first_argument = argument;
         last_argument = argument;
         call_command_R1_response.add_call(command);
         return this->R1_response;
@@ -91,12 +103,44 @@ struct Mock_SDIO : public sdhc::interface
     };
     bool read_single_block(const uint32_t* buffer_begin, const uint32_t* buffer_end) override
     {
-        return call_read_single_block();
+        // Short transfers receive the register data
+        const auto words = static_cast<int>(buffer_end - buffer_begin);
+        if (words <= 16)
+            std::copy(data.begin(), data.begin() + 4 * words, reinterpret_cast<uint8_t*>(const_cast<uint32_t*>(buffer_begin)));
+        call_read_single_block.add_call(words);
+        return true;
     };
     bool write_single_block(const uint32_t* buffer_begin, const uint32_t* buffer_end) override
     {
         return call_write_single_block();
     };
+    bool read_multiple_blocks(const uint32_t* buffer_begin, const uint32_t* buffer_end) override
+    {
+        call_read_multiple_blocks.add_call(static_cast<int>(buffer_end - buffer_begin));
+        return true;
+    };
+    bool write_multiple_blocks(const uint32_t* buffer_begin, const uint32_t* buffer_end) override
+    {
+        call_write_multiple_blocks.add_call(static_cast<int>(buffer_end - buffer_begin));
+        return true;
+    };
+    bool has_dma() const override { return dma; };
+    bool start_dma_read(const uint32_t* buffer_begin, const uint32_t* buffer_end) override
+    {
+        call_start_dma_read.add_call(static_cast<int>(buffer_end - buffer_begin));
+        return true;
+    };
+    bool start_dma_write(const uint32_t* buffer_begin, const uint32_t* buffer_end) override
+    {
+        call_start_dma_write.add_call(static_cast<int>(buffer_end - buffer_begin));
+        return true;
+    };
+    bool dma_transfer_finished() const override { return dma_finished; };
+    bool complete_dma_transfer() override
+    {
+        call_complete_dma_transfer.add_call(0);
+        return dma_success;
+    };
 };
 Mock_SDIO mock_sdio;
 
@@ -104,11 +148,16 @@ Mock_SDIO mock_sdio;
 void setUp(void) {
     // set stuff up here
     mock_sdio.last_argument = 0;
+    mock_sdio.first_argument = 0;
     mock_sdio.R1_response = 0;
     mock_sdio.R2_response = 0;
     mock_sdio.R3_response = 0;
     mock_sdio.R6_response = 0;
     mock_sdio.R7_response = 0;
+    mock_sdio.dma = false;
+    mock_sdio.dma_finished = false;
+    mock_sdio.dma_success = true;
+    mock_sdio.data.fill(0);
     mock_sdio.call_command_no_response.reset();
     mock_sdio.call_command_R1_response.reset();
     mock_sdio.call_command_R2_response.reset();
@@ -117,6 +166,11 @@ void setUp(void) {
     mock_sdio.call_command_R7_response.reset();
     mock_sdio.call_read_single_block.reset();
     mock_sdio.call_write_single_block.reset();
+    mock_sdio.call_read_multiple_blocks.reset();
+    mock_sdio.call_write_multiple_blocks.reset();
+    mock_sdio.call_start_dma_read.reset();
+    mock_sdio.call_start_dma_write.reset();
+    mock_sdio.call_complete_dma_transfer.reset();
 };
 
 void tearDown(void) {
@@ -267,10 +321,12 @@ void test_change_bus_width(void)
     setUp();
     sdhc::Card UUT(mock_sdio);
 
-    // Test the successfull change of the bus width
+    // Test the successfull change of the bus width, the card is addressed with its RCA
+    UUT.RCA = 0x1234;
     mock_sdio.R1_response = sdhc::R1::APP_CMD;
     TEST_ASSERT_TRUE( UUT.set_bus_width_4bits() );
     mock_sdio.call_command_R1_response.assert_called_last_with(sdhc::ACMD<6>() );
+    TEST_ASSERT_EQUAL( 0x1234 << 16, mock_sdio.first_argument);
     TEST_ASSERT_EQUAL( 0b10, mock_sdio.last_argument);
 
     // Test the successfull change of the bus width
@@ -280,6 +336,91 @@ void test_change_bus_width(void)
     TEST_ASSERT_EQUAL( 0b10, mock_sdio.last_argument);
 };
 
+/// @brief Test reading the SD configuration register
+void test_get_SCR(void)
+{
+    // Create Card
+    setUp();
+    sdhc::Card UUT(mock_sdio);
+    UUT.RCA = 0x1234;
+
+    // The card does not accept the application command
+    TEST_ASSERT_FALSE( UUT.get_SCR() );
+    TEST_ASSERT_EQUAL( 0, mock_sdio.call_read_single_block.call_count );
+
+    // Read the SCR of a card with version 3.0, 1bit and 4bit bus and CMD23 support
+    setUp();
+    mock_sdio.R1_response = sdhc::R1::APP_CMD;
+    mock_sdio.data[0] = 0x02;
+    mock_sdio.data[1] = 0x05;
+    mock_sdio.data[3] = 0x02;
+    TEST_ASSERT_TRUE( UUT.get_SCR() );
+    TEST_ASSERT_EQUAL( 0x1234 << 16, mock_sdio.first_argument );
+    mock_sdio.call_command_R1_response.assert_called_last_with(sdhc::ACMD<51>());
+    mock_sdio.call_read_single_block.assert_called_once_with(2);
+    TEST_ASSERT_EQUAL( 2, UUT.spec_version );
+    TEST_ASSERT_TRUE( UUT.supports_4bits );
+    TEST_ASSERT_TRUE( UUT.supports_CMD23 );
+
+    // Read the SCR of a card with version 1.0
+    setUp();
+    mock_sdio.R1_response = sdhc::R1::APP_CMD;
+    mock_sdio.data[1] = 0x01;
+    TEST_ASSERT_TRUE( UUT.get_SCR() );
+    TEST_ASSERT_EQUAL( 0, UUT.spec_version );
+    TEST_ASSERT_FALSE( UUT.supports_4bits );
+    TEST_ASSERT_FALSE( UUT.supports_CMD23 );
+};
+
+/// @brief Test reading the SD status register
+void test_get_SSR(void)
+{
+    // Create Card
+    setUp();
+    sdhc::Card UUT(mock_sdio);
+
+    // Read the SSR of a class 6 card with 4 MiB allocation units
+    mock_sdio.R1_response = sdhc::R1::APP_CMD;
+    mock_sdio.data[8] = 0x03;
+    mock_sdio.data[10] = 0x90;
+    TEST_ASSERT_TRUE( UUT.get_SSR() );
+    mock_sdio.call_command_R1_response.assert_called_last_with(sdhc::ACMD<13>());
+    mock_sdio.call_read_single_block.assert_called_once_with(16);
+    TEST_ASSERT_EQUAL( 6, UUT.speed_class );
+    TEST_ASSERT_EQUAL( 4096, UUT.AU_size );
+};
+
+/// @brief Test switching the card to the high-speed mode
+void test_set_high_speed(void)
+{
+    // Create Card
+    setUp();
+    sdhc::Card UUT(mock_sdio);
+
+    // Cards of version 1.0 do not support CMD6
+    TEST_ASSERT_FALSE( UUT.set_high_speed() );
+    TEST_ASSERT_EQUAL( 0, mock_sdio.call_command_R1_response.call_count );
+
+    // The card does not support the high-speed function
+    UUT.spec_version = 2;
+    mock_sdio.data[13] = 0x01;
+    TEST_ASSERT_FALSE( UUT.set_high_speed() );
+    mock_sdio.call_command_R1_response.assert_called_once_with(sdhc::CMD<6>());
+    TEST_ASSERT_EQUAL( sdhc::CMD6::Check_High_Speed, mock_sdio.last_argument );
+    mock_sdio.call_read_single_block.assert_called_once_with(16);
+    TEST_ASSERT_FALSE( UUT.supports_high_speed );
+
+    // The card switches to the high-speed function
+    setUp();
+    mock_sdio.data[13] = 0x03;
+    mock_sdio.data[16] = 0x01;
+    TEST_ASSERT_TRUE( UUT.set_high_speed() );
+    TEST_ASSERT_EQUAL( 2, mock_sdio.call_command_R1_response.call_count );
+    TEST_ASSERT_EQUAL( sdhc::CMD6::Check_High_Speed, mock_sdio.first_argument );
+    TEST_ASSERT_EQUAL( sdhc::CMD6::Switch_High_Speed, mock_sdio.last_argument );
+    TEST_ASSERT_TRUE( UUT.supports_high_speed );
+};
+
 /// @brief Test ejecting the card
 void test_eject(void)
 {
@@ -351,6 +492,147 @@ void test_write_single_block(void)
     TEST_ASSERT_EQUAL(1, mock_sdio.last_argument);
 };
 
+/// @brief Test reading multiple blocks
+void test_read_multiple_blocks(void)
+{
+    // Create Card
+    setUp();
+    sdhc::Card UUT(mock_sdio);
+    auto buffer = sdhc::create_block_buffer<4>();
+
+    // Test reading 4 blocks of a SDSC card, the transfer is stopped with CMD12
+    TEST_ASSERT_TRUE( UUT.read_multiple_blocks(buffer.begin(), 2, 4) );
+    TEST_ASSERT_EQUAL( 2, mock_sdio.call_command_R1_response.call_count );
+    TEST_ASSERT_EQUAL( 2*sdhc::BLOCKLENGTH, mock_sdio.first_argument );
+    mock_sdio.call_command_R1_response.assert_called_last_with(sdhc::CMD<12>());
+    mock_sdio.call_read_multiple_blocks.assert_called_once_with(4 * 128);
+
+    // Test reading 4 blocks of a SDHC card with CMD23 support
+    setUp();
+    UUT.type_sdsc = false;
+    UUT.supports_CMD23 = true;
+    TEST_ASSERT_TRUE( UUT.read_multiple_blocks(buffer.begin(), 2, 4) );
+    TEST_ASSERT_EQUAL( 2, mock_sdio.call_command_R1_response.call_count );
+    TEST_ASSERT_EQUAL( 4, mock_sdio.first_argument );
+    TEST_ASSERT_EQUAL( 2, mock_sdio.last_argument );
+    mock_sdio.call_command_R1_response.assert_called_last_with(sdhc::CMD<18>());
+    mock_sdio.call_read_multiple_blocks.assert_called_once_with(4 * 128);
+
+    // Test that one block uses the single block transfer
+    setUp();
+    TEST_ASSERT_TRUE( UUT.read_multiple_blocks(buffer.begin(), 2, 1) );
+    mock_sdio.call_command_R1_response.assert_called_once_with(sdhc::CMD<17>());
+    mock_sdio.call_read_single_block.assert_called_once();
+    TEST_ASSERT_EQUAL( 0, mock_sdio.call_read_multiple_blocks.call_count );
+};
+
+/// @brief Test writing multiple blocks
+void test_write_multiple_blocks(void)
+{
+    // Create Card
+    setUp();
+    sdhc::Card UUT(mock_sdio);
+    auto buffer = sdhc::create_block_buffer<2>();
+
+    // Test writing 2 blocks of a SDHC card, the transfer is stopped with CMD12
+    UUT.type_sdsc = false;
+    TEST_ASSERT_TRUE( UUT.write_multiple_blocks(buffer.begin(), 8, 2) );
+    TEST_ASSERT_EQUAL( 2, mock_sdio.call_command_R1_response.call_count );
+    TEST_ASSERT_EQUAL( 8, mock_sdio.first_argument );
+    mock_sdio.call_command_R1_response.assert_called_last_with(sdhc::CMD<12>());
+    mock_sdio.call_write_multiple_blocks.assert_called_once_with(2 * 128);
+
+    // Test writing 2 blocks with CMD23 support
+    setUp();
+    UUT.supports_CMD23 = true;
+    TEST_ASSERT_TRUE( UUT.write_multiple_blocks(buffer.begin(), 8, 2) );
+    TEST_ASSERT_EQUAL( 2, mock_sdio.call_command_R1_response.call_count );
+    TEST_ASSERT_EQUAL( 2, mock_sdio.first_argument );
+    mock_sdio.call_command_R1_response.assert_called_last_with(sdhc::CMD<25>());
+    mock_sdio.call_write_multiple_blocks.assert_called_once_with(2 * 128);
+};
+
+/// @brief Test transferring blocks in the background
+void test_transfer_in_background(void)
+{
+    // Create Card
+    setUp();
+    sdhc::Card UUT(mock_sdio);
+    auto buffer = sdhc::create_block_buffer<4>();
+
+    // Test that a bus without DMA reads the blocks immediately
+    TEST_ASSERT_TRUE( drive::start_read_multiple_blocks(UUT, buffer.begin(), 2, 4) );
+    mock_sdio.call_read_multiple_blocks.assert_called_once_with(4 * 128);
+    TEST_ASSERT_EQUAL( 0, mock_sdio.call_start_dma_read.call_count );
+    TEST_ASSERT_TRUE( drive::is_read_finished(UUT) );
+    TEST_ASSERT_TRUE( drive::complete_read(UUT) );
+    TEST_ASSERT_EQUAL( 0, mock_sdio.call_complete_dma_transfer.call_count );
+
+    // Test reading 4 blocks of a SDSC card with DMA, the transfer is stopped with CMD12
+    setUp();
+    mock_sdio.dma = true;
+    TEST_ASSERT_TRUE( drive::start_read_multiple_blocks(UUT, buffer.begin(), 2, 4) );
+    mock_sdio.call_command_R1_response.assert_called_once_with(sdhc::CMD<18>());
+    TEST_ASSERT_EQUAL( 2*sdhc::BLOCKLENGTH, mock_sdio.last_argument );
+    mock_sdio.call_start_dma_read.assert_called_once_with(4 * 128);
+    TEST_ASSERT_EQUAL( 0, mock_sdio.call_read_multiple_blocks.call_count );
+    TEST_ASSERT_FALSE( drive::is_read_finished(UUT) );
+    mock_sdio.dma_finished = true;
+    TEST_ASSERT_TRUE( drive::is_read_finished(UUT) );
+    TEST_ASSERT_TRUE( drive::complete_read(UUT) );
+    mock_sdio.call_complete_dma_transfer.assert_called_once();
+    mock_sdio.call_command_R1_response.assert_called_once_with(sdhc::CMD<12>());
+
+    // Test writing 2 blocks of a SDHC card with CMD23 support, no CMD12 is needed
+    setUp();
+    mock_sdio.dma = true;
+    UUT.type_sdsc = false;
+    UUT.supports_CMD23 = true;
+    TEST_ASSERT_TRUE( drive::start_write_multiple_blocks(UUT, buffer.begin(), 8, 2) );
+    TEST_ASSERT_EQUAL( 2, mock_sdio.call_command_R1_response.call_count );
+    TEST_ASSERT_EQUAL( 2, mock_sdio.first_argument );
+    TEST_ASSERT_EQUAL( 8, mock_sdio.last_argument );
+    mock_sdio.call_command_R1_response.assert_called_last_with(sdhc::CMD<25>());
+    mock_sdio.call_start_dma_write.assert_called_once_with(2 * 128);
+    TEST_ASSERT_FALSE( drive::is_write_finished(UUT) );
+    mock_sdio.dma_finished = true;
+    TEST_ASSERT_TRUE( drive::complete_write(UUT) );
+    TEST_ASSERT_EQUAL( 2, mock_sdio.call_command_R1_response.call_count );
+
+    // Test that a single block uses the single block command
+    setUp();
+    mock_sdio.dma = true;
+    mock_sdio.dma_finished = true;
+    TEST_ASSERT_TRUE( drive::start_write_multiple_blocks(UUT, buffer.begin(), 8, 1) );
+    mock_sdio.call_command_R1_response.assert_called_once_with(sdhc::CMD<24>());
+    mock_sdio.call_start_dma_write.assert_called_once_with(128);
+    TEST_ASSERT_TRUE( drive::complete_write(UUT) );
+    TEST_ASSERT_EQUAL( 0, mock_sdio.call_command_R1_response.call_count );
+
+    // Test that a failed transfer is reported once and stopped with CMD12
+    setUp();
+    mock_sdio.dma = true;
+    mock_sdio.dma_finished = true;
+    mock_sdio.dma_success = false;
+    TEST_ASSERT_TRUE( drive::start_read_multiple_blocks(UUT, buffer.begin(), 2, 4) );
+    TEST_ASSERT_FALSE( drive::complete_read(UUT) );
+    mock_sdio.call_command_R1_response.assert_called_last_with(sdhc::CMD<12>());
+    TEST_ASSERT_TRUE( drive::complete_read(UUT) );
+    mock_sdio.call_complete_dma_transfer.assert_called_once();
+
+    // Test that other accesses finish the running transfer first
+    setUp();
+    mock_sdio.dma = true;
+    mock_sdio.dma_finished = true;
+    TEST_ASSERT_TRUE( drive::start_read_multiple_blocks(UUT, buffer.begin(), 2, 4) );
+    TEST_ASSERT_TRUE( UUT.read_single_block(buffer.begin(), 0) );
+    mock_sdio.call_complete_dma_transfer.assert_called_once();
+    mock_sdio.call_command_R1_response.assert_called_last_with(sdhc::CMD<17>());
+    TEST_ASSERT_TRUE( drive::is_read_finished(UUT) );
+    TEST_ASSERT_TRUE( drive::complete_read(UUT) );
+    TEST_ASSERT_EQUAL( 0, mock_sdio.call_complete_dma_transfer.call_count );
+};
+
 void test_data_access(void)
 {
     // auto buffer = SDHC::create_block_buffer<1>();
@@ -378,9 +660,15 @@ int main(int argc, char **argv)
     RUN_TEST(test_get_RCA);
     RUN_TEST(test_select_card);
     RUN_TEST(test_change_bus_width);
+    RUN_TEST(test_get_SCR);
+    RUN_TEST(test_get_SSR);
+    RUN_TEST(test_set_high_speed);
     RUN_TEST(test_eject);
     RUN_TEST(test_read_single_block);
     RUN_TEST(test_write_single_block);
+    RUN_TEST(test_read_multiple_blocks);
+    RUN_TEST(test_write_multiple_blocks);
+    RUN_TEST(test_transfer_in_background);
     RUN_TEST(test_data_access);
     return UNITY_END();
 };
\ No newline at end of file
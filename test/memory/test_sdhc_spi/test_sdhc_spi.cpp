@@ -0,0 +1,413 @@
+/**
+ * OTOS - Open Tec Operating System
+ * Copyright (c) 2021 Sebastian Oberschwendtner, sebastian.oberschwendtner@gmail.com
+ *
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+/**
+ ==============================================================================
+ * @file    test_sdhc_spi.cpp
+ * @author  SO
+ * @version v5.2.0
+ * @date    18-October-2026
+ * @brief   Unit tests for the SPI bus of SD cards.
+ ==============================================================================
+ */
+
+/* === Includes === */
+#include <unity.h>
+#include <array>
+#include <vector>
+#include "memory/sdhc_spi.h"
+#include "memory/sdhc_spi.cpp"
+
+/** === Test List ===
+ * ✓ The CRCs match the examples of the specification.
+ * ✓ The reset clocks the card before CMD0.
+ * ✓ The card is initialized with CMD8, ACMD41 and CMD58 and checks the CRC afterwards.
+ * ✓ The R1 response of SPI mode is converted to the card status.
+ * ✓ Registers are read as data.
+ * ✓ Single blocks are read and written.
+ * ✓ Multiple blocks are read and written and the bus stops the transfers.
+ * ✓ Wrong CRCs, error tokens and missing cards fail the transfers.
+ * ✓ The data blocks are transferred with DMA.
+*/
+
+/* === Fixtures === */
+struct Fake_SPI
+{
+    Fake::SD_Card *card;
+    uint32_t bytes{0};
+
+    auto transfer_byte(const uint8_t data) -> std::optional<uint8_t>
+    {
+        this->bytes++;
+        return this->card->exchange(data);
+    };
+};
+
+struct Fake_Pin
+{
+    Fake::SD_Card *card;
+    bool present{true};
+
+    void set_high() { this->card->select(false); };
+    void set_low() { this->card->select(this->present); };
+};
+
+struct Fake_DMA_Stream
+{
+    Fake::SD_Card *card;
+    Fake_DMA_Stream *rx{nullptr}; /* Only set for the TX stream, which clocks the transfer */
+    uint8_t *memory{nullptr};
+    bool increment{false};
+    std::size_t transfers{0};
+    bool complete{false};
+    uint32_t runs{0};
+
+    template <typename memory_t>
+    auto assign_memory(memory_t &memory, const bool enable_increment = false) -> Fake_DMA_Stream &
+    {
+        this->memory = const_cast<uint8_t *>(&memory);
+        this->increment = enable_increment;
+        return *this;
+    };
+    auto set_number_of_transfers(const std::size_t number_of_transfers) -> Fake_DMA_Stream &
+    {
+        this->transfers = number_of_transfers;
+        return *this;
+    };
+    auto enable() -> bool
+    {
+        this->complete = false;
+        if (!this->rx)
+            return true;
+
+        /* The TX stream exchanges all bytes at once */
+        this->runs++;
+        for (std::size_t i = 0; i < this->transfers; i++)
+        {
+            const uint8_t miso = this->card->exchange(this->memory[this->increment ? i : 0]);
+            this->rx->memory[this->rx->increment ? i : 0] = miso;
+        }
+        this->rx->complete = true;
+        this->complete = true;
+        return true;
+    };
+    void disable() {};
+    auto is_transfer_complete() const -> bool { return this->complete; };
+    auto is_transfer_error() const -> bool { return false; };
+};
+
+using Bus = sdhc::SPI_Bus<Fake_SPI, Fake_Pin, Fake_DMA_Stream>;
+
+/* Bring the card to the transfer state */
+void initialize(sdhc::Card &UUT)
+{
+    TEST_ASSERT_TRUE(UUT.reset());
+    TEST_ASSERT_TRUE(UUT.set_supply_voltage());
+    while (!UUT.initialize_card())
+        TEST_ASSERT_NOT_EQUAL(sdhc::State::Disconnected, UUT.state);
+    TEST_ASSERT_TRUE(UUT.get_RCA());
+    TEST_ASSERT_TRUE(UUT.select());
+};
+
+/* Fill a block buffer with a pattern */
+void fill(std::array<uint32_t, 128> &block, const uint32_t seed)
+{
+    for (uint32_t i = 0; i < block.size(); i++)
+        block[i] = seed * 0x01010101 + i;
+};
+
+/* === Tests === */
+void setUp(void) {
+    /* set stuff up here */
+};
+
+void tearDown(void) {
+    /* clean stuff up here */
+};
+
+void test_crc(void)
+{
+    /* The command frames of CMD0 and CMD8 */
+    const std::array<uint8_t, 5> cmd0{0x40, 0x00, 0x00, 0x00, 0x00};
+    const std::array<uint8_t, 5> cmd8{0x48, 0x00, 0x00, 0x01, 0xAA};
+    const std::array<uint8_t, 5> cmd17{0x51, 0x00, 0x00, 0x00, 0x00};
+    TEST_ASSERT_EQUAL_HEX8(0x4A, sdhc::crc7(cmd0.data(), 5));
+    TEST_ASSERT_EQUAL_HEX8(0x43, sdhc::crc7(cmd8.data(), 5));
+    TEST_ASSERT_EQUAL_HEX8(0x2A, sdhc::crc7(cmd17.data(), 5));
+
+    /* A block of 0xFF */
+    std::array<uint8_t, 512> block{};
+    block.fill(0xFF);
+    TEST_ASSERT_EQUAL_HEX16(0x7FA1, sdhc::crc16(block.data(), block.size()));
+};
+
+void test_reset(void)
+{
+    Fake::SD_Card card;
+    Fake_SPI spi{&card};
+    Fake_Pin cs{&card};
+    Bus bus{spi, cs};
+    sdhc::Card UUT{bus};
+
+    /* The card gets at least 74 clocks without chip select */
+    TEST_ASSERT_TRUE(UUT.reset());
+    TEST_ASSERT_GREATER_OR_EQUAL(10, card.idle_clocks);
+    TEST_ASSERT_EQUAL(1, card.commands.size());
+    TEST_ASSERT_EQUAL(0, card.commands.back());
+
+    /* Without a card there is no response */
+    cs.present = false;
+    TEST_ASSERT_FALSE(UUT.reset());
+    TEST_ASSERT_FALSE(UUT.set_supply_voltage());
+    TEST_ASSERT_EQUAL(sdhc::State::Disconnected, UUT.state);
+};
+
+void test_initialize(void)
+{
+    Fake::SD_Card card;
+    Fake_SPI spi{&card};
+    Fake_Pin cs{&card};
+    Bus bus{spi, cs};
+    sdhc::Card UUT{bus};
+
+    /* The voltage check echos the pattern */
+    TEST_ASSERT_TRUE(UUT.reset());
+    TEST_ASSERT_TRUE(UUT.set_supply_voltage());
+    TEST_ASSERT_EQUAL(sdhc::State::Identification, UUT.state);
+
+    /* The card is busy while it is idle */
+    TEST_ASSERT_FALSE(UUT.initialize_card());
+    TEST_ASSERT_FALSE(UUT.initialize_card());
+    TEST_ASSERT_FALSE(card.crc_enabled);
+    TEST_ASSERT_TRUE(UUT.initialize_card());
+    TEST_ASSERT_FALSE(UUT.is_SDSC());
+    TEST_ASSERT_TRUE(card.crc_enabled);
+
+    /* The card is selected without identification */
+    TEST_ASSERT_TRUE(UUT.get_RCA());
+    TEST_ASSERT_EQUAL(0, UUT.RCA);
+    TEST_ASSERT_TRUE(UUT.select());
+    TEST_ASSERT_EQUAL(sdhc::State::Transfering, UUT.state);
+
+    /* Only the commands of SPI mode were sent */
+    const std::vector<uint8_t> expected{0, 8, 55, 41, 55, 41, 55, 41, 59, 58};
+    TEST_ASSERT_EQUAL(expected.size(), card.commands.size());
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected.data(), card.commands.data(), expected.size());
+};
+
+void test_card_status(void)
+{
+    Fake::SD_Card card;
+    Fake_SPI spi{&card};
+    Fake_Pin cs{&card};
+    Bus bus{spi, cs};
+    sdhc::Card UUT{bus};
+    initialize(UUT);
+
+    /* CMD55 enables the application commands */
+    auto response = bus.send_command_R1_response(55, 0);
+    TEST_ASSERT_TRUE(response);
+    TEST_ASSERT_EQUAL_HEX32(sdhc::R1::APP_CMD, response.value());
+
+    /* Illegal commands */
+    response = bus.send_command_R1_response(5, 0);
+    TEST_ASSERT_TRUE(response);
+    TEST_ASSERT_EQUAL_HEX32(sdhc::R1::ERROR | sdhc::R1::ILLEGAL_CMD, response.value());
+
+    /* The bus width cannot be changed in SPI mode */
+    TEST_ASSERT_FALSE(UUT.set_bus_width_4bits());
+
+    /* The bus answers CMD12 and CMD23 itself */
+    card.commands.clear();
+    TEST_ASSERT_TRUE(UUT.stop_transmission());
+    TEST_ASSERT_TRUE(bus.send_command_R1_response(23, 4));
+    TEST_ASSERT_EQUAL(0, card.commands.size());
+
+    /* Ejecting does not send a command */
+    UUT.eject();
+    TEST_ASSERT_EQUAL(0, card.commands.size());
+    TEST_ASSERT_EQUAL(sdhc::State::Disconnected, UUT.state);
+};
+
+void test_registers(void)
+{
+    Fake::SD_Card card;
+    Fake_SPI spi{&card};
+    Fake_Pin cs{&card};
+    Bus bus{spi, cs};
+    sdhc::Card UUT{bus};
+    initialize(UUT);
+
+    /* Read the SCR */
+    TEST_ASSERT_TRUE(UUT.get_SCR());
+    TEST_ASSERT_EQUAL(2, UUT.spec_version);
+    TEST_ASSERT_TRUE(UUT.supports_4bits);
+    TEST_ASSERT_TRUE(UUT.supports_CMD23);
+
+    /* Read the SSR, which has a R2 response */
+    TEST_ASSERT_TRUE(UUT.get_SSR());
+    TEST_ASSERT_EQUAL(10, UUT.speed_class);
+    TEST_ASSERT_EQUAL(4096, UUT.AU_size);
+
+    /* Switch to high speed */
+    TEST_ASSERT_TRUE(UUT.set_high_speed());
+    TEST_ASSERT_TRUE(UUT.supports_high_speed);
+};
+
+void test_single_block(void)
+{
+    Fake::SD_Card card;
+    Fake_SPI spi{&card};
+    Fake_Pin cs{&card};
+    Bus bus{spi, cs};
+    sdhc::Card UUT{bus};
+    initialize(UUT);
+
+    /* Write a block and read it back */
+    std::array<uint32_t, 128> block{};
+    fill(block, 3);
+    TEST_ASSERT_TRUE(UUT.write_single_block(block.begin(), 5));
+    TEST_ASSERT_EQUAL_MEMORY(block.data(), card.get_block(5), 512);
+
+    std::array<uint32_t, 128> read{};
+    TEST_ASSERT_TRUE(UUT.read_single_block(read.begin(), 5));
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(block.data(), read.data(), 128);
+
+    /* The card is released after the transfers */
+    card.commands.clear();
+    TEST_ASSERT_TRUE(bus.send_command_R1_response(13, 0));
+    TEST_ASSERT_EQUAL(1, card.commands.size());
+};
+
+void test_multiple_blocks(void)
+{
+    Fake::SD_Card card;
+    Fake_SPI spi{&card};
+    Fake_Pin cs{&card};
+    Bus bus{spi, cs};
+    sdhc::Card UUT{bus};
+    initialize(UUT);
+    std::array<uint32_t, 4 * 128> blocks{};
+    for (uint32_t i = 0; i < blocks.size(); i++)
+        blocks[i] = 0x5A000000 + i;
+
+    /* The write is stopped with the stop token */
+    card.commands.clear();
+    TEST_ASSERT_TRUE(UUT.write_multiple_blocks(blocks.begin(), 10, 4));
+    TEST_ASSERT_EQUAL(1, card.commands.size());
+    TEST_ASSERT_EQUAL(25, card.commands.back());
+    TEST_ASSERT_EQUAL_MEMORY(blocks.data(), card.get_block(10), 4 * 512);
+
+    /* The read is stopped with CMD12, with and without CMD23 */
+    std::array<uint32_t, 4 * 128> read{};
+    card.commands.clear();
+    TEST_ASSERT_TRUE(UUT.read_multiple_blocks(read.begin(), 10, 4));
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(blocks.data(), read.data(), read.size());
+    TEST_ASSERT_EQUAL(2, card.commands.size());
+    TEST_ASSERT_EQUAL(18, card.commands[0]);
+    TEST_ASSERT_EQUAL(12, card.commands[1]);
+
+    read.fill(0);
+    UUT.supports_CMD23 = true;
+    TEST_ASSERT_TRUE(UUT.read_multiple_blocks(read.begin(), 11, 3));
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(blocks.data() + 128, read.data(), 3 * 128);
+
+    /* The card accepts commands afterwards */
+    std::array<uint32_t, 128> block{};
+    TEST_ASSERT_TRUE(UUT.read_single_block(block.begin(), 13));
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(blocks.data() + 3 * 128, block.data(), 128);
+};
+
+void test_errors(void)
+{
+    Fake::SD_Card card{16};
+    Fake_SPI spi{&card};
+    Fake_Pin cs{&card};
+    Bus bus{spi, cs};
+    sdhc::Card UUT{bus};
+    initialize(UUT);
+    std::array<uint32_t, 2 * 128> blocks{};
+
+    /* Wrong CRC of the data */
+    card.corrupt_crc = true;
+    TEST_ASSERT_FALSE(UUT.read_single_block(blocks.begin(), 1));
+    TEST_ASSERT_TRUE(UUT.read_single_block(blocks.begin(), 1));
+
+    /* The card sends an error token for blocks out of range */
+    TEST_ASSERT_FALSE(UUT.read_single_block(blocks.begin(), 16));
+    TEST_ASSERT_FALSE(UUT.read_multiple_blocks(blocks.begin(), 15, 2));
+    TEST_ASSERT_TRUE(UUT.read_multiple_blocks(blocks.begin(), 14, 2));
+
+    /* The card is removed */
+    cs.present = false;
+    TEST_ASSERT_FALSE(UUT.read_single_block(blocks.begin(), 1));
+    TEST_ASSERT_FALSE(UUT.write_multiple_blocks(blocks.begin(), 1, 2));
+    TEST_ASSERT_FALSE(bus.send_command_R1_response(13, 0));
+};
+
+void test_dma(void)
+{
+    Fake::SD_Card card;
+    Fake_SPI spi{&card};
+    Fake_Pin cs{&card};
+    Bus bus{spi, cs};
+    sdhc::Card UUT{bus};
+    initialize(UUT);
+
+    Fake_DMA_Stream rx{&card};
+    Fake_DMA_Stream tx{&card, &rx};
+    bus.set_dma_streams(rx, tx);
+
+    /* The blocks are transferred with DMA, only the framing by the controller */
+    std::array<uint32_t, 4 * 128> blocks{};
+    for (uint32_t i = 0; i < blocks.size(); i++)
+        blocks[i] = 0xA5000000 + i;
+    spi.bytes = 0;
+    TEST_ASSERT_TRUE(UUT.write_multiple_blocks(blocks.begin(), 20, 4));
+    TEST_ASSERT_EQUAL(4, tx.runs);
+    TEST_ASSERT_LESS_THAN(100, spi.bytes);
+    TEST_ASSERT_EQUAL_MEMORY(blocks.data(), card.get_block(20), 4 * 512);
+
+    std::array<uint32_t, 4 * 128> read{};
+    spi.bytes = 0;
+    TEST_ASSERT_TRUE(UUT.read_multiple_blocks(read.begin(), 20, 4));
+    TEST_ASSERT_EQUAL(8, tx.runs);
+    TEST_ASSERT_LESS_THAN(100, spi.bytes);
+    TEST_ASSERT_EQUAL_UINT32_ARRAY(blocks.data(), read.data(), read.size());
+
+    /* The CRC is still checked */
+    card.corrupt_crc = true;
+    TEST_ASSERT_FALSE(UUT.read_single_block(read.begin(), 20));
+};
+
+/* === Main === */
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_crc);
+    RUN_TEST(test_reset);
+    RUN_TEST(test_initialize);
+    RUN_TEST(test_card_status);
+    RUN_TEST(test_registers);
+    RUN_TEST(test_single_block);
+    RUN_TEST(test_multiple_blocks);
+    RUN_TEST(test_errors);
+    RUN_TEST(test_dma);
+    return UNITY_END();
+};
@@ -47,13 +47,13 @@
 *   ▢ Priority can be assigned.
 *   ✓ Memory increment can be turned on.
 *   ✓ Peripheral increment can be turned on.
-* ▢ Enable and disable Stream.
+* ✓ Enable and disable Stream.
 * ▢ Status:
 *   ✓ Read whether the stream is enabled.
 *   ▢ Read interrupt flags:
 *     ✓ Transfer Finished
 *     ▢ Half Transfer Finished
-*     ▢ Transfer Error
+*     ✓ Transfer Error
 *     ▢ Direct Mode Error
 *   ▢ Clear interrupt flags:
 *     ✓ All flags
@@ -61,7 +61,10 @@
 *     ▢ Half Transfer Finished
 *     ▢ Transfer Error
 *     ▢ Direct Mode Error
-* ▢ FIFO Control:
+* ✓ FIFO Control:
+*   ✓ Burst transfers.
+*   ✓ Direct mode can be disabled.
+* ✓ Peripheral flow control.
 */
 
 /* === Mocks === */
@@ -403,6 +406,90 @@ void test_enable_dma_stream()
     );
 };
 
+/** 
+ * @brief Test disabling the dma stream
+ */
+void test_disable_dma_stream()
+{
+    /* Create DMA Stream0 */
+    dma::Stream UUT{{1,0,0}};
+    UUT.enable();
+
+    /* Disable Stream0 */
+    UUT.disable();
+    TEST_ASSERT_BIT_LOW(DMA_SxCR_EN_Pos, DMA1_Stream0->CR);
+    TEST_ASSERT_FALSE(UUT.is_enabled());
+};
+
+/** 
+ * @brief Test reading the TEIF flag
+ */
+void test_read_transfer_error_flag()
+{
+    /* Create DMA Stream1 */
+    dma::Stream UUT{{1,1,0}};
+    TEST_ASSERT_FALSE(UUT.is_transfer_error());
+    DMA1->LISR = DMA_LISR_TEIF1;
+    TEST_ASSERT_TRUE(UUT.is_transfer_error());
+
+    /* Create DMA Stream4 */
+    UUT = dma::Stream{{1,4,0}};
+    TEST_ASSERT_FALSE(UUT.is_transfer_error());
+    DMA1->HISR = DMA_HISR_TEIF4;
+    TEST_ASSERT_TRUE(UUT.is_transfer_error());
+};
+
+/** 
+ * @brief Test setting the burst transfers
+ */
+void test_set_burst()
+{
+    /* Create DMA Stream0 */
+    dma::Stream UUT{{1,0,0}};
+
+    /* Set incremental bursts */
+    UUT.set_burst(dma::Burst::Increment_4, dma::Burst::Increment_8);
+    TEST_ASSERT_BITS(DMA_SxCR_MBURST_Msk, 1 << DMA_SxCR_MBURST_Pos, DMA1_Stream0->CR);
+    TEST_ASSERT_BITS(DMA_SxCR_PBURST_Msk, 2 << DMA_SxCR_PBURST_Pos, DMA1_Stream0->CR);
+
+    /* Set single transfers */
+    UUT.set_burst(dma::Burst::Single, dma::Burst::Increment_16);
+    TEST_ASSERT_BITS(DMA_SxCR_MBURST_Msk, 0, DMA1_Stream0->CR);
+    TEST_ASSERT_BITS(DMA_SxCR_PBURST_Msk, 3 << DMA_SxCR_PBURST_Pos, DMA1_Stream0->CR);
+};
+
+/** 
+ * @brief Test the FIFO control
+ */
+void test_set_fifo()
+{
+    /* Create DMA Stream0 */
+    dma::Stream UUT{{1,0,0}};
+
+    /* Enable the FIFO with full threshold */
+    UUT.set_fifo(true);
+    TEST_ASSERT_BIT_HIGH(DMA_SxFCR_DMDIS_Pos, DMA1_Stream0->FCR);
+    TEST_ASSERT_BITS(DMA_SxFCR_FTH_Msk, DMA_SxFCR_FTH_Msk, DMA1_Stream0->FCR);
+
+    /* Return to direct mode */
+    UUT.set_fifo(false);
+    TEST_ASSERT_BIT_LOW(DMA_SxFCR_DMDIS_Pos, DMA1_Stream0->FCR);
+};
+
+/** 
+ * @brief Test setting the peripheral flow control
+ */
+void test_set_peripheral_flow_control()
+{
+    /* Create DMA Stream0 */
+    dma::Stream UUT{{1,0,0}};
+
+    UUT.set_peripheral_flow_control(true);
+    TEST_ASSERT_BIT_HIGH(DMA_SxCR_PFCTRL_Pos, DMA1_Stream0->CR);
+    UUT.set_peripheral_flow_control(false);
+    TEST_ASSERT_BIT_LOW(DMA_SxCR_PFCTRL_Pos, DMA1_Stream0->CR);
+};
+
 /* === Main === */
 int main(int argc, char **argv)
 {
@@ -419,5 +506,10 @@ int main(int argc, char **argv)
     RUN_TEST(test_read_transfer_complete_flag);
     RUN_TEST(test_clear_interrupt_flags);
     RUN_TEST(test_enable_dma_stream);
+    RUN_TEST(test_disable_dma_stream);
+    RUN_TEST(test_read_transfer_error_flag);
+    RUN_TEST(test_set_burst);
+    RUN_TEST(test_set_fifo);
+    RUN_TEST(test_set_peripheral_flow_control);
     return UNITY_END();
 };
@@ -37,6 +37,7 @@
 * ▢ error codes:
 *   ✓ error -130: Timeout during transfer
 *   ✓ error -131: Bus busy during start of transfer
+*   ✓ error -132: Data error during DMA transfer
 */
 
 /* === Tests === */
@@ -44,6 +45,8 @@ void setUp() {
     /* set stuff up here */
     RCC->registers_to_default();
     SDIO->registers_to_default();
+    DMA2->registers_to_default();
+    DMA2_Stream3->registers_to_default();
 };
 
 void tearDown() {
@@ -75,6 +78,7 @@ void test_set_clock()
     /* Test the side effects */
     TEST_ASSERT_BITS(SDIO_CLKCR_CLKDIV_Msk, 46, SDIO->CLKCR);
     TEST_ASSERT_BIT_HIGH(SDIO_CLKCR_CLKEN_Pos, SDIO->CLKCR);
+    TEST_ASSERT_BIT_HIGH(SDIO_CLKCR_HWFC_EN_Pos, SDIO->CLKCR);
 
     /* Change clock rate again */
     SDIO->CLKCR &= ~SDIO_CLKCR_CLKEN;
@@ -87,6 +91,22 @@ void test_set_clock()
     UUT.set_clock(400'000, true);
     TEST_ASSERT_BIT_HIGH(SDIO_CLKCR_PWRSAV_Pos, SDIO->CLKCR);
     TEST_ASSERT_BIT_HIGH(SDIO_CLKCR_CLKEN_Pos, SDIO->CLKCR);
+
+    /* The clock does not exceed the requested rate */
+    UUT.set_clock(25'000'000);
+    TEST_ASSERT_BITS(SDIO_CLKCR_CLKDIV_Msk, 0, SDIO->CLKCR);
+    TEST_ASSERT_BIT_LOW(SDIO_CLKCR_BYPASS_Pos, SDIO->CLKCR);
+    UUT.set_clock(5'000'000);
+    TEST_ASSERT_BITS(SDIO_CLKCR_CLKDIV_Msk, 8, SDIO->CLKCR);
+
+    /* The high-speed clock bypasses the divider and keeps the flow control */
+    UUT.set_clock(50'000'000);
+    TEST_ASSERT_BIT_HIGH(SDIO_CLKCR_BYPASS_Pos, SDIO->CLKCR);
+    TEST_ASSERT_BIT_HIGH(SDIO_CLKCR_PWRSAV_Pos, SDIO->CLKCR);
+    TEST_ASSERT_BIT_HIGH(SDIO_CLKCR_HWFC_EN_Pos, SDIO->CLKCR);
+    UUT.set_clock(400'000);
+    TEST_ASSERT_BIT_LOW(SDIO_CLKCR_BYPASS_Pos, SDIO->CLKCR);
+    TEST_ASSERT_BITS(SDIO_CLKCR_CLKDIV_Msk, 118, SDIO->CLKCR);
 };
 
 /** 
@@ -497,6 +517,236 @@ void test_write_block()
     TEST_ASSERT_EQUAL(error::Code::SDIO_Timeout, UUT.get_error() );
 };
 
+/** 
+ * @brief Test reading multiple blocks with one transfer
+ */
+void test_read_multiple_blocks()
+{
+    setUp();
+
+    /* Create Controller -> SDIO */
+    auto UUT = sdio::Controller::create(1'000'000);
+    std::array<uint32_t, 4 * 128> buffer{0};
+
+    /* Test reading 4 blocks with no errors */
+    SDIO->STA = SDIO_STA_DATAEND | SDIO_STA_RXDAVL;
+    TEST_ASSERT_TRUE( UUT.read_multiple_blocks(buffer.begin(), buffer.end()) );
+    TEST_ASSERT_EQUAL( 4 * 512, SDIO->DLEN );
+    TEST_ASSERT_EQUAL( (9 << 4) | SDIO_DCTRL_DTDIR | SDIO_DCTRL_DTEN, SDIO->DCTRL);
+    TEST_ASSERT_EQUAL( SDIO_ICR_DBCKENDC | SDIO_ICR_DATAENDC, SDIO->ICR);
+    TEST_ASSERT_EQUAL(error::Code::None, UUT.get_error() );
+
+    /* Test reading a buffer which does not contain whole blocks */
+    SDIO->DLEN = 0;
+    TEST_ASSERT_FALSE( UUT.read_multiple_blocks(buffer.begin(), buffer.begin() + 100) );
+    TEST_ASSERT_EQUAL( 0, SDIO->DLEN );
+
+    /* Test reading blocks when bus is busy */
+    SDIO->STA = SDIO_STA_RXACT;
+    TEST_ASSERT_FALSE( UUT.read_multiple_blocks(buffer.begin(), buffer.end()) );
+    TEST_ASSERT_EQUAL(error::Code::SDIO_BUS_Busy_Error, UUT.get_error() );
+
+    /* Test reading blocks when a timeout occurs */
+    SDIO->STA = SDIO_STA_DTIMEOUT;
+    TEST_ASSERT_FALSE( UUT.read_multiple_blocks(buffer.begin(), buffer.end()) );
+    TEST_ASSERT_EQUAL(error::Code::SDIO_Timeout, UUT.get_error() );
+
+    /* The FIFO is emptied after the data counter reached zero */
+    SDIO->STA = SDIO_STA_DATAEND | SDIO_STA_RXDAVL;
+    SDIO->FIFO = 0x12345678;
+    TEST_ASSERT_TRUE( UUT.read_multiple_blocks(buffer.begin(), buffer.end()) );
+    TEST_ASSERT_EQUAL_HEX32( 0x12345678, buffer.front() );
+    TEST_ASSERT_EQUAL_HEX32( 0x12345678, buffer.back() );
+
+    /* Test reading blocks with a CRC error */
+    SDIO->STA = SDIO_STA_DCRCFAIL | SDIO_STA_RXDAVL;
+    TEST_ASSERT_FALSE( UUT.read_multiple_blocks(buffer.begin(), buffer.end()) );
+    TEST_ASSERT_EQUAL(error::Code::SDIO_Data_Error, UUT.get_error() );
+    TEST_ASSERT_BITS_HIGH( SDIO_ICR_DCRCFAILC | SDIO_ICR_RXOVERRC, SDIO->ICR );
+
+    /* Test reading blocks when the FIFO overran */
+    SDIO->STA = SDIO_STA_DATAEND | SDIO_STA_RXOVERR;
+    TEST_ASSERT_FALSE( UUT.read_multiple_blocks(buffer.begin(), buffer.end()) );
+    TEST_ASSERT_EQUAL(error::Code::SDIO_Data_Error, UUT.get_error() );
+
+    /* Test reading blocks when the peripheral stalls without a hardware timeout */
+    SDIO->STA = 0;
+    TEST_ASSERT_FALSE( UUT.read_multiple_blocks(buffer.begin(), buffer.end()) );
+    TEST_ASSERT_EQUAL(error::Code::SDIO_Timeout, UUT.get_error() );
+};
+
+/** 
+ * @brief Test writing multiple blocks with one transfer
+ */
+void test_write_multiple_blocks()
+{
+    setUp();
+
+    /* Create Controller -> SDIO */
+    auto UUT = sdio::Controller::create(1'000'000);
+    std::array<uint32_t, 2 * 128> buffer{0x11};
+
+    /* Test writing 2 blocks with no errors */
+    SDIO->STA = SDIO_STA_DATAEND | SDIO_STA_TXFIFOE;
+    TEST_ASSERT_TRUE( UUT.write_multiple_blocks(buffer.begin(), buffer.end()) );
+    TEST_ASSERT_EQUAL( 2 * 512, SDIO->DLEN );
+    TEST_ASSERT_EQUAL( (9 << 4) | SDIO_DCTRL_DTEN, SDIO->DCTRL);
+    TEST_ASSERT_EQUAL( SDIO_ICR_DBCKENDC | SDIO_ICR_DATAENDC, SDIO->ICR);
+    TEST_ASSERT_EQUAL(error::Code::None, UUT.get_error() );
+
+    /* Test writing blocks when bus is busy */
+    SDIO->STA = SDIO_STA_TXACT;
+    TEST_ASSERT_FALSE( UUT.write_multiple_blocks(buffer.begin(), buffer.end()) );
+    TEST_ASSERT_EQUAL(error::Code::SDIO_BUS_Busy_Error, UUT.get_error() );
+
+    /* Test writing blocks when a timeout occurs */
+    SDIO->STA = SDIO_STA_DTIMEOUT;
+    TEST_ASSERT_FALSE( UUT.write_multiple_blocks(buffer.begin(), buffer.end()) );
+    TEST_ASSERT_EQUAL(error::Code::SDIO_Timeout, UUT.get_error() );
+
+    /* Test writing blocks when the peripheral stalls without a hardware timeout */
+    SDIO->STA = SDIO_STA_TXFIFOE;
+    TEST_ASSERT_FALSE( UUT.write_multiple_blocks(buffer.begin(), buffer.end()) );
+    TEST_ASSERT_EQUAL(error::Code::SDIO_Timeout, UUT.get_error() );
+
+    /* Test writing blocks which the card did not accept */
+    SDIO->STA = SDIO_STA_DCRCFAIL;
+    TEST_ASSERT_FALSE( UUT.write_multiple_blocks(buffer.begin(), buffer.end()) );
+    TEST_ASSERT_EQUAL(error::Code::SDIO_Data_Error, UUT.get_error() );
+};
+
+/** 
+ * @brief Test the DMA transfers without an assigned stream
+ */
+void test_dma_without_stream()
+{
+    setUp();
+
+    /* Create Controller -> SDIO without DMA stream */
+    auto UUT = sdio::Controller::create(1'000'000);
+    std::array<uint32_t, 128> buffer{0};
+
+    /* No transfer can be started or completed */
+    TEST_ASSERT_FALSE( UUT.start_dma_read(buffer.begin(), buffer.end()) );
+    TEST_ASSERT_EQUAL(error::Code::SDIO_No_DMA_Stream, UUT.get_error() );
+    TEST_ASSERT_EQUAL( 0, SDIO->DCTRL );
+    TEST_ASSERT_FALSE( UUT.start_dma_write(buffer.begin(), buffer.end()) );
+    TEST_ASSERT_FALSE( UUT.dma_transfer_finished() );
+    TEST_ASSERT_FALSE( UUT.complete_dma_transfer() );
+    TEST_ASSERT_EQUAL(error::Code::SDIO_No_DMA_Stream, UUT.get_error() );
+};
+
+/** 
+ * @brief Test reading blocks using the DMA
+ */
+void test_dma_read()
+{
+    setUp();
+
+    /* Create Controller -> SDIO with DMA2 Stream3 Channel4 */
+    auto UUT = sdio::Controller::create(1'000'000);
+    dma::Stream stream{{2, 3, 4}};
+    UUT.assign_dma_stream(stream);
+    std::array<uint32_t, 2 * 128> buffer{0};
+
+    /* Start the transfer */
+    TEST_ASSERT_TRUE( UUT.start_dma_read(buffer.begin(), buffer.end()) );
+    TEST_ASSERT_EQUAL( 2 * 512, SDIO->DLEN );
+    TEST_ASSERT_EQUAL( (9 << 4) | SDIO_DCTRL_DTDIR | SDIO_DCTRL_DMAEN | SDIO_DCTRL_DTEN, SDIO->DCTRL);
+    TEST_ASSERT_BIT_HIGH(DMA_SxCR_EN_Pos, DMA2_Stream3->CR);
+    TEST_ASSERT_BITS(DMA_SxCR_DIR_Msk, 0, DMA2_Stream3->CR);
+    TEST_ASSERT_BIT_HIGH(DMA_SxCR_PFCTRL_Pos, DMA2_Stream3->CR);
+    TEST_ASSERT_BIT_HIGH(DMA_SxCR_MINC_Pos, DMA2_Stream3->CR);
+    TEST_ASSERT_BITS(DMA_SxCR_MBURST_Msk | DMA_SxCR_PBURST_Msk,
+        DMA_SxCR_MBURST_0 | DMA_SxCR_PBURST_0, DMA2_Stream3->CR);
+    TEST_ASSERT_BIT_HIGH(DMA_SxFCR_DMDIS_Pos, DMA2_Stream3->FCR);
+    TEST_ASSERT_EQUAL_HEX32(reinterpret_cast<std::uintptr_t>(&SDIO->FIFO), DMA2_Stream3->PAR);
+    TEST_ASSERT_EQUAL_HEX32(reinterpret_cast<std::uintptr_t>(buffer.data()), DMA2_Stream3->M0AR);
+
+    /* A second transfer cannot be started */
+    TEST_ASSERT_FALSE( UUT.start_dma_read(buffer.begin(), buffer.end()) );
+    TEST_ASSERT_EQUAL(error::Code::SDIO_BUS_Busy_Error, UUT.get_error() );
+
+    /* The transfer is finished when the SDIO and the DMA are done */
+    TEST_ASSERT_FALSE( UUT.dma_transfer_finished() );
+    SDIO->finish_data_transfer();
+    TEST_ASSERT_FALSE( UUT.dma_transfer_finished() );
+    DMA2->finish_transfer(3);
+    TEST_ASSERT_TRUE( UUT.dma_transfer_finished() );
+
+    /* Complete the transfer */
+    TEST_ASSERT_TRUE( UUT.complete_dma_transfer() );
+    TEST_ASSERT_EQUAL( 0, SDIO->DCTRL );
+    TEST_ASSERT_BITS_HIGH( SDIO_ICR_DBCKENDC | SDIO_ICR_DATAENDC, SDIO->ICR);
+    TEST_ASSERT_BITS_HIGH( DMA_LIFCR_CTCIF3 | DMA_LIFCR_CTEIF3, DMA2->LIFCR);
+
+    /* Buffers which do not contain whole blocks are rejected */
+    DMA2->registers_to_default();
+    SDIO->registers_to_default();
+    TEST_ASSERT_FALSE( UUT.start_dma_read(buffer.begin(), buffer.begin() + 100) );
+    TEST_ASSERT_BIT_LOW(DMA_SxCR_EN_Pos, DMA2_Stream3->CR);
+
+    /* A timeout aborts the transfer */
+    TEST_ASSERT_TRUE( UUT.start_dma_read(buffer.begin(), buffer.end()) );
+    SDIO->STA = SDIO_STA_DTIMEOUT;
+    TEST_ASSERT_TRUE( UUT.dma_transfer_finished() );
+    TEST_ASSERT_FALSE( UUT.complete_dma_transfer() );
+    TEST_ASSERT_EQUAL(error::Code::SDIO_Timeout, UUT.get_error() );
+    TEST_ASSERT_BIT_LOW(DMA_SxCR_EN_Pos, DMA2_Stream3->CR);
+};
+
+/** 
+ * @brief Test writing blocks using the DMA
+ */
+void test_dma_write()
+{
+    setUp();
+
+    /* Create Controller -> SDIO with DMA2 Stream3 Channel4 */
+    auto UUT = sdio::Controller::create(1'000'000);
+    dma::Stream stream{{2, 3, 4}};
+    UUT.assign_dma_stream(stream);
+    std::array<uint32_t, 4 * 128> buffer{0x11};
+
+    /* Start the transfer */
+    TEST_ASSERT_TRUE( UUT.start_dma_write(buffer.begin(), buffer.end()) );
+    TEST_ASSERT_EQUAL( 4 * 512, SDIO->DLEN );
+    TEST_ASSERT_EQUAL( (9 << 4) | SDIO_DCTRL_DMAEN | SDIO_DCTRL_DTEN, SDIO->DCTRL);
+    TEST_ASSERT_BITS(DMA_SxCR_DIR_Msk, DMA_SxCR_DIR_0, DMA2_Stream3->CR);
+
+    /* Finish the transfer */
+    DMA2->finish_transfer(3);
+    SDIO->finish_data_transfer();
+    TEST_ASSERT_TRUE( UUT.dma_transfer_finished() );
+    TEST_ASSERT_TRUE( UUT.complete_dma_transfer() );
+    TEST_ASSERT_EQUAL(error::Code::None, UUT.get_error() );
+
+    /* The transfer is not started when the bus is busy */
+    SDIO->registers_to_default();
+    SDIO->STA = SDIO_STA_TXACT;
+    TEST_ASSERT_FALSE( UUT.start_dma_write(buffer.begin(), buffer.end()) );
+    TEST_ASSERT_EQUAL(error::Code::SDIO_BUS_Busy_Error, UUT.get_error() );
+
+    /* A DMA error aborts the transfer */
+    SDIO->registers_to_default();
+    DMA2->registers_to_default();
+    TEST_ASSERT_TRUE( UUT.start_dma_write(buffer.begin(), buffer.end()) );
+    DMA2->fail_transfer(3);
+    TEST_ASSERT_TRUE( UUT.dma_transfer_finished() );
+    TEST_ASSERT_FALSE( UUT.complete_dma_transfer() );
+    TEST_ASSERT_EQUAL(error::Code::SDIO_Data_Error, UUT.get_error() );
+
+    /* A FIFO underrun aborts the transfer */
+    SDIO->registers_to_default();
+    DMA2->registers_to_default();
+    TEST_ASSERT_TRUE( UUT.start_dma_write(buffer.begin(), buffer.end()) );
+    SDIO->STA = SDIO_STA_TXUNDERR;
+    TEST_ASSERT_TRUE( UUT.dma_transfer_finished() );
+    TEST_ASSERT_FALSE( UUT.complete_dma_transfer() );
+    TEST_ASSERT_EQUAL(error::Code::SDIO_Data_Error, UUT.get_error() );
+    TEST_ASSERT_BIT_LOW(DMA_SxCR_EN_Pos, DMA2_Stream3->CR);
+};
+
 /* === Main === */
 int main(int argc, char **argv)
 {
@@ -516,5 +766,10 @@ int main(int argc, char **argv)
     RUN_TEST(test_get_long_response); 
     RUN_TEST(test_read_block);
     RUN_TEST(test_write_block);
+    RUN_TEST(test_read_multiple_blocks);
+    RUN_TEST(test_write_multiple_blocks);
+    RUN_TEST(test_dma_read);
+    RUN_TEST(test_dma_write);
+    RUN_TEST(test_dma_without_stream);
     return UNITY_END();
 };
\ No newline at end of file
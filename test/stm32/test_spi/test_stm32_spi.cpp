@@ -397,6 +397,29 @@ void test_read_array()
     TEST_ASSERT_EQUAL(error::Code::SPI_BUS_Busy_Error, UUT.get_error());
 };
 
+/** 
+ * @brief Test transferring a byte in full duplex
+ */
+void test_transfer_byte()
+{
+    setUp();
+    auto UUT = spi::Controller::create<Peripheral::SPI_1>(1'000'000);
+
+    /* The given byte is sent, the fake data register returns it */
+    SPI1->SR = SPI_SR_RXNE | SPI_SR_TXE;
+    SPI1->DR = 0x12;
+    auto rx = UUT.transfer_byte(0xFF);
+    TEST_ASSERT_TRUE(rx);
+    TEST_ASSERT_EQUAL(0xFF, rx.value());
+    TEST_ASSERT_EQUAL(0xFF, SPI1->DR);
+    TEST_ASSERT_EQUAL(error::Code::None, UUT.get_error());
+
+    /* Test transferring a byte, when nothing is received */
+    SPI1->SR = SPI_SR_TXE;
+    TEST_ASSERT_FALSE(UUT.transfer_byte(0xFF));
+    TEST_ASSERT_EQUAL(error::Code::SPI_Timeout, UUT.get_error());
+};
+
 /** 
  * @brief Test changing the data width of the SPI
  */
@@ -455,6 +478,7 @@ int main(int argc, char **argv)
     RUN_TEST(test_read_data);
     RUN_TEST(test_send_array);
     RUN_TEST(test_read_array);
+    RUN_TEST(test_transfer_byte);
     RUN_TEST(test_create_dma_stream);
     RUN_TEST(test_set_data_width);
     return UNITY_END();
@@ -98,6 +98,10 @@ void test_configure_SysTick()
     uint32_t Expected = F_CPU / 1000;
     CMSIS_SysTick_Config.assert_called_once_with(Expected);
     TEST_ASSERT_EQUAL(2, CMSIS_NVIC_SetPriority.call_count);
+
+    /* Configure SysTick with a faster interrupt rate */
+    timer::SysTick_Configure(10'000);
+    CMSIS_SysTick_Config.assert_called_once_with(F_CPU / 10'000);
 };
 
 /**
@@ -0,0 +1,110 @@
+/**
+ * OTOS - Open Tec Operating System
+ * Copyright (c) 2021 - 2024 Sebastian Oberschwendtner, sebastian.oberschwendtner@gmail.com
+ *
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+/**
+ ==============================================================================
+ * @file    test_stm32_watchdog.cpp
+ * @author  SO
+ * @version v5.2.0
+ * @date    18-October-2026
+ * @brief   Unit tests for testing the watchdog driver for stm32 microcontrollers.
+ ==============================================================================
+ */
+
+/* === Includes === */
+#include "stm32/watchdog_stm32.h"
+#include <mock.h>
+#include <unity.h>
+
+/* === Test List ===
+ * ✓ Watchdog can be started with a timeout
+ * ✓ The prescaler is chosen according to the timeout
+ * ✓ The timeout is limited to the maximum timeout
+ * ✓ Watchdog can be kicked
+ */
+
+/* === Tests === */
+void setUp()
+{
+    /* set stuff up here */
+    IWDG->registers_to_default();
+};
+
+void tearDown() {
+    /* clean stuff up here */
+};
+
+/**
+ * @brief Test starting the watchdog
+ */
+void test_create()
+{
+    using namespace std::chrono_literals;
+    setUp();
+
+    /* Start the watchdog with a short timeout */
+    auto UUT = watchdog::Independent::create(100ms);
+    TEST_ASSERT_EQUAL(watchdog::key::Reload, IWDG->KR);
+    TEST_ASSERT_EQUAL(0, IWDG->PR);
+    TEST_ASSERT_EQUAL((100 * watchdog::f_lsi / 4 / 1000) - 1, IWDG->RLR);
+    TEST_ASSERT_EQUAL(100, UUT.get_timeout().count());
+
+    /* Start the watchdog with a longer timeout */
+    setUp();
+    UUT = watchdog::Independent::create(2s);
+    TEST_ASSERT_EQUAL(2, IWDG->PR);
+    TEST_ASSERT_EQUAL((2000 * watchdog::f_lsi / 16 / 1000) - 1, IWDG->RLR);
+    TEST_ASSERT_EQUAL(2000, UUT.get_timeout().count());
+
+    /* The timeout is limited to the maximum timeout */
+    setUp();
+    UUT = watchdog::Independent::create(60s);
+    TEST_ASSERT_EQUAL(6, IWDG->PR);
+    TEST_ASSERT_EQUAL(0xFFF, IWDG->RLR);
+    TEST_ASSERT_EQUAL(4096 * 1000 / (watchdog::f_lsi / 256), UUT.get_timeout().count());
+};
+
+/**
+ * @brief Test kicking the watchdog
+ */
+void test_kick()
+{
+    using namespace std::chrono_literals;
+    setUp();
+    auto UUT = watchdog::Independent::create(100ms);
+
+    /* Kick using the driver */
+    IWDG->KR = 0;
+    UUT.kick();
+    TEST_ASSERT_EQUAL(watchdog::key::Reload, IWDG->KR);
+
+    /* Kick using the atomic function */
+    IWDG->KR = 0;
+    watchdog::kick();
+    TEST_ASSERT_EQUAL(watchdog::key::Reload, IWDG->KR);
+};
+
+/* === Main === */
+int main(int argc, char **argv)
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_create);
+    RUN_TEST(test_kick);
+    return UNITY_END();
+};
@@ -49,9 +49,17 @@ std::uint32_t mock_handle_increment()
     return tick_ms++;
 };
 
+std::uint64_t tick_us = 0;
+std::uint64_t mock_handle_us()
+{
+    call_timer.add_call(0);
+    return tick_us++;
+};
+
 void setUp(){
     /* set stuff up here */
     tick_ms = 0;
+    tick_us = 0;
     call_timer.reset();
 };
 
@@ -92,6 +100,29 @@ void test_time_elapsed()
     TEST_ASSERT_EQUAL(10, UUT.toc() );
 };
 
+/** 
+ * @brief Test the elapsed time with micro-second resolution
+ */
+void test_time_elapsed_us()
+{
+    setUp();
+    /* Without us timer the ms timer is used */
+    OTOS::TimedTask UUT(&mock_handle_constant);
+    tick_ms = 3;
+    TEST_ASSERT_EQUAL(3000, UUT.time_elapsed_us());
+
+    /* With us timer the us timer is used */
+    setUp();
+    OTOS::TimedTask UUT_us(&mock_handle_constant, &mock_handle_us);
+    tick_us = 10;
+    TEST_ASSERT_EQUAL(10, UUT_us.time_elapsed_us());
+
+    /* Waiting with us resolution */
+    setUp();
+    UUT_us.wait_us(10);
+    TEST_ASSERT_EQUAL(12, call_timer.call_count);
+};
+
 /** 
  * @brief Test the waiting functions
  */
@@ -128,6 +159,7 @@ int main(int argc, char **argv)
     UNITY_BEGIN();
     RUN_TEST(test_constructor);
     RUN_TEST(test_time_elapsed);
+    RUN_TEST(test_time_elapsed_us);
     RUN_TEST(test_waiting);
     RUN_TEST(test_blocking);
     UNITY_END();
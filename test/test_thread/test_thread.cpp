@@ -190,6 +190,44 @@ void test_priority()
     TEST_ASSERT_EQUAL(OTOS::Priority::Low, UUT.get_priority());
 };
 
+void test_heartbeat()
+{
+    /* Create UUT */
+    OTOS::Thread UUT;
+    UUT.set_schedule(0, OTOS::Priority::Normal);
+
+    /* Threads without supervision are always alive */
+    TEST_ASSERT_TRUE( UUT.count_heartbeat("zone.running") );
+    TEST_ASSERT_FALSE( UUT.is_stalled() );
+    TEST_ASSERT_EQUAL( 0, UUT.get_worst_heartbeat() );
+
+    /* Supervised thread stalls when the interval is exceeded */
+    UUT.set_heartbeat_interval(2);
+    UUT.set_last_zone("zone.yielded");
+    TEST_ASSERT_TRUE( UUT.count_heartbeat("zone.running") );
+    TEST_ASSERT_TRUE( UUT.count_heartbeat("zone.running") );
+    TEST_ASSERT_FALSE( UUT.count_heartbeat("zone.running") );
+    TEST_ASSERT_TRUE( UUT.is_stalled() );
+    TEST_ASSERT_EQUAL( 1, UUT.get_stall_count() );
+    TEST_ASSERT_EQUAL_STRING( "zone.yielded", UUT.get_stall_zone() );
+
+    /* The stall is only counted once */
+    TEST_ASSERT_FALSE( UUT.count_heartbeat("zone.running") );
+    TEST_ASSERT_EQUAL( 1, UUT.get_stall_count() );
+    TEST_ASSERT_EQUAL( 4, UUT.get_worst_heartbeat() );
+
+    /* The heartbeat revives the thread */
+    UUT.heartbeat();
+    TEST_ASSERT_FALSE( UUT.is_stalled() );
+
+    /* When the running thread stalls, the running zone is logged */
+    UUT.set_running();
+    for (int tick = 0; tick < 3; tick++)
+        UUT.count_heartbeat("zone.running");
+    TEST_ASSERT_EQUAL( 2, UUT.get_stall_count() );
+    TEST_ASSERT_EQUAL_STRING( "zone.running", UUT.get_stall_zone() );
+};
+
 /* === Perform the tests ===  */
 int main(int argc, char** argv)
 {
@@ -200,6 +238,7 @@ int main(int argc, char** argv)
     RUN_TEST(test_is_runnable_execute_always);
     RUN_TEST(test_is_runnable_with_schedule);
     RUN_TEST(test_priority);
+    RUN_TEST(test_heartbeat);
     UNITY_END();
     return 0;
 };